@@ -67,5 +67,12 @@ void TDEventDispatcher::fireEvent() {
 		}
 		((TDControllerEvent)callback->event)(data->controllerId, data->changeEvent, data->changeType, data->newValue.c_str(), callback->id, callback->context);
 
+	} else if (callback->type == CallbackStruct::SensorChangeEvent) {
+		SensorChangeEventCallbackData *data = dynamic_cast<SensorChangeEventCallbackData *>(callbackData.get());
+		if (!data) {
+			return;
+		}
+		((TDSensorChangeEvent)callback->event)(data->protocol.c_str(), data->model.c_str(), data->id, data->changeEvent, callback->id, callback->context);
+
 	}
 }
@@ -25,7 +25,7 @@ namespace TelldusCore {
 		TelldusCore::Mutex mutex;
 	};*/
 	struct CallbackStruct {
-		enum CallbackType { DeviceEvent, DeviceChangeEvent, RawDeviceEvent, SensorEvent, ControllerEvent };
+		enum CallbackType { DeviceEvent, DeviceChangeEvent, RawDeviceEvent, SensorEvent, ControllerEvent, SensorChangeEvent };
 		CallbackType type;
 		void *event;
 		int id;
@@ -82,6 +82,14 @@ namespace TelldusCore {
 		int changeType;
 		std::string newValue;
 	};
+	class SensorChangeEventCallbackData : public CallbackData {
+	public:
+		SensorChangeEventCallbackData() : CallbackData(CallbackStruct::SensorChangeEvent) {}
+		std::string protocol;
+		std::string model;
+		int id;
+		int changeEvent;
+	};
 
 	class TDEventDispatcher : public Thread {
 	public:
@@ -13,7 +13,7 @@ class Client::PrivateData {
 public:
 	Socket eventSocket;
 	bool running, sensorCached, controllerCached;
-	std::wstring sensorCache, controllerCache;
+	std::string sensorCache, controllerCache;
 	TelldusCore::Mutex mutex;
 	CallbackMainDispatcher callbackMainDispatcher;
 
@@ -60,15 +60,15 @@ bool Client::getBoolFromService(const Message &msg) {
 }
 
 int Client::getIntegerFromService(const Message &msg) {
-	std::wstring response = sendToService(msg);
-	if (response.compare(L"") == 0) {
+	std::string response = sendToService(msg);
+	if (response.compare("") == 0) {
 		return TELLSTICK_ERROR_COMMUNICATING_SERVICE;
 	}
 	return Message::takeInt(&response);
 }
 
-std::wstring Client::getWStringFromService(const Message &msg) {
-	std::wstring response = sendToService(msg);
+std::string Client::getStringFromService(const Message &msg) {
+	std::string response = sendToService(msg);
 	return Message::takeString(&response);
 }
 
@@ -78,12 +78,12 @@ int Client::registerEvent( CallbackStruct::CallbackType type, void *eventFunctio
 
 void Client::run(){
 	//listen here
-	d->eventSocket.connect(L"TelldusEvents");
+	d->eventSocket.connect("TelldusEvents");
 
 	while(d->running){
 
 		if(!d->eventSocket.isConnected()){
-			d->eventSocket.connect(L"TelldusEvents");	//try to reconnect to service
+			d->eventSocket.connect("TelldusEvents");	//try to reconnect to service
 			if(!d->eventSocket.isConnected()){
 				//reconnect didn't succeed, wait a while and try again
 				msleep(2000);
@@ -91,60 +91,68 @@ void Client::run(){
 			}
 		}
 
-		std::wstring clientMessage = d->eventSocket.read(1000);	//testing 5 second timeout
+		std::string clientMessage = d->eventSocket.read(1000);	//testing 5 second timeout
 
-		while(clientMessage != L""){
+		while(clientMessage != ""){
 			//a message arrived
-			std::wstring type = Message::takeString(&clientMessage);
-			if(type == L"TDDeviceChangeEvent"){
+			std::string type = Message::takeString(&clientMessage);
+			if(type == "TDDeviceChangeEvent"){
 				DeviceChangeEventCallbackData *data = new DeviceChangeEventCallbackData();
 				data->deviceId = Message::takeInt(&clientMessage);
 				data->changeEvent = Message::takeInt(&clientMessage);
 				data->changeType = Message::takeInt(&clientMessage);
 				d->callbackMainDispatcher.retrieveCallbackEvent()->signal(data);
 
-			} else if(type == L"TDDeviceEvent"){
+			} else if(type == "TDDeviceEvent"){
 				DeviceEventCallbackData *data = new DeviceEventCallbackData();
 				data->deviceId = Message::takeInt(&clientMessage);
 				data->deviceState = Message::takeInt(&clientMessage);
-				data->deviceStateValue = TelldusCore::wideToString(Message::takeString(&clientMessage));
+				data->deviceStateValue = Message::takeString(&clientMessage);
 				d->callbackMainDispatcher.retrieveCallbackEvent()->signal(data);
 
-			} else if(type == L"TDRawDeviceEvent"){
+			} else if(type == "TDRawDeviceEvent"){
 				RawDeviceEventCallbackData *data = new RawDeviceEventCallbackData();
-				data->data = TelldusCore::wideToString(Message::takeString(&clientMessage));
+				data->data = Message::takeString(&clientMessage);
 				data->controllerId = Message::takeInt(&clientMessage);
 				d->callbackMainDispatcher.retrieveCallbackEvent()->signal(data);
 
-			} else if(type == L"TDSensorEvent"){
+			} else if(type == "TDSensorEvent"){
 				SensorEventCallbackData *data = new SensorEventCallbackData();
-				data->protocol = TelldusCore::wideToString(Message::takeString(&clientMessage));
-				data->model = TelldusCore::wideToString(Message::takeString(&clientMessage));
+				data->protocol = Message::takeString(&clientMessage);
+				data->model = Message::takeString(&clientMessage);
 				data->id = Message::takeInt(&clientMessage);
 				data->dataType = Message::takeInt(&clientMessage);
-				data->value = TelldusCore::wideToString(Message::takeString(&clientMessage));
+				data->value = Message::takeString(&clientMessage);
 				data->timestamp = Message::takeInt(&clientMessage);
 				d->callbackMainDispatcher.retrieveCallbackEvent()->signal(data);
 
-			} else if(type == L"TDControllerEvent") {
+			} else if(type == "TDControllerEvent") {
 				ControllerEventCallbackData *data = new ControllerEventCallbackData();
 				data->controllerId = Message::takeInt(&clientMessage);
 				data->changeEvent = Message::takeInt(&clientMessage);
 				data->changeType = Message::takeInt(&clientMessage);
-				data->newValue = TelldusCore::wideToString(Message::takeString(&clientMessage));
+				data->newValue = Message::takeString(&clientMessage);
+				d->callbackMainDispatcher.retrieveCallbackEvent()->signal(data);
+
+			} else if(type == "TDSensorChangeEvent") {
+				SensorChangeEventCallbackData *data = new SensorChangeEventCallbackData();
+				data->protocol = Message::takeString(&clientMessage);
+				data->model = Message::takeString(&clientMessage);
+				data->id = Message::takeInt(&clientMessage);
+				data->changeEvent = Message::takeInt(&clientMessage);
 				d->callbackMainDispatcher.retrieveCallbackEvent()->signal(data);
 
 			} else {
-				clientMessage = L"";  //cleanup, if message contained garbage/unhandled data
+				clientMessage = "";  //cleanup, if message contained garbage/unhandled data
 			}
 		}
 	}
 }
 
-std::wstring Client::sendToService(const Message &msg) {
+std::string Client::sendToService(const Message &msg) {
 
 	int tries = 0;
-	std::wstring readData;
+	std::string readData;
 	while(tries < 20){
 		tries++;
 		if(tries == 20){
@@ -153,7 +161,7 @@ std::wstring Client::sendToService(const Message &msg) {
 			return msg;
 		}
 		Socket s;
-		s.connect(L"TelldusClient");
+		s.connect("TelldusClient");
 		if (!s.isConnected()) { //Connection failed
 			msleep(500);
 			continue; //retry
@@ -164,7 +172,7 @@ std::wstring Client::sendToService(const Message &msg) {
 			continue; //retry
 		}
 		readData = s.read(8000);  //TODO changed to 10000 from 5000, how much does this do...?
-		if(readData == L""){
+		if(readData == ""){
 			msleep(500);
 			continue; //TODO can we be really sure it SHOULD be anything?
 			//TODO perhaps break here instead?
@@ -191,31 +199,31 @@ bool Client::unregisterCallback( int callbackId ) {
 
 int Client::getSensor(char *protocol, int protocolLen, char *model, int modelLen, int *sensorId, int *dataTypes) {
 	if (!d->sensorCached) {
-		Message msg(L"tdSensor");
-		std::wstring response = Client::getWStringFromService(msg);
+		Message msg("tdSensor");
+		std::string response = Client::getStringFromService(msg);
 		int count = Message::takeInt(&response);
 		d->sensorCached = true;
-		d->sensorCache = L"";
+		d->sensorCache = "";
 		if (count > 0) {
 			d->sensorCache = response;
 		}
 	}
 
-	if (d->sensorCache == L"") {
+	if (d->sensorCache == "") {
 		d->sensorCached = false;
 		return TELLSTICK_ERROR_DEVICE_NOT_FOUND;
 	}
 
-	std::wstring p = Message::takeString(&d->sensorCache);
-	std::wstring m = Message::takeString(&d->sensorCache);
+	std::string p = Message::takeString(&d->sensorCache);
+	std::string m = Message::takeString(&d->sensorCache);
 	int id = Message::takeInt(&d->sensorCache);
 	int dt = Message::takeInt(&d->sensorCache);
 
 	if (protocol && protocolLen) {
-		strncpy(protocol, TelldusCore::wideToString(p).c_str(), protocolLen);
+		strncpy(protocol, p.c_str(), protocolLen);
 	}
 	if (model && modelLen) {
-		strncpy(model, TelldusCore::wideToString(m).c_str(), modelLen);
+		strncpy(model, m.c_str(), modelLen);
 	}
 	if (sensorId) {
 		(*sensorId) = id;
@@ -229,24 +237,24 @@ int Client::getSensor(char *protocol, int protocolLen, char *model, int modelLen
 
 int Client::getController(int *controllerId, int *controllerType, char *name, int nameLen, int *available) {
 	if (!d->controllerCached) {
-		Message msg(L"tdController");
-		std::wstring response = Client::getWStringFromService(msg);
+		Message msg("tdController");
+		std::string response = Client::getStringFromService(msg);
 		int count = Message::takeInt(&response);
 		d->controllerCached = true;
-		d->controllerCache = L"";
+		d->controllerCache = "";
 		if (count > 0) {
 			d->controllerCache = response;
 		}
 	}
 
-	if (d->controllerCache == L"") {
+	if (d->controllerCache == "") {
 		d->controllerCached = false;
 		return TELLSTICK_ERROR_NOT_FOUND;
 	}
 
 	int id = Message::takeInt(&d->controllerCache);
 	int type = Message::takeInt(&d->controllerCache);
-	std::wstring n = Message::takeString(&d->controllerCache);
+	std::string n = Message::takeString(&d->controllerCache);
 	int a = Message::takeInt(&d->controllerCache);
 
 	if (controllerId) {
@@ -256,7 +264,7 @@ int Client::getController(int *controllerId, int *controllerType, char *name, in
 		(*controllerType) = type;
 	}
 	if (name && nameLen) {
-		strncpy(name, TelldusCore::wideToString(n).c_str(), nameLen);
+		strncpy(name, n.c_str(), nameLen);
 	}
 	if (available) {
 		(*available) = a;
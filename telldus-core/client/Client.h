@@ -24,14 +24,14 @@ namespace TelldusCore {
 
 		static bool getBoolFromService(const Message &msg);
 		static int getIntegerFromService(const Message &msg);
-		static std::wstring getWStringFromService(const Message &msg);
+		static std::string getStringFromService(const Message &msg);
 
 	protected:
 			void run(void);
 
 	private:
 		Client();
-		static std::wstring sendToService(const Message &msg);
+		static std::string sendToService(const Message &msg);
 
 		class PrivateData;
 		PrivateData *d;
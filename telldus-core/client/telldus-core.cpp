@@ -10,6 +10,7 @@
 #include "Message.h"
 #include "Socket.h"
 #include <stdlib.h>
+#include <sstream>
 
 using namespace TelldusCore;
 
@@ -304,6 +305,33 @@ using namespace TelldusCore;
  *
  * @sa tdRegisterControllerEvent
  *
+ ******************************************************************************
+ *
+ * @typedef TDSensorChangeEvent
+ *   The callback type for changes to the list of sensors.
+ *
+ * @attention
+ *   The callback will be called by another thread than the thread used by the
+ *   application and some measures must be taken to synchronize it with the
+ *   main thread.
+ *
+ * @param protocol
+ *   The sensor's protocol.
+ * @param model
+ *   The model of the sensor.
+ * @param id
+ *   The unique id for the sensor.
+ * @param changeEvent
+ *   @ref TELLSTICK_DEVICE_REMOVED when the service has dropped the sensor,
+ *   because it has not been heard from within @c sensorTimeout seconds or to
+ *   make room for a new sensor when there are @c sensorCapacity of them.
+ * @param callbackId
+ *   The id of the callback.
+ * @param context
+ *   The pointer passed when registering for the event.
+ *
+ * @sa tdRegisterSensorChangeEvent
+ *
  **//* @} */
 
 /**
@@ -418,6 +446,27 @@ int WINAPI tdRegisterControllerEvent( TDControllerEvent eventFunction, void *con
 	return client->registerEvent( CallbackStruct::ControllerEvent, (void *)eventFunction, context );
 }
 
+/**
+ * Register a callback that will receive events when sensors are removed
+ * from the service's list of sensors.
+ *
+ * @param eventFunction
+ *   Callback function.
+ * @param context
+ *   Pointer that will be passed back in the callback.
+ *
+ * @returns
+ *   An id identifying the callback. Pass this id to tdUnregisterCallback() to
+ *   stop receiving callbacks.
+ *
+ * @sa @ref sec_events_registering
+ * @since Version 2.1.2
+ **/
+int WINAPI tdRegisterSensorChangeEvent( TDSensorChangeEvent eventFunction, void *context) {
+	Client *client = Client::getInstance();
+	return client->registerEvent( CallbackStruct::SensorChangeEvent, (void *)eventFunction, context );
+}
+
 /**
  * Unregister a callback.
  *
@@ -475,7 +524,7 @@ void WINAPI tdReleaseString(char *string) {
  * @since Version 2.0.0
  **/
 int WINAPI tdTurnOn(int intDeviceId){
-	Message msg(L"tdTurnOn");
+	Message msg("tdTurnOn");
 	msg.addArgument(intDeviceId);
 	return Client::getIntegerFromService(msg);
 }
@@ -493,7 +542,7 @@ int WINAPI tdTurnOn(int intDeviceId){
  * @since Version 2.0.0
  **/
 int WINAPI tdTurnOff(int intDeviceId){
-	Message msg(L"tdTurnOff");
+	Message msg("tdTurnOff");
 	msg.addArgument(intDeviceId);
 	return Client::getIntegerFromService(msg);
 }
@@ -511,7 +560,7 @@ int WINAPI tdTurnOff(int intDeviceId){
  * @since Version 2.0.0
  **/
 int WINAPI tdBell(int intDeviceId){
-	Message msg(L"tdBell");
+	Message msg("tdBell");
 	msg.addArgument(intDeviceId);
 	return Client::getIntegerFromService(msg);
 }
@@ -531,7 +580,7 @@ int WINAPI tdBell(int intDeviceId){
  * @since Version 2.0.0
  **/
 int WINAPI tdDim(int intDeviceId, unsigned char level){
-	Message msg(L"tdDim");
+	Message msg("tdDim");
 	msg.addArgument(intDeviceId);
 	msg.addArgument(level);
 	return Client::getIntegerFromService(msg);
@@ -550,7 +599,7 @@ int WINAPI tdDim(int intDeviceId, unsigned char level){
  * @since Version 2.1.0
  **/
 int WINAPI tdExecute(int intDeviceId){
-	Message msg(L"tdExecute");
+	Message msg("tdExecute");
 	msg.addArgument(intDeviceId);
 	return Client::getIntegerFromService(msg);
 }
@@ -568,7 +617,7 @@ int WINAPI tdExecute(int intDeviceId){
  * @since Version 2.1.0
  **/
 int WINAPI tdUp(int intDeviceId){
-	Message msg(L"tdUp");
+	Message msg("tdUp");
 	msg.addArgument(intDeviceId);
 	return Client::getIntegerFromService(msg);
 }
@@ -586,7 +635,7 @@ int WINAPI tdUp(int intDeviceId){
  * @since Version 2.1.0
  **/
 int WINAPI tdDown(int intDeviceId){
-	Message msg(L"tdDown");
+	Message msg("tdDown");
 	msg.addArgument(intDeviceId);
 	return Client::getIntegerFromService(msg);
 }
@@ -604,7 +653,7 @@ int WINAPI tdDown(int intDeviceId){
  * @since Version 2.1.0
  */
 int WINAPI tdStop(int intDeviceId){
-	Message msg(L"tdStop");
+	Message msg("tdStop");
 	msg.addArgument(intDeviceId);
 	return Client::getIntegerFromService(msg);
 }
@@ -623,7 +672,7 @@ int WINAPI tdStop(int intDeviceId){
  * @since Version 2.0.0
  **/
 int WINAPI tdLearn(int intDeviceId) {
-	Message msg(L"tdLearn");
+	Message msg("tdLearn");
 	msg.addArgument(intDeviceId);
 	return Client::getIntegerFromService(msg);
 }
@@ -643,7 +692,7 @@ int WINAPI tdLearn(int intDeviceId) {
  * @since Version 2.0.0
  **/
 int WINAPI tdLastSentCommand(int intDeviceId, int methodsSupported ) {
-	Message msg(L"tdLastSentCommand");
+	Message msg("tdLastSentCommand");
 	msg.addArgument(intDeviceId);
 	msg.addArgument(methodsSupported);
 	return Client::getIntegerFromService(msg);
@@ -663,10 +712,10 @@ int WINAPI tdLastSentCommand(int intDeviceId, int methodsSupported ) {
  * @since Version 2.0.0
  **/
 char * WINAPI tdLastSentValue( int intDeviceId ) {
-	Message msg(L"tdLastSentValue");
+	Message msg("tdLastSentValue");
 	msg.addArgument(intDeviceId);
-	std::wstring strReturn = Client::getWStringFromService(msg);
-	return wrapStdWstring(strReturn);
+	std::string strReturn = Client::getStringFromService(msg);
+	return wrapStdString(strReturn);
 }
 
 /**
@@ -678,7 +727,7 @@ char * WINAPI tdLastSentValue( int intDeviceId ) {
  * @since Version 2.0.0
  **/
 int WINAPI tdGetNumberOfDevices(void){
-	return Client::getIntegerFromService(Message(L"tdGetNumberOfDevices"));
+	return Client::getIntegerFromService(Message("tdGetNumberOfDevices"));
 }
 
 /**
@@ -702,7 +751,7 @@ int WINAPI tdGetNumberOfDevices(void){
  * @since Version 2.0.0
  **/
 int WINAPI tdGetDeviceId(int intDeviceIndex){
-	Message msg(L"tdGetDeviceId");
+	Message msg("tdGetDeviceId");
 	msg.addArgument(intDeviceIndex);
 	return Client::getIntegerFromService(msg);
 }
@@ -721,7 +770,7 @@ int WINAPI tdGetDeviceId(int intDeviceIndex){
  * @since Version 2.0.0
  **/
 int WINAPI tdGetDeviceType(int intDeviceId) {
-	Message msg(L"tdGetDeviceType");
+	Message msg("tdGetDeviceType");
 	msg.addArgument(intDeviceId);
 	return Client::getIntegerFromService(msg);
 }
@@ -739,10 +788,10 @@ int WINAPI tdGetDeviceType(int intDeviceId) {
  * @since Version 2.0.0
  **/
 char * WINAPI tdGetName(int intDeviceId){
-	Message msg(L"tdGetName");
+	Message msg("tdGetName");
 	msg.addArgument(intDeviceId);
-	std::wstring strReturn =  Client::getWStringFromService(msg);
-	return wrapStdWstring(strReturn);
+	std::string strReturn =  Client::getStringFromService(msg);
+	return wrapStdString(strReturn);
 }
 
 /**
@@ -760,7 +809,7 @@ char * WINAPI tdGetName(int intDeviceId){
  * @since Version 2.0.0
  **/
 bool WINAPI tdSetName(int intDeviceId, const char* strNewName){
-	Message msg(L"tdSetName");
+	Message msg("tdSetName");
 	msg.addArgument(intDeviceId);
 	msg.addArgument(strNewName);
 	return Client::getBoolFromService(msg);
@@ -779,10 +828,10 @@ bool WINAPI tdSetName(int intDeviceId, const char* strNewName){
  * @since Version 2.0.0
  **/
 char* WINAPI tdGetProtocol(int intDeviceId){
-	Message msg(L"tdGetProtocol");
+	Message msg("tdGetProtocol");
 	msg.addArgument(intDeviceId);
-	std::wstring strReturn =  Client::getWStringFromService(msg);
-	return wrapStdWstring(strReturn);
+	std::string strReturn =  Client::getStringFromService(msg);
+	return wrapStdString(strReturn);
 }
 
 /**
@@ -803,7 +852,7 @@ char* WINAPI tdGetProtocol(int intDeviceId){
  * @since Version 2.0.0
  **/
 bool WINAPI tdSetProtocol(int intDeviceId, const char* strProtocol){
-	Message msg(L"tdSetProtocol");
+	Message msg("tdSetProtocol");
 	msg.addArgument(intDeviceId);
 	msg.addArgument(strProtocol);
 	return Client::getBoolFromService(msg);
@@ -822,10 +871,10 @@ bool WINAPI tdSetProtocol(int intDeviceId, const char* strProtocol){
  * @since Version 2.0.0
  **/
 char* WINAPI tdGetModel(int intDeviceId){
-	Message msg(L"tdGetModel");
+	Message msg("tdGetModel");
 	msg.addArgument(intDeviceId);
-	std::wstring strReturn = Client::getWStringFromService(msg);
-	return wrapStdWstring(strReturn);
+	std::string strReturn = Client::getStringFromService(msg);
+	return wrapStdString(strReturn);
 }
 
 /**
@@ -843,7 +892,7 @@ char* WINAPI tdGetModel(int intDeviceId){
  * @since Version 2.0.0
  **/
 bool WINAPI tdSetModel(int intDeviceId, const char *strModel){
-	Message msg(L"tdSetModel");
+	Message msg("tdSetModel");
 	msg.addArgument(intDeviceId);
 	msg.addArgument(strModel);
 	return Client::getBoolFromService(msg);
@@ -866,7 +915,7 @@ bool WINAPI tdSetModel(int intDeviceId, const char *strModel){
  * @since Version 2.0.0
  **/
 bool WINAPI tdSetDeviceParameter(int intDeviceId, const char *strName, const char *strValue){
-	Message msg(L"tdSetDeviceParameter");
+	Message msg("tdSetDeviceParameter");
 	msg.addArgument(intDeviceId);
 	msg.addArgument(strName);
 	msg.addArgument(strValue);
@@ -891,12 +940,12 @@ bool WINAPI tdSetDeviceParameter(int intDeviceId, const char *strName, const cha
  * @since Version 2.0.0
  **/
 char * WINAPI tdGetDeviceParameter(int intDeviceId, const char *strName, const char *defaultValue){
-	Message msg(L"tdGetDeviceParameter");
+	Message msg("tdGetDeviceParameter");
 	msg.addArgument(intDeviceId);
 	msg.addArgument(strName);
 	msg.addArgument(defaultValue);
-	std::wstring strReturn = Client::getWStringFromService(msg);
-	return wrapStdWstring(strReturn);
+	std::string strReturn = Client::getStringFromService(msg);
+	return wrapStdString(strReturn);
 }
 
 /**
@@ -911,7 +960,7 @@ char * WINAPI tdGetDeviceParameter(int intDeviceId, const char *strName, const c
  * @since Version 2.0.0
  **/
 int WINAPI tdAddDevice(){
-	Message msg(L"tdAddDevice");
+	Message msg("tdAddDevice");
 	return Client::getIntegerFromService(msg);
 }
 
@@ -927,7 +976,7 @@ int WINAPI tdAddDevice(){
  * @since Version 2.0.0
  **/
 bool WINAPI tdRemoveDevice(int intDeviceId){
-	Message msg(L"tdRemoveDevice");
+	Message msg("tdRemoveDevice");
 	msg.addArgument(intDeviceId);
 	return Client::getBoolFromService(msg);
 }
@@ -968,7 +1017,7 @@ bool WINAPI tdRemoveDevice(int intDeviceId){
  * @since Version 2.0.0
  **/
 int WINAPI tdMethods(int id, int methodsSupported){
-	Message msg(L"tdMethods");
+	Message msg("tdMethods");
 	msg.addArgument(id);
 	msg.addArgument(methodsSupported);
 	return Client::getIntegerFromService(msg);
@@ -1041,12 +1090,8 @@ char * WINAPI tdGetErrorString(int intErrorNo) {
  * @since Version 2.0.0
  **/
 int WINAPI tdSendRawCommand(const char *command, int reserved) {
-	std::wstring wcommand;
-	for(int i = 0; i < strlen(command);++i) {
-		wcommand.append(1, (unsigned char)command[i]);
-	}
-	Message msg(L"tdSendRawCommand");
-	msg.addArgument(wcommand);
+	Message msg("tdSendRawCommand");
+	msg.addArgument(command);
 	msg.addArgument(reserved);
 	return Client::getIntegerFromService(msg);
 }
@@ -1064,11 +1109,11 @@ int WINAPI tdSendRawCommand(const char *command, int reserved) {
  * @since Version 2.1.0
  **/
 void WINAPI tdConnectTellStickController(int vid, int pid, const char *serial) {
-	Message msg(L"tdConnectTellStickController");
+	Message msg("tdConnectTellStickController");
 	msg.addArgument(vid);
 	msg.addArgument(pid);
 	msg.addArgument(serial);
-	Client::getWStringFromService(msg);
+	Client::getStringFromService(msg);
 }
 
 /**
@@ -1084,11 +1129,11 @@ void WINAPI tdConnectTellStickController(int vid, int pid, const char *serial) {
  * @since Version 2.1.0
  **/
 void WINAPI tdDisconnectTellStickController(int vid, int pid, const char *serial) {
-	Message msg(L"tdDisconnectTellStickController");
+	Message msg("tdDisconnectTellStickController");
 	msg.addArgument(vid);
 	msg.addArgument(pid);
 	msg.addArgument(serial);
-	Client::getWStringFromService(msg);
+	Client::getStringFromService(msg);
 }
 
 /**
@@ -1146,20 +1191,20 @@ int WINAPI tdSensor(char *protocol, int protocolLen, char *model, int modelLen,
  * @since Version 2.1.0
  */
 int WINAPI tdSensorValue(const char *protocol, const char *model, int id, int dataType, char *value, int len, int *timestamp) {
-	Message msg(L"tdSensorValue");
+	Message msg("tdSensorValue");
 	msg.addArgument(protocol);
 	msg.addArgument(model);
 	msg.addArgument(id);
 	msg.addArgument(dataType);
-	std::wstring retval = Client::getWStringFromService(msg);
+	std::string retval = Client::getStringFromService(msg);
 	if (retval.length() == 0) {
 		return TELLSTICK_ERROR_METHOD_NOT_SUPPORTED;
 	}
 
-	std::wstring v = Message::takeString(&retval);
+	std::string v = Message::takeString(&retval);
 	int t = Message::takeInt(&retval);
 	if (value && len) {
-		strncpy(value, TelldusCore::wideToString(v).c_str(), len);
+		strncpy(value, v.c_str(), len);
 	}
 	if (timestamp) {
 		(*timestamp) = t;
@@ -1167,6 +1212,144 @@ int WINAPI tdSensorValue(const char *protocol, const char *model, int id, int da
 	return TELLSTICK_SUCCESS;
 }
 
+/**
+ * Get the recent values of one type from a sensor, as kept by the service.
+ * The service keeps the latest values of every data type of every sensor,
+ * as many as the setting @c sensorHistoryDepth allows.
+ *
+ * @param[in] protocol
+ *   The protocol for the sensor.
+ * @param[in] model
+ *   The model for the sensor.
+ * @param[in] id
+ *   The id of the sensor.
+ * @param[in] dataType
+ *   Which sensor value to retrive (one of @ref TELLSTICK_TEMPERATURE or @ref
+ *   TELLSTICK_HUMIDITY).
+ * @param[in] fromTimestamp
+ *   The oldest values to include.
+ * @param[in] toTimestamp
+ *   The newest values to include.
+ *
+ * @returns
+ *   The values, oldest first, one per line as the timestamp and the value
+ *   separated by a space. The string is empty if there are no values. The
+ *   returned string must be freed by calling tdReleaseString().
+ *
+ * @since Version 2.1.2
+ */
+char * WINAPI tdSensorHistory(const char *protocol, const char *model, int id, int dataType, int fromTimestamp, int toTimestamp) {
+	Message msg("tdSensorHistory");
+	msg.addArgument(protocol);
+	msg.addArgument(model);
+	msg.addArgument(id);
+	msg.addArgument(dataType);
+	msg.addArgument(fromTimestamp);
+	msg.addArgument(toTimestamp);
+	std::string response = Client::getStringFromService(msg);
+
+	std::stringstream history;
+	int count = Message::takeInt(&response);
+	for (int i = 0; i < count; ++i) {
+		std::string value = Message::takeString(&response);
+		int timestamp = Message::takeInt(&response);
+		history << timestamp << " " << value << "\n";
+	}
+	return wrapStdString(history.str());
+}
+
+/**
+ * Get the min, max and average of one type of value from a sensor, per
+ * minute, hour or day. The service updates these as the values arrive and
+ * keeps as many of them as the settings @c sensorRollupMinutes,
+ * @c sensorRollupHours and @c sensorRollupDays allow. They are aligned to
+ * UTC.
+ *
+ * @param[in] protocol
+ *   The protocol for the sensor.
+ * @param[in] model
+ *   The model for the sensor.
+ * @param[in] id
+ *   The id of the sensor.
+ * @param[in] dataType
+ *   Which sensor value to retrive (one of @ref TELLSTICK_TEMPERATURE or @ref
+ *   TELLSTICK_HUMIDITY).
+ * @param[in] rollup
+ *   One of @ref TELLSTICK_ROLLUP_MINUTE, @ref TELLSTICK_ROLLUP_HOUR or
+ *   @ref TELLSTICK_ROLLUP_DAY.
+ * @param[in] fromTimestamp
+ *   The start of the oldest minute, hour or day to include.
+ * @param[in] toTimestamp
+ *   The start of the newest minute, hour or day to include.
+ *
+ * @returns
+ *   One line per minute, hour or day, oldest first, with its start
+ *   timestamp, the min, max and average value and the number of values
+ *   separated by spaces. The string is empty if there are no values. The
+ *   returned string must be freed by calling tdReleaseString().
+ *
+ * @since Version 2.1.2
+ */
+char * WINAPI tdSensorRollup(const char *protocol, const char *model, int id, int dataType, int rollup, int fromTimestamp, int toTimestamp) {
+	Message msg("tdSensorRollup");
+	msg.addArgument(protocol);
+	msg.addArgument(model);
+	msg.addArgument(id);
+	msg.addArgument(dataType);
+	msg.addArgument(rollup);
+	msg.addArgument(fromTimestamp);
+	msg.addArgument(toTimestamp);
+	std::string response = Client::getStringFromService(msg);
+
+	std::stringstream rollups;
+	int count = Message::takeInt(&response);
+	for (int i = 0; i < count; ++i) {
+		int start = Message::takeInt(&response);
+		std::string min = Message::takeString(&response);
+		std::string max = Message::takeString(&response);
+		std::string average = Message::takeString(&response);
+		int values = Message::takeInt(&response);
+		rollups << start << " " << min << " " << max << " " << average << " " << values << "\n";
+	}
+	return wrapStdString(rollups.str());
+}
+
+/**
+ * Get the latest value of every type from every sensor, in one call. This
+ * is the same as iterating with tdSensor() and calling tdSensorValue() for
+ * each type, without a round trip to the service for each value.
+ *
+ * @returns
+ *   One line per value with the protocol, model, id, data type, value and
+ *   timestamp separated by single spaces. The values of a sensor are on
+ *   consecutive lines. The string is empty if no sensor has reported
+ *   anything. The returned string must be freed by calling tdReleaseString().
+ *
+ * The format is stable, fields will not be added, removed or reordered. The
+ * protocol and model names from the protocol decoders never contain spaces;
+ * a line that does not split into exactly six fields can not be parsed
+ * reliably and should be skipped.
+ *
+ * @since Version 2.1.2
+ */
+char * WINAPI tdSensorSnapshot() {
+	Message msg("tdSensorSnapshot");
+	std::string response = Client::getStringFromService(msg);
+
+	std::stringstream snapshot;
+	int count = Message::takeInt(&response);
+	for (int i = 0; i < count; ++i) {
+		std::string protocol = Message::takeString(&response);
+		std::string model = Message::takeString(&response);
+		int id = Message::takeInt(&response);
+		int dataType = Message::takeInt(&response);
+		std::string value = Message::takeString(&response);
+		int timestamp = Message::takeInt(&response);
+		snapshot << protocol << " " << model << " " << id << " " << dataType << " " << value << " " << timestamp << "\n";
+	}
+	return wrapStdString(snapshot.str());
+}
+
 /**
  * Use this function to iterate over all controllers. Iterate until
  * @ref TELLSTICK_SUCCESS is not returned
@@ -1199,7 +1382,8 @@ int WINAPI tdController(int *controllerId, int *controllerType, char *name, int
 
 /**
  * This function gets a parameter on a controller.
- * Valid parameters are: \c serial, \c name, \c available and \c firmware
+ * Valid parameters are: \c serial, \c name, \c available, \c firmware and
+ * \c airtime (the estimated time in ms the controller has spent transmitting)
  *
  * @param[in] controllerId
  *   The controller to change.
@@ -1216,16 +1400,16 @@ int WINAPI tdController(int *controllerId, int *controllerType, char *name, int
  * @since Version 2.1.2
  **/
 int WINAPI tdControllerValue(int controllerId, const char *name, char *value, int valueLen) {
-	Message msg(L"tdControllerValue");
+	Message msg("tdControllerValue");
 	msg.addArgument(controllerId);
 	msg.addArgument(name);
-	std::wstring retval = Client::getWStringFromService(msg);
+	std::string retval = Client::getStringFromService(msg);
 	if (retval.length() == 0) {
 		return TELLSTICK_ERROR_METHOD_NOT_SUPPORTED;
 	}
 
 	if (value && valueLen) {
-		strncpy(value, TelldusCore::wideToString(retval).c_str(), valueLen);
+		strncpy(value, retval.c_str(), valueLen);
 	}
 	return TELLSTICK_SUCCESS;
 }
@@ -1247,7 +1431,7 @@ int WINAPI tdControllerValue(int controllerId, const char *name, char *value, in
  * @since Version 2.1.2
  **/
 int WINAPI tdSetControllerValue(int controllerId, const char *name, const char *value) {
-	Message msg(L"tdSetControllerValue");
+	Message msg("tdSetControllerValue");
 	msg.addArgument(controllerId);
 	msg.addArgument(name);
 	msg.addArgument(value);
@@ -1269,9 +1453,105 @@ int WINAPI tdSetControllerValue(int controllerId, const char *name, const char *
  * @since Version 2.1.2
  **/
 int WINAPI tdRemoveController(int controllerId) {
-	Message msg(L"tdRemoveController");
+	Message msg("tdRemoveController");
 	msg.addArgument(controllerId);
 	return Client::getIntegerFromService(msg);
 }
 
+/**
+ * Add a job to the scheduler in the service. The service runs the job on
+ * the device at the given time, also when no client is running. Jobs are
+ * saved and kept across restarts of the service.
+ *
+ * Sunrise and sunset are calculated for the position in the settings
+ * @c schedulerLatitude and @c schedulerLongitude, in decimal degrees with
+ * north and east positive. Jobs at sunrise or sunset are not run if these
+ * are not set.
+ *
+ * @param[in] deviceId
+ *   The device to control.
+ * @param[in] method
+ *   The method to run, for example @ref TELLSTICK_TURNON or
+ *   @ref TELLSTICK_DIM.
+ * @param[in] methodValue
+ *   The value for the method, the dim level for @ref TELLSTICK_DIM.
+ * @param[in] type
+ *   One of @ref TELLSTICK_SCHEDULE_TIME, @ref TELLSTICK_SCHEDULE_SUNRISE or
+ *   @ref TELLSTICK_SCHEDULE_SUNSET.
+ * @param[in] hour
+ *   The hour, in local time, for @ref TELLSTICK_SCHEDULE_TIME.
+ * @param[in] minute
+ *   The minute for @ref TELLSTICK_SCHEDULE_TIME.
+ * @param[in] offset
+ *   Minutes to add to the time, may be negative.
+ * @param[in] weekdays
+ *   The days to run the job on, bit 0 for Monday up to bit 6 for Sunday. If
+ *   0 the job is run once and then removed.
+ *
+ * @returns
+ *   The id of the new job, @ref TELLSTICK_ERROR_SYNTAX if a parameter is
+ *   out of range, or another error code on failure.
+ *
+ * @since Version 2.1.2
+ **/
+int WINAPI tdAddScheduledJob(int deviceId, int method, int methodValue, int type, int hour, int minute, int offset, int weekdays) {
+	Message msg("tdAddScheduledJob");
+	msg.addArgument(deviceId);
+	msg.addArgument(method);
+	msg.addArgument(methodValue);
+	msg.addArgument(type);
+	msg.addArgument(hour);
+	msg.addArgument(minute);
+	msg.addArgument(offset);
+	msg.addArgument(weekdays);
+	return Client::getIntegerFromService(msg);
+}
+
+/**
+ * Remove a job from the scheduler in the service.
+ *
+ * @param[in] jobId
+ *   The id returned by tdAddScheduledJob().
+ *
+ * @returns
+ *   @ref TELLSTICK_SUCCESS if the job was removed, @ref
+ *   TELLSTICK_ERROR_NOT_FOUND if there is no such job.
+ *
+ * @since Version 2.1.2
+ **/
+int WINAPI tdRemoveScheduledJob(int jobId) {
+	Message msg("tdRemoveScheduledJob");
+	msg.addArgument(jobId);
+	return Client::getIntegerFromService(msg);
+}
+
+/**
+ * List the jobs in the scheduler in the service.
+ *
+ * @returns
+ *   One line per job with the id, device id, method, method value, type,
+ *   hour, minute, offset, weekdays and the next time the job runs,
+ *   separated by spaces. The next time is 0 if the job will not run. The
+ *   returned string must be freed by calling tdReleaseString().
+ *
+ * @sa tdAddScheduledJob
+ *
+ * @since Version 2.1.2
+ **/
+char * WINAPI tdScheduledJobs() {
+	Message msg("tdScheduledJobs");
+	std::string response = Client::getStringFromService(msg);
+
+	std::stringstream jobs;
+	int count = Message::takeInt(&response);
+	for (int i = 0; i < count; ++i) {
+		//The id, the job fields and the next run time
+		for (int field = 0; field < 10; ++field) {
+			jobs << (field ? " " : "") << Message::takeInt(&response);
+		}
+		jobs << "\n";
+	}
+	return wrapStdString(jobs.str());
+}
+
 /* @} */
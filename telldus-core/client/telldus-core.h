@@ -30,6 +30,7 @@ typedef void (WINAPI *TDDeviceChangeEvent)(int deviceId, int changeEvent, int ch
 typedef void (WINAPI *TDRawDeviceEvent)(const char *data, int controllerId, int callbackId, void *context);
 typedef void (WINAPI *TDSensorEvent)(const char *protocol, const char *model, int id, int dataType, const char *value, int timestamp, int callbackId, void *context);
 typedef void (WINAPI *TDControllerEvent)(int controllerId, int changeEvent, int changeType, const char *newValue, int callbackId, void *context);
+typedef void (WINAPI *TDSensorChangeEvent)(const char *protocol, const char *model, int id, int changeEvent, int callbackId, void *context);
 
 #ifndef __cplusplus
 	#define bool char
@@ -44,6 +45,7 @@ extern "C" {
 	TELLSTICK_API int WINAPI tdRegisterRawDeviceEvent( TDRawDeviceEvent eventFunction, void *context );
 	TELLSTICK_API int WINAPI tdRegisterSensorEvent( TDSensorEvent eventFunction, void *context );
 	TELLSTICK_API int WINAPI tdRegisterControllerEvent( TDControllerEvent eventFunction, void *context);
+	TELLSTICK_API int WINAPI tdRegisterSensorChangeEvent( TDSensorChangeEvent eventFunction, void *context);
 	TELLSTICK_API int WINAPI tdUnregisterCallback( int callbackId );
 	TELLSTICK_API void WINAPI tdClose(void);
 	TELLSTICK_API void WINAPI tdReleaseString(char *string);
@@ -87,12 +89,20 @@ extern "C" {
 
 	TELLSTICK_API int WINAPI tdSensor(char *protocol, int protocolLen, char *model, int modelLen, int *id, int *dataTypes);
 	TELLSTICK_API int WINAPI tdSensorValue(const char *protocol, const char *model, int id, int dataType, char *value, int len, int *timestamp);
+	TELLSTICK_API char * WINAPI tdSensorHistory(const char *protocol, const char *model, int id, int dataType, int fromTimestamp, int toTimestamp);
+	TELLSTICK_API char * WINAPI tdSensorRollup(const char *protocol, const char *model, int id, int dataType, int rollup, int fromTimestamp, int toTimestamp);
+	//"protocol model id dataType value timestamp\n" per value, see the documentation
+	TELLSTICK_API char * WINAPI tdSensorSnapshot();
 
 	TELLSTICK_API int WINAPI tdController(int *controllerId, int *controllerType, char *name, int nameLen, int *available);
 	TELLSTICK_API int WINAPI tdControllerValue(int controllerId, const char *name, char *value, int valueLen);
 	TELLSTICK_API int WINAPI tdSetControllerValue(int controllerId, const char *name, const char *value);
 	TELLSTICK_API int WINAPI tdRemoveController(int controllerId);
 
+	TELLSTICK_API int WINAPI tdAddScheduledJob(int deviceId, int method, int methodValue, int type, int hour, int minute, int offset, int weekdays);
+	TELLSTICK_API int WINAPI tdRemoveScheduledJob(int jobId);
+	TELLSTICK_API char * WINAPI tdScheduledJobs();
+
 #ifdef __cplusplus
 }
 #endif
@@ -113,6 +123,16 @@ extern "C" {
 #define TELLSTICK_TEMPERATURE	1
 #define TELLSTICK_HUMIDITY		2
 
+//Sensor value rollups
+#define TELLSTICK_ROLLUP_MINUTE	1
+#define TELLSTICK_ROLLUP_HOUR	2
+#define TELLSTICK_ROLLUP_DAY	3
+
+//Scheduled job types
+#define TELLSTICK_SCHEDULE_TIME		1
+#define TELLSTICK_SCHEDULE_SUNRISE	2
+#define TELLSTICK_SCHEDULE_SUNSET	3
+
 //Error codes
 #define TELLSTICK_SUCCESS 0
 #define TELLSTICK_ERROR_NOT_FOUND -1
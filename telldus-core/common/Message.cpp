@@ -2,19 +2,19 @@
 #include "Socket.h"
 #include "Strings.h"
 #include <sstream>
-#include <wctype.h>
+#include <ctype.h>
 #include <stdlib.h>
 
 using namespace TelldusCore;
 
 
 Message::Message()
-	: std::wstring()
+	: std::string()
 {
 }
 
-Message::Message(const std::wstring &functionName)
-	:std::wstring()
+Message::Message(const std::string &functionName)
+	:std::string()
 {
 	this->addArgument(functionName);
 }
@@ -22,20 +22,20 @@ Message::Message(const std::wstring &functionName)
 Message::~Message(void) {
 }
 
-void Message::addArgument(const std::wstring &value) {
-	//std::wstringstream st;
+void Message::addArgument(const std::string &value) {
+	//std::stringstream st;
 	//st << (int)value.size();
-	this->append(TelldusCore::intToWstring(value.size())); //st.str());
-	this->append(L":");
+	this->append(TelldusCore::intToString(value.size())); //st.str());
+	this->append(":");
 	this->append(value);
 }
 
 void Message::addArgument(int value) {
-	//std::wstringstream st;
+	//std::stringstream st;
 	//st << (int)value;
-	this->append(L"i");
-	this->append(TelldusCore::intToWstring(value)); // st.str());
-	this->append(L"s");
+	this->append("i");
+	this->append(TelldusCore::intToString(value)); // st.str());
+	this->append("s");
 }
 
 /*
@@ -88,41 +88,41 @@ void Message::addSpecialArgument(const char *value){
 */
 
 void Message::addArgument(const char *value) {
-	this->addArgument(TelldusCore::charToWstring(value));
+	this->addArgument(std::string(value));
 }
 
-bool Message::nextIsInt(const std::wstring &message) {
+bool Message::nextIsInt(const std::string &message) {
 	if (message.length() == 0) {
 		return false;
 	}
 	return (message.at(0) == 'i');
 }
 
-bool Message::nextIsString(const std::wstring &message) {
+bool Message::nextIsString(const std::string &message) {
 	if (message.length() == 0) {
 		return false;
 	}
-	return (iswdigit(message.at(0)) != 0);
+	return (isdigit(static_cast<unsigned char>(message.at(0))) != 0);
 }
 
-std::wstring Message::takeString(std::wstring *message) {
+std::string Message::takeString(std::string *message) {
     
 	if (!Message::nextIsString(*message)) {
-		return L"";
+		return "";
 	}
 	size_t index = message->find(':');
-	int length = wideToInteger(message->substr(0, index));
-	std::wstring retval(message->substr(index+1, length));
+	int length = charToInteger(message->substr(0, index).c_str());
+	std::string retval(message->substr(index+1, length));
 	message->erase(0, index+length+1);
 	return retval;
 }
 
-int Message::takeInt(std::wstring *message) {
+int Message::takeInt(std::string *message) {
 	if (!Message::nextIsInt(*message)) {
 		return 0;
 	}
 	size_t index = message->find('s');
-	int value = wideToInteger(message->substr(1, index - 1));
+	int value = charToInteger(message->substr(1, index - 1).c_str());
 	message->erase(0, index+1);
 	return value;
 }
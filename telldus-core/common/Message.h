@@ -4,24 +4,24 @@
 #include <string>
 
 namespace TelldusCore {
-	class Message : public std::wstring {
+	class Message : public std::string {
 	public:
 		Message();
-		Message(const std::wstring &);
+		Message(const std::string &);
 		~Message(void);
 
-		void addArgument(const std::wstring &);
-		//void addSpecialArgument(const std::wstring &);
+		void addArgument(const std::string &);
+		//void addSpecialArgument(const std::string &);
 		//void addSpecialArgument(int);
 		//void addSpecialArgument(const char *);
 		void addArgument(int);
 		void addArgument(const char *);
 				
-		static bool nextIsInt(const std::wstring &);
-		static bool nextIsString(const std::wstring &);
+		static bool nextIsInt(const std::string &);
+		static bool nextIsString(const std::string &);
 
-		static std::wstring takeString(std::wstring *);
-		static int takeInt(std::wstring *);
+		static std::string takeString(std::string *);
+		static int takeInt(std::string *);
 		
 	private:
 		
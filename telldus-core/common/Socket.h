@@ -18,12 +18,12 @@ namespace TelldusCore {
 		Socket(SOCKET_T hPipe);
 		virtual ~Socket(void);
 
-		void connect(const std::wstring &server);
+		void connect(const std::string &server);
 		bool isConnected();
-		std::wstring read();
-		std::wstring read(int timeout);
+		std::string read();
+		std::string read(int timeout);
 		void stopReadWait();
-		void write(const std::wstring &msg);
+		void write(const std::string &msg);
 		
 	private:
 		class PrivateData;
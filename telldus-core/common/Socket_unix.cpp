@@ -46,14 +46,14 @@ Socket::~Socket(void) {
 	delete d;
 }
 
-void Socket::connect(const std::wstring &server) {
+void Socket::connect(const std::string &server) {
 	struct sockaddr_un remote;
 	socklen_t len;
 
 	if ((d->socket = socket(AF_UNIX, SOCK_STREAM, 0)) == -1) {
 		return;
 	}
-	std::string name = "/tmp/" + std::string(server.begin(), server.end());
+	std::string name = "/tmp/" + server;
 	remote.sun_family = AF_UNIX;
 	strcpy(remote.sun_path, name.c_str());
 
@@ -71,11 +71,11 @@ bool Socket::isConnected(){
 	return d->connected;
 }
 
-std::wstring Socket::read() {
+std::string Socket::read() {
 	return this->read(0);
 }
 
-std::wstring Socket::read(int timeout) {
+std::string Socket::read(int timeout) {
 	struct timeval tv;
 	char inbuf[BUFSIZE];
 
@@ -87,7 +87,7 @@ std::wstring Socket::read(int timeout) {
 
 		int response = select(d->socket+1, &d->infds, NULL, NULL, &tv);
 		if (response == 0 && timeout > 0) {
-			return L"";
+			return "";
 		} else if (response <= 0) {
 			FD_SET(d->socket, &d->infds);
 			continue;
@@ -98,7 +98,7 @@ std::wstring Socket::read(int timeout) {
 			memset(inbuf, '\0', sizeof(inbuf));
 			received = recv(d->socket, inbuf, BUFSIZE - 1, 0);
 			if(received > 0){
-				msg.append(std::string(inbuf));
+				msg.append(inbuf, received);
 			}
 		}
 		if (received < 0) {
@@ -108,7 +108,7 @@ std::wstring Socket::read(int timeout) {
 		break;
 	}
 
-	return TelldusCore::charToWstring(msg.c_str());
+	return msg;
 }
 
 void Socket::stopReadWait(){
@@ -117,9 +117,8 @@ void Socket::stopReadWait(){
 	//TODO somehow signal the socket here?
 }
 
-void Socket::write(const std::wstring &msg) {
-	std::string newMsg(TelldusCore::wideToString(msg));
-	int sent = send(d->socket, newMsg.c_str(), newMsg.length(), 0);
+void Socket::write(const std::string &msg) {
+	int sent = send(d->socket, msg.c_str(), msg.length(), 0);
 	if (sent < 0) {
 		TelldusCore::MutexLocker locker(&d->mutex);
 		d->connected = false;
@@ -1,4 +1,5 @@
 #include "Socket.h"
+#include "Strings.h"
 
 #include <windows.h>
 #include <AccCtrl.h>
@@ -42,10 +43,10 @@ Socket::~Socket(void){
 	delete d;
 }
 
-void Socket::connect(const std::wstring &server){
+void Socket::connect(const std::string &server){
 	BOOL fSuccess = false;
 
-	std::wstring name(L"\\\\.\\pipe\\" + server);
+	std::wstring name(L"\\\\.\\pipe\\" + TelldusCore::charToWstring(server.c_str()));
 	d->hPipe = CreateFile(
 		(const wchar_t *)name.c_str(),           // pipe name 
 		GENERIC_READ |  // read and write access 
@@ -78,12 +79,12 @@ void Socket::stopReadWait(){
 	SetEvent(d->readEvent);
 }
 
-std::wstring Socket::read() {
+std::string Socket::read() {
 	return read(INFINITE);
 }
 
-std::wstring Socket::read(int timeout){
-	wchar_t buf[BUFSIZE];
+std::string Socket::read(int timeout){
+	char buf[BUFSIZE];
 	int result;
 	DWORD cbBytesRead = 0;
 	OVERLAPPED oOverlap; 
@@ -93,14 +94,14 @@ std::wstring Socket::read(int timeout){
 	d->readEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
 	oOverlap.hEvent = d->readEvent;
 	BOOL fSuccess = false;
-	std::wstring returnString;
+	std::string returnString;
 	bool moreData = true;
 	
 	while(moreData){
 		moreData = false;
 		memset(&buf, 0, sizeof(buf));
 
-		ReadFile( d->hPipe, &buf, sizeof(buf)-sizeof(wchar_t), &cbBytesRead, &oOverlap);
+		ReadFile( d->hPipe, &buf, sizeof(buf)-sizeof(char), &cbBytesRead, &oOverlap);
 		
 		result = WaitForSingleObject(oOverlap.hEvent, timeout);
 		
@@ -109,7 +110,7 @@ std::wstring Socket::read(int timeout){
 			WaitForSingleObject(oOverlap.hEvent, INFINITE);
 			d->readEvent = 0;
 			CloseHandle(oOverlap.hEvent);
-			return L"";
+			return "";
 		}
 
 		if (result == WAIT_TIMEOUT) {
@@ -138,7 +139,7 @@ std::wstring Socket::read(int timeout){
 	return returnString;
 }
 
-void Socket::write(const std::wstring &msg){
+void Socket::write(const std::string &msg){
 	
 	OVERLAPPED oOverlap;
 	DWORD bytesWritten = 0;
@@ -150,7 +151,7 @@ void Socket::write(const std::wstring &msg){
 	HANDLE writeEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
 	oOverlap.hEvent = writeEvent;
 	
-	BOOL writeSuccess = WriteFile(d->hPipe, msg.data(), (DWORD)msg.length()*sizeof(wchar_t), &bytesWritten, &oOverlap);
+	BOOL writeSuccess = WriteFile(d->hPipe, msg.data(), (DWORD)msg.length(), &bytesWritten, &oOverlap);
 	result = GetLastError();
 	if (writeSuccess || result == ERROR_IO_PENDING) {
 		result = WaitForSingleObject(writeEvent, 500);
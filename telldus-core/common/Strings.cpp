@@ -1,15 +1,16 @@
 #include "Strings.h"
 
-#include <algorithm>
-#include <sstream>
+#include <limits.h>
 #include <string>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #ifdef _WINDOWS
 #include <windows.h>
 #else
 #include <iconv.h>
+#include <pthread.h>
 #endif
 
 #ifdef _MACOSX
@@ -18,7 +19,151 @@
 #define WCHAR_T_ENCODING "WCHAR_T"
 #endif
 
+namespace {
+	//True if all characters are 7 bit, and can be converted by a plain copy
+	bool isAscii(const char *value, size_t *length) {
+		const char *p = value;
+		bool ascii = true;
+		for (; *p; ++p) {
+			if (static_cast<unsigned char>(*p) >= 0x80) {
+				ascii = false;
+			}
+		}
+		(*length) = p - value;
+		return ascii;
+	}
+
+	bool isAscii(const std::wstring &value) {
+		for (std::wstring::const_iterator it = value.begin(); it != value.end(); ++it) {
+			if (static_cast<uint32_t>(*it) >= 0x80) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//Only folds A-Z, like toupper() in the C locale
+	inline char foldCase(char c) {
+		return (c >= 'a' && c <= 'z' ? c - ('a' - 'A') : c);
+	}
+
+	//Writes value backwards, ending at end. Returns the first character.
+	template <typename T> T *formatInteger(int value, T *end) {
+		//Negate as unsigned, -INT_MIN does not fit in an int
+		unsigned int number = (value < 0 ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value));
+		T *p = end;
+		do {
+			*--p = static_cast<T>('0' + number % 10);
+			number /= 10;
+		} while (number);
+		if (value < 0) {
+			*--p = static_cast<T>('-');
+		}
+		return p;
+	}
+
+	//Parses a decimal integer the way operator>> does: leading white space
+	//and a sign are allowed and parsing stops at the first non digit.
+	//Returns 0 if there is no number, and saturates on overflow.
+	template <typename T> int parseInteger(const T *p) {
+		while (*p == ' ' || (*p >= '\t' && *p <= '\r')) {
+			++p;
+		}
+		bool negative = (*p == '-');
+		if (*p == '-' || *p == '+') {
+			++p;
+		}
+		int64_t number = 0;
+		for (; *p >= '0' && *p <= '9'; ++p) {
+			if (number <= static_cast<int64_t>(INT_MAX) + 1) {
+				number = number*10 + (*p - '0');
+			}
+		}
+		if (negative) {
+			number = -number;
+		}
+		if (number > INT_MAX) {
+			return INT_MAX;
+		}
+		if (number < INT_MIN) {
+			return INT_MIN;
+		}
+		return static_cast<int>(number);
+	}
+
+	//Enough for all numbers up to 64 bits, and a sign
+	const size_t INTEGER_BUFFER_SIZE = 21;
+
+#ifndef _WINDOWS
+#ifdef _FREEBSD
+	typedef const char *IconvInput;
+#else
+	typedef char *IconvInput;
+#endif
+
+	//Opening a conversion is slow, so each thread keeps its own open
+	class IconvCache {
+	public:
+		IconvCache() {
+			toWide = iconv_open(WCHAR_T_ENCODING, "UTF-8");
+			fromWide = iconv_open("UTF-8", WCHAR_T_ENCODING);
+		}
+		~IconvCache() {
+			if (toWide != reinterpret_cast<iconv_t>(-1)) {
+				iconv_close(toWide);
+			}
+			if (fromWide != reinterpret_cast<iconv_t>(-1)) {
+				iconv_close(fromWide);
+			}
+		}
+		iconv_t toWide, fromWide;
+	};
+
+	pthread_key_t iconvKey;
+	pthread_once_t iconvKeyOnce = PTHREAD_ONCE_INIT;
+
+	void deleteIconvCache(void *cache) {
+		delete reinterpret_cast<IconvCache *>(cache);
+	}
+
+	void createIconvKey() {
+		pthread_key_create(&iconvKey, deleteIconvCache);
+	}
+
+	IconvCache *iconvCache() {
+		pthread_once(&iconvKeyOnce, createIconvKey);
+		IconvCache *cache = reinterpret_cast<IconvCache *>(pthread_getspecific(iconvKey));
+		if (!cache) {
+			cache = new IconvCache;
+			pthread_setspecific(iconvKey, cache);
+		}
+		return cache;
+	}
+
+	//Converts with a cached descriptor, stopping at the first invalid
+	//sequence. Returns the number of bytes written.
+	size_t convert(iconv_t convDesc, const char *in, size_t inBytes, char *out, size_t outBytes) {
+		if (convDesc == reinterpret_cast<iconv_t>(-1)) {
+			return 0;
+		}
+		//Reset the shift state left by the previous call
+		iconv(convDesc, NULL, NULL, NULL, NULL);
+		//iconv() does not write to the input, despite the signature
+		IconvInput inPointer = const_cast<char *>(in);
+		char *outPointer = out;
+		size_t outLeft = outBytes;
+		iconv(convDesc, &inPointer, &inBytes, &outPointer, &outLeft);
+		return outBytes - outLeft;
+	}
+#endif
+}
+
 std::wstring TelldusCore::charToWstring(const char *value) {
+	size_t length;
+	if (isAscii(value, &length)) {
+		return std::wstring(value, value + length);
+	}
+
 #ifdef _WINDOWS
 	//Determine size
 	int size = MultiByteToWideChar(CP_UTF8, 0, value, -1, NULL, 0);
@@ -35,94 +180,48 @@ std::wstring TelldusCore::charToWstring(const char *value) {
 	return retval;
 
 #else
-	size_t utf8Length = strlen(value);
-	size_t outbytesLeft = utf8Length*sizeof(wchar_t);
-
-	//Copy the instring
-	char *inString = new char[utf8Length+1];
-	strcpy(inString, value);
-
-	//Create buffer for output
-	char *outString = (char*)new wchar_t[utf8Length+1];
-	memset(outString, 0, sizeof(wchar_t)*(utf8Length+1));
-
-#ifdef _FREEBSD
-	const char *inPointer = inString;
-#else
-	char *inPointer = inString;
-#endif
-	char *outPointer = outString;
-
-	iconv_t convDesc = iconv_open(WCHAR_T_ENCODING, "UTF-8");
-	iconv(convDesc, &inPointer, &utf8Length, &outPointer, &outbytesLeft);
-	iconv_close(convDesc);
-
-	std::wstring retval( (wchar_t *)outString );
-
-	//Cleanup
-	delete[] inString;
-	delete[] outString;
-
+	//Never more characters than bytes in
+	std::wstring retval(length, L'\0');
+	size_t bytes = convert(iconvCache()->toWide, value, length, reinterpret_cast<char *>(&retval[0]), length*sizeof(wchar_t));
+	retval.resize(bytes/sizeof(wchar_t));
 	return retval;
 #endif
 }
 
 int TelldusCore::charToInteger(const char *input){
-	std::stringstream inputstream;
-	inputstream << input;
-	int retval;
-	inputstream >> retval;
-	return retval;
+	return parseInteger(input);
 }
 
 std::wstring TelldusCore::charUnsignedToWstring(const unsigned char value) {
-	std::wstringstream st;
-	st << value;
-	return st.str();
+	//Formatted as a number, not as a character
+	return intToWstring(value);
 }
 
 /**
 * This method doesn't support all locales
 */
-bool TelldusCore::comparei(std::wstring stringA, std::wstring stringB) {
-	transform(stringA.begin(), stringA.end(), stringA.begin(), toupper);
-	transform(stringB.begin(), stringB.end(), stringB.begin(), toupper);
-
-	return stringA == stringB;
+bool TelldusCore::comparei(const std::string &stringA, const std::string &stringB) {
+	if (stringA.length() != stringB.length()) {
+		return false;
+	}
+	for (size_t i = 0; i < stringA.length(); ++i) {
+		if (foldCase(stringA[i]) != foldCase(stringB[i])) {
+			return false;
+		}
+	}
+	return true;
 }
 
 std::wstring TelldusCore::intToWstring(int value) {
-#ifdef _WINDOWS
-	//no stream used
-//TODO! Make effective and safe...
-	wchar_t numstr[21]; // enough to hold all numbers up to 64-bits
-	_itow_s(value, numstr, sizeof(numstr), 10);
-	std::wstring newstring(numstr);
-	return newstring;
-	//return TelldusCore::charToWstring(stdstring.c_str());
-	//std::wstring temp = TelldusCore::charToWstring(stdstring.c_str());
-	//std::wstring temp(stdstring.length(), L' ');
-	//std::copy(stdstring.begin(), stdstring.end(), temp.begin());
-	//return temp;
-#else
-	std::wstringstream st;
-	st << value;
-	return st.str();
-#endif
+	wchar_t buffer[INTEGER_BUFFER_SIZE];
+	wchar_t *end = buffer + INTEGER_BUFFER_SIZE;
+	return std::wstring(formatInteger(value, end), end);
 }
 
 std::string TelldusCore::intToString(int value) {
-//Not sure if this is neecssary (for ordinary stringstream that is)
-#ifdef _WINDOWS
-	char numstr[21]; // enough to hold all numbers up to 64-bits
-	_itoa_s(value, numstr, sizeof(numstr), 10);
-	std::string stdstring(numstr);
-	return stdstring;
-#else
-	std::stringstream st;
-	st << value;
-	return st.str();
-#endif
+	char buffer[INTEGER_BUFFER_SIZE];
+	char *end = buffer + INTEGER_BUFFER_SIZE;
+	return std::string(formatInteger(value, end), end);
 }
 
 /*
@@ -155,14 +254,18 @@ uint64_t TelldusCore::hexTo64l(const std::string data){
 }
 
 int TelldusCore::wideToInteger(const std::wstring &input){
-	std::wstringstream inputstream;
-	inputstream << input;
-	int retval;
-	inputstream >> retval;
-	return retval;
+	return parseInteger(input.c_str());
 }
 
 std::string TelldusCore::wideToString(const std::wstring &input) {
+	if (isAscii(input)) {
+		std::string retval(input.length(), '\0');
+		for (size_t i = 0; i < input.length(); ++i) {
+			retval[i] = static_cast<char>(input[i]);
+		}
+		return retval;
+	}
+
 #ifdef _WINDOWS
 	//Determine size
 	int size = WideCharToMultiByte(CP_UTF8, 0, input.c_str(), -1, NULL, 0, NULL, NULL);
@@ -179,34 +282,11 @@ std::string TelldusCore::wideToString(const std::wstring &input) {
 	return retval;
 
 #else
+	//A character is at most four bytes in UTF-8
 	size_t wideSize = sizeof(wchar_t)*input.length();
-	size_t outbytesLeft = wideSize+sizeof(char); //We cannot know how many wide character there is yet
-
-	//Copy the instring
-	char *inString = (char*)new wchar_t[input.length()+1];
-	memcpy(inString, input.c_str(), wideSize+sizeof(wchar_t));
-
-	//Create buffer for output
-	char *outString = new char[outbytesLeft];
-	memset(outString, 0, sizeof(char)*(outbytesLeft));
-
-#ifdef _FREEBSD
-	const char *inPointer = inString;
-#else
-	char *inPointer = inString;
-#endif
-	char *outPointer = outString;
-
-	iconv_t convDesc = iconv_open("UTF-8", WCHAR_T_ENCODING);
-	iconv(convDesc, &inPointer, &wideSize, &outPointer, &outbytesLeft);
-	iconv_close(convDesc);
-
-	std::string retval(outString);
-
-	//Cleanup
-	delete[] inString;
-	delete[] outString;
-
+	std::string retval(4*input.length(), '\0');
+	size_t bytes = convert(iconvCache()->fromWide, reinterpret_cast<const char *>(input.c_str()), wideSize, &retval[0], retval.length());
+	retval.resize(bytes);
 	return retval;
 #endif
 }
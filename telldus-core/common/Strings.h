@@ -8,6 +8,7 @@ typedef unsigned __int8 uint8_t;
 typedef unsigned __int16 uint16_t;
 typedef unsigned __int32 uint32_t;
 typedef unsigned __int64 uint64_t;
+typedef __int64 int64_t;
 #else
 #include <stdint.h>
 #endif
@@ -17,7 +18,7 @@ namespace TelldusCore {
 	int charToInteger(const char *value);
 	std::wstring charUnsignedToWstring(const unsigned char value);
 
-	bool comparei(std::wstring stringA, std::wstring stringB);
+	bool comparei(const std::string &stringA, const std::string &stringB);
 	std::wstring intToWstring(int value);
 	//std::wstring intToWStringSafe(int value);
 	std::string intToString(int value);
@@ -0,0 +1,75 @@
+#ifndef ATOMIC_H
+#define ATOMIC_H
+
+#ifdef _WINDOWS
+#include <windows.h>
+#endif
+
+/**
+ * The few atomic operations needed for the lock free parts of the service.
+ * All of them are full memory barriers.
+ */
+namespace Atomic {
+#ifdef _WINDOWS
+	//Returns the value before the swap
+	inline long compareAndSwap(volatile long *value, long expected, long desired) {
+		return InterlockedCompareExchange(value, desired, expected);
+	}
+
+	inline void *compareAndSwapPointer(void * volatile *value, void *expected, void *desired) {
+		return InterlockedCompareExchangePointer(value, desired, expected);
+	}
+
+	//Returns the new value
+	inline long add(volatile long *value, long delta) {
+		return InterlockedExchangeAdd(value, delta) + delta;
+	}
+
+	//Returns the old value
+	inline long exchange(volatile long *value, long newValue) {
+		return InterlockedExchange(value, newValue);
+	}
+
+	inline void memoryBarrier() {
+		MemoryBarrier();
+	}
+#else
+	inline long compareAndSwap(volatile long *value, long expected, long desired) {
+		return __sync_val_compare_and_swap(value, expected, desired);
+	}
+
+	inline void *compareAndSwapPointer(void * volatile *value, void *expected, void *desired) {
+		return __sync_val_compare_and_swap(value, expected, desired);
+	}
+
+	inline long add(volatile long *value, long delta) {
+		return __sync_add_and_fetch(value, delta);
+	}
+
+	inline long exchange(volatile long *value, long newValue) {
+		long oldValue = *value;
+		while (true) {
+			long previous = __sync_val_compare_and_swap(value, oldValue, newValue);
+			if (previous == oldValue) {
+				return oldValue;
+			}
+			oldValue = previous;
+		}
+	}
+
+	inline void memoryBarrier() {
+		__sync_synchronize();
+	}
+#endif
+
+	//Counters are allowed to wrap around, compare them with this
+	inline long difference(long a, long b) {
+		return (long)((unsigned long)a - (unsigned long)b);
+	}
+
+	inline long increment(long value, long delta) {
+		return (long)((unsigned long)value + (unsigned long)delta);
+	}
+}
+
+#endif // ATOMIC_H
@@ -11,13 +11,14 @@ public:
 	bool done;
 	DeviceManager *deviceManager;
 	ControllerManager *controllerManager;
+	Scheduler *scheduler;
 };
 
 ClientCommunicationHandler::ClientCommunicationHandler(){
 
 }
 
-ClientCommunicationHandler::ClientCommunicationHandler(TelldusCore::Socket *clientSocket, TelldusCore::EventRef event, DeviceManager *deviceManager, TelldusCore::EventRef deviceUpdateEvent, ControllerManager *controllerManager)
+ClientCommunicationHandler::ClientCommunicationHandler(TelldusCore::Socket *clientSocket, TelldusCore::EventRef event, DeviceManager *deviceManager, TelldusCore::EventRef deviceUpdateEvent, ControllerManager *controllerManager, Scheduler *scheduler)
 	:Thread()
 {
 	d = new PrivateData;
@@ -27,6 +28,7 @@ ClientCommunicationHandler::ClientCommunicationHandler(TelldusCore::Socket *clie
 	d->deviceManager = deviceManager;
 	d->deviceUpdateEvent = deviceUpdateEvent;
 	d->controllerManager = controllerManager;
+	d->scheduler = scheduler;
 }
 
 ClientCommunicationHandler::~ClientCommunicationHandler(void)
@@ -39,22 +41,22 @@ ClientCommunicationHandler::~ClientCommunicationHandler(void)
 void ClientCommunicationHandler::run(){
 	//run thread
 
-	std::wstring clientMessage = d->clientSocket->read(2000);
+	std::string clientMessage = d->clientSocket->read(2000);
 
 	int intReturn;
-	std::wstring strReturn;
-	strReturn = L"";
+	std::string strReturn;
+	strReturn = "";
 	parseMessage(clientMessage, &intReturn, &strReturn);
 
 	TelldusCore::Message msg;
 
-	if(strReturn == L""){
+	if(strReturn == ""){
 		msg.addArgument(intReturn);
 	}
 	else{
 		msg.addArgument(strReturn);
 	}
-	msg.append(L"\n");
+	msg.append("\n");
 	d->clientSocket->write(msg);
 
 	//We are done, signal for removal
@@ -67,88 +69,88 @@ bool ClientCommunicationHandler::isDone(){
 }
 
 
-void ClientCommunicationHandler::parseMessage(const std::wstring &clientMessage, int *intReturn, std::wstring *wstringReturn){
+void ClientCommunicationHandler::parseMessage(const std::string &clientMessage, int *intReturn, std::string *stringReturn){
 
 	(*intReturn) = 0;
-	(*wstringReturn) = L"";
-	std::wstring msg(clientMessage);	//Copy
-	std::wstring function(TelldusCore::Message::takeString(&msg));
+	(*stringReturn) = "";
+	std::string msg(clientMessage);	//Copy
+	std::string function(TelldusCore::Message::takeString(&msg));
 
-	if (function == L"tdTurnOn") {
+	if (function == "tdTurnOn") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->deviceManager->doAction(deviceId, TELLSTICK_TURNON, 0);
 
-	} else if (function == L"tdTurnOff") {
+	} else if (function == "tdTurnOff") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->deviceManager->doAction(deviceId, TELLSTICK_TURNOFF, 0);
 
-	} else if (function == L"tdBell") {
+	} else if (function == "tdBell") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->deviceManager->doAction(deviceId, TELLSTICK_BELL, 0);
 
-	} else if (function == L"tdDim") {
+	} else if (function == "tdDim") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
 		int level = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->deviceManager->doAction(deviceId, TELLSTICK_DIM, level);
 
-	} else if (function == L"tdExecute") {
+	} else if (function == "tdExecute") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->deviceManager->doAction(deviceId, TELLSTICK_EXECUTE, 0);
 
-	} else if (function == L"tdUp") {
+	} else if (function == "tdUp") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->deviceManager->doAction(deviceId, TELLSTICK_UP, 0);
 
-	} else if (function == L"tdDown") {
+	} else if (function == "tdDown") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->deviceManager->doAction(deviceId, TELLSTICK_DOWN, 0);
 
-	} else if (function == L"tdStop") {
+	} else if (function == "tdStop") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->deviceManager->doAction(deviceId, TELLSTICK_STOP, 0);
 
-	}  else if (function == L"tdLearn") {
+	}  else if (function == "tdLearn") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->deviceManager->doAction(deviceId, TELLSTICK_LEARN, 0);
 
-	} else if (function == L"tdLastSentCommand") {
+	} else if (function == "tdLastSentCommand") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
 		int methodsSupported = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->deviceManager->getDeviceLastSentCommand(deviceId, methodsSupported);
 
-	} else if (function == L"tdLastSentValue") {
+	} else if (function == "tdLastSentValue") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
-		(*wstringReturn) = d->deviceManager->getDeviceStateValue(deviceId);
+		(*stringReturn) = d->deviceManager->getDeviceStateValue(deviceId);
 
-	} else if(function == L"tdGetNumberOfDevices"){
+	} else if(function == "tdGetNumberOfDevices"){
 
 		(*intReturn) = d->deviceManager->getNumberOfDevices();
 
-	} else if (function == L"tdGetDeviceId") {
+	} else if (function == "tdGetDeviceId") {
 		int deviceIndex = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->deviceManager->getDeviceId(deviceIndex);
 
-	} else if (function == L"tdGetDeviceType") {
+	} else if (function == "tdGetDeviceType") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->deviceManager->getDeviceType(deviceId);
 
-	} else if (function == L"tdGetName") {
+	} else if (function == "tdGetName") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
-		(*wstringReturn) = d->deviceManager->getDeviceName(deviceId);
+		(*stringReturn) = d->deviceManager->getDeviceName(deviceId);
 
-	} else if (function == L"tdSetName") {
+	} else if (function == "tdSetName") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
-		std::wstring name = TelldusCore::Message::takeString(&msg);
+		std::string name = TelldusCore::Message::takeString(&msg);
 		(*intReturn) = d->deviceManager->setDeviceName(deviceId, name);
 		sendDeviceSignal(deviceId, TELLSTICK_DEVICE_CHANGED, TELLSTICK_CHANGE_NAME);
 
-	} else if (function == L"tdGetProtocol") {
+	} else if (function == "tdGetProtocol") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
-		(*wstringReturn) = d->deviceManager->getDeviceProtocol(deviceId);
+		(*stringReturn) = d->deviceManager->getDeviceProtocol(deviceId);
 
-	} else if (function == L"tdSetProtocol") {
+	} else if (function == "tdSetProtocol") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
-		std::wstring protocol = TelldusCore::Message::takeString(&msg);
+		std::string protocol = TelldusCore::Message::takeString(&msg);
 		int oldMethods = d->deviceManager->getDeviceMethods(deviceId);
 		(*intReturn) = d->deviceManager->setDeviceProtocol(deviceId, protocol);
 		sendDeviceSignal(deviceId, TELLSTICK_DEVICE_CHANGED, TELLSTICK_CHANGE_PROTOCOL);
@@ -156,13 +158,13 @@ void ClientCommunicationHandler::parseMessage(const std::wstring &clientMessage,
 			sendDeviceSignal(deviceId, TELLSTICK_DEVICE_CHANGED, TELLSTICK_CHANGE_METHOD);
 		}
 
-	} else if (function == L"tdGetModel") {
+	} else if (function == "tdGetModel") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
-		(*wstringReturn) = d->deviceManager->getDeviceModel(deviceId);
+		(*stringReturn) = d->deviceManager->getDeviceModel(deviceId);
 
-	} else if (function == L"tdSetModel") {
+	} else if (function == "tdSetModel") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
-		std::wstring model = TelldusCore::Message::takeString(&msg);
+		std::string model = TelldusCore::Message::takeString(&msg);
 		int oldMethods = d->deviceManager->getDeviceMethods(deviceId);
 		(*intReturn) = d->deviceManager->setDeviceModel(deviceId, model);
 		sendDeviceSignal(deviceId, TELLSTICK_DEVICE_CHANGED, TELLSTICK_CHANGE_MODEL);
@@ -170,85 +172,127 @@ void ClientCommunicationHandler::parseMessage(const std::wstring &clientMessage,
 			sendDeviceSignal(deviceId, TELLSTICK_DEVICE_CHANGED, TELLSTICK_CHANGE_METHOD);
 		}
 
-	} else if (function == L"tdGetDeviceParameter") {
+	} else if (function == "tdGetDeviceParameter") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
-		std::wstring name = TelldusCore::Message::takeString(&msg);
-		std::wstring defaultValue = TelldusCore::Message::takeString(&msg);
-		(*wstringReturn) = d->deviceManager->getDeviceParameter(deviceId, name, defaultValue);
+		std::string name = TelldusCore::Message::takeString(&msg);
+		std::string defaultValue = TelldusCore::Message::takeString(&msg);
+		(*stringReturn) = d->deviceManager->getDeviceParameter(deviceId, name, defaultValue);
 
-	} else if (function == L"tdSetDeviceParameter") {
+	} else if (function == "tdSetDeviceParameter") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
-		std::wstring name = TelldusCore::Message::takeString(&msg);
-		std::wstring value = TelldusCore::Message::takeString(&msg);
+		std::string name = TelldusCore::Message::takeString(&msg);
+		std::string value = TelldusCore::Message::takeString(&msg);
 		int oldMethods = d->deviceManager->getDeviceMethods(deviceId);
 		(*intReturn) = d->deviceManager->setDeviceParameter(deviceId, name, value);
 		if(oldMethods != d->deviceManager->getDeviceMethods(deviceId)){
 			sendDeviceSignal(deviceId, TELLSTICK_DEVICE_CHANGED, TELLSTICK_CHANGE_METHOD);
 		}
 
-	} else if (function == L"tdAddDevice") {
+	} else if (function == "tdAddDevice") {
 		(*intReturn) = d->deviceManager->addDevice();
 		if((*intReturn) >= 0){
 			sendDeviceSignal((*intReturn), TELLSTICK_DEVICE_ADDED, 0);
 		}
 
-	} else if (function == L"tdRemoveDevice") {
+	} else if (function == "tdRemoveDevice") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->deviceManager->removeDevice(deviceId);
 		if((*intReturn) == TELLSTICK_SUCCESS){
 			sendDeviceSignal(deviceId, TELLSTICK_DEVICE_REMOVED, 0);
 		}
 
-	} else if (function == L"tdMethods") {
+	} else if (function == "tdMethods") {
 		int deviceId = TelldusCore::Message::takeInt(&msg);
 		int intMethodsSupported = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->deviceManager->getDeviceMethods(deviceId, intMethodsSupported);
 
-	} else if (function == L"tdSendRawCommand") {
-		std::wstring command = TelldusCore::Message::takeString(&msg);
+	} else if (function == "tdSendRawCommand") {
+		std::string command = TelldusCore::Message::takeString(&msg);
 		int reserved = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->deviceManager->sendRawCommand(command, reserved);
 
-	} else if (function == L"tdConnectTellStickController") {
+	} else if (function == "tdConnectTellStickController") {
 		int vid = TelldusCore::Message::takeInt(&msg);
 		int pid = TelldusCore::Message::takeInt(&msg);
-		std::string serial = TelldusCore::wideToString(TelldusCore::Message::takeString(&msg));
+		std::string serial = TelldusCore::Message::takeString(&msg);
 		d->deviceManager->connectTellStickController(vid, pid, serial);
 
-	} else if (function == L"tdDisconnectTellStickController") {
+	} else if (function == "tdDisconnectTellStickController") {
 		int vid = TelldusCore::Message::takeInt(&msg);
 		int pid = TelldusCore::Message::takeInt(&msg);
-		std::string serial = TelldusCore::wideToString(TelldusCore::Message::takeString(&msg));
+		std::string serial = TelldusCore::Message::takeString(&msg);
 		d->deviceManager->disconnectTellStickController(vid, pid, serial);
 
-	} else if (function == L"tdSensor") {
-		(*wstringReturn) = d->deviceManager->getSensors();
+	} else if (function == "tdSensor") {
+		(*stringReturn) = d->deviceManager->getSensors();
 
-	} else if (function == L"tdSensorValue") {
-		std::wstring protocol = TelldusCore::Message::takeString(&msg);
-		std::wstring model = TelldusCore::Message::takeString(&msg);
+	} else if (function == "tdSensorSnapshot") {
+		(*stringReturn) = d->deviceManager->getSensorSnapshot();
+
+	} else if (function == "tdSensorValue") {
+		std::string protocol = TelldusCore::Message::takeString(&msg);
+		std::string model = TelldusCore::Message::takeString(&msg);
+		int id = TelldusCore::Message::takeInt(&msg);
+		int dataType = TelldusCore::Message::takeInt(&msg);
+		(*stringReturn) = d->deviceManager->getSensorValue(protocol, model, id, dataType);
+
+	} else if (function == "tdSensorHistory") {
+		std::string protocol = TelldusCore::Message::takeString(&msg);
+		std::string model = TelldusCore::Message::takeString(&msg);
 		int id = TelldusCore::Message::takeInt(&msg);
 		int dataType = TelldusCore::Message::takeInt(&msg);
-		(*wstringReturn) = d->deviceManager->getSensorValue(protocol, model, id, dataType);
+		int from = TelldusCore::Message::takeInt(&msg);
+		int to = TelldusCore::Message::takeInt(&msg);
+		(*stringReturn) = d->deviceManager->getSensorHistory(protocol, model, id, dataType, from, to);
 
-	} else if (function == L"tdController") {
-		(*wstringReturn) = d->controllerManager->getControllers();
+	} else if (function == "tdSensorRollup") {
+		std::string protocol = TelldusCore::Message::takeString(&msg);
+		std::string model = TelldusCore::Message::takeString(&msg);
+		int id = TelldusCore::Message::takeInt(&msg);
+		int dataType = TelldusCore::Message::takeInt(&msg);
+		int resolution = TelldusCore::Message::takeInt(&msg);
+		int from = TelldusCore::Message::takeInt(&msg);
+		int to = TelldusCore::Message::takeInt(&msg);
+		//TELLSTICK_ROLLUP_MINUTE is the first resolution
+		(*stringReturn) = d->deviceManager->getSensorRollup(protocol, model, id, dataType, resolution - TELLSTICK_ROLLUP_MINUTE, from, to);
 
-	} else if (function == L"tdControllerValue") {
+	} else if (function == "tdController") {
+		(*stringReturn) = d->controllerManager->getControllers();
+
+	} else if (function == "tdControllerValue") {
 		int id = TelldusCore::Message::takeInt(&msg);
-		std::wstring name = TelldusCore::Message::takeString(&msg);
-		(*wstringReturn) = d->controllerManager->getControllerValue(id, name);
+		std::string name = TelldusCore::Message::takeString(&msg);
+		(*stringReturn) = d->controllerManager->getControllerValue(id, name);
 
-	} else if (function == L"tdSetControllerValue") {
+	} else if (function == "tdSetControllerValue") {
 		int id = TelldusCore::Message::takeInt(&msg);
-		std::wstring name = TelldusCore::Message::takeString(&msg);
-		std::wstring value = TelldusCore::Message::takeString(&msg);
+		std::string name = TelldusCore::Message::takeString(&msg);
+		std::string value = TelldusCore::Message::takeString(&msg);
 		(*intReturn) = d->controllerManager->setControllerValue(id, name, value);
 
-	} else if (function == L"tdRemoveController") {
+	} else if (function == "tdRemoveController") {
 		int controllerId = TelldusCore::Message::takeInt(&msg);
 		(*intReturn) = d->controllerManager->removeController(controllerId);
 
+	} else if (function == "tdAddScheduledJob") {
+		SchedulerJob job;
+		job.deviceId = TelldusCore::Message::takeInt(&msg);
+		job.method = TelldusCore::Message::takeInt(&msg);
+		job.methodValue = TelldusCore::Message::takeInt(&msg);
+		job.type = TelldusCore::Message::takeInt(&msg);
+		job.hour = TelldusCore::Message::takeInt(&msg);
+		job.minute = TelldusCore::Message::takeInt(&msg);
+		job.offset = TelldusCore::Message::takeInt(&msg);
+		job.weekdays = TelldusCore::Message::takeInt(&msg);
+		(*intReturn) = d->scheduler->addJob(job);
+
+	} else if (function == "tdRemoveScheduledJob") {
+		int jobId = TelldusCore::Message::takeInt(&msg);
+		(*intReturn) = d->scheduler->removeJob(jobId);
+
+	} else if (function == "tdScheduledJobs") {
+		(*stringReturn) = d->scheduler->getJobs();
+
 	} else{
 		(*intReturn) = TELLSTICK_ERROR_UNKNOWN;
 	}
@@ -257,7 +301,7 @@ void ClientCommunicationHandler::parseMessage(const std::wstring &clientMessage,
 void ClientCommunicationHandler::sendDeviceSignal(int deviceId, int eventDeviceChanges, int eventChangeType){
 
 	EventUpdateData *eventData = new EventUpdateData();
-	eventData->messageType = L"TDDeviceChangeEvent";
+	eventData->messageType = "TDDeviceChangeEvent";
 	eventData->deviceId = deviceId;
 	eventData->eventDeviceChanges = eventDeviceChanges;
 	eventData->eventChangeType = eventChangeType;
@@ -7,6 +7,7 @@
 #include "Event.h"
 #include "DeviceManager.h"
 #include "ControllerManager.h"
+#include "Scheduler.h"
 
 class ClientCommunicationHandler : public TelldusCore::Thread
 {
@@ -17,7 +18,8 @@ public:
 		TelldusCore::EventRef event,
 		DeviceManager *deviceManager,
 		TelldusCore::EventRef deviceUpdateEvent,
-		ControllerManager *controllerManager
+		ControllerManager *controllerManager,
+		Scheduler *scheduler
 	);
 	~ClientCommunicationHandler(void);
 
@@ -29,7 +31,7 @@ protected:
 private:
 	class PrivateData;
 	PrivateData *d;
-	void parseMessage(const std::wstring &clientMessage, int *intReturn, std::wstring *wstringReturn);
+	void parseMessage(const std::string &clientMessage, int *intReturn, std::string *stringReturn);
 	void sendDeviceSignal(int deviceId, int eventDeviceChanges, int eventChangeType);
 };
 
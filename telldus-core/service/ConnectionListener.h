@@ -17,7 +17,7 @@ public:
 
 class ConnectionListener : public TelldusCore::Thread {
 public:
-	ConnectionListener(const std::wstring &name, TelldusCore::EventRef waitEvent);
+	ConnectionListener(const std::string &name, TelldusCore::EventRef waitEvent);
 	virtual ~ConnectionListener(void);
 
 protected:
@@ -19,12 +19,12 @@ public:
 	bool running;
 };
 
-ConnectionListener::ConnectionListener(const std::wstring &name, TelldusCore::EventRef waitEvent)
+ConnectionListener::ConnectionListener(const std::string &name, TelldusCore::EventRef waitEvent)
 {
 	d = new PrivateData;
 	d->waitEvent = waitEvent;
 
-	d->name = "/tmp/" + std::string(name.begin(), name.end());
+	d->name = "/tmp/" + name;
 	d->running = true;
 
 	this->start();
@@ -1,6 +1,7 @@
 #include "ConnectionListener.h"
 #include "Event.h"
 #include "Socket.h"
+#include "Strings.h"
 
 #include <windows.h>
 #include <AccCtrl.h>
@@ -17,14 +18,14 @@ public:
 	TelldusCore::EventRef waitEvent;
 };
 
-ConnectionListener::ConnectionListener(const std::wstring &name, TelldusCore::EventRef waitEvent)
+ConnectionListener::ConnectionListener(const std::string &name, TelldusCore::EventRef waitEvent)
 {
 	d = new PrivateData;
 	d->hEvent = 0;
 
 	d->running = true;
 	d->waitEvent = waitEvent;
-	d->pipename = L"\\\\.\\pipe\\" + name;
+	d->pipename = L"\\\\.\\pipe\\" + TelldusCore::charToWstring(name.c_str());
 
 	PSECURITY_DESCRIPTOR pSD = NULL;
 	PACL pACL = NULL;
@@ -2,39 +2,214 @@
 #include "Protocol.h"
 #include "EventUpdateManager.h"
 #include "Strings.h"
+#include "Mutex.h"
+#include "common.h"
+#include "../client/telldus-core.h"
+#ifdef _WINDOWS
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+namespace {
+	//Milliseconds from an arbitrary starting point
+	unsigned long currentTime() {
+#ifdef _WINDOWS
+		return GetTickCount();
+#else
+		struct timeval tv;
+		gettimeofday(&tv, NULL);
+		return tv.tv_sec*1000 + tv.tv_usec/1000;
+#endif
+	}
+}
 
 class Controller::PrivateData {
 public:
 	TelldusCore::EventRef event, updateEvent;
 	int id, firmwareVersion;
+	int queueDepth, ackLatency, errorRate;
+	int dutyCycle, receiveGap, airtime;
+	unsigned long nextSendTime;
+	TelldusCore::Mutex mutex;
+
+	int transmitGap(int packetAirtime) const;
 };
 
+int Controller::PrivateData::transmitGap(int packetAirtime) const {
+	//Silence needed after a packet to stay within the duty cycle
+	return packetAirtime*(100-dutyCycle)/dutyCycle + receiveGap;
+}
+
 Controller::Controller(int id, TelldusCore::EventRef event, TelldusCore::EventRef updateEvent){
 	d = new PrivateData;
 	d->event = event;
 	d->updateEvent = updateEvent;
 	d->id = id;
 	d->firmwareVersion = 0;
+	d->queueDepth = 0;
+	d->ackLatency = 0;
+	d->errorRate = 0;
+	d->dutyCycle = 100;
+	d->receiveGap = 0;
+	d->airtime = 0;
+	d->nextSendTime = currentTime();
 }
 
 Controller::~Controller(){
 	delete d;
 }
 
+Controller::PendingSend::PendingSend()
+	:result(TELLSTICK_SUCCESS), ticket(0), airtime(0), start(0)
+{
+}
+
+int Controller::send( const std::string &message ) {
+	PendingSend pending;
+	startSend(message, &pending);
+	return finishSend(&pending);
+}
+
+void Controller::startSend( const std::string &message, PendingSend *pending ) {
+	pending->airtime = this->estimateAirtime(message);
+	//Start writing early enough for the packet to be in the controller when its slot begins
+	int transferTime = this->estimateTransferTime(message);
+	int wait = 0;
+	{
+		TelldusCore::MutexLocker locker(&d->mutex);
+		++d->queueDepth;
+		if (pending->airtime > 0) {
+			//Reserve the next free slot on air
+			unsigned long now = currentTime();
+			if ((long)(d->nextSendTime - now) > 0) {
+				wait = (int)(d->nextSendTime - now);
+			}
+			d->nextSendTime = now + wait + pending->airtime + d->transmitGap(pending->airtime);
+			d->airtime += pending->airtime;
+		}
+	}
+	if (wait > transferTime) {
+		msleep(wait - transferTime);
+	}
+	pending->start = currentTime();
+	pending->ticket = 0;
+	pending->result = this->doStartSend(message, &pending->ticket);
+}
+
+int Controller::finishSend( PendingSend *pending ) {
+	int retval = pending->result;
+	if (pending->ticket != 0) {
+		int ackResult = this->doFinishSend(pending->ticket);
+		if (retval == TELLSTICK_SUCCESS) {
+			retval = ackResult;
+		}
+	}
+	pending->ticket = 0;
+	pending->result = retval;
+	unsigned long end = currentTime();
+	int elapsed = (int)(end - pending->start);
+
+	TelldusCore::MutexLocker locker(&d->mutex);
+	--d->queueDepth;
+	if (pending->airtime > 0 && (long)(end + d->transmitGap(pending->airtime) - d->nextSendTime) > 0) {
+		//The ack came later than estimated, keep the gap after it
+		d->nextSendTime = end + d->transmitGap(pending->airtime);
+	}
+	//Moving averages, weighted towards the most recent sends
+	if (retval == TELLSTICK_SUCCESS) {
+		d->ackLatency = (d->ackLatency*3 + elapsed)/4;
+		d->errorRate = (d->errorRate*3)/4;
+	} else {
+		d->errorRate = (d->errorRate*3 + 100)/4;
+	}
+	return retval;
+}
+
+int Controller::queueDepth() const {
+	TelldusCore::MutexLocker locker(&d->mutex);
+	return d->queueDepth;
+}
+
+int Controller::ackLatency() const {
+	TelldusCore::MutexLocker locker(&d->mutex);
+	return d->ackLatency;
+}
+
+int Controller::errorRate() const {
+	TelldusCore::MutexLocker locker(&d->mutex);
+	return d->errorRate;
+}
+
+int Controller::airtime() const {
+	TelldusCore::MutexLocker locker(&d->mutex);
+	return d->airtime;
+}
+
+int Controller::doFinishSend( int /*ticket*/ ) {
+	//Only reached by controllers handing out tickets, which override this
+	return TELLSTICK_ERROR_UNKNOWN;
+}
+
+int Controller::estimateAirtime( const std::string &/*message*/ ) const {
+	return 0;
+}
+
+int Controller::estimateTransferTime( const std::string &/*message*/ ) const {
+	return 0;
+}
+
+void Controller::setTransmitPacing(int dutyCycle, int receiveGap) {
+	TelldusCore::MutexLocker locker(&d->mutex);
+	if (dutyCycle < 1 || dutyCycle > 100) {
+		dutyCycle = 100;
+	}
+	if (receiveGap < 0) {
+		receiveGap = 0;
+	}
+	d->dutyCycle = dutyCycle;
+	d->receiveGap = receiveGap;
+}
+
 void Controller::publishData(const std::string &msg) const {
 	ControllerEventData *data = new ControllerEventData;
-	data->msg = msg;
+	//Parsed here, once, and passed on as it is
+	data->msg = ControllerMessage(msg);
+	SensorRecord::fromMessage(data->msg, &data->sensor);
 	data->controllerId = d->id;
 	d->event->signal(data);
 }
 
 void Controller::decodePublishData(const std::string &data) const {
+	ControllerMessage dataMsg(data);
+
+	SensorRecord record;
+	if (Protocol::decodeSensorData(dataMsg, &record)) {
+		this->publishSensorData(record);
+		return;
+	}
 
-	std::list<std::string> msgList = Protocol::decodeData(data);
+	std::list<std::string> msgList = Protocol::decodeData(dataMsg);
+	if (msgList.empty()) {
+		return;
+	}
 
-	for (std::list<std::string>::iterator msgIt = msgList.begin(); msgIt != msgList.end(); ++msgIt){
-		this->publishData(*msgIt);
+	//All readings of the frame go out together, to be matched against the devices at once
+	ControllerEventData *eventData = new ControllerEventData;
+	eventData->msg = ControllerMessage(msgList.front());
+	for (std::list<std::string>::iterator msgIt = ++msgList.begin(); msgIt != msgList.end(); ++msgIt){
+		eventData->alternatives.push_back(ControllerMessage(*msgIt));
 	}
+	eventData->controllerId = d->id;
+	d->event->signal(eventData);
+}
+
+void Controller::publishSensorData(const SensorRecord &record) const {
+	//No text is produced until the reading reaches a client
+	ControllerEventData *data = new ControllerEventData;
+	data->sensor = record;
+	data->controllerId = d->id;
+	d->event->signal(data);
 }
 
 int Controller::firmwareVersion() const {
@@ -44,10 +219,10 @@ int Controller::firmwareVersion() const {
 void Controller::setFirmwareVersion(int version) {
 	d->firmwareVersion = version;
 	EventUpdateData *eventData = new EventUpdateData();
-	eventData->messageType = L"TDControllerEvent";
+	eventData->messageType = "TDControllerEvent";
 	eventData->controllerId = d->id;
 	eventData->eventState = TELLSTICK_DEVICE_CHANGED;
 	eventData->eventChangeType = TELLSTICK_CHANGE_FIRMWARE;
-	eventData->eventValue = TelldusCore::intToWstring(version);
+	eventData->eventValue = TelldusCore::intToString(version);
 	d->updateEvent->signal(eventData);
 }
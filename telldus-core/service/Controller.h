@@ -2,26 +2,57 @@
 #define CONTROLLER_H
 
 #include "Event.h"
+#include "ControllerMessage.h"
+#include "SensorRecord.h"
+#include <list>
 #include <string>
 
 class ControllerEventData : public TelldusCore::EventDataBase {
 public:
-	std::string msg;
+	ControllerMessage msg;
+	SensorRecord sensor; //Valid if this is a sensor reading
+	std::list<ControllerMessage> alternatives; //Other readings of the same frame, when the protocol is ambiguous
 	int controllerId;
 };
 
 class Controller {
 public:
+	/**
+	 * A command started with startSend(), to be finished with finishSend().
+	 */
+	class PendingSend {
+	public:
+		PendingSend();
+		int result, ticket, airtime;
+		unsigned long start;
+	};
+
 	virtual ~Controller();
 
 	virtual int firmwareVersion() const;
-	virtual int send( const std::string &message ) = 0;
+	int send( const std::string &message );
+	//Writes a command without waiting for its ack, so the next ones can follow it into the
+	//controller. Every started command must be finished, in the order they were started.
+	void startSend( const std::string &message, PendingSend *pending );
+	int finishSend( PendingSend *pending );
 	virtual int reset() = 0;
 
+	int queueDepth() const;
+	int ackLatency() const;
+	int errorRate() const;
+	int airtime() const;
+
 protected:
 	Controller(int id, TelldusCore::EventRef event, TelldusCore::EventRef updateEvent);
+	//Sets ticket to something else than 0 if the result must be waited for with doFinishSend()
+	virtual int doStartSend( const std::string &message, int *ticket ) = 0;
+	virtual int doFinishSend( int ticket );
+	virtual int estimateAirtime( const std::string &message ) const;
+	virtual int estimateTransferTime( const std::string &message ) const;
+	void setTransmitPacing(int dutyCycle, int receiveGap);
 	void publishData(const std::string &data) const;
 	void decodePublishData(const std::string &data) const;
+	void publishSensorData(const SensorRecord &record) const;
 	void setFirmwareVersion(int version);
 
 private:
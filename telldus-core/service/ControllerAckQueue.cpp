@@ -0,0 +1,253 @@
+#include "ControllerAckQueue.h"
+#include "../client/telldus-core.h"
+#include <list>
+#ifdef _WINDOWS
+#include <windows.h>
+#include "Mutex.h"
+#else
+#include <pthread.h>
+#include <sys/time.h>
+#include <errno.h>
+#endif
+
+namespace {
+	const int ACK_PENDING = 1;
+
+	class Pending {
+	public:
+		int ticket;
+		size_t length;
+		int result;
+#ifdef _WINDOWS
+		HANDLE event;
+#endif
+	};
+}
+
+class ControllerAckQueue::PrivateData {
+public:
+	//In the order the controller will ack them
+	std::list<Pending> pending;
+	size_t bytesInFlight;
+	int lastTicket;
+#ifdef _WINDOWS
+	TelldusCore::Mutex mutex;
+	HANDLE roomEvent;
+#else
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+#endif
+
+	void lock();
+	void unlock();
+	std::list<Pending>::iterator find(int ticket);
+	void resolve(Pending *pending, int result);
+#ifndef _WINDOWS
+	static struct timespec deadline(int timeout);
+#endif
+};
+
+void ControllerAckQueue::PrivateData::lock() {
+#ifdef _WINDOWS
+	mutex.lock();
+#else
+	pthread_mutex_lock(&mutex);
+#endif
+}
+
+void ControllerAckQueue::PrivateData::unlock() {
+#ifdef _WINDOWS
+	mutex.unlock();
+#else
+	pthread_mutex_unlock(&mutex);
+#endif
+}
+
+std::list<Pending>::iterator ControllerAckQueue::PrivateData::find(int ticket) {
+	//Private, the lock must be held
+	std::list<Pending>::iterator it = pending.begin();
+	for(; it != pending.end(); ++it) {
+		if (it->ticket == ticket) {
+			break;
+		}
+	}
+	return it;
+}
+
+void ControllerAckQueue::PrivateData::resolve(Pending *p, int result) {
+	//Private, the lock must be held
+	p->result = result;
+	bytesInFlight -= p->length;
+#ifdef _WINDOWS
+	SetEvent(p->event);
+	SetEvent(roomEvent);
+#else
+	pthread_cond_broadcast(&cond);
+#endif
+}
+
+#ifndef _WINDOWS
+struct timespec ControllerAckQueue::PrivateData::deadline(int timeout) {
+	struct timeval tp;
+	gettimeofday(&tp, NULL);
+	long usec = tp.tv_usec + (timeout%1000)*1000L;
+	struct timespec ts;
+	ts.tv_sec = tp.tv_sec + timeout/1000 + usec/1000000;
+	ts.tv_nsec = (usec%1000000)*1000;
+	return ts;
+}
+#endif
+
+ControllerAckQueue::ControllerAckQueue() {
+	d = new PrivateData;
+	d->bytesInFlight = 0;
+	d->lastTicket = 0;
+#ifdef _WINDOWS
+	d->roomEvent = CreateEvent( NULL, false, false, NULL );
+#else
+	pthread_mutex_init(&d->mutex, NULL);
+	pthread_cond_init(&d->cond, NULL);
+#endif
+}
+
+ControllerAckQueue::~ControllerAckQueue() {
+#ifdef _WINDOWS
+	for(std::list<Pending>::iterator it = d->pending.begin(); it != d->pending.end(); ++it) {
+		CloseHandle(it->event);
+	}
+	CloseHandle(d->roomEvent);
+#else
+	pthread_cond_destroy(&d->cond);
+	pthread_mutex_destroy(&d->mutex);
+#endif
+	delete d;
+}
+
+bool ControllerAckQueue::waitForRoom(size_t length, size_t limit, int timeout) {
+#ifdef _WINDOWS
+	DWORD deadline = GetTickCount() + timeout;
+#else
+	struct timespec ts = PrivateData::deadline(timeout);
+#endif
+	bool retval = true;
+	d->lock();
+	while(d->bytesInFlight > 0 && (limit == 0 || d->bytesInFlight + length > limit)) {
+#ifdef _WINDOWS
+		d->unlock();
+		long remaining = (long)(deadline - GetTickCount());
+		bool signaled = (remaining > 0 && WaitForSingleObject(d->roomEvent, remaining) == WAIT_OBJECT_0);
+		d->lock();
+#else
+		bool signaled = (pthread_cond_timedwait(&d->cond, &d->mutex, &ts) != ETIMEDOUT);
+#endif
+		if (!signaled) {
+			retval = false;
+			break;
+		}
+	}
+	d->unlock();
+	return retval;
+}
+
+int ControllerAckQueue::queue(size_t length) {
+	Pending p;
+	p.length = length;
+	p.result = ACK_PENDING;
+#ifdef _WINDOWS
+	p.event = CreateEvent( NULL, true, false, NULL );
+#endif
+	d->lock();
+	//Tickets are never 0, so 0 can mean that nothing is waited for
+	if (++d->lastTicket <= 0) {
+		d->lastTicket = 1;
+	}
+	p.ticket = d->lastTicket;
+	d->pending.push_back(p);
+	d->bytesInFlight += length;
+	d->unlock();
+	return p.ticket;
+}
+
+void ControllerAckQueue::cancel(int ticket) {
+	d->lock();
+	std::list<Pending>::iterator it = d->find(ticket);
+	if (it != d->pending.end()) {
+		if (it->result == ACK_PENDING) {
+			d->resolve(&(*it), TELLSTICK_ERROR_BROKEN_PIPE);
+		}
+#ifdef _WINDOWS
+		CloseHandle(it->event);
+#endif
+		d->pending.erase(it);
+	}
+	d->unlock();
+}
+
+void ControllerAckQueue::signal(int result) {
+	d->lock();
+	for(std::list<Pending>::iterator it = d->pending.begin(); it != d->pending.end(); ++it) {
+		if (it->result != ACK_PENDING) {
+			continue;
+		}
+		d->resolve(&(*it), result);
+		if (result == TELLSTICK_SUCCESS) {
+			//Acks arrive in the order the commands were written
+			break;
+		}
+	}
+	d->unlock();
+}
+
+int ControllerAckQueue::wait(int ticket, int timeout) {
+#ifdef _WINDOWS
+	HANDLE event = NULL;
+	d->lock();
+	std::list<Pending>::iterator it = d->find(ticket);
+	if (it != d->pending.end()) {
+		event = it->event;
+	}
+	d->unlock();
+	if (!event) {
+		return TELLSTICK_ERROR_UNKNOWN;
+	}
+	//The event is only closed by the owner of the ticket
+	WaitForSingleObject(event, timeout);
+	d->lock();
+	it = d->find(ticket);
+#else
+	struct timespec ts = PrivateData::deadline(timeout);
+	d->lock();
+	std::list<Pending>::iterator it = d->find(ticket);
+	if (it == d->pending.end()) {
+		d->unlock();
+		return TELLSTICK_ERROR_UNKNOWN;
+	}
+	while(it->result == ACK_PENDING) {
+		if (pthread_cond_timedwait(&d->cond, &d->mutex, &ts) == ETIMEDOUT) {
+			break;
+		}
+	}
+#endif
+	if (it->result == ACK_PENDING) {
+		//A lost ack would be credited to the wrong command, give up on everything in flight
+		for(std::list<Pending>::iterator p = d->pending.begin(); p != d->pending.end(); ++p) {
+			if (p->result == ACK_PENDING) {
+				d->resolve(&(*p), TELLSTICK_ERROR_COMMUNICATION);
+			}
+		}
+	}
+	int retval = it->result;
+#ifdef _WINDOWS
+	CloseHandle(it->event);
+#endif
+	d->pending.erase(it);
+	d->unlock();
+	return retval;
+}
+
+bool ControllerAckQueue::isWaiting() const {
+	d->lock();
+	bool retval = (d->bytesInFlight > 0);
+	d->unlock();
+	return retval;
+}
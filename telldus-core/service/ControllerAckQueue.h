@@ -0,0 +1,59 @@
+#ifndef CONTROLLERACKQUEUE_H
+#define CONTROLLERACKQUEUE_H
+
+#include <stddef.h>
+
+/**
+ * Keeps track of the commands written to a controller that are waiting for
+ * their ack.
+ *
+ * The controller acks the commands in the order they were written, without
+ * saying which command an ack belongs to. A command is queued before it is
+ * written, so an ack seen by the reader thread right after the write is not
+ * lost. The sender then waits for its own ack while the reader thread
+ * signals them as they arrive.
+ */
+class ControllerAckQueue {
+public:
+	ControllerAckQueue();
+	~ControllerAckQueue();
+
+	/**
+	 * Waits until length more bytes may be written. With a limit of 0 every
+	 * queued command must be acked first.
+	 * @return false if there was no room within timeout milliseconds.
+	 */
+	bool waitForRoom(size_t length, size_t limit, int timeout);
+
+	/**
+	 * Queues a command of length bytes that is about to be written.
+	 * @return the ticket to wait for its ack with.
+	 */
+	int queue(size_t length);
+
+	/**
+	 * Removes a queued command that could not be written.
+	 */
+	void cancel(int ticket);
+
+	/**
+	 * Acks the oldest command still waiting. Any other result than
+	 * TELLSTICK_SUCCESS fails all of them.
+	 */
+	void signal(int result);
+
+	/**
+	 * Waits up to timeout milliseconds for the ack. If it doesn't come, the
+	 * later acks can't be matched to their commands, so all commands waiting
+	 * fail with TELLSTICK_ERROR_COMMUNICATION.
+	 */
+	int wait(int ticket, int timeout);
+
+	bool isWaiting() const;
+
+private:
+	class PrivateData;
+	PrivateData *d;
+};
+
+#endif //CONTROLLERACKQUEUE_H
@@ -0,0 +1,99 @@
+#include "ControllerLineFramer.h"
+#include <string.h>
+
+class ControllerLineFramer::PrivateData {
+public:
+	char *buffer;
+	size_t capacity, start, scanned, end;
+	bool discarding;
+	int dropped;
+};
+
+ControllerLineFramer::ControllerLineFramer(size_t capacity) {
+	d = new PrivateData;
+	d->buffer = new char[capacity];
+	d->capacity = capacity;
+	d->start = 0;
+	d->scanned = 0;
+	d->end = 0;
+	d->discarding = false;
+	d->dropped = 0;
+}
+
+ControllerLineFramer::~ControllerLineFramer() {
+	delete[] d->buffer;
+	delete d;
+}
+
+void ControllerLineFramer::clear() {
+	d->start = 0;
+	d->scanned = 0;
+	d->end = 0;
+	d->discarding = false;
+}
+
+size_t ControllerLineFramer::append(const char *data, size_t length) {
+	if (d->start > 0) {
+		//Move the unfinished line to the front. This is usually only a few bytes.
+		memmove(d->buffer, d->buffer + d->start, d->end - d->start);
+		d->end -= d->start;
+		d->scanned -= d->start;
+		d->start = 0;
+	}
+	if (d->end == d->capacity) {
+		if (d->scanned < d->end) {
+			//There are complete lines left to fetch
+			return 0;
+		}
+		//The buffer is full without a line ending, drop the line and skip the rest of it.
+		//It is counted when its end arrives, it may fill the buffer several times.
+		d->discarding = true;
+		d->scanned = 0;
+		d->end = 0;
+	}
+	size_t size = d->capacity - d->end;
+	if (length < size) {
+		size = length;
+	}
+	memcpy(d->buffer + d->end, data, size);
+	d->end += size;
+	return size;
+}
+
+bool ControllerLineFramer::nextLine(const char **line, size_t *length) {
+	while (d->scanned < d->end) {
+		char *begin = d->buffer + d->start;
+		char *newline = static_cast<char *>(memchr(d->buffer + d->scanned, '\n', d->end - d->scanned));
+		if (!newline) {
+			d->scanned = d->end;
+			return false;
+		}
+		size_t next = (newline - d->buffer) + 1;
+		d->start = next;
+		d->scanned = next;
+		if (d->discarding) {
+			//This was the end of a line that did not fit
+			d->discarding = false;
+			++d->dropped;
+			continue;
+		}
+		if (newline > begin && *(newline-1) == '\r') {
+			--newline;
+		}
+		*newline = '\0';
+		*line = begin;
+		*length = newline - begin;
+		if (d->start == d->end) {
+			//Everything consumed, no need to move anything on the next append
+			d->start = 0;
+			d->scanned = 0;
+			d->end = 0;
+		}
+		return true;
+	}
+	return false;
+}
+
+int ControllerLineFramer::droppedLines() const {
+	return d->dropped;
+}
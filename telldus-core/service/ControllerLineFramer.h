@@ -0,0 +1,47 @@
+#ifndef CONTROLLERLINEFRAMER_H
+#define CONTROLLERLINEFRAMER_H
+
+#include <stddef.h>
+
+/**
+ * Splits the byte stream from a controller into lines.
+ *
+ * Data is kept in a fixed-capacity buffer and lines are returned as slices
+ * into that buffer, terminated in place. A line is only valid until the
+ * next call to append(). Lines that don't fit in the buffer are dropped.
+ */
+class ControllerLineFramer {
+public:
+	ControllerLineFramer(size_t capacity = 2048);
+	~ControllerLineFramer();
+
+	/**
+	 * Copies as much of data as fits into the buffer.
+	 * @return the number of bytes consumed. This is only less than length
+	 * if complete lines are waiting to be fetched with nextLine().
+	 */
+	size_t append(const char *data, size_t length);
+
+	/**
+	 * Drops everything buffered, for when the stream starts over.
+	 */
+	void clear();
+
+	/**
+	 * Fetches the next complete line, without the trailing \r\n.
+	 * @return false if there is no complete line buffered.
+	 */
+	bool nextLine(const char **line, size_t *length);
+
+	/**
+	 * @return the number of lines dropped because they were too long. A
+	 * line is counted once, when nextLine() reaches its end.
+	 */
+	int droppedLines() const;
+
+private:
+	class PrivateData;
+	PrivateData *d;
+};
+
+#endif //CONTROLLERLINEFRAMER_H
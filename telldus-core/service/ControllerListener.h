@@ -15,6 +15,8 @@ public:
 	ControllerListener(TelldusCore::EventRef event);
 	virtual ~ControllerListener();
 
+	bool isMonitoring() const;
+
 protected:
 	void run();
 
@@ -0,0 +1,133 @@
+#include "ControllerListener.h"
+#include "Log.h"
+
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+
+//Multicast group for uevents sent by the kernel. udev sends each event again
+//on another group, but only when udevd is running, so only this one is used.
+//The kernel event may arrive before udev has set the permissions of the
+//device, ControllerManager retries the open when that happens.
+#define UEVENT_GROUP_KERNEL 1
+
+class ControllerListener::PrivateData {
+public:
+	int socket;
+	int stopPipe[2];
+	TelldusCore::EventRef event;
+
+	void handleUevent(const char *buffer, size_t length);
+};
+
+ControllerListener::ControllerListener(TelldusCore::EventRef event)
+:Thread()
+{
+	d = new PrivateData;
+	d->event = event;
+	d->stopPipe[0] = d->stopPipe[1] = -1;
+
+	d->socket = ::socket(PF_NETLINK, SOCK_DGRAM, NETLINK_KOBJECT_UEVENT);
+	if (d->socket < 0) {
+		Log::warning("Could not monitor USB hotplug events");
+		return;
+	}
+	struct sockaddr_nl addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.nl_family = AF_NETLINK;
+	addr.nl_groups = UEVENT_GROUP_KERNEL;
+	if (bind(d->socket, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0 || pipe(d->stopPipe) < 0) {
+		Log::warning("Could not monitor USB hotplug events");
+		close(d->socket);
+		d->socket = -1;
+		return;
+	}
+	this->start();
+}
+
+ControllerListener::~ControllerListener() {
+	if (d->socket >= 0) {
+		//Wake up the thread
+		char c = 0;
+		if (write(d->stopPipe[1], &c, 1) < 0) {
+			Log::warning("Could not stop the USB hotplug monitor");
+		}
+		this->wait();
+		close(d->socket);
+		close(d->stopPipe[0]);
+		close(d->stopPipe[1]);
+	}
+	delete d;
+}
+
+bool ControllerListener::isMonitoring() const {
+	return d->socket >= 0;
+}
+
+void ControllerListener::run() {
+	char buffer[4096];
+	struct pollfd fds[2];
+	fds[0].fd = d->socket;
+	fds[0].events = POLLIN;
+	fds[1].fd = d->stopPipe[0];
+	fds[1].events = POLLIN;
+
+	while(1) {
+		if (poll(fds, 2, -1) < 0) {
+			continue;
+		}
+		if (fds[1].revents) {
+			break;
+		}
+		if (!(fds[0].revents & POLLIN)) {
+			continue;
+		}
+		ssize_t length = recv(d->socket, buffer, sizeof(buffer)-1, 0);
+		if (length <= 0) {
+			continue;
+		}
+		buffer[length] = 0;
+		d->handleUevent(buffer, length);
+	}
+}
+
+void ControllerListener::PrivateData::handleUevent(const char *buffer, size_t length) {
+	//Messages from the kernel starts with "action@devpath"
+	size_t offset = strlen(buffer) + 1;
+
+	std::string action, subsystem, devtype, product;
+	while (offset < length) {
+		const char *property = buffer + offset;
+		offset += strlen(property) + 1;
+		if (strncmp(property, "ACTION=", 7) == 0) {
+			action = property + 7;
+		} else if (strncmp(property, "SUBSYSTEM=", 10) == 0) {
+			subsystem = property + 10;
+		} else if (strncmp(property, "DEVTYPE=", 8) == 0) {
+			devtype = property + 8;
+		} else if (strncmp(property, "PRODUCT=", 8) == 0) {
+			product = property + 8;
+		}
+	}
+	if (subsystem != "usb" || devtype != "usb_device") {
+		return;
+	}
+	if (action != "add" && action != "remove") {
+		return;
+	}
+	//PRODUCT is vid/pid/bcdDevice in hex
+	int vid = 0, pid = 0;
+	if (sscanf(product.c_str(), "%x/%x", &vid, &pid) != 2 || vid != 0x1781) {
+		return;
+	}
+
+	ControllerChangeEventData *data = new ControllerChangeEventData;
+	data->vid = vid;
+	data->pid = pid;
+	data->inserted = (action == "add");
+	event->signal(data);
+}
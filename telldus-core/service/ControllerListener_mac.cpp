@@ -41,6 +41,10 @@ ControllerListener::~ControllerListener() {
 	delete d;
 }
 
+bool ControllerListener::isMonitoring() const {
+	return true;
+}
+
 void ControllerListener::run() {
     CFRunLoopSourceRef		runLoopSource;
 			
@@ -2,11 +2,14 @@
 #include "Controller.h"
 #include "Mutex.h"
 #include "TellStick.h"
+#include "VirtualTellStick.h"
+#include "NetworkTellStick.h"
 #include "Log.h"
 #include "Message.h"
 #include "Strings.h"
 #include "Settings.h"
 #include "EventUpdateManager.h"
+#include "common.h"
 #include "../client/telldus-core.h"
 
 #include <map>
@@ -14,25 +17,100 @@
 
 class ControllerDescriptor {
 public:
-	std::wstring name, serial;
+	std::string name, serial;
 	int type;
 	Controller *controller;
 };
 
 typedef std::map<int, ControllerDescriptor> ControllerMap;
 
+//Controllers with a recent error rate (in percent) above this are avoided if possible
+const int MAX_ERROR_RATE = 50;
+//A TellStick may be announced before udev has set its permissions, retry opening it this many times
+const int HOTPLUG_RETRIES = 5;
+const int HOTPLUG_RETRY_DELAY = 200; //ms
+
 class ControllerManager::PrivateData {
 public:
-	int lastControllerId;
+	int lastControllerId, lastSelectedId;
+	bool hotplugMonitored;
+	//TellSticks announced as plugged in that could not be opened yet
+	int pendingAdds;
 	Settings settings;
 	ControllerMap controllers;
 	TelldusCore::EventRef event, updateEvent;
 	TelldusCore::Mutex mutex;
+
+	int findOrAddController(int type, const std::string &serial, bool *isNew);
+	Controller *leastLoadedController();
 };
 
+namespace {
+	long controllerCost(const Controller *controller) {
+		//Expected time until a new command would be confirmed
+		long cost = (controller->queueDepth() + 1) * (long)(controller->ackLatency() + 50);
+		cost = cost * (100 + controller->errorRate()) / 100;
+		if (controller->errorRate() >= MAX_ERROR_RATE) {
+			//Only use as a last resort
+			cost *= 1000;
+		}
+		return cost;
+	}
+}
+
+int ControllerManager::PrivateData::findOrAddController(int type, const std::string &serial, bool *isNew) {
+	//See if the controller matches one of the loaded controllers
+	for(ControllerMap::const_iterator it = controllers.begin(); it != controllers.end(); ++it) {
+		if (it->second.type == type && it->second.serial.compare(serial) == 0) {
+			*isNew = false;
+			return it->first;
+		}
+	}
+	int controllerId = settings.addNode(Settings::Controller);
+	if(controllerId < 0){
+		return controllerId;
+	}
+	*isNew = true;
+	controllers[controllerId].controller = 0;
+	controllers[controllerId].type = type;
+	settings.setControllerType(controllerId, type);
+	controllers[controllerId].serial = serial;
+	settings.setControllerSerial(controllerId, serial);
+	return controllerId;
+}
+
+Controller *ControllerManager::PrivateData::leastLoadedController() {
+	//Start after the last selected controller so equally loaded controllers take turns
+	ControllerMap::const_iterator start = controllers.upper_bound(lastSelectedId);
+	ControllerMap::const_iterator it = start;
+	ControllerMap::const_iterator best = controllers.end();
+	long bestCost = 0;
+	for (size_t i = 0; i < controllers.size(); ++i, ++it) {
+		if (it == controllers.end()) {
+			it = controllers.begin();
+		}
+		if (!it->second.controller) {
+			continue;
+		}
+		long cost = controllerCost(it->second.controller);
+		if (best == controllers.end() || cost < bestCost) {
+			best = it;
+			bestCost = cost;
+		}
+	}
+	if (best == controllers.end()) {
+		return 0;
+	}
+	lastSelectedId = best->first;
+	return best->second.controller;
+}
+
 ControllerManager::ControllerManager(TelldusCore::EventRef event, TelldusCore::EventRef updateEvent){
 	d = new PrivateData;
 	d->lastControllerId = 0;
+	d->lastSelectedId = 0;
+	d->hotplugMonitored = false;
+	d->pendingAdds = 0;
 	d->event = event;
 	d->updateEvent = updateEvent;
 	this->loadStoredControllers();
@@ -59,7 +137,7 @@ void ControllerManager::deviceInsertedOrRemoved(int vid, int pid, const std::str
 				ControllerMap::iterator it = d->controllers.begin();
 				delete it->second.controller;
 				it->second.controller = 0;
-				signalControllerEvent(it->first, TELLSTICK_DEVICE_STATE_CHANGED, TELLSTICK_CHANGE_AVAILABLE, L"0");
+				signalControllerEvent(it->first, TELLSTICK_DEVICE_STATE_CHANGED, TELLSTICK_CHANGE_AVAILABLE, "0");
 			}
 		}
 		return;
@@ -71,10 +149,26 @@ void ControllerManager::deviceInsertedOrRemoved(int vid, int pid, const std::str
 		return;
 	}
 	if (inserted) {
-		loadControllers();
+		{
+			TelldusCore::MutexLocker locker(&d->mutex);
+			++d->pendingAdds;
+		}
+		for (int i = 0; i <= HOTPLUG_RETRIES; ++i) {
+			if (i > 0) {
+				msleep(HOTPLUG_RETRY_DELAY);
+			}
+			loadControllers();
+			TelldusCore::MutexLocker locker(&d->mutex);
+			if (!d->pendingAdds) {
+				return;
+			}
+		}
+		//Keep rescanning until it can be opened, we won't be told again
+		Log::warning("A TellStick was plugged in but could not be opened, will try again");
 	} else {
 		//Autodetect which has been disconnected
 		TelldusCore::MutexLocker locker(&d->mutex);
+		bool removed = false;
 		for(ControllerMap::iterator it = d->controllers.begin(); it != d->controllers.end(); ++it) {
 			if (!it->second.controller) {
 				continue;
@@ -97,7 +191,12 @@ void ControllerManager::deviceInsertedOrRemoved(int vid, int pid, const std::str
 
 			it->second.controller = 0;
 			delete tellstick;
-			signalControllerEvent(it->first, TELLSTICK_DEVICE_STATE_CHANGED, TELLSTICK_CHANGE_AVAILABLE, L"0");
+			removed = true;
+			signalControllerEvent(it->first, TELLSTICK_DEVICE_STATE_CHANGED, TELLSTICK_CHANGE_AVAILABLE, "0");
+		}
+		if (!removed && d->pendingAdds > 0) {
+			//It was unplugged before it could be opened
+			--d->pendingAdds;
 		}
 	}
 }
@@ -109,16 +208,20 @@ Controller *ControllerManager::getBestControllerById(int id) {
 	}
 	ControllerMap::const_iterator it = d->controllers.find(id);
 	if (it != d->controllers.end() && it->second.controller) {
-		return it->second.controller;
-	}
-	//Find first available controller
-	for(it = d->controllers.begin(); it != d->controllers.end(); ++it) {
-		if (it->second.controller) {
-			return it->second.controller;
+		Controller *preferred = it->second.controller;
+		if (preferred->errorRate() < MAX_ERROR_RATE) {
+			return preferred;
 		}
+		//The preferred controller keeps failing, fail over to a healthy one if we have any
+		Controller *controller = d->leastLoadedController();
+		if (controller && controller->errorRate() < MAX_ERROR_RATE) {
+			Log::debug("Controller %i is unreliable, using controller %i instead", id, d->lastSelectedId);
+			return controller;
+		}
+		return preferred;
 	}
-	return 0;
-
+	//No preferred controller, spread the load over the available ones
+	return d->leastLoadedController();
 }
 
 void ControllerManager::loadControllers() {
@@ -153,27 +256,11 @@ void ControllerManager::loadControllers() {
 		if ((*it).pid == 0x0c31) {
 			type = TELLSTICK_CONTROLLER_TELLSTICK_DUO;
 		}
-		int controllerId = 0;
-		//See if the controller matches one of the loaded, non available controllers
-		std::wstring serial = TelldusCore::charToWstring((*it).serial.c_str());
-		for(cit = d->controllers.begin(); cit != d->controllers.end(); ++cit) {
-			if (cit->second.type == type && cit->second.serial.compare(serial) == 0) {
-				controllerId = cit->first;
-				break;
-			}
-		}
 		bool isNew = false;
-		if (!controllerId) {
-			controllerId = d->settings.addNode(Settings::Controller);
-			if(controllerId < 0){
-				//TODO: How to handle this?
-				continue;
-			}
-			isNew = true;
-			d->controllers[controllerId].type = type;
-			d->settings.setControllerType(controllerId, type);
-			d->controllers[controllerId].serial = TelldusCore::charToWstring((*it).serial.c_str());
-			d->settings.setControllerSerial(controllerId, d->controllers[controllerId].serial);
+		int controllerId = d->findOrAddController(type, (*it).serial, &isNew);
+		if(controllerId < 0){
+			//TODO: How to handle this?
+			continue;
 		}
 
 		//int controllerId = d->lastControllerId+1;
@@ -183,10 +270,53 @@ void ControllerManager::loadControllers() {
 			continue;
 		}
 		d->controllers[controllerId].controller = controller;
+		if (d->pendingAdds > 0) {
+			--d->pendingAdds;
+		}
+		if (isNew) {
+			signalControllerEvent(controllerId, TELLSTICK_DEVICE_ADDED, type, "");
+		} else {
+			signalControllerEvent(controllerId, TELLSTICK_DEVICE_STATE_CHANGED, TELLSTICK_CHANGE_AVAILABLE, "1");
+		}
+	}
+
+	//TellSticks on other hosts, reached through a serial to TCP bridge
+	std::list<TellStickDescriptor> remote = NetworkTellStick::findConfigured();
+	for(it = remote.begin(); it != remote.end(); ++it) {
+		int type = TELLSTICK_CONTROLLER_TELLSTICK;
+		if ((*it).pid == 0x0c31) {
+			type = TELLSTICK_CONTROLLER_TELLSTICK_DUO;
+		}
+		bool isNew = false;
+		int controllerId = d->findOrAddController(type, (*it).serial, &isNew);
+		if (controllerId < 0 || d->controllers[controllerId].controller) {
+			continue;
+		}
+		d->controllers[controllerId].controller = new NetworkTellStick(controllerId, d->event, d->updateEvent, *it);
 		if (isNew) {
-			signalControllerEvent(controllerId, TELLSTICK_DEVICE_ADDED, type, L"");
+			signalControllerEvent(controllerId, TELLSTICK_DEVICE_ADDED, type, "");
 		} else {
-			signalControllerEvent(controllerId, TELLSTICK_DEVICE_STATE_CHANGED, TELLSTICK_CHANGE_AVAILABLE, L"1");
+			signalControllerEvent(controllerId, TELLSTICK_DEVICE_STATE_CHANGED, TELLSTICK_CHANGE_AVAILABLE, "1");
+		}
+	}
+
+	//A controller emulated in software, for testing without hardware
+	std::string virtualType = VirtualTellStick::configuredType();
+	if (virtualType.length()) {
+		int pid = 0x0C30, type = TELLSTICK_CONTROLLER_TELLSTICK;
+		if (TelldusCore::comparei(virtualType, "duo")) {
+			pid = 0x0C31;
+			type = TELLSTICK_CONTROLLER_TELLSTICK_DUO;
+		}
+		bool isNew = false;
+		int controllerId = d->findOrAddController(type, "VIRTUAL", &isNew);
+		if (controllerId >= 0 && !d->controllers[controllerId].controller) {
+			d->controllers[controllerId].controller = new VirtualTellStick(controllerId, d->event, d->updateEvent, pid);
+			if (isNew) {
+				signalControllerEvent(controllerId, TELLSTICK_DEVICE_ADDED, type, "");
+			} else {
+				signalControllerEvent(controllerId, TELLSTICK_DEVICE_STATE_CHANGED, TELLSTICK_CHANGE_AVAILABLE, "1");
+			}
 		}
 	}
 }
@@ -202,7 +332,7 @@ void ControllerManager::loadStoredControllers() {
 		const int type = d->settings.getControllerType(id);
 		d->controllers[id].type = type;
 		d->controllers[id].serial = d->settings.getControllerSerial(id);
-		signalControllerEvent(id, TELLSTICK_DEVICE_ADDED, type, L"");
+		signalControllerEvent(id, TELLSTICK_DEVICE_ADDED, type, "");
 	}
 }
 
@@ -236,8 +366,9 @@ void ControllerManager::queryControllerStatus(){
 		}
 	}
 
-	if(!tellStickControllers.size() || reloadControllers){
-		//no tellstick at all found, or controller was reset
+	bool monitored = isHotplugMonitored();
+	if(reloadControllers || (!tellStickControllers.size() && !monitored)){
+		//controller was reset, or no tellstick at all found and we won't be told when one is plugged in
 		Log::debug("TellStick query: Rescanning USB ports");  //only log as debug, since this will happen all the time if no TellStick is connected
 		loadControllers();
 	}
@@ -253,7 +384,18 @@ int ControllerManager::resetController(Controller *controller) {
 	return success;
 }
 
-std::wstring ControllerManager::getControllers() const {
+bool ControllerManager::isHotplugMonitored() const {
+	TelldusCore::MutexLocker locker(&d->mutex);
+	//Fall back to rescanning while a plugged in TellStick is still not opened
+	return d->hotplugMonitored && !d->pendingAdds;
+}
+
+void ControllerManager::setHotplugMonitored(bool monitored) {
+	TelldusCore::MutexLocker locker(&d->mutex);
+	d->hotplugMonitored = monitored;
+}
+
+std::string ControllerManager::getControllers() const {
 	TelldusCore::MutexLocker locker(&d->mutex);
 
 	TelldusCore::Message msg;
@@ -269,26 +411,31 @@ std::wstring ControllerManager::getControllers() const {
 	return msg;
 }
 
-std::wstring ControllerManager::getControllerValue(int id, const std::wstring &name) {
+std::string ControllerManager::getControllerValue(int id, const std::string &name) {
 	TelldusCore::MutexLocker locker(&d->mutex);
 
 	ControllerMap::iterator it = d->controllers.find(id);
 	if (it == d->controllers.end()) {
-		return L"";
+		return "";
 	}
-	if (name == L"serial") {
+	if (name == "serial") {
 		return it->second.serial;
-	} else if (name == L"name") {
+	} else if (name == "name") {
 		return it->second.name;
-	} else if (name == L"available") {
-		return it->second.controller ? L"1" : L"0";
-	} else if (name == L"firmware") {
+	} else if (name == "available") {
+		return it->second.controller ? "1" : "0";
+	} else if (name == "firmware") {
+		if (!it->second.controller) {
+			return "-1";
+		}
+		return TelldusCore::intToString(it->second.controller->firmwareVersion());
+	} else if (name == "airtime") {
 		if (!it->second.controller) {
-			return L"-1";
+			return "-1";
 		}
-		return TelldusCore::intToWstring(it->second.controller->firmwareVersion());
+		return TelldusCore::intToString(it->second.controller->airtime());
 	}
-	return L"";
+	return "";
 }
 
 int ControllerManager::removeController(int id) {
@@ -310,18 +457,18 @@ int ControllerManager::removeController(int id) {
 
 	d->controllers.erase(it);
 
-	signalControllerEvent(id, TELLSTICK_DEVICE_REMOVED, 0, L"");
+	signalControllerEvent(id, TELLSTICK_DEVICE_REMOVED, 0, "");
 	return TELLSTICK_SUCCESS;
 }
 
-int ControllerManager::setControllerValue(int id, const std::wstring &name, const std::wstring &value) {
+int ControllerManager::setControllerValue(int id, const std::string &name, const std::string &value) {
 	TelldusCore::MutexLocker locker(&d->mutex);
 
 	ControllerMap::iterator it = d->controllers.find(id);
 	if (it == d->controllers.end()) {
 		return TELLSTICK_ERROR_NOT_FOUND;
 	}
-	if (name == L"name") {
+	if (name == "name") {
 		it->second.name = value;
 		d->settings.setName(Settings::Controller, id, value);
 		signalControllerEvent(id, TELLSTICK_DEVICE_CHANGED, TELLSTICK_CHANGE_NAME, value);
@@ -331,9 +478,9 @@ int ControllerManager::setControllerValue(int id, const std::wstring &name, cons
 	return TELLSTICK_SUCCESS;
 }
 
-void ControllerManager::signalControllerEvent(int controllerId, int changeEvent, int changeType, const std::wstring &newValue) {
+void ControllerManager::signalControllerEvent(int controllerId, int changeEvent, int changeType, const std::string &newValue) {
 	EventUpdateData *eventData = new EventUpdateData();
-	eventData->messageType = L"TDControllerEvent";
+	eventData->messageType = "TDControllerEvent";
 	eventData->controllerId = controllerId;
 	eventData->eventState = changeEvent;
 	eventData->eventChangeType = changeType;
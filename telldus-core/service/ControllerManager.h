@@ -18,14 +18,16 @@ public:
 	void loadStoredControllers();
 	void queryControllerStatus();
 	int resetController(Controller *controller);
+	bool isHotplugMonitored() const;
+	void setHotplugMonitored(bool monitored);
 
-	std::wstring getControllers() const;
-	std::wstring getControllerValue(int id, const std::wstring &name);
+	std::string getControllers() const;
+	std::string getControllerValue(int id, const std::string &name);
 	int removeController(int id);
-	int setControllerValue(int id, const std::wstring &name, const std::wstring &value);
+	int setControllerValue(int id, const std::string &name, const std::string &value);
 
 private:
-	void signalControllerEvent(int controllerId, int changeEvent, int changeType, const std::wstring &newValue);
+	void signalControllerEvent(int controllerId, int changeEvent, int changeType, const std::string &newValue);
 	class PrivateData;
 	PrivateData *d;
 };
@@ -1,89 +1,193 @@
 #include "ControllerMessage.h"
-#include "Device.h"
+#include "../client/telldus-core.h"
 #include "Strings.h"
 
 #include "common.h"
 
-#include <map>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
 
-class ControllerMessage::PrivateData {
-public:
-	std::map<std::string, std::string> parameters;
-	std::string protocol, model, msgClass;
-	int method;
-};
+ControllerMessage::ControllerMessage()
+	:numberOfParameters(0), methodId(0)
+{
+	memset(&classSlice, 0, sizeof(Slice));
+	memset(&protocolSlice, 0, sizeof(Slice));
+	memset(&modelSlice, 0, sizeof(Slice));
+}
 
-ControllerMessage::ControllerMessage(const std::string &message) {
-	d = new PrivateData;
+ControllerMessage::ControllerMessage(const std::string &rawMessage)
+	:message(rawMessage), numberOfParameters(0), methodId(0)
+{
+	memset(&classSlice, 0, sizeof(Slice));
+	memset(&protocolSlice, 0, sizeof(Slice));
+	memset(&modelSlice, 0, sizeof(Slice));
 
 	//Process our message into bits
+	const char *data = message.c_str();
 	size_t prevPos = 0;
-	size_t pos = message.find(";");
+	size_t pos = message.find(';');
 	while(pos != std::string::npos) {
-		std::string param = message.substr(prevPos, pos-prevPos);
-		prevPos = pos+1;
-		size_t delim = param.find(":");
-		if (delim == std::string::npos) {
+		const char *delim = static_cast<const char *>(memchr(data + prevPos, ':', pos - prevPos));
+		if (!delim) {
 			break;
 		}
-		if (param.substr(0, delim).compare("class") == 0) {
-			d->msgClass = param.substr(delim+1, param.length()-delim);
-		} else if (param.substr(0, delim).compare("protocol") == 0) {
-			d->protocol = param.substr(delim+1, param.length()-delim);
-		} else if (param.substr(0, delim).compare("model") == 0) {
-			d->model = param.substr(delim+1, param.length()-delim);
-		} else if (param.substr(0, delim).compare("method") == 0) {
-			d->method = Device::methodId(param.substr(delim+1, param.length()-delim));
-		} else {
-			d->parameters[param.substr(0, delim)] = param.substr(delim+1, param.length()-delim);
+		Slice slice;
+		slice.keyStart = prevPos;
+		slice.keyLength = delim - (data + prevPos);
+		slice.valueStart = slice.keyStart + slice.keyLength + 1;
+		slice.valueLength = pos - slice.valueStart;
+		prevPos = pos+1;
+		pos = message.find(';', prevPos);
+
+		if (message.compare(slice.keyStart, slice.keyLength, "class") == 0) {
+			classSlice = slice;
+		} else if (message.compare(slice.keyStart, slice.keyLength, "protocol") == 0) {
+			protocolSlice = slice;
+		} else if (message.compare(slice.keyStart, slice.keyLength, "model") == 0) {
+			modelSlice = slice;
+		} else if (message.compare(slice.keyStart, slice.keyLength, "method") == 0) {
+			methodId = methodFromName(data + slice.valueStart, slice.valueLength);
+		} else if (numberOfParameters < MAX_PARAMETERS) {
+			parameters[numberOfParameters++] = slice;
 		}
-		pos = message.find(";", pos+1);
 	}
 }
 
 ControllerMessage::~ControllerMessage(){
-	delete d;
+}
+
+const std::string &ControllerMessage::rawMessage() const {
+	return message;
 }
 
 std::string ControllerMessage::msgClass() const {
-	return d->msgClass;
+	return value(&classSlice);
 }
 
 int ControllerMessage::method() const {
-	return d->method;
+	return methodId;
+}
+
+std::string ControllerMessage::protocol() const {
+	return value(&protocolSlice);
+}
+
+std::string ControllerMessage::model() const {
+	return value(&modelSlice);
 }
 
-std::wstring ControllerMessage::protocol() const {
-	return TelldusCore::charToWstring(d->protocol.c_str());
+bool ControllerMessage::isClass(const char *msgClass) const {
+	return valueEquals(classSlice, msgClass);
 }
 
-std::wstring ControllerMessage::model() const {
-	return TelldusCore::charToWstring(d->model.c_str());
+bool ControllerMessage::isProtocol(const char *protocol) const {
+	return valueEquals(protocolSlice, protocol);
+}
+
+bool ControllerMessage::isModel(const char *model) const {
+	return valueEquals(modelSlice, model);
 }
 
 int ControllerMessage::getIntParameter(const std::string &key) const {
-	std::string strValue = getParameter(key);
-	if (strValue.compare("") == 0) {
+	const Slice *slice = findParameter(key);
+	if (!slice || slice->valueLength == 0) {
 		return -1;
 	}
-	if (strValue.substr(0,2).compare("0x") == 0) {
-		return strtol(strValue.c_str(), NULL, 16);
+	//The value is always followed by ';', which ends the conversion
+	const char *value = message.c_str() + slice->valueStart;
+	if (slice->valueLength >= 2 && value[0] == '0' && value[1] == 'x') {
+		return strtol(value, NULL, 16);
 	}
-	return strtol(strValue.c_str(), NULL, 10);
+	return strtol(value, NULL, 10);
 }
 
 std::string ControllerMessage::getParameter(const std::string &key) const {
-	std::map<std::string, std::string>::iterator it = d->parameters.find(key);
-	if (it == d->parameters.end()) {
-		return "";
-	}
-	return d->parameters[key];
+	return value(findParameter(key));
 }
 
-bool ControllerMessage::hasParameter(const std::string &key) const {
-	std::map<std::string, std::string>::iterator it = d->parameters.find(key);
-	if (it == d->parameters.end()) {
+bool ControllerMessage::getHexParameter(const std::string &key, uint64_t *value) const {
+	const Slice *slice = findParameter(key);
+	if (!slice) {
 		return false;
 	}
+	const char *data = message.c_str() + slice->valueStart;
+	size_t length = slice->valueLength;
+	if (length >= 2 && data[0] == '0' && (data[1] == 'x' || data[1] == 'X')) {
+		data += 2;
+		length -= 2;
+	}
+	if (length == 0 || length > 16) {
+		return false;
+	}
+	uint64_t retval = 0;
+	for (size_t i = 0; i < length; ++i) {
+		char c = data[i];
+		int digit;
+		if (c >= '0' && c <= '9') {
+			digit = c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			digit = c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			digit = c - 'A' + 10;
+		} else {
+			return false;
+		}
+		retval = (retval << 4) | digit;
+	}
+	*value = retval;
 	return true;
 }
+
+bool ControllerMessage::hasParameter(const std::string &key) const {
+	return findParameter(key) != 0;
+}
+
+const ControllerMessage::Slice *ControllerMessage::findParameter(const std::string &key) const {
+	//Search backwards, a repeated key overrides the earlier ones
+	for (int i = numberOfParameters-1; i >= 0; --i) {
+		if (message.compare(parameters[i].keyStart, parameters[i].keyLength, key) == 0) {
+			return &parameters[i];
+		}
+	}
+	return 0;
+}
+
+bool ControllerMessage::valueEquals(const Slice &slice, const char *value) const {
+	const char *data = message.c_str() + slice.valueStart;
+	for (size_t i = 0; i < slice.valueLength; ++i) {
+		if (value[i] == '\0' || tolower((unsigned char)data[i]) != tolower((unsigned char)value[i])) {
+			return false;
+		}
+	}
+	return (value[slice.valueLength] == '\0');
+}
+
+std::string ControllerMessage::value(const Slice *slice) const {
+	if (!slice || slice->valueLength == 0) {
+		return "";
+	}
+	return message.substr(slice->valueStart, slice->valueLength);
+}
+
+int ControllerMessage::methodFromName( const char *methodName, size_t length ) {
+	static const struct {
+		const char *name;
+		int id;
+	} methods[] = {
+		{"turnon", TELLSTICK_TURNON},
+		{"turnoff", TELLSTICK_TURNOFF},
+		{"bell", TELLSTICK_BELL},
+		{"dim", TELLSTICK_DIM},
+		{"execute", TELLSTICK_EXECUTE},
+		{"up", TELLSTICK_UP},
+		{"down", TELLSTICK_DOWN},
+		{"stop", TELLSTICK_STOP}
+	};
+	for (size_t i = 0; i < sizeof(methods)/sizeof(methods[0]); ++i) {
+		if (strlen(methods[i].name) == length && strncmp(methods[i].name, methodName, length) == 0) {
+			return methods[i].id;
+		}
+	}
+	return 0;
+}
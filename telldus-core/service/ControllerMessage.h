@@ -1,25 +1,65 @@
 #ifndef CONTROLLERMESSAGE_H
 #define CONTROLLERMESSAGE_H
 
+#include "Strings.h"
 #include <string>
 
+/**
+ * A message from a controller, like "class:command;protocol:arctech;house:A;".
+ *
+ * The message is parsed once when constructed. Keys and values are kept as
+ * slices of the message text, so no memory is allocated besides the text
+ * itself. Only the first MAX_PARAMETERS pairs are kept. Messages are cheap
+ * to copy and can be passed along as they are.
+ */
 class ControllerMessage {
 public:
+	ControllerMessage();
 	ControllerMessage(const std::string &rawMessage);
 	virtual ~ControllerMessage();
 
+	const std::string &rawMessage() const;
 	std::string msgClass() const;
 	int getIntParameter(const std::string &key) const;
 	std::string getParameter(const std::string &key) const;
+
+	/**
+	 * Parses a parameter holding raw data in hex, with or without 0x.
+	 * @return false if the parameter is missing, empty, has more than 16
+	 * digits or has anything but hex digits in it.
+	 */
+	bool getHexParameter(const std::string &key, uint64_t *value) const;
 	int method() const;
-	std::wstring protocol() const;
-	std::wstring model() const;
+	std::string protocol() const;
+	std::string model() const;
 
 	bool hasParameter(const std::string &key) const;
 
+	//Case insensitive comparisons without copying the value
+	bool isClass(const char *msgClass) const;
+	bool isProtocol(const char *protocol) const;
+	bool isModel(const char *model) const;
+
+	//The TELLSTICK_* method for a name like "turnon", 0 if unknown
+	static int methodFromName(const char *methodName, size_t length);
+
 private:
-	class PrivateData;
-	PrivateData *d;
+	enum { MAX_PARAMETERS = 16 };
+
+	class Slice {
+	public:
+		size_t keyStart, keyLength, valueStart, valueLength;
+	};
+
+	const Slice *findParameter(const std::string &key) const;
+	bool valueEquals(const Slice &slice, const char *value) const;
+	std::string value(const Slice *slice) const;
+
+	std::string message;
+	Slice parameters[MAX_PARAMETERS];
+	int numberOfParameters;
+	Slice classSlice, protocolSlice, modelSlice;
+	int methodId;
 };
 
 #endif //CONTROLLERMESSAGE_H
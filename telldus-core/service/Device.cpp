@@ -1,17 +1,18 @@
 #include "Device.h"
+#include "ControllerMessage.h"
 #include "Settings.h"
 #include "TellStick.h"
 
 class Device::PrivateData {
 public:
-	std::wstring model;
-	std::wstring name;
+	std::string model;
+	std::string name;
 	ParameterMap parameterList;
 	Protocol *protocol;
-	std::wstring protocolName;
+	std::string protocolName;
 	int preferredControllerId;
 	int state;
-	std::wstring stateValue;
+	std::string stateValue;
 };
 
 Device::Device(int id)
@@ -55,16 +56,16 @@ int Device::getMethods() const {
 	return 0;
 }
 
-void Device::setLastSentCommand(int command, std::wstring value){
+void Device::setLastSentCommand(int command, std::string value){
 	d->state = command;
 	d->stateValue = value;
 }
 
-std::wstring Device::getModel(){
+std::string Device::getModel(){
 	return d->model;
 }
 
-void Device::setModel(const std::wstring &model){
+void Device::setModel(const std::string &model){
 	if(d->protocol){
 		delete(d->protocol);
 		d->protocol = 0;
@@ -72,18 +73,18 @@ void Device::setModel(const std::wstring &model){
 	d->model = model;
 }
 
-std::wstring Device::getName(){
+std::string Device::getName(){
 	return d->name;
 }
 
-void Device::setName(const std::wstring &name){
+void Device::setName(const std::string &name){
 	d->name = name;
 }
 
-std::wstring Device::getParameter(const std::wstring &key){
+std::string Device::getParameter(const std::string &key){
 	ParameterMap::iterator it = d->parameterList.find(key);
 	if (it == d->parameterList.end()) {
-		return L"";
+		return "";
 	}
 	return d->parameterList[key];
 }
@@ -92,7 +93,7 @@ std::list<std::string> Device::getParametersForProtocol() const {
 	return Protocol::getParametersForProtocol(getProtocolName());
 }
 
-void Device::setParameter(const std::wstring &key, const std::wstring &value){
+void Device::setParameter(const std::string &key, const std::string &value){
 	d->parameterList[key] = value;
 	if(d->protocol){
 		d->protocol->setParameters(d->parameterList);
@@ -107,11 +108,11 @@ void Device::setPreferredControllerId(int controllerId){
 	d->preferredControllerId = controllerId;
 }
 
-std::wstring Device::getProtocolName() const {
+std::string Device::getProtocolName() const {
 	return d->protocolName;
 }
 
-void Device::setProtocolName(const std::wstring &protocolName){
+void Device::setProtocolName(const std::string &protocolName){
 	if(d->protocol){
 		delete(d->protocol);
 		d->protocol = 0;
@@ -119,15 +120,15 @@ void Device::setProtocolName(const std::wstring &protocolName){
 	d->protocolName = protocolName;
 }
 
-std::wstring Device::getStateValue(){
+std::string Device::getStateValue(){
 	return d->stateValue;
 }
 
 int Device::getType(){
-	if(d->protocolName == L"group"){
+	if(d->protocolName == "group"){
 		return TELLSTICK_TYPE_GROUP;
 	}
-	else if(d->protocolName == L"scene"){
+	else if(d->protocolName == "scene"){
 		return TELLSTICK_TYPE_SCENE;
 	}
 	return TELLSTICK_TYPE_DEVICE;
@@ -137,7 +138,7 @@ int Device::getType(){
 * End Get-/Set
 */
 
-int Device::doAction(int action, unsigned char data, Controller *controller) {
+int Device::encodeAction(int action, unsigned char data, Controller *controller, std::string *code) {
 	Protocol *p = this->retrieveProtocol();
 	if(p){
 		//Try to determine if we need to call another method due to masking
@@ -157,29 +158,17 @@ int Device::doAction(int action, unsigned char data, Controller *controller) {
 		if ((action & methods) == 0) {
 			return TELLSTICK_ERROR_METHOD_NOT_SUPPORTED;
 		}
-		std::string code = p->getStringForMethod(action, data, controller);
-		if (code == "") {
+		*code = p->getStringForMethod(action, data, controller);
+		if (*code == "") {
 			return TELLSTICK_ERROR_METHOD_NOT_SUPPORTED;
 		}
-		if (code[0] != 'S' && code[0] != 'T' && code[0] != 'P' && code[0] != 'R') {
-			//Try autodetect sendtype
-			TellStick *tellstick = reinterpret_cast<TellStick *>(controller);
-			if (!tellstick) {
-				return TELLSTICK_ERROR_UNKNOWN;
-			}
-			unsigned int maxlength = 80;
-			if (tellstick->pid() == 0x0c31) {
-				maxlength = 512;
-			}
-			if (code.length() <= maxlength) {
-				//S is enough
-				code.insert(0, 1, 'S');
-				code.append(1, '+');
-			} else {
-				code = TellStick::createTPacket(code);
-			}
+		//Pick the smallest packet type for the pulses
+		TellStick *tellstick = reinterpret_cast<TellStick *>(controller);
+		if (!tellstick) {
+			return TELLSTICK_ERROR_UNKNOWN;
 		}
-		return controller->send(code);
+		*code = TellStick::encodePacket(*code, tellstick->pid());
+		return TELLSTICK_SUCCESS;
 	}
 	return TELLSTICK_ERROR_UNKNOWN;
 }
@@ -225,29 +214,5 @@ int Device::maskUnsupportedMethods(int methods, int supportedMethods) {
 }
 
 int Device::methodId( const std::string &methodName ) {
-	if (methodName.compare("turnon") == 0) {
-		return TELLSTICK_TURNON;
-	}
-	if (methodName.compare("turnoff") == 0) {
-		return TELLSTICK_TURNOFF;
-	}
-	if (methodName.compare("bell") == 0) {
-		return TELLSTICK_BELL;
-	}
-	if (methodName.compare("dim") == 0) {
-		return TELLSTICK_DIM;
-	}
-	if (methodName.compare("execute") == 0) {
-		return TELLSTICK_EXECUTE;
-	}
-	if (methodName.compare("up") == 0) {
-		return TELLSTICK_UP;
-	}
-	if (methodName.compare("down") == 0) {
-		return TELLSTICK_DOWN;
-	}
-	if (methodName.compare("stop") == 0) {
-		return TELLSTICK_STOP;
-	}
-	return 0;
+	return ControllerMessage::methodFromName(methodName.c_str(), methodName.length());
 }
@@ -13,23 +13,23 @@ public:
 	Device(int id);
 	~Device(void);
 
-	int doAction(int action, unsigned char data, Controller *controller);
-	std::wstring getStateValue();
+	int encodeAction(int action, unsigned char data, Controller *controller, std::string *code);
+	std::string getStateValue();
 	int getLastSentCommand(int methodsSupported);
 	int getMethods() const;
-	std::wstring getModel();
-	void setModel(const std::wstring &model);
-	std::wstring getName();
-	void setName(const std::wstring &name);
-	std::wstring getParameter(const std::wstring &key);
+	std::string getModel();
+	void setModel(const std::string &model);
+	std::string getName();
+	void setName(const std::string &name);
+	std::string getParameter(const std::string &key);
 	std::list<std::string> getParametersForProtocol() const;
-	void setParameter(const std::wstring &key, const std::wstring &value);
+	void setParameter(const std::string &key, const std::string &value);
 	int getPreferredControllerId();
 	void setPreferredControllerId(int controllerId);
-	std::wstring getProtocolName() const;
-	void setProtocolName(const std::wstring &name);
+	std::string getProtocolName() const;
+	void setProtocolName(const std::string &name);
 	void setStateValue(int stateValue);
-	void setLastSentCommand(int command, std::wstring value);
+	void setLastSentCommand(int command, std::string value);
 	int getType();
 
 	static int maskUnsupportedMethods(int methods, int supportedMethods);
@@ -2,6 +2,8 @@
 #include "ControllerMessage.h"
 #include "Mutex.h"
 #include "Sensor.h"
+#include "SensorEventPolicy.h"
+#include "SensorStore.h"
 #include "Settings.h"
 #include "Strings.h"
 #include "Message.h"
@@ -10,10 +12,39 @@
 #include <map>
 #include <memory>
 #include <sstream>
+#include <string.h>
+#include <vector>
 #include <time.h>
 
 typedef std::map<int, Device *> DeviceMap;
 
+namespace {
+	//What getSensorSnapshot() needs from a sensor, copied under its lock
+	class SensorCopy {
+	public:
+		std::string protocol, model;
+		int id;
+		Sensor::Readings readings;
+	};
+
+	//A sensor listed in the setting pinnedSensors
+	class PinnedSensor {
+	public:
+		std::string protocol, model;
+		int id;
+	};
+
+	//How often sensors not heard from within the timeout are looked for
+	const int SENSOR_SWEEP_INTERVAL = 60;
+
+	//A setting holding a count, 0 if negative
+	size_t sizeSetting(const Settings &set, const std::string &name, int defaultValue) {
+		std::string value = set.getSetting(name);
+		int size = (value.length() ? TelldusCore::charToInteger(value.c_str()) : defaultValue);
+		return (size > 0 ? size : 0);
+	}
+}
+
 class DeviceManager::PrivateData {
 public:
 	 DeviceMap devices;
@@ -22,12 +53,31 @@ public:
 	 TelldusCore::Mutex lock;
 	 ControllerManager *controllerManager;
 	 TelldusCore::EventRef deviceUpdateEvent;
+	 Sensor::Retention sensorRetention;
+	 SensorStore sensorStore;
+	 size_t sensorCapacity;
+	 int sensorTimeout;
+	 time_t lastSensorSweep;
+	 std::vector<PinnedSensor> pinnedSensors;
+	 SensorEventPolicy sensorEventPolicy;
+	 int signalledSensorEvents, suppressedSensorEvents;
 };
 
 DeviceManager::DeviceManager(ControllerManager *controllerManager, TelldusCore::EventRef deviceUpdateEvent){
 	d = new PrivateData;
 	d->controllerManager = controllerManager;
 	d->deviceUpdateEvent = deviceUpdateEvent;
+	d->sensorRetention.history = sizeSetting(d->set, "sensorHistoryDepth", 256);
+	//32 bytes per bucket and data type, so these come to about 17 kB for each, minutes are opt-in
+	d->sensorRetention.rollups[SensorRollup::MINUTE] = sizeSetting(d->set, "sensorRollupMinutes", 0);
+	d->sensorRetention.rollups[SensorRollup::HOUR] = sizeSetting(d->set, "sensorRollupHours", 7*24);
+	d->sensorRetention.rollups[SensorRollup::DAY] = sizeSetting(d->set, "sensorRollupDays", 365);
+	d->sensorCapacity = sizeSetting(d->set, "sensorCapacity", 128);
+	d->sensorTimeout = (int)sizeSetting(d->set, "sensorTimeout", 7*24*3600);
+	d->lastSensorSweep = 0;
+	loadPinnedSensors();
+	loadSensorEventPolicy();
+	loadSensorStore();
 	fillDevices();
 }
 
@@ -58,13 +108,13 @@ void DeviceManager::fillDevices(){
 		d->devices[id]->setProtocolName(d->set.getProtocol(id));
 		d->devices[id]->setPreferredControllerId(d->set.getPreferredControllerId(id));
 		d->devices[id]->setLastSentCommand(d->set.getDeviceState(id), d->set.getDeviceStateValue(id));
-		d->devices[id]->setParameter(L"house", d->set.getDeviceParameter(id, L"house"));
-		d->devices[id]->setParameter(L"unit", d->set.getDeviceParameter(id, L"unit"));
-		d->devices[id]->setParameter(L"code", d->set.getDeviceParameter(id, L"code"));
-		d->devices[id]->setParameter(L"units", d->set.getDeviceParameter(id, L"units"));
-		d->devices[id]->setParameter(L"fade", d->set.getDeviceParameter(id, L"fade"));
-		d->devices[id]->setParameter(L"system", d->set.getDeviceParameter(id, L"system"));
-		d->devices[id]->setParameter(L"devices", d->set.getDeviceParameter(id, L"devices"));
+		d->devices[id]->setParameter("house", d->set.getDeviceParameter(id, "house"));
+		d->devices[id]->setParameter("unit", d->set.getDeviceParameter(id, "unit"));
+		d->devices[id]->setParameter("code", d->set.getDeviceParameter(id, "code"));
+		d->devices[id]->setParameter("units", d->set.getDeviceParameter(id, "units"));
+		d->devices[id]->setParameter("fade", d->set.getDeviceParameter(id, "fade"));
+		d->devices[id]->setParameter("system", d->set.getDeviceParameter(id, "system"));
+		d->devices[id]->setParameter("devices", d->set.getDeviceParameter(id, "devices"));
 	}
 }
 
@@ -81,7 +131,7 @@ int DeviceManager::getDeviceLastSentCommand(int deviceId, int methodsSupported){
 	return TELLSTICK_ERROR_DEVICE_NOT_FOUND;
 }
 
-int DeviceManager::setDeviceLastSentCommand(int deviceId, int command, const std::wstring &value)
+int DeviceManager::setDeviceLastSentCommand(int deviceId, int command, const std::string &value)
 {
 	TelldusCore::MutexLocker deviceListLocker(&d->lock);
 	if (!d->devices.size()) {
@@ -99,17 +149,17 @@ int DeviceManager::setDeviceLastSentCommand(int deviceId, int command, const std
 	return TELLSTICK_SUCCESS;
 }
 
-std::wstring DeviceManager::getDeviceStateValue(int deviceId){
+std::string DeviceManager::getDeviceStateValue(int deviceId){
 	TelldusCore::MutexLocker deviceListLocker(&d->lock);
 	if (!d->devices.size()) {
-			return L"UNKNOWN";
+			return "UNKNOWN";
 	}
 	DeviceMap::iterator it = d->devices.find(deviceId);
 	if (it != d->devices.end()) {
 		TelldusCore::MutexLocker deviceLocker(it->second);
 		return it->second->getStateValue();
 	}
-	return L"UNKNOWN";
+	return "UNKNOWN";
 }
 
 int DeviceManager::getDeviceMethods(int deviceId, int methodsSupported) {
@@ -124,8 +174,8 @@ int DeviceManager::getDeviceMethods(int deviceId) {
 int DeviceManager::getDeviceMethods(int deviceId, std::set<int> &duplicateDeviceIds){
 	int type = 0;
 	int methods = 0;
-	std::wstring deviceIds;
-	std::wstring protocol;
+	std::string deviceIds;
+	std::string protocol;
 
 	{
 		//devices locked
@@ -141,7 +191,7 @@ int DeviceManager::getDeviceMethods(int deviceId, std::set<int> &duplicateDevice
 				TelldusCore::MutexLocker deviceLocker(it->second);
 				type = it->second->getType();
 				methods = it->second->getMethods();
-				deviceIds = it->second->getParameter(L"devices");
+				deviceIds = it->second->getParameter("devices");
 				protocol = it->second->getProtocolName();
 			}
 		}
@@ -152,14 +202,14 @@ int DeviceManager::getDeviceMethods(int deviceId, std::set<int> &duplicateDevice
 	if(type == TELLSTICK_TYPE_GROUP){
 
 		//get all methods that some device in the groups supports
-		std::wstring deviceIdBuffer;
-		std::wstringstream devicesstream(deviceIds);
+		std::string deviceIdBuffer;
+		std::stringstream devicesstream(deviceIds);
 		methods = 0;
 
 		duplicateDeviceIds.insert(deviceId);
 
-		while(std::getline(devicesstream, deviceIdBuffer, L',')){
-			int deviceIdInGroup = TelldusCore::wideToInteger(deviceIdBuffer);
+		while(std::getline(devicesstream, deviceIdBuffer, ',')){
+			int deviceIdInGroup = TelldusCore::charToInteger(deviceIdBuffer.c_str());
 			if(duplicateDeviceIds.count(deviceIdInGroup) == 1){
 				//action for device already executed, or will execute, do nothing to avoid infinite loop
 				continue;
@@ -176,21 +226,21 @@ int DeviceManager::getDeviceMethods(int deviceId, std::set<int> &duplicateDevice
 	return methods;
 }
 
-std::wstring DeviceManager::getDeviceModel(int deviceId){
+std::string DeviceManager::getDeviceModel(int deviceId){
 
 	TelldusCore::MutexLocker deviceListLocker(&d->lock);
 	if (!d->devices.size()) {
-			return L"UNKNOWN";
+			return "UNKNOWN";
 	}
 	DeviceMap::iterator it = d->devices.find(deviceId);
 	if (it != d->devices.end()) {
 		TelldusCore::MutexLocker deviceLocker(it->second);
 		return it->second->getModel();
 	}
-	return L"UNKNOWN";
+	return "UNKNOWN";
 }
 
-int DeviceManager::setDeviceModel(int deviceId, const std::wstring &model)
+int DeviceManager::setDeviceModel(int deviceId, const std::string &model)
 {
 	TelldusCore::MutexLocker deviceListLocker(&d->lock);
 	if (!d->devices.size()) {
@@ -212,21 +262,21 @@ int DeviceManager::setDeviceModel(int deviceId, const std::wstring &model)
 	return TELLSTICK_SUCCESS;
 }
 
-std::wstring DeviceManager::getDeviceName(int deviceId){
+std::string DeviceManager::getDeviceName(int deviceId){
 
 	TelldusCore::MutexLocker deviceListLocker(&d->lock);
 	if (!d->devices.size()) {
-			return L"UNKNOWN";
+			return "UNKNOWN";
 	}
 	DeviceMap::iterator it = d->devices.find(deviceId);
 	if (it != d->devices.end()) {
 		TelldusCore::MutexLocker deviceLocker(it->second);
 		return it->second->getName();
 	}
-	return L"UNKNOWN";
+	return "UNKNOWN";
 }
 
-int DeviceManager::setDeviceName(int deviceId, const std::wstring &name){
+int DeviceManager::setDeviceName(int deviceId, const std::string &name){
 
 	TelldusCore::MutexLocker deviceListLocker(&d->lock);
 	if (!d->devices.size()) {
@@ -248,7 +298,7 @@ int DeviceManager::setDeviceName(int deviceId, const std::wstring &name){
 	return TELLSTICK_SUCCESS;
 }
 
-std::wstring DeviceManager::getDeviceParameter(int deviceId, const std::wstring &name, const std::wstring &defaultValue){
+std::string DeviceManager::getDeviceParameter(int deviceId, const std::string &name, const std::string &defaultValue){
 
 	TelldusCore::MutexLocker deviceListLocker(&d->lock);
 	if (!d->devices.size()) {
@@ -257,15 +307,15 @@ std::wstring DeviceManager::getDeviceParameter(int deviceId, const std::wstring
 	DeviceMap::iterator it = d->devices.find(deviceId);
 	if (it != d->devices.end()){
 		TelldusCore::MutexLocker deviceLocker(it->second);
-		std::wstring returnString = it->second->getParameter(name);
-		if(returnString != L""){
+		std::string returnString = it->second->getParameter(name);
+		if(returnString != ""){
 			return returnString;
 		}
 	}
 	return defaultValue;
 }
 
-int DeviceManager::setDeviceParameter(int deviceId, const std::wstring &name, const std::wstring &value)
+int DeviceManager::setDeviceParameter(int deviceId, const std::string &name, const std::string &value)
 {
 	TelldusCore::MutexLocker deviceListLocker(&d->lock);
 	if (!d->devices.size()) {
@@ -287,21 +337,21 @@ int DeviceManager::setDeviceParameter(int deviceId, const std::wstring &name, co
 	return TELLSTICK_SUCCESS;
 }
 
-std::wstring DeviceManager::getDeviceProtocol(int deviceId){
+std::string DeviceManager::getDeviceProtocol(int deviceId){
 
 	TelldusCore::MutexLocker deviceListLocker(&d->lock);
 	if (!d->devices.size()) {
-			return L"UNKNOWN";
+			return "UNKNOWN";
 	}
 	DeviceMap::iterator it = d->devices.find(deviceId);
 	if (it != d->devices.end()) {
 		TelldusCore::MutexLocker deviceLocker(it->second);
 		return it->second->getProtocolName();
 	}
-	return L"UNKNOWN";
+	return "UNKNOWN";
 }
 
-int DeviceManager::setDeviceProtocol(int deviceId, const std::wstring &protocol)
+int DeviceManager::setDeviceProtocol(int deviceId, const std::string &protocol)
 {
 	TelldusCore::MutexLocker deviceListLocker(&d->lock);
 	if (!d->devices.size()) {
@@ -384,11 +434,61 @@ void DeviceManager::disconnectTellStickController(int vid, int pid, const std::s
 	d->controllerManager->deviceInsertedOrRemoved(vid, pid, serial, false);
 }
 
+//One device to act on, the member of a group or scene
+class DeviceManager::PendingAction {
+public:
+	enum Kind {
+		DEVICE, //Sent with startDeviceAction(), waitForDeviceAction() and finishDeviceAction()
+		ACTION, //Something else than a device, run with doAction() in its turn
+		GROUP, //A group in the group, its state follows its members
+		DONE //Nothing to send, result is all there is
+	};
+	PendingAction(Kind kind, int deviceId, int action, unsigned char data)
+		:kind(kind), deviceId(deviceId), action(action), data(data), result(TELLSTICK_SUCCESS), firstMember(0), controller(0) {
+	}
+	Kind kind;
+	int deviceId, action;
+	unsigned char data;
+	int result;
+	size_t firstMember; //For a GROUP, the index of its first member. The members come right before it.
+	Controller *controller; //Set from when a send is started until it's finished
+	Controller::PendingSend send;
+};
+
 int DeviceManager::doAction(int deviceId, int action, unsigned char data){
+	int type;
+	std::string devices;
+	{
+		//devicelist locked
+		TelldusCore::MutexLocker deviceListLocker(&d->lock);
+
+		if (!d->devices.size()) {
+			return TELLSTICK_ERROR_DEVICE_NOT_FOUND;
+		}
+		DeviceMap::iterator it = d->devices.find(deviceId);
+		if (it == d->devices.end()) {
+			return TELLSTICK_ERROR_DEVICE_NOT_FOUND;	//not found
+		}
+		TelldusCore::MutexLocker deviceLocker(it->second);
+		type = it->second->getType();
+		devices = it->second->getParameter("devices");
+	} //devicelist unlocked
+
+	if(type != TELLSTICK_TYPE_GROUP && type != TELLSTICK_TYPE_SCENE){
+		PendingAction pending(PendingAction::DEVICE, deviceId, action, data);
+		startDeviceAction(&pending);
+		waitForDeviceAction(&pending);
+		std::set<Controller *> resetControllers;
+		return finishDeviceAction(&pending, &resetControllers);
+	}
+
+	std::set<int> duplicateDeviceIds;
+	int retval = doGroupAction(devices, action, data, type, deviceId, &duplicateDeviceIds);
+
 	Device *device = 0;
-	//On the stack and will be released if we have a device lock.
 	std::auto_ptr<TelldusCore::MutexLocker> deviceLocker(0);
 	{
+		//reaquire device lock, make sure it still exists
 		//devicelist locked
 		TelldusCore::MutexLocker deviceListLocker(&d->lock);
 
@@ -403,84 +503,186 @@ int DeviceManager::doAction(int deviceId, int action, unsigned char data){
 		deviceLocker = std::auto_ptr<TelldusCore::MutexLocker>(new TelldusCore::MutexLocker(it->second));
 		device = it->second;
 	} //devicelist unlocked
+	if(retval == TELLSTICK_SUCCESS && device->getType() != TELLSTICK_TYPE_SCENE && device->getMethods() & action) {
+		std::string datastring = TelldusCore::intToString(data);
+		if (this->triggerDeviceStateChange(deviceId, action, datastring)) {
+			device->setLastSentCommand(action, datastring);
+			d->set.setDeviceState(deviceId, action, datastring);
+		}
+	}
+	return retval;
+}
 
-	int retval = TELLSTICK_ERROR_UNKNOWN;
-
-	if(device->getType() == TELLSTICK_TYPE_GROUP || device->getType() == TELLSTICK_TYPE_SCENE){
-		std::wstring devices = device->getParameter(L"devices");
-		deviceLocker = std::auto_ptr<TelldusCore::MutexLocker>(0);
-		std::set<int> *duplicateDeviceIds = new std::set<int>;
-		retval = doGroupAction(devices, action, data, device->getType(), deviceId, duplicateDeviceIds);
-		delete duplicateDeviceIds;
-
+void DeviceManager::startDeviceAction(PendingAction *pending){
+	pending->controller = 0;
+	std::string code;
+	{
+		Device *device = 0;
+		//device locked, only while the command is encoded
+		std::auto_ptr<TelldusCore::MutexLocker> deviceLocker(0);
 		{
-			//reaquire device lock, make sure it still exists
 			//devicelist locked
 			TelldusCore::MutexLocker deviceListLocker(&d->lock);
 
-			if (!d->devices.size()) {
-				return TELLSTICK_ERROR_DEVICE_NOT_FOUND;
-			}
-			DeviceMap::iterator it = d->devices.find(deviceId);
+			DeviceMap::iterator it = d->devices.find(pending->deviceId);
 			if (it == d->devices.end()) {
-				return TELLSTICK_ERROR_DEVICE_NOT_FOUND;	//not found
+				pending->result = TELLSTICK_ERROR_DEVICE_NOT_FOUND;
+				return;
 			}
-			//device locked
 			deviceLocker = std::auto_ptr<TelldusCore::MutexLocker>(new TelldusCore::MutexLocker(it->second));
 			device = it->second;
 		} //devicelist unlocked
-	}
-	else{
+
 		Controller *controller = d->controllerManager->getBestControllerById(device->getPreferredControllerId());
-		if(!controller){
+		if(!controller && !d->controllerManager->isHotplugMonitored()){
 			Log::warning("Trying to execute action, but no controller found. Rescanning USB ports");
 			//no controller found, scan for one, and retry once
 			d->controllerManager->loadControllers();
 			controller = d->controllerManager->getBestControllerById(device->getPreferredControllerId());
 		}
-
-		if(controller){
-			retval = device->doAction(action, data, controller);
-			if(retval == TELLSTICK_ERROR_BROKEN_PIPE){
-				Log::warning("Error in communication with TellStick when executing action. Resetting USB");
-				d->controllerManager->resetController(controller);
-			}
-			if(retval == TELLSTICK_ERROR_BROKEN_PIPE || retval == TELLSTICK_ERROR_NOT_FOUND){
-				Log::warning("Rescanning USB ports");
-				d->controllerManager->loadControllers();
-				controller = d->controllerManager->getBestControllerById(device->getPreferredControllerId());
-				if(!controller){
-					Log::error("No contoller (TellStick) found, even after reset. Giving up.");
-					return TELLSTICK_ERROR_NOT_FOUND;
-				}
-				retval = device->doAction(action, data, controller); //retry one more time
-			}
-		} else {
+		if(!controller){
 			Log::error("No contoller (TellStick) found after one retry. Giving up.");
-			return TELLSTICK_ERROR_NOT_FOUND;
+			pending->result = TELLSTICK_ERROR_NOT_FOUND;
+			return;
 		}
+
+		pending->result = device->encodeAction(pending->action, pending->data, controller, &code);
+		if (pending->result != TELLSTICK_SUCCESS) {
+			return;
+		}
+		pending->controller = controller;
 	}
-	if(retval == TELLSTICK_SUCCESS && device->getType() != TELLSTICK_TYPE_SCENE && device->getMethods() & action) {
+	pending->controller->startSend(code, &pending->send);
+}
+
+void DeviceManager::waitForDeviceAction(PendingAction *pending){
+	if (pending->controller) {
+		pending->result = pending->controller->finishSend(&pending->send);
+	}
+}
+
+int DeviceManager::finishDeviceAction(PendingAction *pending, std::set<Controller *> *resetControllers){
+	Controller *controller = pending->controller;
+	pending->controller = 0;
+	int retval = pending->result;
+	if (!controller) {
+		//Never sent
+		return retval;
+	}
+	if(retval == TELLSTICK_ERROR_BROKEN_PIPE && resetControllers->insert(controller).second){
+		//Only once, the controller is gone after the reset
+		Log::warning("Error in communication with TellStick when executing action. Resetting USB");
+		d->controllerManager->resetController(controller);
+	}
+	if(retval == TELLSTICK_ERROR_BROKEN_PIPE || retval == TELLSTICK_ERROR_NOT_FOUND){
+		Log::warning("Rescanning USB ports");
+		d->controllerManager->loadControllers();
+		//retry one more time
+		startDeviceAction(pending);
+		waitForDeviceAction(pending);
+		pending->controller = 0;
+		retval = pending->result;
+	}
+
+	Device *device = 0;
+	std::auto_ptr<TelldusCore::MutexLocker> deviceLocker(0);
+	{
+		//devicelist locked
+		TelldusCore::MutexLocker deviceListLocker(&d->lock);
+		DeviceMap::iterator it = d->devices.find(pending->deviceId);
+		if (it == d->devices.end()) {
+			return retval;
+		}
+		//device locked
+		deviceLocker = std::auto_ptr<TelldusCore::MutexLocker>(new TelldusCore::MutexLocker(it->second));
+		device = it->second;
+	} //devicelist unlocked
+	if(retval == TELLSTICK_SUCCESS && device->getMethods() & pending->action) {
 		//if method isn't explicitly supported by device, but used anyway as a fallback (i.e. bell), don't change state
-		std::wstring datastring = TelldusCore::charUnsignedToWstring(data);
-		if (this->triggerDeviceStateChange(deviceId, action, datastring)) {
-			device->setLastSentCommand(action, datastring);
-			d->set.setDeviceState(deviceId, action, datastring);
+		std::string datastring = TelldusCore::intToString(pending->data);
+		if (this->triggerDeviceStateChange(pending->deviceId, pending->action, datastring)) {
+			device->setLastSentCommand(pending->action, datastring);
+			d->set.setDeviceState(pending->deviceId, pending->action, datastring);
 		}
 	}
 	return retval;
 }
 
-int DeviceManager::doGroupAction(const std::wstring devices, const int action, const unsigned char data, const int type, const int groupDeviceId, std::set<int> *duplicateDeviceIds){
+void DeviceManager::finishGroupActions(std::vector<PendingAction> *members, size_t first, size_t last){
+	//Every ack first, resetting a controller for one member must not pull it away from the others in flight
+	for(size_t i = first; i < last; ++i) {
+		if ((*members)[i].kind == PendingAction::DEVICE) {
+			waitForDeviceAction(&(*members)[i]);
+		}
+	}
+	std::set<Controller *> resetControllers;
+	for(size_t i = first; i < last; ++i) {
+		if ((*members)[i].kind == PendingAction::DEVICE) {
+			(*members)[i].result = finishDeviceAction(&(*members)[i], &resetControllers);
+		}
+	}
+}
+
+int DeviceManager::doGroupAction(const std::string devices, const int action, const unsigned char data, const int type, const int groupDeviceId, std::set<int> *duplicateDeviceIds){
+	std::vector<PendingAction> members;
+	collectGroupActions(devices, action, data, type, groupDeviceId, duplicateDeviceIds, &members);
+
+	//Write every member before waiting for any ack, so a controller buffering
+	//commands gets them back to back. Others take them one at a time anyway.
+	size_t finished = 0;
+	for(size_t i = 0; i < members.size(); ++i) {
+		if (members[i].kind == PendingAction::DEVICE) {
+			startDeviceAction(&members[i]);
+		} else if (members[i].kind == PendingAction::ACTION) {
+			//May reset controllers, so nothing can be in flight
+			finishGroupActions(&members, finished, i);
+			finished = i;
+			members[i].result = doAction(members[i].deviceId, members[i].action, members[i].data);
+		}
+	}
+	finishGroupActions(&members, finished, members.size());
+
 	int retval = TELLSTICK_ERROR_METHOD_NOT_SUPPORTED;
-	std::wstring singledevice;
-	std::wstringstream devicesstream(devices);
+	for(size_t i = 0; i < members.size(); ++i) {
+		PendingAction &member = members[i];
+		if (member.kind == PendingAction::GROUP) {
+			//Its members come right before it
+			int groupReturnValue = TELLSTICK_ERROR_METHOD_NOT_SUPPORTED;
+			for(size_t j = member.firstMember; j < i; ++j) {
+				if (members[j].kind != PendingAction::GROUP && members[j].result != TELLSTICK_ERROR_METHOD_NOT_SUPPORTED) {
+					groupReturnValue = members[j].result;
+				}
+			}
+			if(groupReturnValue == TELLSTICK_SUCCESS) {
+				std::string datastring = TelldusCore::intToString(member.data);
+				if (this->triggerDeviceStateChange(member.deviceId, member.action, datastring)) {
+					DeviceManager::setDeviceLastSentCommand(member.deviceId, member.action, datastring);
+					d->set.setDeviceState(member.deviceId, member.action, datastring);
+				}
+			}
+			//Its members count on their own
+			continue;
+		}
+
+		if(member.result != TELLSTICK_ERROR_METHOD_NOT_SUPPORTED){
+			//if error(s), return the last error, but still try to continue the action with the other devices
+			//if the error is a method not supported we igore is since there might be others supporting it
+			//If no devices support the method the default value will be returned (method not supported)
+			retval = member.result;
+		}
+	}
+	return retval;
+}
+
+void DeviceManager::collectGroupActions(const std::string &devices, int action, unsigned char data, int type, int groupDeviceId, std::set<int> *duplicateDeviceIds, std::vector<PendingAction> *members){
+	std::string singledevice;
+	std::stringstream devicesstream(devices);
 
 	duplicateDeviceIds->insert(groupDeviceId);
 
-	while(std::getline(devicesstream, singledevice, L',')){
+	while(std::getline(devicesstream, singledevice, ',')){
 
-		int deviceId = TelldusCore::wideToInteger(singledevice);
+		int deviceId = TelldusCore::charToInteger(singledevice.c_str());
 
 		if(duplicateDeviceIds->count(deviceId) == 1){
 			//action for device already executed, or will execute, do nothing to avoid infinite loop
@@ -489,84 +691,78 @@ int DeviceManager::doGroupAction(const std::wstring devices, const int action, c
 
 		duplicateDeviceIds->insert(deviceId);
 
-		int deviceReturnValue = TELLSTICK_SUCCESS;
-
 		if(type == TELLSTICK_TYPE_SCENE && (action == TELLSTICK_TURNON || action == TELLSTICK_EXECUTE)){
-			deviceReturnValue = executeScene(singledevice, groupDeviceId);
+			members->push_back(sceneAction(singledevice, groupDeviceId));
 		}
 		else if(type == TELLSTICK_TYPE_GROUP){
 			if(deviceId != 0){
 				int childType = DeviceManager::getDeviceType(deviceId);
 				if(childType == TELLSTICK_TYPE_DEVICE){
-					deviceReturnValue = doAction(deviceId, action, data);
+					members->push_back(PendingAction(PendingAction::DEVICE, deviceId, action, data));
 				}
 				else if(childType == TELLSTICK_TYPE_SCENE){
-					deviceReturnValue = doGroupAction(DeviceManager::getDeviceParameter(deviceId, L"devices", L""), action, data, childType, deviceId, duplicateDeviceIds); //TODO make scenes infinite loops-safe
+					collectGroupActions(DeviceManager::getDeviceParameter(deviceId, "devices", ""), action, data, childType, deviceId, duplicateDeviceIds, members); //TODO make scenes infinite loops-safe
 				}
 				else{
 					//group (in group)
-					deviceReturnValue = doGroupAction(DeviceManager::getDeviceParameter(deviceId, L"devices", L""), action, data, childType, deviceId, duplicateDeviceIds);
-
-					if(deviceReturnValue == TELLSTICK_SUCCESS) {
-						std::wstring datastring = TelldusCore::charUnsignedToWstring(data);
-						if (this->triggerDeviceStateChange(deviceId, action, datastring)) {
-							DeviceManager::setDeviceLastSentCommand(deviceId, action, datastring);
-							d->set.setDeviceState(deviceId, action, datastring);
-						}
-					}
+					size_t firstMember = members->size();
+					collectGroupActions(DeviceManager::getDeviceParameter(deviceId, "devices", ""), action, data, childType, deviceId, duplicateDeviceIds, members);
+					PendingAction group(PendingAction::GROUP, deviceId, action, data);
+					group.firstMember = firstMember;
+					members->push_back(group);
 				}
 			}
 			else{
-				deviceReturnValue = TELLSTICK_ERROR_DEVICE_NOT_FOUND;	//Probably incorrectly formatted parameter
+				PendingAction notFound(PendingAction::DONE, deviceId, action, data);
+				notFound.result = TELLSTICK_ERROR_DEVICE_NOT_FOUND;	//Probably incorrectly formatted parameter
+				members->push_back(notFound);
 			}
 		}
-
-		if(deviceReturnValue != TELLSTICK_ERROR_METHOD_NOT_SUPPORTED){
-			//if error(s), return the last error, but still try to continue the action with the other devices
-			//if the error is a method not supported we igore is since there might be others supporting it
-			//If no devices support the method the default value will be returned (method not supported)
-			retval = deviceReturnValue;
+		else{
+			members->push_back(PendingAction(PendingAction::DONE, deviceId, action, data));
 		}
-
 	}
-	return retval;
 }
 
-int DeviceManager::executeScene(std::wstring singledevice, int groupDeviceId){
+DeviceManager::PendingAction DeviceManager::sceneAction(const std::string &singledevice, int groupDeviceId){
 
-	std::wstringstream devicestream(singledevice);
+	std::stringstream devicestream(singledevice);
 
 	const int deviceParameterLength = 3;
-	std::wstring deviceParts[deviceParameterLength] = {L"", L"", L""};
-	std::wstring devicePart = L"";
+	std::string deviceParts[deviceParameterLength] = {"", "", ""};
+	std::string devicePart = "";
 	int i = 0;
-	while(std::getline(devicestream, devicePart, L':') && i < deviceParameterLength){
+	while(std::getline(devicestream, devicePart, ':') && i < deviceParameterLength){
 		deviceParts[i] = devicePart;
 		i++;
 	}
 
-	if(deviceParts[0] == L"" || deviceParts[1] == L""){
-		return TELLSTICK_ERROR_UNKNOWN;	//malformed or missing parameter
+	PendingAction malformed(PendingAction::DONE, 0, 0, 0);
+	malformed.result = TELLSTICK_ERROR_UNKNOWN;
+	if(deviceParts[0] == "" || deviceParts[1] == ""){
+		return malformed;	//malformed or missing parameter
 	}
 
-	int deviceId = TelldusCore::wideToInteger(deviceParts[0]);
+	int deviceId = TelldusCore::charToInteger(deviceParts[0].c_str());
 	if(deviceId == groupDeviceId){
-		return TELLSTICK_ERROR_UNKNOWN;	//the scene itself has been added to its devices, avoid infinite loop
+		return malformed;	//the scene itself has been added to its devices, avoid infinite loop
 	}
-	int method = Device::methodId(TelldusCore::wideToString(deviceParts[1]));	//support methodparts both in the form of integers (e.g. TELLSTICK_TURNON) or text (e.g. "turnon")
+	int method = Device::methodId(deviceParts[1]);	//support methodparts both in the form of integers (e.g. TELLSTICK_TURNON) or text (e.g. "turnon")
 	if(method == 0){
-		method = TelldusCore::wideToInteger(deviceParts[1]);
+		method = TelldusCore::charToInteger(deviceParts[1].c_str());
 	}
 	unsigned char devicedata = 0;
-	if(deviceParts[2] != L""){
-		devicedata = TelldusCore::wideToInteger(deviceParts[2]);
+	if(deviceParts[2] != ""){
+		devicedata = TelldusCore::charToInteger(deviceParts[2].c_str());
 	}
 
 	if(deviceId > 0 && method > 0){	//check for format error in parameter "devices"
-		return doAction(deviceId, method, devicedata);
+		//Groups and scenes in a scene are run as a whole, in their turn
+		PendingAction::Kind kind = (DeviceManager::getDeviceType(deviceId) == TELLSTICK_TYPE_DEVICE ? PendingAction::DEVICE : PendingAction::ACTION);
+		return PendingAction(kind, deviceId, method, devicedata);
 	}
 
-	return TELLSTICK_ERROR_UNKNOWN;
+	return malformed;
 }
 
 int DeviceManager::removeDevice(int deviceId){
@@ -597,7 +793,7 @@ int DeviceManager::removeDevice(int deviceId){
 	return TELLSTICK_SUCCESS;
 }
 
-std::wstring DeviceManager::getSensors() const {
+std::string DeviceManager::getSensors() const {
 	TelldusCore::MutexLocker sensorListLocker(&d->lock);
 
 	TelldusCore::Message msg;
@@ -615,9 +811,201 @@ std::wstring DeviceManager::getSensors() const {
 	return msg;
 }
 
-std::wstring DeviceManager::getSensorValue(const std::wstring &protocol, const std::wstring &model, int id, int dataType) const {
+std::string DeviceManager::getSensorValue(const std::string &protocol, const std::string &model, int id, int dataType) const {
 	TelldusCore::MutexLocker sensorListLocker(&d->lock);
-	Sensor *sensor = 0;
+	Sensor *sensor = findSensor(protocol, model, id);
+	if (!sensor) {
+		return "";
+	}
+	Sensor::Readings readings;
+	{
+		TelldusCore::MutexLocker sensorLocker(sensor);
+		sensor->readings(&readings);
+	}
+	TelldusCore::Message msg;
+	const Sensor::Reading *reading = readings.find(dataType);
+	if (reading) {
+		msg.addArgument(SensorRecord::formatValue(reading->value, reading->decimals));
+		msg.addArgument((int)reading->timestamp);
+	}
+	return msg;
+}
+
+
+void DeviceManager::handleControllerMessage(const ControllerEventData &eventData) {
+	//Already parsed by the controller
+	const ControllerMessage &msg = eventData.msg;
+
+	if (eventData.sensor.isValid()) {
+		//Decoded straight into a record, the text is only needed for the raw event
+		signalRawDeviceEvent(eventData.controllerId, (msg.rawMessage().length() ? msg.rawMessage() : eventData.sensor.toString()));
+		handleSensorMessage(eventData.sensor);
+		return;
+	}
+	if (msg.isClass("sensor")) {
+		//A sensor message without any values we know of
+		signalRawDeviceEvent(eventData.controllerId, msg.rawMessage());
+		return;
+	}
+
+	std::vector<const ControllerMessage *> messages;
+	messages.push_back(&msg);
+	for (std::list<ControllerMessage>::const_iterator it = eventData.alternatives.begin(); it != eventData.alternatives.end(); ++it) {
+		messages.push_back(&(*it));
+	}
+
+	//Every reading of the frame is checked against the devices in one pass
+	TelldusCore::MutexLocker deviceListLocker(&d->lock);
+	std::vector<bool> matched(messages.size(), false);
+	std::vector<std::pair<int, size_t> > changes; //The device and the reading it matched
+	for (DeviceMap::iterator it = d->devices.begin(); it != d->devices.end(); ++it) {
+		TelldusCore::MutexLocker deviceLocker(it->second);
+		for (size_t i = 0; i < messages.size(); ++i) {
+			if (deviceMatchesMessage(it->second, *messages[i])) {
+				matched[i] = true;
+				changes.push_back(std::make_pair(it->first, i));
+				break;
+			}
+		}
+	}
+
+	//Only the readings a configured device agrees with are reported. If there
+	//is none, all of them are so that new remotes can still be found.
+	bool anyMatched = false;
+	for (size_t i = 0; i < matched.size(); ++i) {
+		anyMatched = anyMatched || matched[i];
+	}
+	for (size_t i = 0; i < messages.size(); ++i) {
+		if (matched[i] || !anyMatched) {
+			signalRawDeviceEvent(eventData.controllerId, messages[i]->rawMessage());
+		}
+	}
+
+	for (size_t i = 0; i < changes.size(); ++i) {
+		int deviceId = changes[i].first;
+		int method = messages[changes[i].second]->method();
+		if (this->triggerDeviceStateChange(deviceId, method, "")) {
+			d->set.setDeviceState(deviceId, method, "");
+			Device *device = d->devices[deviceId];
+			TelldusCore::MutexLocker deviceLocker(device);
+			device->setLastSentCommand(method, "");
+		}
+	}
+}
+
+bool DeviceManager::deviceMatchesMessage(Device *device, const ControllerMessage &msg) const {
+	if (!TelldusCore::comparei(device->getProtocolName(), msg.protocol())) {
+		return false;
+	}
+	if (! (device->getMethods() & msg.method())) {
+		return false;
+	}
+
+	std::list<std::string> parameters = device->getParametersForProtocol();
+	for (std::list<std::string>::iterator paramIt = parameters.begin(); paramIt != parameters.end(); ++paramIt){
+		if(!TelldusCore::comparei(device->getParameter(*paramIt), msg.getParameter(*paramIt))){
+			return false;
+		}
+	}
+	return true;
+}
+
+void DeviceManager::signalRawDeviceEvent(int controllerId, const std::string &message) const {
+	EventUpdateData *eventUpdateData = new EventUpdateData();
+	eventUpdateData->messageType = "TDRawDeviceEvent";
+	eventUpdateData->controllerId = controllerId;
+	eventUpdateData->eventValue = message;
+	d->deviceUpdateEvent->signal(eventUpdateData);
+}
+
+std::string DeviceManager::getSensorSnapshot() const {
+	std::vector<SensorCopy> sensors;
+	int numberOfValues = 0;
+	{
+		TelldusCore::MutexLocker sensorListLocker(&d->lock);
+		sensors.resize(d->sensorList.size());
+		size_t i = 0;
+		for (std::list<Sensor *>::const_iterator it = d->sensorList.begin(); it != d->sensorList.end(); ++it, ++i) {
+			TelldusCore::MutexLocker sensorLocker(*it);
+			sensors[i].protocol = (*it)->protocol();
+			sensors[i].model = (*it)->model();
+			sensors[i].id = (*it)->id();
+			(*it)->readings(&sensors[i].readings);
+		}
+	}
+	for (size_t i = 0; i < sensors.size(); ++i) {
+		for (int slot = 0; slot < Sensor::MAX_DATA_TYPES; ++slot) {
+			if (sensors[i].readings.dataTypes & (1 << slot)) {
+				++numberOfValues;
+			}
+		}
+	}
+
+	//One entry per value, the values of a sensor follow each other
+	TelldusCore::Message msg;
+	msg.addArgument(numberOfValues);
+	for (size_t i = 0; i < sensors.size(); ++i) {
+		for (int slot = 0; slot < Sensor::MAX_DATA_TYPES; ++slot) {
+			if (!(sensors[i].readings.dataTypes & (1 << slot))) {
+				continue;
+			}
+			const Sensor::Reading &reading = sensors[i].readings.values[slot];
+			msg.addArgument(sensors[i].protocol);
+			msg.addArgument(sensors[i].model);
+			msg.addArgument(sensors[i].id);
+			msg.addArgument(1 << slot);
+			msg.addArgument(SensorRecord::formatValue(reading.value, reading.decimals));
+			msg.addArgument((int)reading.timestamp);
+		}
+	}
+	return msg;
+}
+
+std::string DeviceManager::getSensorHistory(const std::string &protocol, const std::string &model, int id, int dataType, time_t from, time_t to) const {
+	std::vector<SensorHistory::Sample> samples;
+	{
+		TelldusCore::MutexLocker sensorListLocker(&d->lock);
+		Sensor *sensor = findSensor(protocol, model, id);
+		if (sensor) {
+			TelldusCore::MutexLocker sensorLocker(sensor);
+			sensor->history(dataType, from, to, &samples);
+		}
+	}
+
+	TelldusCore::Message msg;
+	msg.addArgument((int)samples.size());
+	for (size_t i = 0; i < samples.size(); ++i) {
+		msg.addArgument(SensorRecord::formatValue(samples[i].value, samples[i].decimals));
+		msg.addArgument((int)samples[i].timestamp);
+	}
+	return msg;
+}
+
+std::string DeviceManager::getSensorRollup(const std::string &protocol, const std::string &model, int id, int dataType, int resolution, time_t from, time_t to) const {
+	std::vector<SensorRollup::Bucket> buckets;
+	{
+		TelldusCore::MutexLocker sensorListLocker(&d->lock);
+		Sensor *sensor = findSensor(protocol, model, id);
+		if (sensor) {
+			TelldusCore::MutexLocker sensorLocker(sensor);
+			sensor->rollup(dataType, resolution, from, to, &buckets);
+		}
+	}
+
+	TelldusCore::Message msg;
+	msg.addArgument((int)buckets.size());
+	for (size_t i = 0; i < buckets.size(); ++i) {
+		int decimals = buckets[i].decimals;
+		msg.addArgument((int)buckets[i].start);
+		msg.addArgument(SensorRecord::formatValue(buckets[i].min, decimals));
+		msg.addArgument(SensorRecord::formatValue(buckets[i].max, decimals));
+		msg.addArgument(SensorRecord::formatValue(buckets[i].average(), decimals));
+		msg.addArgument(buckets[i].count);
+	}
+	return msg;
+}
+
+Sensor *DeviceManager::findSensor(const std::string &protocol, const std::string &model, int id) const {
 	for (std::list<Sensor *>::iterator it = d->sensorList.begin(); it != d->sensorList.end(); ++it) {
 		TelldusCore::MutexLocker sensorLocker(*it);
 		if (!TelldusCore::comparei((*it)->protocol(), protocol)) {
@@ -629,120 +1017,221 @@ std::wstring DeviceManager::getSensorValue(const std::wstring &protocol, const s
 		if ((*it)->id() != id) {
 			continue;
 		}
-		sensor = *it;
-		break;
+		return *it;
 	}
+	return 0;
+}
 
+void DeviceManager::handleSensorMessage(const SensorRecord &record) {
+	std::string protocol(record.protocol), model(record.model);
+
+	time_t t = time(NULL);
+
+	TelldusCore::MutexLocker sensorListLocker(&d->lock);
+	if (t - d->lastSensorSweep >= SENSOR_SWEEP_INTERVAL) {
+		evictSensors(t, 0);
+		if (d->suppressedSensorEvents) {
+			Log::debug("%i sensor events signalled, %i suppressed", d->signalledSensorEvents, d->suppressedSensorEvents);
+		}
+	}
+	Sensor *sensor = findSensor(protocol, model, record.id);
 	if (!sensor) {
-		return L"";
+		sensor = createSensor(protocol, model, record.id, t);
 	}
 	TelldusCore::MutexLocker sensorLocker(sensor);
-	TelldusCore::Message msg;
-	std::string value = sensor->value(dataType);
-	if (value.length() > 0) {
-		msg.addArgument(TelldusCore::charToWstring(value.c_str()));
-		msg.addArgument((int)sensor->timestamp());
+
+	SensorStore::Entry entry;
+	strncpy(entry.protocol, record.protocol, sizeof(entry.protocol));
+	strncpy(entry.model, record.model, sizeof(entry.model));
+	entry.id = record.id;
+	entry.timestamp = t;
+	for (int i = 0; i < record.numberOfValues; ++i) {
+		setSensorValueAndSignal(record.values[i], sensor, t);
+		entry.value = record.values[i];
+		d->sensorStore.append(entry);
 	}
-	return msg;
 }
 
-
-void DeviceManager::handleControllerMessage(const ControllerEventData &eventData) {
-	//Trigger raw-event
-	EventUpdateData *eventUpdateData = new EventUpdateData();
-	eventUpdateData->messageType = L"TDRawDeviceEvent";
-	eventUpdateData->controllerId = eventData.controllerId;
-	eventUpdateData->eventValue = TelldusCore::charToWstring(eventData.msg.c_str());
-	d->deviceUpdateEvent->signal(eventUpdateData);
-
-	ControllerMessage msg(eventData.msg);
-	if (msg.msgClass().compare("sensor") == 0) {
-		handleSensorMessage(msg);
+void DeviceManager::loadSensorStore() {
+	std::string path = d->set.getSetting("sensorStore");
+	size_t size = sizeSetting(d->set, "sensorStoreSize", 0);
+	if (path.length() == 0 || size == 0) {
+		return;
+	}
+	if (!d->sensorStore.open(path, size, (int)sizeSetting(d->set, "sensorStoreFlushInterval", 300))) {
+		Log::warning("Could not open the sensor store %s, sensor values will not be saved", path.c_str());
 		return;
 	}
 
-	TelldusCore::MutexLocker deviceListLocker(&d->lock);
-	for (DeviceMap::iterator it = d->devices.begin(); it != d->devices.end(); ++it) {
-		TelldusCore::MutexLocker deviceLocker(it->second);
-		if (!TelldusCore::comparei(it->second->getProtocolName(), msg.protocol())) {
-			continue;
+	//Replayed oldest first, so the sensors get their history back as well
+	TelldusCore::MutexLocker sensorListLocker(&d->lock);
+	time_t now = time(NULL);
+	SensorStore::Entry entry;
+	for (size_t i = 0; d->sensorStore.entry(i, &entry); ++i) {
+		std::string protocol(entry.protocol), model(entry.model);
+		Sensor *sensor = findSensor(protocol, model, entry.id);
+		if (!sensor) {
+			sensor = createSensor(protocol, model, entry.id, now);
 		}
-		if (! (it->second->getMethods() & msg.method())) {
+		TelldusCore::MutexLocker sensorLocker(sensor);
+		sensor->setValue(entry.value, entry.timestamp);
+	}
+	//Those that have timed out while the service was stopped
+	evictSensors(now, 0);
+	Log::notice("Loaded %i sensor values for %i sensors", (int)d->sensorStore.size(), (int)d->sensorList.size());
+}
+
+void DeviceManager::loadPinnedSensors() {
+	std::stringstream sensors(d->set.getSetting("pinnedSensors"));
+	std::string sensor;
+	while(std::getline(sensors, sensor, ',')) {
+		size_t start = sensor.find_first_not_of(" \t");
+		size_t end = sensor.find_last_not_of(" \t");
+		if (start == std::string::npos) {
 			continue;
 		}
+		sensor = sensor.substr(start, end-start+1);
 
-		std::list<std::string> parameters = it->second->getParametersForProtocol();
-		bool thisDevice = true;
-		for (std::list<std::string>::iterator paramIt = parameters.begin(); paramIt != parameters.end(); ++paramIt){
-			if(!TelldusCore::comparei(it->second->getParameter(TelldusCore::charToWstring((*paramIt).c_str())), TelldusCore::charToWstring(msg.getParameter(*paramIt).c_str()))){
-				thisDevice = false;
-				break;
-			}
+		//protocol:model:id
+		size_t first = sensor.find(':'), last = sensor.rfind(':');
+		if (first == std::string::npos || first == last) {
+			Log::warning("Ignoring malformed pinned sensor %s", sensor.c_str());
+			continue;
 		}
+		PinnedSensor pinned;
+		pinned.protocol = sensor.substr(0, first);
+		pinned.model = sensor.substr(first+1, last-first-1);
+		pinned.id = TelldusCore::charToInteger(sensor.substr(last+1).c_str());
+		d->pinnedSensors.push_back(pinned);
+	}
+}
 
-		if(!thisDevice){
+void DeviceManager::loadSensorEventPolicy() {
+	d->signalledSensorEvents = 0;
+	d->suppressedSensorEvents = 0;
+
+	const char *settings[] = { "sensorDeadbandTemperature", "sensorDeadbandHumidity" };
+	const int dataTypes[] = { TELLSTICK_TEMPERATURE, TELLSTICK_HUMIDITY };
+	for (int i = 0; i < 2; ++i) {
+		std::string text = d->set.getSetting(settings[i]);
+		if (text.length() == 0) {
+			continue;
+		}
+		int value, decimals;
+		if (!SensorRecord::parseValue(text, &value, &decimals)) {
+			Log::warning("Ignoring malformed deadband %s", text.c_str());
 			continue;
 		}
+		d->sensorEventPolicy.setDeadband(dataTypes[i], value, decimals);
+	}
+	d->sensorEventPolicy.setHeartbeat((int)sizeSetting(d->set, "sensorEventHeartbeat", 600));
+}
 
-		if (this->triggerDeviceStateChange(it->first, msg.method(), L"")) {
-			d->set.setDeviceState(it->first, msg.method(), L"");
-			it->second->setLastSentCommand(msg.method(), L"");
+Sensor *DeviceManager::createSensor(const std::string &protocol, const std::string &model, int id, time_t now) {
+	evictSensors(now, 1);
+	Sensor *sensor = new Sensor(protocol, model, id, d->sensorRetention);
+	for (size_t i = 0; i < d->pinnedSensors.size(); ++i) {
+		const PinnedSensor &pinned = d->pinnedSensors[i];
+		if (pinned.id == id && TelldusCore::comparei(pinned.protocol, protocol) && TelldusCore::comparei(pinned.model, model)) {
+			sensor->setPinned(true);
+			break;
 		}
 	}
+	d->sensorList.push_back(sensor);
+	return sensor;
 }
 
-void DeviceManager::handleSensorMessage(const ControllerMessage &msg) {
-	TelldusCore::MutexLocker sensorListLocker(&d->lock);
-	Sensor *sensor = 0;
-	for (std::list<Sensor *>::iterator it = d->sensorList.begin(); it != d->sensorList.end(); ++it) {
-		TelldusCore::MutexLocker sensorLocker(*it);
-		if (!TelldusCore::comparei((*it)->protocol(), msg.protocol())) {
-			continue;
+void DeviceManager::evictSensors(time_t now, size_t room) {
+	d->lastSensorSweep = now;
+
+	//First those not heard from within the timeout
+	std::list<Sensor *>::iterator oldest = d->sensorList.end();
+	time_t oldestTimestamp = 0;
+	for (std::list<Sensor *>::iterator it = d->sensorList.begin(); it != d->sensorList.end();) {
+		time_t timestamp;
+		{
+			TelldusCore::MutexLocker sensorLocker(*it);
+			if ((*it)->isPinned()) {
+				++it;
+				continue;
+			}
+			timestamp = (*it)->timestamp();
 		}
-		if (!TelldusCore::comparei((*it)->model(), msg.model())) {
+		if (d->sensorTimeout > 0 && now - timestamp > d->sensorTimeout) {
+			signalSensorEvicted(*it);
+			delete *it;
+			it = d->sensorList.erase(it);
 			continue;
 		}
-		if ((*it)->id() != msg.getIntParameter("id")) {
-			continue;
+		if (oldest == d->sensorList.end() || timestamp < oldestTimestamp) {
+			oldest = it;
+			oldestTimestamp = timestamp;
 		}
-		sensor = *it;
-		break;
+		++it;
 	}
 
-	if (!sensor) {
-		sensor = new Sensor(msg.protocol(), msg.model(), msg.getIntParameter("id"));
-		d->sensorList.push_back(sensor);
+	//Then the least recently heard until there is room. A sensor is only
+	//created for a new value, so this rarely needs more than one pass.
+	while (d->sensorCapacity > 0 && d->sensorList.size() + room > d->sensorCapacity) {
+		if (oldest == d->sensorList.end()) {
+			for (std::list<Sensor *>::iterator it = d->sensorList.begin(); it != d->sensorList.end(); ++it) {
+				TelldusCore::MutexLocker sensorLocker(*it);
+				if (!(*it)->isPinned() && (oldest == d->sensorList.end() || (*it)->timestamp() < oldestTimestamp)) {
+					oldest = it;
+					oldestTimestamp = (*it)->timestamp();
+				}
+			}
+			if (oldest == d->sensorList.end()) {
+				//All of them are pinned
+				break;
+			}
+		}
+		signalSensorEvicted(*oldest);
+		delete *oldest;
+		d->sensorList.erase(oldest);
+		oldest = d->sensorList.end();
 	}
-	TelldusCore::MutexLocker sensorLocker(sensor);
+}
 
-	time_t t = time(NULL);
+void DeviceManager::signalSensorEvicted(Sensor *sensor) const {
+	TelldusCore::MutexLocker sensorLocker(sensor);
+	Log::debug("Evicting sensor %s %s %i, %i events suppressed", sensor->protocol().c_str(), sensor->model().c_str(), sensor->id(), sensor->suppressed());
 
-	setSensorValueAndSignal("temp", TELLSTICK_TEMPERATURE, sensor, msg, t);
-	setSensorValueAndSignal("humidity", TELLSTICK_HUMIDITY, sensor, msg, t);
+	EventUpdateData *eventData = new EventUpdateData();
+	eventData->messageType = "TDSensorChangeEvent";
+	eventData->protocol = sensor->protocol();
+	eventData->model = sensor->model();
+	eventData->sensorId = sensor->id();
+	eventData->eventState = TELLSTICK_DEVICE_REMOVED;
+	d->deviceUpdateEvent->signal(eventData);
 }
 
-void DeviceManager::setSensorValueAndSignal( const std::string &dataType, int dataTypeId, Sensor *sensor, const ControllerMessage &msg, time_t timestamp) const {
-	if (!msg.hasParameter(dataType)) {
+void DeviceManager::setSensorValueAndSignal( const SensorRecord::Value &value, Sensor *sensor, time_t timestamp) const {
+	sensor->setValue(value, timestamp);
+	if (!d->sensorEventPolicy.shouldSignal(sensor->lastSignalled(value.dataType), value, timestamp)) {
+		sensor->countSuppressed();
+		++d->suppressedSensorEvents;
 		return;
 	}
-	sensor->setValue(dataTypeId, msg.getParameter(dataType), timestamp);
+	sensor->setSignalled(value, timestamp);
+	++d->signalledSensorEvents;
 
 	EventUpdateData *eventData = new EventUpdateData();
-	eventData->messageType = L"TDSensorEvent";
+	eventData->messageType = "TDSensorEvent";
 	eventData->protocol = sensor->protocol();
 	eventData->model = sensor->model();
 	eventData->sensorId = sensor->id();
-	eventData->dataType = dataTypeId;
-	eventData->value = TelldusCore::charToWstring(sensor->value(dataTypeId).c_str());
+	eventData->dataType = value.dataType;
+	eventData->value = SensorRecord::formatValue(value.value, value.decimals);
 	eventData->timestamp = (int)timestamp;
 	d->deviceUpdateEvent->signal(eventData);
 }
 
-int DeviceManager::sendRawCommand(const std::wstring &command, int reserved){
+int DeviceManager::sendRawCommand(const std::string &command, int reserved){
 
 	Controller *controller = d->controllerManager->getBestControllerById(-1);
 
-	if(!controller){
+	if(!controller && !d->controllerManager->isHotplugMonitored()){
 		//no controller found, scan for one, and retry once
 		d->controllerManager->loadControllers();
 		controller = d->controllerManager->getBestControllerById(-1);
@@ -750,7 +1239,7 @@ int DeviceManager::sendRawCommand(const std::wstring &command, int reserved){
 
 	int retval = TELLSTICK_ERROR_UNKNOWN;
 	if(controller){
-		retval = controller->send(TelldusCore::wideToString(command));
+		retval = controller->send(command);
 		if(retval == TELLSTICK_ERROR_BROKEN_PIPE){
 			d->controllerManager->resetController(controller);
 		}
@@ -760,7 +1249,7 @@ int DeviceManager::sendRawCommand(const std::wstring &command, int reserved){
 			if(!controller){
 				return TELLSTICK_ERROR_NOT_FOUND;
 			}
-			retval = controller->send(TelldusCore::wideToString(command));  //retry one more time
+			retval = controller->send(command);  //retry one more time
 		}
 		return retval;
 	} else {
@@ -768,13 +1257,13 @@ int DeviceManager::sendRawCommand(const std::wstring &command, int reserved){
 	}
 }
 
-bool DeviceManager::triggerDeviceStateChange(int deviceId, int intDeviceState, const std::wstring &strDeviceStateValue ) {
+bool DeviceManager::triggerDeviceStateChange(int deviceId, int intDeviceState, const std::string &strDeviceStateValue ) {
 	if ( intDeviceState == TELLSTICK_BELL || intDeviceState == TELLSTICK_LEARN || intDeviceState == TELLSTICK_EXECUTE) {
 		return false;
 	}
 
 	EventUpdateData *eventData = new EventUpdateData();
-	eventData->messageType = L"TDDeviceEvent";
+	eventData->messageType = "TDDeviceEvent";
 	eventData->eventState = intDeviceState;
 	eventData->deviceId = deviceId;
 	eventData->eventValue = strDeviceStateValue;
@@ -4,8 +4,10 @@
 #include "Device.h"
 #include "ControllerManager.h"
 #include "ControllerMessage.h"
+#include "SensorRecord.h"
 #include "EventUpdateManager.h"
 #include <set>
+#include <vector>
 
 class Sensor;
 
@@ -20,36 +22,54 @@ public:
 	void disconnectTellStickController(int vid, int pid, const std::string &serial);
 	int getDeviceId(int deviceIndex);
 	int getDeviceLastSentCommand(int deviceId, int methodsSupported);
-	int setDeviceLastSentCommand(int deviceId, int command, const std::wstring &value);
+	int setDeviceLastSentCommand(int deviceId, int command, const std::string &value);
 	int getDeviceMethods(int deviceId);
 	int getDeviceMethods(int deviceId, int methodsSupported);
-	std::wstring getDeviceModel(int deviceId);
-	int setDeviceModel(int deviceId, const std::wstring &model);
-	std::wstring getDeviceName(int deviceId);
-	int setDeviceName(int deviceId, const std::wstring &name);
-	std::wstring getDeviceParameter(int deviceId, const std::wstring &name, const std::wstring &defauleValue);
-	int setDeviceParameter(int deviceId, const std::wstring &name, const std::wstring &value);
-	std::wstring getDeviceProtocol(int deviceId);
-	int setDeviceProtocol(int deviceId, const std::wstring &name);
-	std::wstring getDeviceStateValue(int deviceId);
+	std::string getDeviceModel(int deviceId);
+	int setDeviceModel(int deviceId, const std::string &model);
+	std::string getDeviceName(int deviceId);
+	int setDeviceName(int deviceId, const std::string &name);
+	std::string getDeviceParameter(int deviceId, const std::string &name, const std::string &defauleValue);
+	int setDeviceParameter(int deviceId, const std::string &name, const std::string &value);
+	std::string getDeviceProtocol(int deviceId);
+	int setDeviceProtocol(int deviceId, const std::string &name);
+	std::string getDeviceStateValue(int deviceId);
 	int getDeviceType(int deviceId);
 	int getPreferredControllerId(int deviceId);
 	int doAction(int deviceId, int action, unsigned char data);
 	int removeDevice(int deviceId);
-	int sendRawCommand(const std::wstring &command, int reserved);
+	int sendRawCommand(const std::string &command, int reserved);
 
-	std::wstring getSensors() const;
-	std::wstring getSensorValue(const std::wstring &protocol, const std::wstring &model, int id, int dataType) const;
+	std::string getSensors() const;
+	std::string getSensorSnapshot() const;
+	std::string getSensorValue(const std::string &protocol, const std::string &model, int id, int dataType) const;
+	std::string getSensorHistory(const std::string &protocol, const std::string &model, int id, int dataType, time_t from, time_t to) const;
+	std::string getSensorRollup(const std::string &protocol, const std::string &model, int id, int dataType, int resolution, time_t from, time_t to) const;
 
 	void handleControllerMessage(const ControllerEventData &event);
 
 private:
-	void handleSensorMessage(const ControllerMessage &msg);
-	void setSensorValueAndSignal( const std::string &dataType, int dataTypeId, Sensor *sensor, const ControllerMessage &msg, time_t timestamp) const;
+	Sensor *findSensor(const std::string &protocol, const std::string &model, int id) const;
+	void handleSensorMessage(const SensorRecord &record);
+	void loadSensorStore();
+	void loadPinnedSensors();
+	void loadSensorEventPolicy();
+	Sensor *createSensor(const std::string &protocol, const std::string &model, int id, time_t now);
+	void evictSensors(time_t now, size_t room);
+	void signalSensorEvicted(Sensor *sensor) const;
+	void setSensorValueAndSignal( const SensorRecord::Value &value, Sensor *sensor, time_t timestamp) const;
+	bool deviceMatchesMessage(Device *device, const ControllerMessage &msg) const;
+	void signalRawDeviceEvent(int controllerId, const std::string &message) const;
 	int getDeviceMethods(int deviceId, std::set<int> &duplicateDeviceIds);
-	int doGroupAction(const std::wstring deviceIds, int action, unsigned char data, const int type, int groupDeviceId, std::set<int> *duplicateDeviceIds);
-	int executeScene(std::wstring singledevice, int groupDeviceId);
-	bool triggerDeviceStateChange(int deviceId, int intDeviceState, const std::wstring &strDeviceStateValue );
+	class PendingAction;
+	void startDeviceAction(PendingAction *pending);
+	void waitForDeviceAction(PendingAction *pending);
+	int finishDeviceAction(PendingAction *pending, std::set<Controller *> *resetControllers);
+	void finishGroupActions(std::vector<PendingAction> *members, size_t first, size_t last);
+	int doGroupAction(const std::string deviceIds, int action, unsigned char data, const int type, int groupDeviceId, std::set<int> *duplicateDeviceIds);
+	void collectGroupActions(const std::string &deviceIds, int action, unsigned char data, int type, int groupDeviceId, std::set<int> *duplicateDeviceIds, std::vector<PendingAction> *members);
+	PendingAction sceneAction(const std::string &singledevice, int groupDeviceId);
+	bool triggerDeviceStateChange(int deviceId, int intDeviceState, const std::string &strDeviceStateValue );
 	void fillDevices(void);
 
 	class PrivateData;
@@ -25,7 +25,7 @@ EventUpdateManager::EventUpdateManager()
 	d->stopEvent = d->eventHandler.addEvent();
 	d->updateEvent = d->eventHandler.addEvent();
 	d->clientConnectEvent = d->eventHandler.addEvent();
-	d->eventUpdateClientListener = new ConnectionListener(L"TelldusEvents", d->clientConnectEvent);
+	d->eventUpdateClientListener = new ConnectionListener("TelldusEvents", d->clientConnectEvent);
 }
 
 EventUpdateManager::~EventUpdateManager(void) {
@@ -79,24 +79,24 @@ void EventUpdateManager::sendMessageToClients(EventUpdateData *data){
 			connected++;
 			TelldusCore::Message msg;
 
-			if(data->messageType == L"TDDeviceEvent"){
+			if(data->messageType == "TDDeviceEvent"){
 				msg.addArgument("TDDeviceEvent");
 				msg.addArgument(data->deviceId);
 				msg.addArgument(data->eventState);
 				msg.addArgument(data->eventValue);	//string
 			}
-			else if(data->messageType == L"TDDeviceChangeEvent"){
+			else if(data->messageType == "TDDeviceChangeEvent"){
 				msg.addArgument("TDDeviceChangeEvent");
 				msg.addArgument(data->deviceId);
 				msg.addArgument(data->eventDeviceChanges);
 				msg.addArgument(data->eventChangeType);
 			}
-			else if(data->messageType == L"TDRawDeviceEvent"){
+			else if(data->messageType == "TDRawDeviceEvent"){
 				msg.addArgument("TDRawDeviceEvent");
 				msg.addArgument(data->eventValue);	//string
 				msg.addArgument(data->controllerId);
 			}
-			else if(data->messageType == L"TDSensorEvent"){
+			else if(data->messageType == "TDSensorEvent"){
 				msg.addArgument("TDSensorEvent");
 				msg.addArgument(data->protocol);
 				msg.addArgument(data->model);
@@ -105,13 +105,20 @@ void EventUpdateManager::sendMessageToClients(EventUpdateData *data){
 				msg.addArgument(data->value);
 				msg.addArgument(data->timestamp);
 			}
-			else if(data->messageType == L"TDControllerEvent") {
+			else if(data->messageType == "TDControllerEvent") {
 				msg.addArgument("TDControllerEvent");
 				msg.addArgument(data->controllerId);
 				msg.addArgument(data->eventState);
 				msg.addArgument(data->eventChangeType);
 				msg.addArgument(data->eventValue);
 			}
+			else if(data->messageType == "TDSensorChangeEvent") {
+				msg.addArgument("TDSensorChangeEvent");
+				msg.addArgument(data->protocol);
+				msg.addArgument(data->model);
+				msg.addArgument(data->sensorId);
+				msg.addArgument(data->eventState);
+			}
 
 			(*it)->write(msg);
 
@@ -6,20 +6,20 @@
 
 class EventUpdateData : public TelldusCore::EventDataBase {
 public:
-	std::wstring messageType;
+	std::string messageType;
 	int controllerId;
 	int deviceId;
 	int eventChangeType;
 	int eventDeviceChanges;
 	int eventState;
-	std::wstring eventValue;
+	std::string eventValue;
 
 	//Sensor event
-	std::wstring protocol;
-	std::wstring model;
+	std::string protocol;
+	std::string model;
 	int sensorId;
 	int dataType;
-	std::wstring value;
+	std::string value;
 	int timestamp;
 };
 
@@ -1,34 +1,140 @@
 #include "Log.h"
+#include "Atomic.h"
+#include "LogBuffer.h"
+#include "LogRateLimiter.h"
+#include "Strings.h"
+#include "Thread.h"
+#include "common.h"
 #include <stdarg.h>
+#include <time.h>
+#include <vector>
 
 #if defined(_LINUX)
 #include <syslog.h>
 #elif defined(_WINDOWS)
 #include <windows.h>
-#include "Strings.h"
 #include "Messages.h"
 #endif
 
+namespace {
+	const size_t QUEUE_SIZE = 256;
+	//Each call site may log this many messages per interval, in seconds
+	const int RATE_BURST = 10;
+	const int RATE_INTERVAL = 10;
+	//How long the writer sleeps when the queue is empty, in ms
+	const int WRITER_IDLE_TIME = 50;
+}
+
 class Log::PrivateData {
 public:
-	PrivateData() : logOutput(Log::System), debug(false) {}
+	PrivateData()
+		:logOutput(Log::System), level(Log::Notice), asynchronous(false), pushing(0),
+		buffer(QUEUE_SIZE), limiter(RATE_BURST, RATE_INTERVAL), lastSummary(0), writer(0)
+	{}
 
 	Log::LogOutput logOutput;
-	bool debug;
+	volatile int level;
+	volatile bool asynchronous;
+	//The threads in message() that may still push to the buffer
+	volatile long pushing;
+	LogBuffer buffer;
+	LogRateLimiter limiter;
+	volatile long lastSummary;
+	Log::Writer *writer;
 
 	static Log *instance;
 #ifdef _WINDOWS
 	HANDLE eventSource;
 #endif
+
+	bool writeQueued();
+	void writeSummaries(time_t now, bool force);
+	void write(int logLevel, const char *message) const;
+	void stopWriter();
+};
+
+class Log::Writer : public TelldusCore::Thread {
+public:
+	Writer(Log::PrivateData *data) : TelldusCore::Thread(), d(data), running(true) {}
+	virtual ~Writer() {}
+
+	void stop() {
+		running = false;
+	}
+
+protected:
+	void run() {
+		while (running) {
+			bool written = d->writeQueued();
+			d->writeSummaries(time(NULL), false);
+			if (!written) {
+				msleep(WRITER_IDLE_TIME);
+			}
+		}
+	}
+
+private:
+	Log::PrivateData *d;
+	volatile bool running;
 };
 
 Log *Log::PrivateData::instance = 0;
 
+bool Log::PrivateData::writeQueued() {
+	LogBuffer::Entry entry;
+	bool written = false;
+	while (buffer.pop(&entry)) {
+		write(entry.level, entry.message);
+		written = true;
+	}
+	return written;
+}
+
+void Log::PrivateData::writeSummaries(time_t now, bool force) {
+	long last = lastSummary;
+	if (!force && now - last < RATE_INTERVAL) {
+		return;
+	}
+	if (Atomic::compareAndSwap(&lastSummary, last, (long)now) != last) {
+		//Another thread got there first
+		return;
+	}
+	std::vector<LogRateLimiter::Suppressed> suppressed;
+	limiter.takeSuppressed(&suppressed);
+	for (size_t i = 0; i < suppressed.size(); ++i) {
+		write(suppressed[i].level, TelldusCore::formatf("%li messages like \"%s\" were suppressed", suppressed[i].count, suppressed[i].format).c_str());
+	}
+	long dropped = buffer.takeDropped();
+	if (dropped > 0) {
+		write(Log::Warning, TelldusCore::formatf("%li messages were dropped, the log queue was full", dropped).c_str());
+	}
+}
+
+void Log::PrivateData::stopWriter() {
+	if (!writer) {
+		return;
+	}
+	asynchronous = false;
+	Atomic::memoryBarrier();
+	writer->stop();
+	writer->wait();
+	delete writer;
+	writer = 0;
+	//Whatever was pushed while it stopped. A thread that saw asynchronous
+	//before it was cleared may not have finished its push yet.
+	while (Atomic::add(&pushing, 0) > 0) {
+		writeQueued();
+		msleep(1);
+	}
+	writeQueued();
+}
+
 Log::Log()
 	:d(new PrivateData)
 {
 #if defined(_LINUX)
-	setlogmask(LOG_UPTO(LOG_INFO));
+	//Filtered by the level in message(), so --debug reaches syslog too
+	setlogmask(LOG_UPTO(LOG_DEBUG));
 	openlog("telldusd", LOG_CONS, LOG_USER);
 #elif defined(_MACOSX)
 	d->logOutput = Log::StdOut;
@@ -57,6 +163,8 @@ Log::Log()
 }
 
 Log::~Log() {
+	d->stopWriter();
+	d->writeSummaries(time(NULL), true);
 #if defined(_LINUX)
 	closelog();
 #elif defined(_WINDOWS)
@@ -108,11 +216,20 @@ void Log::error(const char *fmt, ...) {
 }
 
 void Log::setDebug() {
-	Log *log = Log::instance();
-	log->d->debug = true;
+	Log::setLevel(Debug);
 	Log::debug("Debug message output enabled");
 }
 
+void Log::setLevel(LogLevel logLevel) {
+	Log *log = Log::instance();
+	log->d->level = logLevel;
+}
+
+Log::LogLevel Log::level() {
+	Log *log = Log::instance();
+	return (LogLevel)log->d->level;
+}
+
 void Log::setLogOutput(LogOutput logOutput) {
 #ifdef _MACOSX
 	//Always stdout
@@ -122,51 +239,84 @@ void Log::setLogOutput(LogOutput logOutput) {
 	log->d->logOutput = logOutput;
 }
 
+void Log::setAsynchronous(bool asynchronous) {
+	Log *log = Log::instance();
+	if (!asynchronous) {
+		log->d->stopWriter();
+		log->d->writeSummaries(time(NULL), true);
+		return;
+	}
+	if (log->d->writer) {
+		return;
+	}
+	log->d->writer = new Writer(log->d);
+	log->d->writer->start();
+	log->d->asynchronous = true;
+}
+
 void Log::message(Log::LogLevel logLevel, const char *format, va_list ap) const {
-	if (logLevel == Debug && d->debug == false) {
+	if (logLevel < d->level) {
 		return;
 	}
-	if (d->logOutput == StdOut) {
+	time_t now = time(NULL);
+	if (!d->limiter.allow(format, logLevel, now)) {
+		return;
+	}
+	if (d->asynchronous) {
+		Atomic::add(&d->pushing, 1);
+		//Checked again, stopWriter() may have cleared it and drained already
+		if (d->asynchronous) {
+			d->buffer.push(logLevel, format, ap);
+			Atomic::add(&d->pushing, -1);
+			return;
+		}
+		Atomic::add(&d->pushing, -1);
+	}
+	d->writeSummaries(now, false);
+	d->write(logLevel, TelldusCore::sformatf(format, ap).c_str());
+}
+
+void Log::PrivateData::write(int logLevel, const char *message) const {
+	if (logOutput == Log::StdOut) {
 		FILE *stream = stdout;
-		if (logLevel == Warning || logLevel == Error) {
+		if (logLevel == Log::Warning || logLevel == Log::Error) {
 			stream = stderr;
 		}
-		vfprintf(stream, format, ap);
-		fprintf(stream, "\n");
+		fprintf(stream, "%s\n", message);
 		fflush(stream);
 	} else {
 #if defined(_LINUX)
 		switch (logLevel) {
-			case Debug:
-				vsyslog(LOG_DEBUG, format, ap);
+			case Log::Debug:
+				syslog(LOG_DEBUG, "%s", message);
 				break;
-			case Notice:
-				vsyslog(LOG_NOTICE, format, ap);
+			case Log::Notice:
+				syslog(LOG_NOTICE, "%s", message);
 				break;
-			case Warning:
-				vsyslog(LOG_WARNING, format, ap);
+			case Log::Warning:
+				syslog(LOG_WARNING, "%s", message);
 				break;
-			case Error:
-				vsyslog(LOG_ERR, format, ap);
+			case Log::Error:
+				syslog(LOG_ERR, "%s", message);
 				break;
 		}
 #elif defined(_WINDOWS)
 		LPWSTR pInsertStrings[2] = {NULL, NULL};
-		std::wstring str = TelldusCore::charToWstring(TelldusCore::sformatf(format, ap).c_str());
+		std::wstring str = TelldusCore::charToWstring(message);
 		pInsertStrings[0] = (LPWSTR)str.c_str();
 
 		switch (logLevel) {
-			case Debug:
-				ReportEvent(d->eventSource, EVENTLOG_SUCCESS, NULL, LOG_DEBUG, NULL, 1, 0, (LPCWSTR*)pInsertStrings, NULL);
+			case Log::Debug:
+				ReportEvent(eventSource, EVENTLOG_SUCCESS, NULL, LOG_DEBUG, NULL, 1, 0, (LPCWSTR*)pInsertStrings, NULL);
 				break;
-			case Notice:
-				ReportEvent(d->eventSource, EVENTLOG_INFORMATION_TYPE, NULL, LOG_NOTICE, NULL, 1, 0, (LPCWSTR*)pInsertStrings, NULL);
+			case Log::Notice:
+				ReportEvent(eventSource, EVENTLOG_INFORMATION_TYPE, NULL, LOG_NOTICE, NULL, 1, 0, (LPCWSTR*)pInsertStrings, NULL);
 				break;
-			case Warning:
-				ReportEvent(d->eventSource, EVENTLOG_WARNING_TYPE, NULL, LOG_WARNING, NULL, 1, 0, (LPCWSTR*)pInsertStrings, NULL);
+			case Log::Warning:
+				ReportEvent(eventSource, EVENTLOG_WARNING_TYPE, NULL, LOG_WARNING, NULL, 1, 0, (LPCWSTR*)pInsertStrings, NULL);
 				break;
-			case Error:
-				ReportEvent(d->eventSource, EVENTLOG_ERROR_TYPE, NULL, LOG_ERR, NULL, 1, 0, (LPCWSTR*)pInsertStrings, NULL);
+			case Log::Error:
+				ReportEvent(eventSource, EVENTLOG_ERROR_TYPE, NULL, LOG_ERR, NULL, 1, 0, (LPCWSTR*)pInsertStrings, NULL);
 				break;
 		}
 #endif
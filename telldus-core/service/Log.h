@@ -18,8 +18,19 @@ public:
 	static void error(const char *fmt, ...);
 
 	static void setDebug();
+	static void setLevel(LogLevel logLevel);
+	static LogLevel level();
 	static void setLogOutput(LogOutput logOutput);
 
+	/**
+	 * When enabled the messages are queued and written by a background
+	 * thread, so logging never waits for syslog. Queued messages are cut
+	 * at LogBuffer::MESSAGE_SIZE (256) bytes, including the terminating
+	 * NUL. Disabling it writes what is left in the queue. Not to be
+	 * enabled before forking.
+	 */
+	static void setAsynchronous(bool asynchronous);
+
 protected:
 	Log();
 	void message(LogLevel logLevel, const char *format, va_list ap) const;
@@ -27,6 +38,7 @@ protected:
 
 private:
 	class PrivateData;
+	class Writer;
 	PrivateData *d;
 };
 
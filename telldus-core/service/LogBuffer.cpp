@@ -0,0 +1,105 @@
+#include "LogBuffer.h"
+#include "Atomic.h"
+#include <stdio.h>
+
+namespace {
+	//A slot is free for the push at position n when its sequence is n and
+	//holds a message for the pop at position n when its sequence is n+1
+	class Cell {
+	public:
+		volatile long sequence;
+		LogBuffer::Entry entry;
+	};
+
+	//Keeps the positions pushed and popped on their own cache lines
+	const size_t CACHE_LINE = 64;
+}
+
+class LogBuffer::PrivateData {
+public:
+	Cell *cells;
+	unsigned long mask;
+	char pad0[CACHE_LINE];
+	volatile long pushPosition;
+	char pad1[CACHE_LINE];
+	volatile long popPosition;
+	char pad2[CACHE_LINE];
+	volatile long dropped;
+};
+
+LogBuffer::LogBuffer(size_t capacity) {
+	d = new PrivateData;
+	size_t size = 2;
+	while (size < capacity) {
+		size *= 2;
+	}
+	d->cells = new Cell[size];
+	for (size_t i = 0; i < size; ++i) {
+		d->cells[i].sequence = (long)i;
+	}
+	d->mask = (unsigned long)size - 1;
+	d->pushPosition = 0;
+	d->popPosition = 0;
+	d->dropped = 0;
+}
+
+LogBuffer::~LogBuffer() {
+	delete[] d->cells;
+	delete d;
+}
+
+size_t LogBuffer::capacity() const {
+	return d->mask + 1;
+}
+
+bool LogBuffer::push(int level, const char *format, va_list ap) {
+	long position = d->pushPosition;
+	Cell *cell;
+	while (true) {
+		cell = &d->cells[(unsigned long)position & d->mask];
+		long sequence = cell->sequence;
+		Atomic::memoryBarrier();
+		long difference = Atomic::difference(sequence, position);
+		if (difference == 0) {
+			//Free, try to claim it
+			long previous = Atomic::compareAndSwap(&d->pushPosition, position, Atomic::increment(position, 1));
+			if (previous == position) {
+				break;
+			}
+			position = previous;
+		} else if (difference < 0) {
+			//Not popped yet, the queue is full
+			Atomic::add(&d->dropped, 1);
+			return false;
+		} else {
+			//Claimed by another thread
+			position = d->pushPosition;
+		}
+	}
+	cell->entry.level = level;
+	vsnprintf(cell->entry.message, MESSAGE_SIZE, format, ap);
+	cell->entry.message[MESSAGE_SIZE-1] = 0;
+	Atomic::memoryBarrier();
+	cell->sequence = Atomic::increment(position, 1);
+	return true;
+}
+
+bool LogBuffer::pop(Entry *entry) {
+	long position = d->popPosition;
+	Cell *cell = &d->cells[(unsigned long)position & d->mask];
+	long sequence = cell->sequence;
+	Atomic::memoryBarrier();
+	if (Atomic::difference(sequence, Atomic::increment(position, 1)) < 0) {
+		//Empty, or the message is still being written
+		return false;
+	}
+	*entry = cell->entry;
+	Atomic::memoryBarrier();
+	cell->sequence = Atomic::increment(position, d->mask + 1);
+	d->popPosition = Atomic::increment(position, 1);
+	return true;
+}
+
+long LogBuffer::takeDropped() {
+	return Atomic::exchange(&d->dropped, 0);
+}
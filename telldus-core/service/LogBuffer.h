@@ -0,0 +1,45 @@
+#ifndef LOGBUFFER_H
+#define LOGBUFFER_H
+
+#include <stdarg.h>
+#include <stddef.h>
+
+/**
+ * A fixed size queue of formatted log messages.
+ *
+ * Any number of threads may push messages without taking a lock, one
+ * thread pops them. A message is formatted straight into its slot and
+ * truncated to MESSAGE_SIZE. When the queue is full the message is dropped
+ * and counted instead of waiting for room.
+ */
+class LogBuffer
+{
+public:
+	enum { MESSAGE_SIZE = 256 };
+
+	class Entry {
+	public:
+		int level;
+		char message[MESSAGE_SIZE];
+	};
+
+	//The capacity is rounded up to a power of two
+	LogBuffer(size_t capacity);
+	~LogBuffer();
+
+	size_t capacity() const;
+
+	bool push(int level, const char *format, va_list ap);
+
+	//Only one thread at a time may pop
+	bool pop(Entry *entry);
+
+	//The number of messages dropped since the last call
+	long takeDropped();
+
+private:
+	class PrivateData;
+	PrivateData *d;
+};
+
+#endif // LOGBUFFER_H
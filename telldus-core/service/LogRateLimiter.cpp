@@ -0,0 +1,90 @@
+#include "LogRateLimiter.h"
+#include "Atomic.h"
+#include <stddef.h>
+
+namespace {
+	const size_t NUMBER_OF_SITES = 128;
+
+	class Site {
+	public:
+		void * volatile format;
+		volatile long level, window, count, suppressed;
+	};
+}
+
+class LogRateLimiter::PrivateData {
+public:
+	Site sites[NUMBER_OF_SITES];
+	long burst, interval;
+};
+
+LogRateLimiter::LogRateLimiter(int burst, int interval) {
+	d = new PrivateData;
+	for (size_t i = 0; i < NUMBER_OF_SITES; ++i) {
+		d->sites[i].format = 0;
+		d->sites[i].level = 0;
+		d->sites[i].window = 0;
+		d->sites[i].count = 0;
+		d->sites[i].suppressed = 0;
+	}
+	d->burst = burst;
+	d->interval = (interval > 0 ? interval : 1);
+}
+
+LogRateLimiter::~LogRateLimiter() {
+	delete d;
+}
+
+bool LogRateLimiter::allow(const char *format, int level, time_t now) {
+	if (!format) {
+		return true;
+	}
+	void *key = const_cast<char *>(format);
+	size_t start = (reinterpret_cast<size_t>(format) >> 3) % NUMBER_OF_SITES;
+	for (size_t i = 0; i < NUMBER_OF_SITES; ++i) {
+		Site &site = d->sites[(start + i) % NUMBER_OF_SITES];
+		void *current = site.format;
+		if (!current) {
+			current = Atomic::compareAndSwapPointer(&site.format, 0, key);
+			if (!current) {
+				site.level = level;
+				current = key;
+			}
+		}
+		if (current != key) {
+			continue;
+		}
+
+		//The thread that moves the site to a new window starts the count over
+		long window = (long)(now / d->interval);
+		long previous = site.window;
+		if (previous != window && Atomic::compareAndSwap(&site.window, previous, window) == previous) {
+			Atomic::exchange(&site.count, 0);
+		}
+		if (Atomic::add(&site.count, 1) <= d->burst) {
+			return true;
+		}
+		Atomic::add(&site.suppressed, 1);
+		return false;
+	}
+	//No room for another site
+	return true;
+}
+
+void LogRateLimiter::takeSuppressed(std::vector<Suppressed> *suppressed) {
+	for (size_t i = 0; i < NUMBER_OF_SITES; ++i) {
+		Site &site = d->sites[i];
+		if (!site.format) {
+			continue;
+		}
+		long count = Atomic::exchange(&site.suppressed, 0);
+		if (count <= 0) {
+			continue;
+		}
+		Suppressed entry;
+		entry.format = reinterpret_cast<const char *>(site.format);
+		entry.level = (int)site.level;
+		entry.count = count;
+		suppressed->push_back(entry);
+	}
+}
@@ -0,0 +1,38 @@
+#ifndef LOGRATELIMITER_H
+#define LOGRATELIMITER_H
+
+#include <time.h>
+#include <vector>
+
+/**
+ * Limits how often the same call site may log.
+ *
+ * A call site is identified by its format string. Each site may log burst
+ * messages per interval seconds, the rest are counted as suppressed. Any
+ * thread may ask without taking a lock. Sites are kept in a fixed table,
+ * once it is full new sites are not limited.
+ */
+class LogRateLimiter
+{
+public:
+	class Suppressed {
+	public:
+		const char *format;
+		int level;
+		long count;
+	};
+
+	LogRateLimiter(int burst, int interval);
+	~LogRateLimiter();
+
+	bool allow(const char *format, int level, time_t now);
+
+	//Appends the sites with messages suppressed since the last call
+	void takeSuppressed(std::vector<Suppressed> *suppressed);
+
+private:
+	class PrivateData;
+	PrivateData *d;
+};
+
+#endif // LOGRATELIMITER_H
@@ -0,0 +1,238 @@
+#include "NetworkConnection.h"
+#include "Mutex.h"
+
+#include <list>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WINDOWS
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET NET_SOCKET_T;
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+typedef int NET_SOCKET_T;
+#define INVALID_SOCKET -1
+#define SD_BOTH SHUT_RDWR
+#define closesocket ::close
+#endif
+
+#ifdef MSG_NOSIGNAL
+const int SEND_FLAGS = MSG_NOSIGNAL; //A lost connection shouldn't kill us with SIGPIPE
+#else
+const int SEND_FLAGS = 0;
+#endif
+
+class NetworkConnection::PrivateData {
+public:
+	NET_SOCKET_T socket;
+	//Writes in progress, and the sockets closed meanwhile that they may still use
+	int writers;
+	std::list<NET_SOCKET_T> closed;
+	TelldusCore::Mutex mutex;
+};
+
+namespace {
+	void setBlocking(NET_SOCKET_T socket, bool blocking) {
+#ifdef _WINDOWS
+		u_long mode = (blocking ? 0 : 1);
+		ioctlsocket(socket, FIONBIO, &mode);
+#else
+		int flags = fcntl(socket, F_GETFL, 0);
+		fcntl(socket, F_SETFL, (blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK));
+#endif
+	}
+
+	bool waitFor(NET_SOCKET_T socket, bool forWriting, int timeout) {
+		fd_set fds;
+		FD_ZERO(&fds);
+		FD_SET(socket, &fds);
+		struct timeval tv;
+		tv.tv_sec = timeout/1000;
+		tv.tv_usec = (timeout%1000)*1000;
+		int ret = select((int)socket+1, (forWriting ? NULL : &fds), (forWriting ? &fds : NULL), NULL, &tv);
+		return (ret > 0);
+	}
+
+	bool wouldBlock() {
+#ifdef _WINDOWS
+		return (WSAGetLastError() == WSAEWOULDBLOCK);
+#else
+		return (errno == EAGAIN || errno == EWOULDBLOCK);
+#endif
+	}
+}
+
+NetworkConnection::NetworkConnection() {
+	d = new PrivateData;
+	d->socket = INVALID_SOCKET;
+	d->writers = 0;
+#ifdef _WINDOWS
+	WSADATA wsaData;
+	WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+}
+
+NetworkConnection::~NetworkConnection() {
+	close();
+#ifdef _WINDOWS
+	WSACleanup();
+#endif
+	delete d;
+}
+
+bool NetworkConnection::connect(const std::string &host, int port, int timeout) {
+	close();
+
+	struct addrinfo hints, *addresses;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	char service[16];
+	sprintf(service, "%i", port);
+	if (getaddrinfo(host.c_str(), service, &hints, &addresses) != 0) {
+		return false;
+	}
+
+	NET_SOCKET_T s = INVALID_SOCKET;
+	for(struct addrinfo *it = addresses; it != NULL; it = it->ai_next) {
+		s = socket(it->ai_family, it->ai_socktype, it->ai_protocol);
+		if (s == INVALID_SOCKET) {
+			continue;
+		}
+		//Connect without blocking so an unreachable host doesn't hold us for minutes
+		setBlocking(s, false);
+		if (::connect(s, it->ai_addr, (int)it->ai_addrlen) == 0) {
+			break;
+		}
+		if (waitFor(s, true, timeout)) {
+			int error = 0;
+			socklen_t length = sizeof(error);
+			getsockopt(s, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&error), &length);
+			if (error == 0) {
+				break;
+			}
+		}
+		closesocket(s);
+		s = INVALID_SOCKET;
+	}
+	freeaddrinfo(addresses);
+	if (s == INVALID_SOCKET) {
+		return false;
+	}
+
+	//Left non-blocking, reads and writes wait with select() so neither can hang on a stalled bridge
+	//Commands are small and latency matters more than throughput
+	int noDelay = 1;
+	setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char *>(&noDelay), sizeof(noDelay));
+#ifdef SO_NOSIGPIPE
+	int noSigPipe = 1;
+	setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+
+	TelldusCore::MutexLocker locker(&d->mutex);
+	d->socket = s;
+	return true;
+}
+
+void NetworkConnection::close() {
+	TelldusCore::MutexLocker locker(&d->mutex);
+	if (d->socket == INVALID_SOCKET) {
+		return;
+	}
+	if (d->writers > 0) {
+		//Wake the writers up, the last one to finish closes the socket
+		shutdown(d->socket, SD_BOTH);
+		d->closed.push_back(d->socket);
+	} else {
+		closesocket(d->socket);
+	}
+	d->socket = INVALID_SOCKET;
+}
+
+bool NetworkConnection::isConnected() const {
+	TelldusCore::MutexLocker locker(&d->mutex);
+	return (d->socket != INVALID_SOCKET);
+}
+
+int NetworkConnection::read(char *buffer, size_t size, int timeout) {
+	NET_SOCKET_T s;
+	{
+		TelldusCore::MutexLocker locker(&d->mutex);
+		s = d->socket;
+	}
+	if (s == INVALID_SOCKET) {
+		return -1;
+	}
+	if (!waitFor(s, false, timeout)) {
+		return 0;
+	}
+	int ret = recv(s, buffer, (int)size, 0);
+	if (ret < 0 && wouldBlock()) {
+		return 0;
+	}
+	if (ret <= 0) {
+		//Zero bytes from a readable socket means the other end closed it
+		return -1;
+	}
+	return ret;
+}
+
+bool NetworkConnection::write(const char *data, size_t length, int timeout) {
+	NET_SOCKET_T s;
+	{
+		//Don't hold the lock while sending, close() must not wait for a stalled bridge
+		TelldusCore::MutexLocker locker(&d->mutex);
+		if (d->socket == INVALID_SOCKET) {
+			return false;
+		}
+		s = d->socket;
+		++d->writers;
+	}
+	bool retval = true;
+	while (length > 0) {
+		if (!waitFor(s, true, timeout)) {
+			retval = false;
+			break;
+		}
+		int ret = send(s, data, (int)length, SEND_FLAGS);
+		if (ret < 0 && wouldBlock()) {
+			continue;
+		}
+		if (ret <= 0) {
+			retval = false;
+			break;
+		}
+		data += ret;
+		length -= ret;
+	}
+
+	TelldusCore::MutexLocker locker(&d->mutex);
+	if (--d->writers == 0) {
+		for(std::list<NET_SOCKET_T>::const_iterator it = d->closed.begin(); it != d->closed.end(); ++it) {
+			closesocket(*it);
+		}
+		d->closed.clear();
+	}
+	return retval;
+}
+
+bool NetworkConnection::parseAddress(const std::string &address, std::string *host, int *port) {
+	size_t separator = address.rfind(':');
+	if (separator == std::string::npos || separator == 0 || separator+1 >= address.length()) {
+		return false;
+	}
+	*host = address.substr(0, separator);
+	*port = atoi(address.substr(separator+1).c_str());
+	return (*port > 0 && *port < 65536);
+}
@@ -0,0 +1,50 @@
+#ifndef NETWORKCONNECTION_H
+#define NETWORKCONNECTION_H
+
+#include <string>
+#include <stddef.h>
+
+/**
+ * A TCP client connection, used to reach controllers behind a serial to
+ * network bridge.
+ *
+ * One thread may read while others write. Only the reading thread should
+ * connect and close the connection.
+ */
+class NetworkConnection {
+public:
+	NetworkConnection();
+	~NetworkConnection();
+
+	/**
+	 * Connects to host:port, giving up after timeout milliseconds.
+	 */
+	bool connect(const std::string &host, int port, int timeout);
+	void close();
+	bool isConnected() const;
+
+	/**
+	 * Waits up to timeout milliseconds for incoming data.
+	 * @return the number of bytes read, 0 on timeout or -1 if the connection was lost.
+	 */
+	int read(char *buffer, size_t size, int timeout);
+
+	/**
+	 * Writes all of data, waiting up to timeout milliseconds at a time for the
+	 * bridge to take more. The connection may be closed by another thread
+	 * meanwhile, which makes the write fail.
+	 * @return false if the data could not be written.
+	 */
+	bool write(const char *data, size_t length, int timeout);
+
+	/**
+	 * Splits an address in the form host:port.
+	 */
+	static bool parseAddress(const std::string &address, std::string *host, int *port);
+
+private:
+	class PrivateData;
+	PrivateData *d;
+};
+
+#endif //NETWORKCONNECTION_H
@@ -0,0 +1,220 @@
+#include "NetworkTellStick.h"
+#include "NetworkConnection.h"
+#include "Settings.h"
+#include "Strings.h"
+#include "Mutex.h"
+#include "Log.h"
+#include "common.h"
+#include "../client/telldus-core.h"
+
+#include <sstream>
+
+const int CONNECT_TIMEOUT = 5000; //ms
+const int RECONNECT_MIN_DELAY = 1000; //ms
+const int RECONNECT_MAX_DELAY = 60000; //ms
+const int READ_INTERVAL = 500; //ms, how often the reader checks if it should stop
+
+class NetworkTellStick::PrivateData {
+public:
+	std::string address, host;
+	int port, pid, ackTimeout;
+	bool running, dropConnection;
+	NetworkConnection connection;
+	TelldusCore::Mutex mutex;
+
+	bool isRunning();
+	bool takeDropRequest();
+	bool sleep(int msec);
+};
+
+bool NetworkTellStick::PrivateData::isRunning() {
+	TelldusCore::MutexLocker locker(&mutex);
+	return running;
+}
+
+bool NetworkTellStick::PrivateData::takeDropRequest() {
+	TelldusCore::MutexLocker locker(&mutex);
+	bool retval = dropConnection;
+	dropConnection = false;
+	return retval;
+}
+
+bool NetworkTellStick::PrivateData::sleep(int msec) {
+	//Sleep in small steps so we can be stopped
+	for(; msec > 0; msec -= 100) {
+		if (!isRunning()) {
+			return false;
+		}
+		msleep(msec < 100 ? msec : 100);
+	}
+	return isRunning();
+}
+
+NetworkTellStick::NetworkTellStick(int controllerId, TelldusCore::EventRef event, TelldusCore::EventRef updateEvent, const TellStickDescriptor &td)
+	:TellStick(controllerId, event, updateEvent)
+{
+	d = new PrivateData;
+	d->address = td.serial;
+	d->pid = td.pid;
+	d->port = 0;
+	NetworkConnection::parseAddress(td.serial, &d->host, &d->port);
+	d->running = true;
+	d->dropConnection = false;
+
+	Settings set;
+	std::string value = set.getSetting("networkControllerAckTimeout");
+	d->ackTimeout = (value.length() ? TelldusCore::charToInteger(value.c_str()) : 5);
+	if (d->ackTimeout < 1) {
+		d->ackTimeout = 1;
+	}
+	setAckTimeout(d->ackTimeout);
+	setPipelineFirmware(set.getSetting("duoPipelineFirmware"));
+	int receiveGap = 0;
+	if (td.pid == 0x0C31) {
+		value = set.getSetting("receiveGap");
+		receiveGap = (value.length() ? TelldusCore::charToInteger(value.c_str()) : 100);
+	}
+	setTransmitPacing(TelldusCore::charToInteger(set.getSetting("transmitDutyCycle").c_str()), receiveGap);
+
+	Log::notice("Connecting to %s at %s", (td.pid == 0x0C31 ? "TellStick Duo" : "TellStick"), d->address.c_str());
+	this->start();
+}
+
+NetworkTellStick::~NetworkTellStick() {
+	{
+		TelldusCore::MutexLocker locker(&d->mutex);
+		d->running = false;
+	}
+	this->wait();
+	//Unlock anyone waiting for an ack
+	failPendingAcks(TELLSTICK_ERROR_BROKEN_PIPE);
+	delete d;
+}
+
+int NetworkTellStick::pid() const {
+	return d->pid;
+}
+
+int NetworkTellStick::vid() const {
+	return 0x1781;
+}
+
+std::string NetworkTellStick::serial() const {
+	return d->address;
+}
+
+bool NetworkTellStick::isSameAsDescriptor(const TellStickDescriptor &td) const {
+	//The serial of a network controller is its address
+	return (td.vid == vid() && td.pid == d->pid && td.serial == d->address);
+}
+
+bool NetworkTellStick::isConnected() const {
+	return d->connection.isConnected();
+}
+
+int NetworkTellStick::reset() {
+	//Let the reader thread reconnect
+	TelldusCore::MutexLocker locker(&d->mutex);
+	d->dropConnection = true;
+	return TELLSTICK_SUCCESS;
+}
+
+bool NetworkTellStick::stillConnected() const {
+	//Never unplugged, a lost connection is re-established in the background
+	return true;
+}
+
+std::list<TellStickDescriptor> NetworkTellStick::findConfigured() {
+	std::list<TellStickDescriptor> retval;
+	Settings set;
+	//A comma separated list of host:port, prefixed with duo@ for a TellStick Duo
+	std::stringstream addresses(set.getSetting("networkControllers"));
+	std::string address;
+	while(std::getline(addresses, address, ',')) {
+		size_t start = address.find_first_not_of(" \t");
+		size_t end = address.find_last_not_of(" \t");
+		if (start == std::string::npos) {
+			continue;
+		}
+		address = address.substr(start, end-start+1);
+
+		TellStickDescriptor td;
+		td.vid = 0x1781;
+		td.pid = 0x0C30;
+		size_t separator = address.find('@');
+		if (separator != std::string::npos) {
+			if (TelldusCore::comparei(address.substr(0, separator), "duo")) {
+				td.pid = 0x0C31;
+			}
+			address = address.substr(separator+1);
+		}
+		std::string host;
+		int port;
+		if (!NetworkConnection::parseAddress(address, &host, &port)) {
+			Log::warning("Ignoring network controller with malformed address %s", address.c_str());
+			continue;
+		}
+		td.serial = address;
+		retval.push_back(td);
+	}
+	return retval;
+}
+
+int NetworkTellStick::doFinishSend( int ticket ) {
+	int retval = TellStick::doFinishSend(ticket);
+	if (retval == TELLSTICK_ERROR_COMMUNICATION && d->connection.isConnected()) {
+		//A bridge that silently lost its end of the connection looks like this
+		Log::debug("No ack from %s within %i seconds, reconnecting", d->address.c_str(), d->ackTimeout);
+		reset();
+	}
+	return retval;
+}
+
+int NetworkTellStick::writeData( const std::string &message ) {
+	if (!d->connection.isConnected()) {
+		return TELLSTICK_ERROR_COMMUNICATION;
+	}
+	if (!d->connection.write(message.c_str(), message.length(), d->ackTimeout*1000)) {
+		Log::debug("Broken pipe on send to %s", d->address.c_str());
+		reset();
+		return TELLSTICK_ERROR_BROKEN_PIPE;
+	}
+	return TELLSTICK_SUCCESS;
+}
+
+void NetworkTellStick::run() {
+	int reconnectDelay = RECONNECT_MIN_DELAY;
+	char buf[1024];
+
+	while(d->isRunning()) {
+		if (!d->connection.connect(d->host, d->port, CONNECT_TIMEOUT)) {
+			//Back off while the bridge is unreachable
+			d->sleep(reconnectDelay);
+			reconnectDelay = (reconnectDelay*2 > RECONNECT_MAX_DELAY ? RECONNECT_MAX_DELAY : reconnectDelay*2);
+			continue;
+		}
+		reconnectDelay = RECONNECT_MIN_DELAY;
+		d->takeDropRequest();
+		clearData();
+		Log::notice("Connected to TellStick at %s", d->address.c_str());
+
+		//Send a firmware version request
+		d->connection.write("V+", 2, CONNECT_TIMEOUT);
+
+		while(d->isRunning() && !d->takeDropRequest()) {
+			int bytesRead = d->connection.read(buf, sizeof(buf), READ_INTERVAL);
+			if (bytesRead < 0) {
+				break;
+			}
+			if (bytesRead > 0) {
+				processData(buf, bytesRead);
+			}
+		}
+
+		d->connection.close();
+		failPendingAcks(TELLSTICK_ERROR_BROKEN_PIPE);
+		if (d->isRunning()) {
+			Log::warning("Lost connection to TellStick at %s", d->address.c_str());
+		}
+	}
+}
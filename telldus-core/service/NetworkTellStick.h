@@ -0,0 +1,41 @@
+#ifndef NETWORKTELLSTICK_H
+#define NETWORKTELLSTICK_H
+
+#include "TellStick.h"
+
+/**
+ * A TellStick or TellStick Duo attached to a serial to TCP bridge on
+ * another host. The connection is kept open in the background and
+ * re-established whenever it is lost.
+ */
+class NetworkTellStick : public TellStick {
+public:
+	NetworkTellStick(int controllerId, TelldusCore::EventRef event, TelldusCore::EventRef updateEvent, const TellStickDescriptor &td);
+	virtual ~NetworkTellStick();
+
+	virtual int pid() const;
+	virtual int vid() const;
+	virtual std::string serial() const;
+
+	bool isConnected() const;
+	virtual bool isSameAsDescriptor(const TellStickDescriptor &td) const;
+	virtual int reset();
+	virtual bool stillConnected() const;
+
+	/**
+	 * The controllers listed in the setting networkControllers.
+	 * The serial of each descriptor holds the host:port address.
+	 */
+	static std::list<TellStickDescriptor> findConfigured();
+
+protected:
+	virtual int doFinishSend( int ticket );
+	virtual int writeData( const std::string &message );
+	void run();
+
+private:
+	class PrivateData;
+	PrivateData *d;
+};
+
+#endif //NETWORKTELLSTICK_H
@@ -28,7 +28,7 @@
 class Protocol::PrivateData {
 public:
 	ParameterMap parameterList;
-	std::wstring model;
+	std::string model;
 };
 
 Protocol::Protocol(){
@@ -40,18 +40,18 @@ Protocol::~Protocol(void) {
 	delete d;
 }
 
-std::wstring Protocol::model() const {
-	std::wstring strModel = d->model;
+std::string Protocol::model() const {
+	std::string strModel = d->model;
 	//Strip anything after : if it is found
-	size_t pos = strModel.find(L":");
-	if (pos != std::wstring::npos) {
+	size_t pos = strModel.find(":");
+	if (pos != std::string::npos) {
 		strModel = strModel.substr(0, pos);
 	}
 
 	return strModel;
 }
 
-void Protocol::setModel(const std::wstring &model){
+void Protocol::setModel(const std::string &model){
 	d->model = model;
 }
 
@@ -59,7 +59,7 @@ void Protocol::setParameters(ParameterMap &parameterList){
 	d->parameterList = parameterList;
 }
 
-std::wstring Protocol::getStringParameter(const std::wstring &name, const std::wstring &defaultValue) const {
+std::string Protocol::getStringParameter(const std::string &name, const std::string &defaultValue) const {
 	ParameterMap::const_iterator it = d->parameterList.find(name);
 	if (it == d->parameterList.end()) {
 		return defaultValue;
@@ -67,12 +67,12 @@ std::wstring Protocol::getStringParameter(const std::wstring &name, const std::w
 	return it->second;
 }
 
-int Protocol::getIntParameter(const std::wstring &name, int min, int max) const {
-	std::wstring value = getStringParameter(name, L"");
-	if (value == L"") {
+int Protocol::getIntParameter(const std::string &name, int min, int max) const {
+	std::string value = getStringParameter(name, "");
+	if (value == "") {
 		return min;
 	}
-	std::wstringstream st;
+	std::stringstream st;
 	st << value;
 	int intValue = 0;
 	st >> intValue;
@@ -90,169 +90,139 @@ bool Protocol::checkBit(int data, int bitno) {
 }
 
 
-Protocol *Protocol::getProtocolInstance(const std::wstring &protocolname){
+Protocol *Protocol::getProtocolInstance(const std::string &protocolname){
 
-	if(TelldusCore::comparei(protocolname, L"arctech")){
+	if(TelldusCore::comparei(protocolname, "arctech")){
 		return new ProtocolNexa();
 
-	} else if (TelldusCore::comparei(protocolname, L"brateck")) {
+	} else if (TelldusCore::comparei(protocolname, "brateck")) {
 		return new ProtocolBrateck();
 
-	} else if (TelldusCore::comparei(protocolname, L"comen")) {
+	} else if (TelldusCore::comparei(protocolname, "comen")) {
 		return new ProtocolComen();
 
-	} else if (TelldusCore::comparei(protocolname, L"everflourish")) {
+	} else if (TelldusCore::comparei(protocolname, "everflourish")) {
 		return new ProtocolEverflourish();
 
-	} else if (TelldusCore::comparei(protocolname, L"fuhaote")) {
+	} else if (TelldusCore::comparei(protocolname, "fuhaote")) {
 		return new ProtocolFuhaote();
 
-	} else if (TelldusCore::comparei(protocolname, L"hasta")) {
+	} else if (TelldusCore::comparei(protocolname, "hasta")) {
 		return new ProtocolHasta();
 
-	} else if (TelldusCore::comparei(protocolname, L"ikea")) {
+	} else if (TelldusCore::comparei(protocolname, "ikea")) {
 		return new ProtocolIkea();
 
-	} else if (TelldusCore::comparei(protocolname, L"risingsun")) {
+	} else if (TelldusCore::comparei(protocolname, "risingsun")) {
 		return new ProtocolRisingSun();
 
-	} else if (TelldusCore::comparei(protocolname, L"sartano")) {
+	} else if (TelldusCore::comparei(protocolname, "sartano")) {
 		return new ProtocolSartano();
 
-	} else if (TelldusCore::comparei(protocolname, L"silvanchip")) {
+	} else if (TelldusCore::comparei(protocolname, "silvanchip")) {
 		return new ProtocolSilvanChip();
 
-	} else if (TelldusCore::comparei(protocolname, L"upm")) {
+	} else if (TelldusCore::comparei(protocolname, "upm")) {
 		return new ProtocolUpm();
 
-	} else if (TelldusCore::comparei(protocolname, L"waveman")) {
+	} else if (TelldusCore::comparei(protocolname, "waveman")) {
 		return new ProtocolWaveman();
 
-	} else if (TelldusCore::comparei(protocolname, L"x10")) {
+	} else if (TelldusCore::comparei(protocolname, "x10")) {
 		return new ProtocolX10();
 
-	} else if (TelldusCore::comparei(protocolname, L"yidong")) {
+	} else if (TelldusCore::comparei(protocolname, "yidong")) {
 		return new ProtocolYidong();
 
-	} else if (TelldusCore::comparei(protocolname, L"group")) {
+	} else if (TelldusCore::comparei(protocolname, "group")) {
 		return new ProtocolGroup();
 	}
 
-	else if (TelldusCore::comparei(protocolname, L"scene")) {
+	else if (TelldusCore::comparei(protocolname, "scene")) {
 		return new ProtocolScene();
 	}
 
 	return 0;
 }
 
-std::list<std::string> Protocol::getParametersForProtocol(const std::wstring &protocolName) {
+std::list<std::string> Protocol::getParametersForProtocol(const std::string &protocolName) {
 	std::list<std::string> parameters;
-	if(TelldusCore::comparei(protocolName, L"arctech")){
+	if(TelldusCore::comparei(protocolName, "arctech")){
 		parameters.push_back("house");
 		parameters.push_back("unit");
 
-	} else if (TelldusCore::comparei(protocolName, L"brateck")) {
+	} else if (TelldusCore::comparei(protocolName, "brateck")) {
 		parameters.push_back("house");
 
-	} else if (TelldusCore::comparei(protocolName, L"comen")) {
+	} else if (TelldusCore::comparei(protocolName, "comen")) {
 		parameters.push_back("house");
 		parameters.push_back("unit");
 
-	} else if (TelldusCore::comparei(protocolName, L"everflourish")) {
+	} else if (TelldusCore::comparei(protocolName, "everflourish")) {
 		parameters.push_back("house");
 		parameters.push_back("unit");
 
-	} else if (TelldusCore::comparei(protocolName, L"fuhaote")) {
+	} else if (TelldusCore::comparei(protocolName, "fuhaote")) {
 		parameters.push_back("code");
 
-	} else if (TelldusCore::comparei(protocolName, L"hasta")) {
+	} else if (TelldusCore::comparei(protocolName, "hasta")) {
 		parameters.push_back("house");
 		parameters.push_back("unit");
 
-	} else if (TelldusCore::comparei(protocolName, L"ikea")) {
+	} else if (TelldusCore::comparei(protocolName, "ikea")) {
 		parameters.push_back("system");
 		parameters.push_back("units");
 		//parameters.push_back("fade");
 
-	} else if (TelldusCore::comparei(protocolName, L"risingsun")) {
+	} else if (TelldusCore::comparei(protocolName, "risingsun")) {
 		parameters.push_back("house");
 		parameters.push_back("unit");
 
-	} else if (TelldusCore::comparei(protocolName, L"sartano")) {
+	} else if (TelldusCore::comparei(protocolName, "sartano")) {
 		parameters.push_back("code");
 
-	} else if (TelldusCore::comparei(protocolName, L"silvanchip")) {
+	} else if (TelldusCore::comparei(protocolName, "silvanchip")) {
 		parameters.push_back("house");
 
-	} else if (TelldusCore::comparei(protocolName, L"upm")) {
+	} else if (TelldusCore::comparei(protocolName, "upm")) {
 		parameters.push_back("house");
 		parameters.push_back("unit");
 
-	} else if (TelldusCore::comparei(protocolName, L"waveman")) {
+	} else if (TelldusCore::comparei(protocolName, "waveman")) {
 		parameters.push_back("house");
 		parameters.push_back("unit");
 
-	} else if (TelldusCore::comparei(protocolName, L"x10")) {
+	} else if (TelldusCore::comparei(protocolName, "x10")) {
 		parameters.push_back("house");
 		parameters.push_back("unit");
 
-	} else if (TelldusCore::comparei(protocolName, L"yidong")) {
+	} else if (TelldusCore::comparei(protocolName, "yidong")) {
 		parameters.push_back("unit");
 
-	} else if (TelldusCore::comparei(protocolName, L"group")) {
+	} else if (TelldusCore::comparei(protocolName, "group")) {
 		parameters.push_back("devices");
 
-	}  else if (TelldusCore::comparei(protocolName, L"scene")) {
+	}  else if (TelldusCore::comparei(protocolName, "scene")) {
 		parameters.push_back("devices");
 	}
 
 	return parameters;
 }
 
-std::list<std::string> Protocol::decodeData(const std::string &fullData) {
+std::list<std::string> Protocol::decodeData(const ControllerMessage &dataMsg) {
 	std::list<std::string> retval;
 	std::string decoded = "";
 
-	ControllerMessage dataMsg(fullData);
-	if( TelldusCore::comparei(dataMsg.protocol(), L"arctech") ) {
-		decoded = ProtocolNexa::decodeData(dataMsg);
-		if (decoded != "") {
-			retval.push_back(decoded);
-		}
-		decoded = ProtocolWaveman::decodeData(dataMsg);
-		if (decoded != "") {
-			retval.push_back(decoded);
-		}
-		decoded = ProtocolSartano::decodeData(dataMsg);
-		if (decoded != "") {
-			retval.push_back(decoded);
-		}
+	if( dataMsg.isProtocol("arctech") ) {
+		retval = ProtocolNexa::decodeData(dataMsg);
 	}
-	else if(TelldusCore::comparei(dataMsg.protocol(), L"everflourish") ) {
+	else if(dataMsg.isProtocol("everflourish") ) {
 		decoded = ProtocolEverflourish::decodeData(dataMsg);
 		if (decoded != "") {
 			retval.push_back(decoded);
 		}
 	}
-	else if(TelldusCore::comparei(dataMsg.protocol(), L"fineoffset") ) {
-		decoded = ProtocolFineoffset::decodeData(dataMsg);
-		if (decoded != "") {
-			retval.push_back(decoded);
-		}
-	}
-	else if(TelldusCore::comparei(dataMsg.protocol(), L"mandolyn") ) {
-		decoded = ProtocolMandolyn::decodeData(dataMsg);
-		if (decoded != "") {
-			retval.push_back(decoded);
-		}
-	}
-	else if(TelldusCore::comparei(dataMsg.protocol(), L"oregon") ) {
-		decoded = ProtocolOregon::decodeData(dataMsg);
-		if (decoded != "") {
-			retval.push_back(decoded);
-		}
-	}
-	else if(TelldusCore::comparei(dataMsg.protocol(), L"x10") ) {
+	else if(dataMsg.isProtocol("x10") ) {
 		decoded = ProtocolX10::decodeData(dataMsg);
 		if (decoded != "") {
 			retval.push_back(decoded);
@@ -261,3 +231,16 @@ std::list<std::string> Protocol::decodeData(const std::string &fullData) {
 
 	return retval;
 }
+
+bool Protocol::decodeSensorData(const ControllerMessage &dataMsg, SensorRecord *record) {
+	if(dataMsg.isProtocol("fineoffset") ) {
+		return ProtocolFineoffset::decodeData(dataMsg, record);
+	}
+	else if(dataMsg.isProtocol("mandolyn") ) {
+		return ProtocolMandolyn::decodeData(dataMsg, record);
+	}
+	else if(dataMsg.isProtocol("oregon") ) {
+		return ProtocolOregon::decodeData(dataMsg, record);
+	}
+	return false;
+}
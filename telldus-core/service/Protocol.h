@@ -6,9 +6,11 @@
 #include <map>
 #include "../client/telldus-core.h"
 
-typedef std::map<std::wstring, std::wstring> ParameterMap;
+typedef std::map<std::string, std::string> ParameterMap;
 
 class Controller;
+class ControllerMessage;
+class SensorRecord;
 
 class Protocol
 {
@@ -16,20 +18,21 @@ public:
 	Protocol();
 	virtual ~Protocol(void);
 
-	static Protocol *getProtocolInstance(const std::wstring &protocolname);
-	static std::list<std::string> getParametersForProtocol(const std::wstring &protocolName);
-	static std::list<std::string> decodeData(const std::string &fullData);
+	static Protocol *getProtocolInstance(const std::string &protocolname);
+	static std::list<std::string> getParametersForProtocol(const std::string &protocolName);
+	static std::list<std::string> decodeData(const ControllerMessage &dataMsg);
+	static bool decodeSensorData(const ControllerMessage &dataMsg, SensorRecord *record);
 
 	virtual int methods() const = 0;
-	std::wstring model() const;
-	void setModel(const std::wstring &model);
+	std::string model() const;
+	void setModel(const std::string &model);
 	void setParameters(ParameterMap &parameterList);
 
 	virtual std::string getStringForMethod(int method, unsigned char data, Controller *controller) = 0;
 
 protected:
-	std::wstring getStringParameter(const std::wstring &name, const std::wstring &defaultValue = L"") const;
-	int getIntParameter(const std::wstring &name, int min, int max) const;
+	std::string getStringParameter(const std::string &name, const std::string &defaultValue = "") const;
+	int getIntParameter(const std::string &name, int min, int max) const;
 
 	static bool checkBit(int data, int bit);
 
@@ -1,10 +1,7 @@
 #include "ProtocolBrateck.h"
+#include "PulseTrain.h"
 
-int ProtocolBrateck::methods() const {
-	return TELLSTICK_UP | TELLSTICK_DOWN | TELLSTICK_STOP;
-}
-
-std::string ProtocolBrateck::getStringForMethod(int method, unsigned char, Controller *) {
+namespace {
 	const char S = '!';
 	const char L = 'V';
 	const char B1[] = {L,S,L,S,0};
@@ -13,34 +10,42 @@ std::string ProtocolBrateck::getStringForMethod(int method, unsigned char, Contr
 	const char BUP[]   = {L,S,L,S,S,L,S,L,S,L,S,L,S,L,S,L,S,0};
 	const char BSTOP[] = {S,L,S,L,L,S,L,S,S,L,S,L,S,L,S,L,S,0};
 	const char BDOWN[] = {S,L,S,L,S,L,S,L,S,L,S,L,L,S,L,S,S,0};
+}
 
-	std::string strReturn;
-	std::wstring strHouse = this->getStringParameter(L"house", L"");
-	if (strHouse == L"") {
+int ProtocolBrateck::methods() const {
+	return TELLSTICK_UP | TELLSTICK_DOWN | TELLSTICK_STOP;
+}
+
+std::string ProtocolBrateck::getStringForMethod(int method, unsigned char, Controller *) {
+	std::string strHouse = this->getStringParameter("house", "");
+	if (strHouse == "") {
 		return "";
 	}
 
-	for( size_t i = 0; i < strHouse.length(); ++i ) {
-		if (strHouse[i] == '1') {
-			strReturn.insert(0, B1);
-		} else if (strHouse[i] == '-') {
-			strReturn.insert(0, BX);
-		} else if (strHouse[i] == '0') {
-			strReturn.insert(0, B0);
+	PulseTrain<> train;
+	train.append('S');
+
+	//The house code is sent last position first
+	for( size_t i = strHouse.length(); i > 0; --i ) {
+		if (strHouse[i-1] == '1') {
+			train.append(B1);
+		} else if (strHouse[i-1] == '-') {
+			train.append(BX);
+		} else if (strHouse[i-1] == '0') {
+			train.append(B0);
 		}
 	}
 
-	strReturn.insert(0, "S");
 	if (method == TELLSTICK_UP) {
-		strReturn.append(BUP);
+		train.append(BUP);
 	} else if (method == TELLSTICK_DOWN) {
-		strReturn.append(BDOWN);
+		train.append(BDOWN);
 	} else if (method == TELLSTICK_STOP) {
-		strReturn.append(BSTOP);
+		train.append(BSTOP);
 	} else {
 		return "";
 	}
-	strReturn.append("+");
+	train.append('+');
 
-	return strReturn;
+	return train.str();
 }
@@ -5,8 +5,8 @@ int ProtocolComen::methods() const {
 }
 
 std::string ProtocolComen::getStringForMethod(int method, unsigned char level, Controller *) {
-	int intHouse = getIntParameter(L"house", 1, 33554431);
+	int intHouse = getIntParameter("house", 1, 33554431);
 	intHouse <<= 1; //They seem to only accept even codes?
-	int intCode = getIntParameter(L"unit", 1, 16)-1;
+	int intCode = getIntParameter("unit", 1, 16)-1;
 	return getStringSelflearningForCode(intHouse, intCode, method, level);
 }
@@ -1,15 +1,20 @@
 #include "ProtocolEverflourish.h"
 #include <sstream>
-#include <stdio.h>
 #include "ControllerMessage.h"
+#include "PulseTrain.h"
+
+namespace {
+	//As indices into the T-packet pulse lengths 114, 60, 1 and 1
+	const BitCoding EVERFLOURISH = {"1110", "1011"};
+}
 
 int ProtocolEverflourish::methods() const {
 	return TELLSTICK_TURNON | TELLSTICK_TURNOFF | TELLSTICK_LEARN;
 }
 
 std::string ProtocolEverflourish::getStringForMethod(int method, unsigned char, Controller *) {
-	unsigned int deviceCode = this->getIntParameter(L"house", 0, 16383);
-	unsigned int intCode = this->getIntParameter(L"unit", 1, 4)-1;
+	unsigned int deviceCode = this->getIntParameter("house", 0, 16383);
+	unsigned int intCode = this->getIntParameter("unit", 1, 4)-1;
 	unsigned char action;
 
 	if (method == TELLSTICK_TURNON) {
@@ -22,35 +27,19 @@ std::string ProtocolEverflourish::getStringForMethod(int method, unsigned char,
 		return "";
 	}
 	
-	const char ssss = 85;
-	const char sssl = 84; // 0
-	const char slss = 69; // 1
-
-	const char bits[2] = {sssl,slss};
-	int i, check;
-
-	std::string strCode;
+	PulseTrain<> train;
+	train.append("11111111"); //Preamble
 
 	deviceCode = (deviceCode << 2) | intCode;
-	
-	check = calculateChecksum(deviceCode);
-
-	char preamble[] = {'R', 5, 'T', 114,60,1,1,105,ssss,ssss,0};
-	strCode.append(preamble);
-
-	for(i=15;i>=0;i--) {
-		strCode.append(1, bits[(deviceCode>>i)&0x01]);
-	}
-	for(i=3;i>=0;i--) {
-		strCode.append(1, bits[(check>>i)&0x01]);
-	}
-	for(i=3;i>=0;i--) {
-		strCode.append(1, bits[(action>>i)&0x01]);
-	}
-	
-	strCode.append(1, ssss);
-	strCode.append(1, '+');
+	train.appendBits(EVERFLOURISH, deviceCode, 16);
+	train.appendBits(EVERFLOURISH, calculateChecksum(deviceCode), 4);
+	train.appendBits(EVERFLOURISH, action, 4);
+	train.append("1111");
 
+	std::string strCode("R");
+	strCode.append(1, 5);
+	//The last pulses are only there to fill the last byte
+	strCode.append(train.tPacket(114, 60, 1, 1, 105));
 	return strCode;
 }
 
@@ -87,15 +76,16 @@ unsigned int ProtocolEverflourish::calculateChecksum(unsigned int x) {
 	return res; 
 }
 
-std::string ProtocolEverflourish::decodeData(ControllerMessage &dataMsg)
+std::string ProtocolEverflourish::decodeData(const ControllerMessage &dataMsg)
 {
-	std::string data = dataMsg.getParameter("data");
-	unsigned int allData;
+	uint64_t allData;
 	unsigned int house = 0;
 	unsigned int unit = 0;
 	unsigned int method = 0;
 	
-	sscanf(data.c_str(), "%X", &allData);
+	if (!dataMsg.getHexParameter("data", &allData)) {
+		return "";
+	}
 	
 	house = allData & 0xFFFC00;
 	house >>= 10;
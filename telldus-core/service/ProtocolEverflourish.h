@@ -9,7 +9,7 @@ class ProtocolEverflourish :  public Protocol
 public:
 	int methods() const;
 	virtual std::string getStringForMethod(int method, unsigned char data, Controller *controller);
-	static std::string decodeData(ControllerMessage &dataMsg);
+	static std::string decodeData(const ControllerMessage &dataMsg);
 
 private:
 	static unsigned int calculateChecksum(unsigned int x);
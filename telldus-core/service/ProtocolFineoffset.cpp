@@ -1,45 +1,41 @@
 #include "ProtocolFineoffset.h"
 #include "Strings.h"
 #include <stdlib.h>
-#include <sstream>
-#include <iomanip>
 
-std::string ProtocolFineoffset::decodeData(ControllerMessage &dataMsg)
+bool ProtocolFineoffset::decodeData(const ControllerMessage &dataMsg, SensorRecord *record)
 {
-	std::string data = dataMsg.getParameter("data");
-	if (data.length() < 8) {
-		return "";
+	//At least the checksum, humidity, temperature and one digit of the id
+	if (dataMsg.getParameter("data").length() < 8) {
+		return false;
+	}
+	uint64_t value = 0;
+	if (!dataMsg.getHexParameter("data", &value)) {
+		return false;
 	}
 
-	uint8_t checksum = (uint8_t)TelldusCore::hexTo64l(data.substr(data.length()-2));
-	data = data.substr(0, data.length()-2);
-
-	uint8_t humidity = (uint8_t)TelldusCore::hexTo64l(data.substr(data.length()-2));
-	data = data.substr(0, data.length()-2);
+	uint8_t checksum = value & 0xFF;
+	value >>= 8;
 
-	uint16_t value = (uint16_t)TelldusCore::hexTo64l(data.substr(data.length()-3));
-	double temperature = (value & 0x7FF)/10.0;
+	uint8_t humidity = value & 0xFF;
+	value >>= 8;
 
-	value >>= 11;
-	if (value & 1) {
+	int temperature = (value & 0x7FF); //tenths of a degree
+	if (value & 0x800) {
 		temperature = -temperature;
 	}
-	data = data.substr(0, data.length()-3);
+	value >>= 12;
 
-	uint16_t id = (uint16_t)TelldusCore::hexTo64l(data) & 0xFF;
-
-	std::stringstream retString;
-	retString << "class:sensor;protocol:fineoffset;id:" << id << ";model:";
+	uint16_t id = value & 0xFF;
 
 	if (humidity <= 100) {
-		retString << "temperaturehumidity;humidity:" << (int)humidity << ";";
+		*record = SensorRecord("fineoffset", "temperaturehumidity", id);
+		record->addValue(TELLSTICK_HUMIDITY, humidity, 0);
 	} else if (humidity == 0xFF) {
-		retString << "temperature;";
+		*record = SensorRecord("fineoffset", "temperature", id);
 	} else {
-		return "";
+		return false;
 	}
+	record->addValue(TELLSTICK_TEMPERATURE, temperature, 1);
 
-	retString << "temp:" << std::fixed << std::setprecision(1) << temperature << ";";
-
-	return retString.str();
+	return true;
 }
@@ -3,11 +3,12 @@
 
 #include "ControllerMessage.h"
 #include "Protocol.h"
+#include "SensorRecord.h"
 
 class ProtocolFineoffset : public Protocol
 {
 public:
-	static std::string decodeData(ControllerMessage &dataMsg);
+	static bool decodeData(const ControllerMessage &dataMsg, SensorRecord *record);
 };
 
 #endif //PROTOCOLFINEOFFSET_H
@@ -1,54 +1,50 @@
 #include "ProtocolFuhaote.h"
+#include "PulseTrain.h"
 
-int ProtocolFuhaote::methods() const {
-	return TELLSTICK_TURNON | TELLSTICK_TURNOFF;
-}
-
-std::string ProtocolFuhaote::getStringForMethod(int method, unsigned char, Controller *) {
+namespace {
 	const char S = 19;
 	const char L = 58;
 	const char B0[] = {S,L,L,S,0};
 	const char B1[] = {L,S,L,S,0};
+	const char UNIT_B1[] = {S,L,S,L,0};
 	const char OFF[] = {S,L,S,L,S,L,L,S,0};
 	const char ON[]  = {S,L,L,S,S,L,S,L,0};
 
-	std::string strReturn = "S";
-	std::wstring strCode = this->getStringParameter(L"code", L"");
-	if (strCode == L"") {
+	const BitCoding HOUSE = {B0, B1};
+	const BitCoding UNIT = {B0, UNIT_B1};
+}
+
+int ProtocolFuhaote::methods() const {
+	return TELLSTICK_TURNON | TELLSTICK_TURNOFF;
+}
+
+std::string ProtocolFuhaote::getStringForMethod(int method, unsigned char, Controller *) {
+	std::string strCode = this->getStringParameter("code", "");
+	if (strCode == "") {
 		return "";
 	}
 
-	//House code
-	for(size_t i = 0; i < 5; ++i) {
-		if (strCode[i] == '0') {
-			strReturn.append(B0);
-		} else if (strCode[i] == '1') {
-			strReturn.append(B1);
-		}
-	}
-	//Unit code
-	for(size_t i = 5; i < 10; ++i) {
-		if (strCode[i] == '0') {
-			strReturn.append(B0);
-		} else if (strCode[i] == '1') {
-			strReturn.append(1, S);
-			strReturn.append(1, L);
-			strReturn.append(1, S);
-			strReturn.append(1, L);
+	PulseTrain<> train;
+	train.append('S');
+
+	//House code, then unit code
+	for(size_t i = 0; i < 10 && i < strCode.length(); ++i) {
+		if (strCode[i] == '0' || strCode[i] == '1') {
+			train.appendBit((i < 5 ? HOUSE : UNIT), strCode[i] == '1');
 		}
 	}
 
 	if (method == TELLSTICK_TURNON) {
-		strReturn.append(ON);
+		train.append(ON);
 	} else if (method == TELLSTICK_TURNOFF) {
-		strReturn.append(OFF);
+		train.append(OFF);
 	} else {
 		return "";
 	}
 
-	strReturn.append(1, S);
-	strReturn.append("+");
-	return strReturn;
+	train.append(S);
+	train.append('+');
+	return train.str();
 
 }
 
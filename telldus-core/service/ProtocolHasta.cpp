@@ -1,26 +1,20 @@
 #include "ProtocolHasta.h"
-#include <sstream>
-#include <stdio.h>
+#include "PulseTrain.h"
+
+namespace {
+	const char PREAMBLE[] = {(char)190, 1, (char)190, 1, (char)190, (char)190, 0};
+	const char B0[] = {17, 33, 0};
+	const char B1[] = {33, 17, 0};
+	const BitCoding HASTA = {B0, B1};
+}
 
 int ProtocolHasta::methods() const {
 	return TELLSTICK_UP | TELLSTICK_DOWN | TELLSTICK_STOP | TELLSTICK_LEARN;
 }
 
 std::string ProtocolHasta::getStringForMethod(int method, unsigned char, Controller *) {
-	int house = this->getIntParameter(L"house", 1, 65536);
-	int unit = this->getIntParameter(L"unit", 1, 15);
-	std::string strReturn;
-
-	std::string preamble;
-	strReturn.append(1, 190);
-	strReturn.append(1, 1);
-	strReturn.append(1, 190);
-	strReturn.append(1, 1);
-	strReturn.append(1, 190);
-	strReturn.append(1, 190);
-
-	strReturn.append(convertByte( (house&0xFF) ));
-	strReturn.append(convertByte( (house>>8)&0xFF ));
+	int house = this->getIntParameter("house", 1, 65536);
+	int unit = this->getIntParameter("unit", 1, 15);
 
 	int byte = unit&0x0F;
 
@@ -39,28 +33,16 @@ std::string ProtocolHasta::getStringForMethod(int method, unsigned char, Control
 	} else {
 		return "";
 	}
-	strReturn.append(convertByte(byte));
 
-	strReturn.append(convertByte(0x0));
-	strReturn.append(convertByte(0x0));
+	PulseTrain<> train;
+	train.append(PREAMBLE);
+	train.appendBitsReversed(HASTA, house&0xFF, 8);
+	train.appendBitsReversed(HASTA, (house>>8)&0xFF, 8);
+	train.appendBitsReversed(HASTA, byte, 8);
+	train.appendBitsReversed(HASTA, 0x0, 16);
 
 	//Remove the last pulse
-	strReturn.erase(strReturn.end()-1,strReturn.end());
+	train.removeLast();
 
-	return strReturn;
+	return train.str();
 }
-
-std::string ProtocolHasta::convertByte(unsigned char byte) {
-	std::string retval;
-	for(int i = 0; i < 8; ++i) {
-		if (byte & 1) {
-			retval.append(1, 33);
-			retval.append(1, 17);
-		} else {
-			retval.append(1, 17);
-			retval.append(1, 33);
-		}
-		byte >>= 1;
-	}
-	return retval;
-}
\ No newline at end of file
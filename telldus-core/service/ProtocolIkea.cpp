@@ -1,17 +1,27 @@
 #include "ProtocolIkea.h"
+#include "PulseTrain.h"
 #include "Strings.h"
 
 #include <stdlib.h>
 #include <string.h>
 
+namespace {
+	const char S = 'T';
+	const char L = (char)170;
+	const char STARTCODE[] = {S,S,S,S,S,S,L,0};
+	const char B0[] = {L,0};
+	const char B1[] = {S,S,0};
+	const BitCoding IKEA = {B0, B1};
+}
+
 int ProtocolIkea::methods() const {
 	return TELLSTICK_TURNON | TELLSTICK_TURNOFF | TELLSTICK_DIM;
 }
 
 std::string ProtocolIkea::getStringForMethod(int method, unsigned char level, Controller *) {
-	int intSystem = this->getIntParameter(L"system", 1, 16)-1;
-	int intFadeStyle = TelldusCore::comparei(this->getStringParameter(L"fade", L"true"), L"true");
-	std::wstring wstrUnits = this->getStringParameter(L"units", L"");
+	int intSystem = this->getIntParameter("system", 1, 16)-1;
+	int intFadeStyle = TelldusCore::comparei(this->getStringParameter("fade", "true"), "true");
+	std::string strUnits = this->getStringParameter("units", "");
 
 	if (method == TELLSTICK_TURNON) {
 		level = 255;
@@ -22,11 +32,10 @@ std::string ProtocolIkea::getStringForMethod(int method, unsigned char level, Co
 		return "";
 	}
 
-	if (wstrUnits == L"") {
+	if (strUnits == "") {
 		return "";
 	}
 
-	std::string strUnits(TelldusCore::wideToString(wstrUnits));
 	int intUnits = 0; //Start without any units
 
 	char *tempUnits = new char[strUnits.size()+1];
@@ -47,27 +56,26 @@ std::string ProtocolIkea::getStringForMethod(int method, unsigned char level, Co
 
 	delete[] tempUnits;
 
-	std::string strReturn = "STTTTTT"; //Startcode, always like this;
+	PulseTrain<> train;
+	train.append('S');
+	train.append(STARTCODE); //Startcode, always like this;
 
-	std::string strChannels = "";
 	int intCode = (intSystem << 10) | intUnits;
 	int checksum1 = 0;
 	int checksum2 = 0;
-	for (int i = 13; i >= 0; --i) {
-		if ((intCode>>i) & 1) {
-			strChannels.append("TT");
+	for (int i = 13; i >= 0; --i) { //System + Units
+		bool bit = (intCode>>i) & 1;
+		train.appendBit(IKEA, bit);
+		if (bit) {
 			if (i % 2 == 0)
 				checksum2++;
 			else
 				checksum1++;
-		} else {
-			strChannels.append("");
 		}
 	}
-	strReturn.append(strChannels); //System + Units
 
-	strReturn.append(checksum1 %2 == 0 ? "TT" : ""); //1st checksum
-	strReturn.append(checksum2 %2 == 0 ? "TT" : ""); //2nd checksum
+	train.appendBit(IKEA, checksum1 %2 == 0); //1st checksum
+	train.appendBit(IKEA, checksum2 %2 == 0); //2nd checksum
 
 	int intLevel = 0;
 	if (level <= 12) {
@@ -106,22 +114,21 @@ std::string ProtocolIkea::getStringForMethod(int method, unsigned char level, Co
 	checksum1 = 0;
 	checksum2 = 0;
 	for (int i = 0; i < 6; ++i) {
-		if ((intCode>>i) & 1) {
-			strReturn.append("TT");
+		bool bit = (intCode>>i) & 1;
+		train.appendBit(IKEA, bit);
+		if (bit) {
 			if (i % 2 == 0)
 				checksum1++;
 			else
 				checksum2++;
-		} else {
-			strReturn.append("");
 		}
 	}
 
-	strReturn.append(checksum1 %2 == 0 ? "TT" : ""); //1st checksum
-	strReturn.append(checksum2 %2 == 0 ? "TT" : ""); //2nd checksum
+	train.appendBit(IKEA, checksum1 %2 == 0); //1st checksum
+	train.appendBit(IKEA, checksum2 %2 == 0); //2nd checksum
 
-	strReturn.append("+");
+	train.append('+');
 
-	return strReturn;
+	return train.str();
 
 }
@@ -1,19 +1,21 @@
 #include "ProtocolMandolyn.h"
 #include "Strings.h"
 #include <stdlib.h>
-#include <sstream>
-#include <iomanip>
 
-std::string ProtocolMandolyn::decodeData(ControllerMessage &dataMsg)
+bool ProtocolMandolyn::decodeData(const ControllerMessage &dataMsg, SensorRecord *record)
 {
-	std::string data = dataMsg.getParameter("data");
-	uint32_t value = (uint32_t)TelldusCore::hexTo64l(data);
+	uint64_t data = 0;
+	if (!dataMsg.getHexParameter("data", &data) || data > 0xFFFFFFFF) {
+		return false;
+	}
+	uint32_t value = (uint32_t)data;
 
 	bool parity = value & 0x1;
 	value >>= 1;
 
-	double temp = (double)(value & 0x7FFF) - (double)6400;
-	temp = temp/128.0;
+	//In 1/128 degrees, rounded to tenths
+	int temp = ((int)(value & 0x7FFF) - 6400)*10;
+	temp = (temp >= 0 ? (temp + 64)/128 : -((-temp + 64)/128));
 	value >>= 15;
 
 	uint8_t humidity = (value & 0x7F);
@@ -27,12 +29,9 @@ std::string ProtocolMandolyn::decodeData(ControllerMessage &dataMsg)
 
 	uint8_t house = value & 0xF;
 
-	std::stringstream retString;
-	retString << "class:sensor;protocol:mandolyn;id:"
-		<< house*10+channel
-		<< ";model:temperaturehumidity;"
-		<< "temp:" << std::fixed << std::setprecision(1) << temp
-		<< ";humidity:" << (int)humidity << ";";
+	*record = SensorRecord("mandolyn", "temperaturehumidity", house*10+channel);
+	record->addValue(TELLSTICK_TEMPERATURE, temp, 1);
+	record->addValue(TELLSTICK_HUMIDITY, humidity, 0);
 
-	return retString.str();
+	return true;
 }
@@ -3,11 +3,12 @@
 
 #include "ControllerMessage.h"
 #include "Protocol.h"
+#include "SensorRecord.h"
 
 class ProtocolMandolyn : public Protocol
 {
 public:
-	static std::string decodeData(ControllerMessage &dataMsg);
+	static bool decodeData(const ControllerMessage &dataMsg, SensorRecord *record);
 };
 
 #endif //PROTOCOLMANDOLYN_H
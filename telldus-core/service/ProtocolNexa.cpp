@@ -1,34 +1,43 @@
 #include "ProtocolNexa.h"
 #include <sstream>
-#include <stdio.h>
+#include "ProtocolSartano.h"
+#include "ProtocolWaveman.h"
 #include "TellStick.h"
+#include "PulseTrain.h"
 #include "Strings.h"
 
+namespace {
+	//Codeswitch bits, in S-packets
+	const BitCoding CODESWITCH = {"$k$k", "$kk$"};
+	//Selflearning bits, as indices into the T-packet pulse lengths 127, 255, 24 and 1
+	const BitCoding SELFLEARNING = {"2220", "2022"};
+}
+
 int ProtocolNexa::lastArctecCodeSwitchWasTurnOff=0;  //TODO, always removing first turnon now, make more flexible (waveman too)
 
 int ProtocolNexa::methods() const {
-	if (TelldusCore::comparei(model(), L"codeswitch")) {
+	if (TelldusCore::comparei(model(), "codeswitch")) {
 		return (TELLSTICK_TURNON | TELLSTICK_TURNOFF);
 
-	} else if (TelldusCore::comparei(model(), L"selflearning-switch")) {
+	} else if (TelldusCore::comparei(model(), "selflearning-switch")) {
 		return (TELLSTICK_TURNON | TELLSTICK_TURNOFF | TELLSTICK_LEARN);
 
-	} else if (TelldusCore::comparei(model(), L"selflearning-dimmer")) {
+	} else if (TelldusCore::comparei(model(), "selflearning-dimmer")) {
 		return (TELLSTICK_TURNON | TELLSTICK_TURNOFF | TELLSTICK_DIM | TELLSTICK_LEARN);
 
-	} else if (TelldusCore::comparei(model(), L"bell")) {
+	} else if (TelldusCore::comparei(model(), "bell")) {
 		return TELLSTICK_BELL;
 	}
 	return 0;
 }
 
 std::string ProtocolNexa::getStringForMethod(int method, unsigned char data, Controller *controller) {
-	if (TelldusCore::comparei(model(), L"codeswitch")) {
+	if (TelldusCore::comparei(model(), "codeswitch")) {
 		return getStringCodeSwitch(method);
-	} else if (TelldusCore::comparei(model(), L"bell")) {
+	} else if (TelldusCore::comparei(model(), "bell")) {
 		return getStringBell();
 	}
-	if ((method == TELLSTICK_TURNON) && TelldusCore::comparei(model(), L"selflearning-dimmer")) {
+	if ((method == TELLSTICK_TURNON) && TelldusCore::comparei(model(), "selflearning-dimmer")) {
 		//Workaround for not letting a dimmer do into "dimming mode"
 		return getStringSelflearning(TELLSTICK_DIM, 255);
 	}
@@ -46,7 +55,7 @@ std::string ProtocolNexa::getStringForMethod(int method, unsigned char data, Con
 			//It is only correct between the first and second packet.
 			//It seems faster to send two packes at a time and some
 			//receivers seems picky about this when learning.
-			//We also return the last packet so Device::doAction() doesn't
+			//We also return the last packet so Device::encodeAction() doesn't
 			//report TELLSTICK_ERROR_METHOD_NOT_SUPPORTED
 
 			str.insert(0, 1, 2); //Repeat two times
@@ -61,119 +70,131 @@ std::string ProtocolNexa::getStringForMethod(int method, unsigned char data, Con
 }
 
 std::string ProtocolNexa::getStringCodeSwitch(int method) {
-	std::string strReturn = "S";
+	PulseTrain<> train;
+	train.append('S');
 
-	std::wstring house = getStringParameter(L"house", L"A");
-	int intHouse = house[0] - L'A';
-	strReturn.append(getCodeSwitchTuple(intHouse));
-	strReturn.append(getCodeSwitchTuple(getIntParameter(L"unit", 1, 16)-1));
+	std::string house = getStringParameter("house", "A");
+	int intHouse = house[0] - 'A';
+	train.appendBitsReversed(CODESWITCH, intHouse, 4);
+	train.appendBitsReversed(CODESWITCH, getIntParameter("unit", 1, 16)-1, 4);
 
 	if (method == TELLSTICK_TURNON) {
-		strReturn.append("$k$k$kk$$kk$$kk$$k+");
+		train.append("$k$k$kk$$kk$$kk$$k+");
 	} else if (method == TELLSTICK_TURNOFF) {
-		strReturn.append(this->getOffCode());
+		train.append(this->getOffCode().c_str());
 	} else {
 		return "";
 	}
-	return strReturn;
+	return train.str();
 }
 
 std::string ProtocolNexa::getStringBell() {
-	std::string strReturn = "S";
+	PulseTrain<> train;
+	train.append('S');
 
-	std::wstring house = getStringParameter(L"house", L"A");
-	int intHouse = house[0] - L'A';
-	strReturn.append(getCodeSwitchTuple(intHouse));
-	strReturn.append("$kk$$kk$$kk$$k$k"); //Unit 7
-	strReturn.append("$kk$$kk$$kk$$kk$$k+"); //Bell
-	return strReturn;
+	std::string house = getStringParameter("house", "A");
+	int intHouse = house[0] - 'A';
+	train.appendBitsReversed(CODESWITCH, intHouse, 4);
+	train.append("$kk$$kk$$kk$$k$k"); //Unit 7
+	train.append("$kk$$kk$$kk$$kk$$k+"); //Bell
+	return train.str();
 }
 
 std::string ProtocolNexa::getStringSelflearning(int method, unsigned char level) {
-	int intHouse = getIntParameter(L"house", 1, 67108863);
-	int intCode = getIntParameter(L"unit", 1, 16)-1;
+	int intHouse = getIntParameter("house", 1, 67108863);
+	int intCode = getIntParameter("unit", 1, 16)-1;
 	return getStringSelflearningForCode(intHouse, intCode, method, level);
 }
 
 std::string ProtocolNexa::getStringSelflearningForCode(int intHouse, int intCode, int method, unsigned char level) {
-	const unsigned char START[] = {'T',127,255,24,1,0};
-//	const char START[] = {'T',130,255,26,24,0};
+	PulseTrain<> train;
+	train.append("21"); //Startcode
 
-	std::string strMessage(reinterpret_cast<const char*>(START));
-	strMessage.append(1,(method == TELLSTICK_DIM ? 147 : 132)); //Number of pulses
-
-	std::string m;
-	for (int i = 25; i >= 0; --i) {
-		m.append( intHouse & 1 << i ? "10" : "01" );
-	}
-	m.append("01"); //Group
+	train.appendBits(SELFLEARNING, intHouse, 26);
+	train.appendBit(SELFLEARNING, false); //Group
 
 	//On/off
 	if (method == TELLSTICK_DIM) {
-		m.append("00");
+		train.append("2222");
 	} else if (method == TELLSTICK_TURNOFF) {
-		m.append("01");
+		train.appendBit(SELFLEARNING, false);
 	} else if (method == TELLSTICK_TURNON) {
-		m.append("10");
+		train.appendBit(SELFLEARNING, true);
 	} else {
 		return "";
 	}
 
-	for (int i = 3; i >= 0; --i) {
-		m.append( intCode & 1 << i ? "10" : "01" );
-	}
+	train.appendBits(SELFLEARNING, intCode, 4);
 
 	if (method == TELLSTICK_DIM) {
-		unsigned char newLevel = level/16;
-		for (int i = 3; i >= 0; --i) {
-			m.append(newLevel & 1 << i ? "10" : "01");
-		}
+		train.appendBits(SELFLEARNING, level/16, 4);
 	}
 
-	//The number of data is odd.
-	//Add this to make it even, otherwise the following loop will not work
-	m.append("0");
+	//Pads the packet to whole bytes, only the pulses counted below are sent
+	train.append("22");
 
-	unsigned char code = 9; //b1001, startcode
-	for (unsigned int i = 0; i < m.length(); ++i) {
-		code <<= 4;
-		if (m[i] == '1') {
-			code |= 8; //b1000
-		} else {
-			code |= 10; //b1010
-//			code |= 11; //b1011
-		}
-		if (i % 2 == 0) {
-			strMessage.append(1,code);
-			code = 0;
-		}
-	}
-	strMessage.append("+");
-
-// 	for( int i = 0; i < strMessage.length(); ++i ) {
-// 		printf("%i,", (unsigned char)strMessage[i]);
-// 	}
-// 	printf("\n");
-	return strMessage;
+	return train.tPacket(127, 255, 24, 1, (method == TELLSTICK_DIM ? 147 : 132));
 }
 
-std::string ProtocolNexa::decodeData(ControllerMessage& dataMsg)
+std::list<std::string> ProtocolNexa::decodeData(const ControllerMessage &dataMsg)
 {
-	unsigned long allData = 0;
+	std::list<std::string> retval;
+	uint64_t allData = 0;
+	
+	if (!dataMsg.getHexParameter("data", &allData)) {
+		return retval;
+	}
 	
-	sscanf(dataMsg.getParameter("data").c_str(), "%lx", &allData);
+	std::string decoded;
+	if(dataMsg.isModel("selflearning")){
+		decoded = decodeDataSelfLearning(allData);
+		if (decoded != "") {
+			retval.push_back(decoded);
+		}
+	}
 	
-	if(TelldusCore::comparei(dataMsg.model(), L"selflearning")){
-		//selflearning
-		return decodeDataSelfLearning(allData);	
+	if (allData > 0xFFF) {
+		//Too long for any of the 12 bit codeswitch protocols
+		return retval;
 	}
-	else{
-		//codeswitch
-		return decodeDataCodeSwitch(allData);
+	
+	//The remotes send a stray turnon or bell after a codeswitch turnoff, it is
+	//dropped for every codeswitch reading of the frame (perhaps: only certain time
+	//interval since last, check that it's the same house/unit... Will lose one
+	//turnon/bell, but it's better than the alternative...)
+	//Only codeswitch frames count, a selflearning frame in between is not the stray one
+	bool strayTurnOn = false;
+	if (!dataMsg.isModel("selflearning")) {
+		if (((allData >> 8) & 0xF) == 6) {
+			lastArctecCodeSwitchWasTurnOff = 1;
+		} else if (lastArctecCodeSwitchWasTurnOff == 1) {
+			lastArctecCodeSwitchWasTurnOff = 0;
+			strayTurnOn = true;
+		}
 	}
+	
+	if (!strayTurnOn) {
+		if (!dataMsg.isModel("selflearning")) {
+			decoded = decodeDataCodeSwitch(allData);
+			if (decoded != "") {
+				retval.push_back(decoded);
+			}
+		}
+		decoded = ProtocolWaveman::decodeData(allData);
+		if (decoded != "") {
+			retval.push_back(decoded);
+		}
+	}
+	
+	decoded = ProtocolSartano::decodeData(allData);
+	if (decoded != "") {
+		retval.push_back(decoded);
+	}
+	
+	return retval;
 }
 
-std::string ProtocolNexa::decodeDataSelfLearning(long allData){
+std::string ProtocolNexa::decodeDataSelfLearning(uint64_t allData){
 	unsigned int house = 0;
 	unsigned int unit = 0;
 	unsigned int group = 0;
@@ -212,7 +233,7 @@ std::string ProtocolNexa::decodeDataSelfLearning(long allData){
 	return retString.str();
 }
 
-std::string ProtocolNexa::decodeDataCodeSwitch(long allData){
+std::string ProtocolNexa::decodeDataCodeSwitch(uint64_t allData){
 	
 	unsigned int house = 0;
 	unsigned int unit = 0;
@@ -234,16 +255,6 @@ std::string ProtocolNexa::decodeDataCodeSwitch(long allData){
 	
 	house = house + 'A'; //house from A to P
 	
-	if(method != 6 && lastArctecCodeSwitchWasTurnOff == 1){
-		lastArctecCodeSwitchWasTurnOff = 0;
-		return ""; //probably a stray turnon or bell	(perhaps: only certain time interval since last, check that it's the same house/unit... Will lose
-						//one turnon/bell, but it's better than the alternative...	
-	}
-	
-	if(method == 6){
-		lastArctecCodeSwitchWasTurnOff = 1;
-	}
-	
 	std::stringstream retString;
 	retString << "class:command;protocol:arctech;model:codeswitch;house:" << char(house);
 	
@@ -264,19 +275,6 @@ std::string ProtocolNexa::decodeDataCodeSwitch(long allData){
 	return retString.str();
 }
 
-std::string ProtocolNexa::getCodeSwitchTuple(int intCode) {
-	std::string strReturn = "";
-	for( int i = 0; i < 4; ++i ) {
-		if (intCode & 1) { //Convert 1
-			strReturn.append("$kk$");
-		} else { //Convert 0
-			strReturn.append("$k$k");
-		}
-		intCode >>= 1;
-	}
-	return strReturn;
-}
-
 std::string ProtocolNexa::getOffCode() const {
 	return "$k$k$kk$$kk$$k$k$k+";
 }
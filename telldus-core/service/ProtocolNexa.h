@@ -3,26 +3,31 @@
 
 #include "ControllerMessage.h"
 #include "Device.h"
+#include <list>
 #include <string>
 
 class ProtocolNexa : public Protocol {
 public:
 	virtual int methods() const;
 	virtual std::string getStringForMethod(int method, unsigned char data, Controller *controller);
-	static std::string decodeData(ControllerMessage& dataMsg);
+	/**
+	 * Every reading of a received arctech frame. Nexa, Waveman and Sartano
+	 * share the arctech pulse timings, so the same frame can be any of them.
+	 * The data is parsed once and each interpretation only checks its bits.
+	 */
+	static std::list<std::string> decodeData(const ControllerMessage &dataMsg);
 
 protected:
 	std::string getStringSelflearning(int method, unsigned char data);
 	std::string getStringCodeSwitch(int method);
 	std::string getStringBell();
 	virtual std::string getOffCode() const;
-	static std::string getCodeSwitchTuple(int code);
 	static std::string getStringSelflearningForCode(int house, int unit, int method, unsigned char data);
 	
 private:
 	static int lastArctecCodeSwitchWasTurnOff;
-	static std::string decodeDataCodeSwitch(long allData);
-	static std::string decodeDataSelfLearning(long allData);
+	static std::string decodeDataCodeSwitch(uint64_t allData);
+	static std::string decodeDataSelfLearning(uint64_t allData);
 };
 
 #endif //PROTOCOLNEXA_H
@@ -1,25 +1,25 @@
 #include "ProtocolOregon.h"
 #include "Strings.h"
 #include <stdlib.h>
-#include <sstream>
-#include <iomanip>
 
-std::string ProtocolOregon::decodeData(ControllerMessage &dataMsg)
+bool ProtocolOregon::decodeData(const ControllerMessage &dataMsg, SensorRecord *record)
 {
-	std::string data = dataMsg.getParameter("data");
+	uint64_t data = 0;
+	if (!dataMsg.getHexParameter("data", &data)) {
+		return false;
+	}
 
-	std::wstring model = dataMsg.model();
-	if (model.compare(L"0xEA4C") == 0) {
-		return decodeEA4C(data);
-	} else if (model.compare(L"0x1A2D") == 0) {
-		return decode1A2D(data);
+	std::string model = dataMsg.model();
+	if (model.compare("0xEA4C") == 0) {
+		return decodeEA4C(data, record);
+	} else if (model.compare("0x1A2D") == 0) {
+		return decode1A2D(data, record);
 	}
 
-	return "";
+	return false;
 }
 
-std::string ProtocolOregon::decodeEA4C(const std::string &data) {
-	uint64_t value = TelldusCore::hexTo64l(data);
+bool ProtocolOregon::decodeEA4C(uint64_t value, SensorRecord *record) {
 	
 	uint8_t checksum = 0xE + 0xA + 0x4 + 0xC;
 	checksum -= (value & 0xF) * 0x10;
@@ -48,23 +48,21 @@ std::string ProtocolOregon::decodeEA4C(const std::string &data) {
 	uint8_t channel = (value >> 4) & 0x7;
 
 	if (checksum != checksumw) {
-		return "";
+		return false;
 	}
 
-	double temperature = ((temp1 * 100) + (temp2 * 10) + temp3)/10.0;
+	int temperature = (temp1 * 100) + (temp2 * 10) + temp3; //tenths of a degree
 	if (neg) {
 		temperature = -temperature;
 	}
 
-	std::stringstream retString;
-	retString << "class:sensor;protocol:oregon;model:EA4C;id:" << (int)address
-		<< ";temp:" << std::fixed << std::setprecision(1) << temperature << ";";
+	*record = SensorRecord("oregon", "EA4C", address);
+	record->addValue(TELLSTICK_TEMPERATURE, temperature, 1);
 
-	return retString.str();
+	return true;
 }
 
-std::string ProtocolOregon::decode1A2D(const std::string &data) {
-	uint64_t value = TelldusCore::hexTo64l(data);
+bool ProtocolOregon::decode1A2D(uint64_t value, SensorRecord *record) {
 	uint8_t checksum2 = value & 0xFF;
 	value >>= 8;
 	uint8_t checksum1 = value & 0xFF;
@@ -99,17 +97,16 @@ std::string ProtocolOregon::decode1A2D(const std::string &data) {
 
 	//TODO: Find out how checksum2 works
 	if (checksum != checksum1) {
-		return "";
+		return false;
 	}
 
-	double temperature = ((temp1 * 100) + (temp2 * 10) + temp3)/10.0;
+	int temperature = (temp1 * 100) + (temp2 * 10) + temp3; //tenths of a degree
 	if (neg) {
 		temperature = -temperature;
 	}
 
-	std::stringstream retString;
-	retString << "class:sensor;protocol:oregon;model:1A2D;id:" << (int)address
-		<< ";temp:" << std::fixed << std::setprecision(1) << temperature << ";";
+	*record = SensorRecord("oregon", "1A2D", address);
+	record->addValue(TELLSTICK_TEMPERATURE, temperature, 1);
 
-	return retString.str();
+	return true;
 }
@@ -3,15 +3,16 @@
 
 #include "ControllerMessage.h"
 #include "Protocol.h"
+#include "SensorRecord.h"
 
 class ProtocolOregon : public Protocol
 {
 public:
-	static std::string decodeData(ControllerMessage &dataMsg);
+	static bool decodeData(const ControllerMessage &dataMsg, SensorRecord *record);
 
 protected:
-	static std::string decodeEA4C(const std::string &data);
-	static std::string decode1A2D(const std::string &data);
+	static bool decodeEA4C(uint64_t value, SensorRecord *record);
+	static bool decode1A2D(uint64_t value, SensorRecord *record);
 };
 
 #endif //PROTOCOLOREGON_H
@@ -1,111 +1,89 @@
 #include "ProtocolRisingSun.h"
+#include "PulseTrain.h"
 #include "Strings.h"
 
+namespace {
+	const char l = 120;
+	const char s = 51;
+	const char B0[] = {s,l,0};
+	const char B1[] = {l,s,0};
+	const BitCoding SELFLEARNING = {B0, B1};
+
+	const BitCoding CODESWITCH = {"e..e", ".e.e"};
+}
+
 int ProtocolRisingSun::methods() const {
-	if (TelldusCore::comparei(model(), L"selflearning")) {
+	if (TelldusCore::comparei(model(), "selflearning")) {
 		return (TELLSTICK_TURNON | TELLSTICK_TURNOFF | TELLSTICK_LEARN);
 	}
 	return TELLSTICK_TURNON | TELLSTICK_TURNOFF;
 }
 
 std::string ProtocolRisingSun::getStringForMethod(int method, unsigned char data, Controller *controller) {
-	if (TelldusCore::comparei(model(), L"selflearning")) {
+	if (TelldusCore::comparei(model(), "selflearning")) {
 		return getStringSelflearning(method);
 	}
 	return getStringCodeSwitch(method);
 }
 
 std::string ProtocolRisingSun::getStringSelflearning(int method) {
-	int intHouse = this->getIntParameter(L"house", 1, 33554432)-1;
-	int intCode = this->getIntParameter(L"code", 1, 16)-1;
+	int intHouse = this->getIntParameter("house", 1, 33554432)-1;
+	int intCode = this->getIntParameter("code", 1, 16)-1;
 
-	const char code_on[][7] = {
-		"110110", "001110", "100110", "010110",
-		"111001", "000101", "101001", "011001",
-		"110000", "001000", "100000", "010000",
-		"111100", "000010", "101100", "011100"
+	//Six bits each, sent most significant first
+	const unsigned char code_on[] = {
+		0x36, 0x0E, 0x26, 0x16,
+		0x39, 0x05, 0x29, 0x19,
+		0x30, 0x08, 0x20, 0x10,
+		0x3C, 0x02, 0x2C, 0x1C
 	};
-	const char code_off[][7] = {
-		"111110", "000001", "101110", "011110",
-		"110101", "001101", "100101", "010101",
-		"111000", "000100", "101000", "011000",
-		"110010", "001010", "100010", "010010"
+	const unsigned char code_off[] = {
+		0x3E, 0x01, 0x2E, 0x1E,
+		0x35, 0x0D, 0x25, 0x15,
+		0x38, 0x04, 0x28, 0x18,
+		0x32, 0x0A, 0x22, 0x12
 	};
-	const char l = 120;
-	const char s = 51;
 
-	std::string strCode = "10";
 	int code = intCode;
 	code = (code < 0 ? 0 : code);
 	code = (code > 15 ? 15 : code);
+
+	PulseTrain<> train;
+	train.pause(5);
+	if (method == TELLSTICK_LEARN) {
+		train.repeat(50);
+	}
+	train.append('S');
+
+	train.appendBits(SELFLEARNING, 2, 2);
 	if (method == TELLSTICK_TURNON) {
-		strCode.append(code_on[code]);
+		train.appendBits(SELFLEARNING, code_on[code], 6);
 	} else if (method == TELLSTICK_TURNOFF) {
-		strCode.append(code_off[code]);
+		train.appendBits(SELFLEARNING, code_off[code], 6);
 	} else if (method == TELLSTICK_LEARN) {
-		strCode.append(code_on[code]);
+		train.appendBits(SELFLEARNING, code_on[code], 6);
 	} else {
 		return "";
 	}
 
-	int house = intHouse;
-	for(int i = 0; i < 25; ++i) {
-		if (house & 1) {
-			strCode.append(1, '1');
-		} else {
-			strCode.append(1, '0');
-		}
-		house >>= 1;
-	}
-
-	std::string strReturn;
-	for(unsigned int i = 0; i < strCode.length(); ++i) {
-		if (strCode[i] == '1') {
-			strReturn.append(1, l);
-			strReturn.append(1, s);
-		} else {
-			strReturn.append(1, s);
-			strReturn.append(1, l);
-		}
-	}
-
-	std::string prefix = "P";
-	prefix.append(1, 5);
-	if (method == TELLSTICK_LEARN) {
-		prefix.append("R");
-		prefix.append( 1, 50 );
-	}
-	prefix.append("S");
-	strReturn.insert(0, prefix);
-	strReturn.append(1, '+');
-	return strReturn;
+	train.appendBitsReversed(SELFLEARNING, intHouse, 25);
+	train.append('+');
+	return train.str();
 }
 
 std::string ProtocolRisingSun::getStringCodeSwitch(int method) {
-	std::string strReturn = "S.e";
-	strReturn.append(getCodeSwitchTuple(this->getIntParameter(L"house", 1, 4)-1));
-	strReturn.append(getCodeSwitchTuple(this->getIntParameter(L"unit", 1, 4)-1));
+	PulseTrain<> train;
+	train.append("S.e");
+	//One bit set for the selected house and unit
+	train.appendBitsReversed(CODESWITCH, 1 << (this->getIntParameter("house", 1, 4)-1), 4);
+	train.appendBitsReversed(CODESWITCH, 1 << (this->getIntParameter("unit", 1, 4)-1), 4);
 	if (method == TELLSTICK_TURNON) {
-		strReturn.append("e..ee..ee..ee..e+");
+		train.append("e..ee..ee..ee..e+");
 	} else if (method == TELLSTICK_TURNOFF) {
-		strReturn.append("e..ee..ee..e.e.e+");
+		train.append("e..ee..ee..e.e.e+");
 	} else {
 		return "";
 	}
-	return strReturn;
-
-}
-
-std::string ProtocolRisingSun::getCodeSwitchTuple(int intToConvert) {
-
-	std::string strReturn = "";
-	for(int i = 0; i < 4; ++i) {
-		if (i == intToConvert) {
-			strReturn.append( ".e.e" );
-		} else {
-			strReturn.append( "e..e" );
-		}
-	}
-	return strReturn;
+	return train.str();
 
 }
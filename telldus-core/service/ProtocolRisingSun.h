@@ -12,7 +12,6 @@ public:
 protected:
 	std::string getStringSelflearning(int method);
 	std::string getStringCodeSwitch(int method);
-	static std::string getCodeSwitchTuple(int code);
 };
 
 #endif //PROTOCOLRISINGSUN_H
@@ -1,52 +1,49 @@
 #include "ProtocolSartano.h"
 #include <sstream>
-#include <stdio.h>
+#include "PulseTrain.h"
+
+namespace {
+	const BitCoding SARTANO = {"$kk$", "$k$k"};
+}
 
 int ProtocolSartano::methods() const {
 	return TELLSTICK_TURNON | TELLSTICK_TURNOFF;
 }
 
 std::string ProtocolSartano::getStringForMethod(int method, unsigned char, Controller *) {
-	std::wstring strCode = this->getStringParameter(L"code", L"");
+	std::string strCode = this->getStringParameter("code", "");
 	return getStringForCode(strCode, method);
 }
 
-std::string ProtocolSartano::getStringForCode(const std::wstring &strCode, int method) {
+std::string ProtocolSartano::getStringForCode(const std::string &strCode, int method) {
 
-	std::string strReturn("S");
+	PulseTrain<> train;
+	train.append('S');
 
 	for (size_t i = 0; i < strCode.length(); ++i) {
-		if (strCode[i] == L'1') {
-			strReturn.append("$k$k");
-		} else {
-			strReturn.append("$kk$");
-		}
+		train.appendBit(SARTANO, strCode[i] == '1');
 	}
 
 	if (method == TELLSTICK_TURNON) {
-		strReturn.append("$k$k$kk$$k+");
+		train.append("$k$k$kk$$k+");
 	} else if (method == TELLSTICK_TURNOFF) {
-		strReturn.append("$kk$$k$k$k+");
+		train.append("$kk$$k$k$k+");
 	} else {
 		return "";
 	}
 
-	return strReturn;
+	return train.str();
 
 }
 
-std::string ProtocolSartano::decodeData(ControllerMessage &dataMsg)
+std::string ProtocolSartano::decodeData(uint64_t allDataIn)
 {
-	std::string data = dataMsg.getParameter("data");
-	signed int allDataIn;
 	signed int allData = 0;
 	unsigned int code = 0;
 	unsigned int method1 = 0;
 	unsigned int method2 = 0;
 	unsigned int method = 0;
 	
-	sscanf(data.c_str(), "%X", &allDataIn);
-	
 	unsigned long mask = (1<<11);
 	for(int i=0;i<12;++i){
 		allData >>= 1;
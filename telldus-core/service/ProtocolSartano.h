@@ -9,10 +9,10 @@ class ProtocolSartano : public Protocol
 public:
 	int methods() const;
 	virtual std::string getStringForMethod(int method, unsigned char data, Controller *controller);
-	static std::string decodeData(ControllerMessage &dataMsg);
+	static std::string decodeData(uint64_t allDataIn);
 
 protected:
-	std::string getStringForCode(const std::wstring &code, int method);
+	std::string getStringForCode(const std::string &code, int method);
 };
 
 #endif //PROTOCOLSARTANO_H
@@ -1,49 +1,38 @@
 #include "ProtocolSilvanChip.h"
+#include "PulseTrain.h"
 #include "Strings.h"
 
+namespace {
+	const char KP100_PREAMBLE[] = {
+		100,
+		(char)255, 1, (char)255, 1, (char)255, 1, (char)255, 1,
+		(char)255, 1, (char)255, 1, (char)255, 1, (char)255, 1,
+		(char)255, 1, (char)255, 1, (char)255, 1, (char)255, 1,
+		100, 0
+	};
+	const BitCoding KP100 = {"\x2E\xFF\x1\x2E", "\xFF\x1\x2E\x2E"};
+
+	const char PREAMBLE[] = {
+		0x25,
+		(char)255, 1, (char)255, 1, (char)255, 1, (char)255, 1,
+		0x25, 0
+	};
+	const BitCoding CODING = {"\x25\x69", "\x69\25"};
+}
+
 int ProtocolSilvanChip::methods() const {
-	if (TelldusCore::comparei(model(), L"kp100")) {
+	if (TelldusCore::comparei(model(), "kp100")) {
 		return TELLSTICK_UP | TELLSTICK_DOWN | TELLSTICK_STOP | TELLSTICK_LEARN;
-	} else if (TelldusCore::comparei(model(), L"ecosavers")) {
+	} else if (TelldusCore::comparei(model(), "ecosavers")) {
 		return TELLSTICK_TURNON | TELLSTICK_TURNOFF | TELLSTICK_LEARN;
-	} else if (TelldusCore::comparei(model(), L"displaymatic")) {
+	} else if (TelldusCore::comparei(model(), "displaymatic")) {
 		return TELLSTICK_UP | TELLSTICK_DOWN | TELLSTICK_STOP;
 	}
 	return 0;
 }
 
 std::string ProtocolSilvanChip::getStringForMethod(int method, unsigned char data, Controller *controller) {
-	if (TelldusCore::comparei(model(), L"kp100")) {
-		std::string preamble;
-		preamble.append(1, 100);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 100);
-
-		const std::string one = "\xFF\x1\x2E\x2E";
-		const std::string zero = "\x2E\xFF\x1\x2E";
+	if (TelldusCore::comparei(model(), "kp100")) {
 		int button = 0;
 		if (method == TELLSTICK_UP) {
 			button = 2;
@@ -56,21 +45,8 @@ std::string ProtocolSilvanChip::getStringForMethod(int method, unsigned char dat
 		} else {
 			return "";
 		}
-		return this->getString(preamble, one, zero, button);
-	} else if (TelldusCore::comparei(model(), L"displaymatic")) {
-		std::string preamble;
-		preamble.append(1, 0x25);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 0x25);
-		const std::string one = "\x69\25";
-		const std::string zero = "\x25\x69";
+		return this->getString(KP100_PREAMBLE, KP100, button);
+	} else if (TelldusCore::comparei(model(), "displaymatic")) {
 		int button = 0;
 		if (method == TELLSTICK_UP) {
 			button = 1;
@@ -79,22 +55,9 @@ std::string ProtocolSilvanChip::getStringForMethod(int method, unsigned char dat
 		} else if (method == TELLSTICK_STOP) {
 			button = 2;
 		}
-		return this->getString(preamble, one, zero, button);
-	} else if (TelldusCore::comparei(model(), L"ecosavers")) {
-		std::string preamble;
-		preamble.append(1, 0x25);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 255);
-		preamble.append(1, 1);
-		preamble.append(1, 0x25);
-		const std::string one = "\x69\25";
-		const std::string zero = "\x25\x69";
-		int intUnit = this->getIntParameter(L"unit", 1, 4);
+		return this->getString(PREAMBLE, CODING, button);
+	} else if (TelldusCore::comparei(model(), "ecosavers")) {
+		int intUnit = this->getIntParameter("unit", 1, 4);
 		int button = 0;
 		if (intUnit == 1) {
 			button = 7;
@@ -109,32 +72,19 @@ std::string ProtocolSilvanChip::getStringForMethod(int method, unsigned char dat
 		if (method == TELLSTICK_TURNON || method == TELLSTICK_LEARN) {
 			button |= 8;
 		}
-		return this->getString(preamble, one, zero, button);
+		return this->getString(PREAMBLE, CODING, button);
 	}
 	return "";
 }
 
-std::string ProtocolSilvanChip::getString(const std::string &preamble, const std::string &one, const std::string &zero, int button) {
-
-	int intHouse = this->getIntParameter(L"house", 1, 1048575);
-	std::string strReturn = preamble;
-
-	for( int i = 19; i >= 0; --i ) {
-		if (intHouse & (1 << i)) {
-			strReturn.append(one);
-		} else {
-			strReturn.append(zero);
-		}
-	}
+std::string ProtocolSilvanChip::getString(const char *preamble, const BitCoding &coding, int button) {
 
-	for( int i = 3; i >= 0; --i) {
-		if (button & (1 << i)) {
-			strReturn.append(one);
-		} else {
-			strReturn.append(zero);
-		}
-	}
+	int intHouse = this->getIntParameter("house", 1, 1048575);
 
-	strReturn.append(zero);
-	return strReturn;
+	PulseTrain<> train;
+	train.append(preamble);
+	train.appendBits(coding, intHouse, 20);
+	train.appendBits(coding, button, 4);
+	train.appendBit(coding, false);
+	return train.str();
 }
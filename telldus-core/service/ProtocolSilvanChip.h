@@ -3,6 +3,8 @@
 
 #include "Protocol.h"
 
+class BitCoding;
+
 class ProtocolSilvanChip : public Protocol
 {
 public:
@@ -10,7 +12,7 @@ public:
 	virtual std::string getStringForMethod(int method, unsigned char data, Controller *controller);
 
 protected:
-	virtual std::string getString(const std::string &preamble, const std::string &one, const std::string &zero, int button);
+	std::string getString(const char *preamble, const BitCoding &coding, int button);
 };
 
 #endif //PROTOCOLSILVANCHIP_H
@@ -1,33 +1,29 @@
 #include "ProtocolUpm.h"
+#include "PulseTrain.h"
 
-int ProtocolUpm::methods() const {
-	return TELLSTICK_TURNON | TELLSTICK_TURNOFF | TELLSTICK_LEARN;
-}
-
-std::string ProtocolUpm::getStringForMethod(int method, unsigned char, Controller *) {
+namespace {
 	const char S = ';';
 	const char L = '~';
-	const char START[] = {S,0};
 	const char B1[] = {L,S,0};
 	const char B0[] = {S,L,0};
 	//const char BON[] = {S,L,L,S,0};
 	//const char BOFF[] = {S,L,S,L,0};
+	const BitCoding UPM = {B0, B1};
+}
 
-	int intUnit = this->getIntParameter(L"unit", 1, 4)-1;
-	std::string strReturn;
+int ProtocolUpm::methods() const {
+	return TELLSTICK_TURNON | TELLSTICK_TURNOFF | TELLSTICK_LEARN;
+}
 
-	int code = this->getIntParameter(L"house", 0, 4095);
-	for( size_t i = 0; i < 12; ++i ) {
-		if (code & 1) {
-			strReturn.insert(0, B1);
-		} else {
-			strReturn.insert(0, B0);
-		}
-		code >>= 1;
-	}
-	strReturn.insert(0, START); //Startcode, first
+std::string ProtocolUpm::getStringForMethod(int method, unsigned char, Controller *) {
+	int intUnit = this->getIntParameter("unit", 1, 4)-1;
+
+	PulseTrain<> train;
+	train.append('S');
+	train.append(S); //Startcode, first
+	train.appendBits(UPM, this->getIntParameter("house", 0, 4095), 12);
 
-	code = 0;
+	int code = 0;
 	if (method == TELLSTICK_TURNON || method == TELLSTICK_LEARN) {
 		code += 2;
 	} else if (method != TELLSTICK_TURNOFF) {
@@ -45,27 +41,14 @@ std::string ProtocolUpm::getStringForMethod(int method, unsigned char, Controlle
 				check2++;
 			}
 		}
-		if (code & 1) {
-			strReturn.append(B1);
-		} else {
-			strReturn.append(B0);
-		}
+		train.appendBit(UPM, code & 1);
 		code >>= 1;
 	}
 
-	if (check1 % 2 == 0) {
-		strReturn.append(B0);
-	} else {
-		strReturn.append(B1);
-	}
-	if (check2 % 2 == 0) {
-		strReturn.append(B0);
-	} else {
-		strReturn.append(B1);
-	}
+	train.appendBit(UPM, check1 % 2 != 0);
+	train.appendBit(UPM, check2 % 2 != 0);
 
-	strReturn.insert(0, "S");
-	strReturn.append("+");
-	return strReturn;
+	train.append('+');
+	return train.str();
 }
 
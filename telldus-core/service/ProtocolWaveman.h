@@ -7,13 +7,10 @@ class ProtocolWaveman : public ProtocolNexa {
 public:
 	int methods() const;
 	virtual std::string getStringForMethod(int method, unsigned char data, Controller *controller);
-	static std::string decodeData(ControllerMessage& dataMsg);
+	static std::string decodeData(uint64_t allData);
 
 protected:
 	virtual std::string getOffCode() const;
-
-private:
-	static int lastArctecCodeSwitchWasTurnOff;
 };
 
 #endif //PROTOCOLWAVEMAN_H
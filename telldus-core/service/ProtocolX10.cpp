@@ -1,25 +1,26 @@
 #include "ProtocolX10.h"
-#include <stdio.h>
+#include "PulseTrain.h"
 #include <sstream>
 
 const unsigned char HOUSES[] = {6,0xE,2,0xA,1,9,5,0xD,7,0xF,3,0xB,0,8,4,0xC};
 
+namespace {
+	const char S = 59, L = (char)169;
+	const char B0[] = {S,S,0};
+	const char B1[] = {S,L,0};
+	const char START_CODE[] = {'S',(char)255,1,(char)255,1,(char)255,1,100,(char)255,1,(char)180,0};
+	const char STOP_CODE[] = {S,0};
+	const BitCoding X10 = {B0, B1};
+	const BitCoding X10_COMPLEMENT = {B1, B0};
+}
+
 int ProtocolX10::methods() const {
 	return TELLSTICK_TURNON | TELLSTICK_TURNOFF;
 }
 
 std::string ProtocolX10::getStringForMethod(int method, unsigned char data, Controller *controller) {
-	const unsigned char S = 59, L = 169;
-	const char B0[] = {S,S,0};
-	const char B1[] = {S,L,0};
-	const unsigned char START_CODE[] = {'S',255,1,255,1,255,1,100,255,1,180,0};
-	const unsigned char STOP_CODE[] = {S,0};
-
-	std::string strReturn = reinterpret_cast<const char*>(START_CODE);
-	std::string strComplement = "";
-
-	std::wstring strHouse = getStringParameter(L"house", L"A");
-	int intHouse = strHouse[0] - L'A';
+	std::string strHouse = getStringParameter("house", "A");
+	int intHouse = strHouse[0] - 'A';
 	if (intHouse < 0) {
 		intHouse = 0;
 	} else if (intHouse > 15) {
@@ -27,90 +28,44 @@ std::string ProtocolX10::getStringForMethod(int method, unsigned char data, Cont
 	}
 	//Translate it
 	intHouse = HOUSES[intHouse];
-	int intCode = getIntParameter(L"unit", 1, 16)-1;
-
-	for( int i = 0; i < 4; ++i ) {
-		if (intHouse & 1) {
-			strReturn.append(B1);
-			strComplement.append(B0);
-		} else {
-			strReturn.append(B0);
-			strComplement.append(B1);
-		}
-		intHouse >>= 1;
-	}
-	strReturn.append( B0 );
-	strComplement.append( B1 );
-
-	if (intCode >= 8) {
-		strReturn.append(B1);
-		strComplement.append(B0);
-	} else {
-		strReturn.append(B0);
-		strComplement.append(B1);
-	}
-
-	strReturn.append( B0 );
-	strComplement.append( B1 );
-	strReturn.append( B0 );
-	strComplement.append( B1 );
-
-	strReturn.append( strComplement );
-	strComplement = "";
-
-	strReturn.append( B0 );
-	strComplement.append( B1 );
-
-	if (intCode >> 2 & 1) { //Bit 2 of intCode
-		strReturn.append(B1);
-		strComplement.append(B0);
-	} else {
-		strReturn.append(B0);
-		strComplement.append(B1);
-	}
+	int intCode = getIntParameter("unit", 1, 16)-1;
 
+	int methodBit = 0;
 	if (method == TELLSTICK_TURNON) {
-		strReturn.append(B0);
-		strComplement.append(B1);
+		methodBit = 0;
 	} else if (method == TELLSTICK_TURNOFF) {
-		strReturn.append(B1);
-		strComplement.append(B0);
+		methodBit = 1;
 	} else {
 		return "";
 	}
 
-	if (intCode & 1) { //Bit 0 of intCode
-		strReturn.append(B1);
-		strComplement.append(B0);
-	} else {
-		strReturn.append(B0);
-		strComplement.append(B1);
-	}
-
-	if (intCode >> 1 & 1) { //Bit 1 of intCode
-		strReturn.append(B1);
-		strComplement.append(B0);
-	} else {
-		strReturn.append(B0);
-		strComplement.append(B1);
-	}
+	//Two bytes, each sent least significant bit first and followed by its complement
+	int address = intHouse | (intCode >= 8 ? 1 << 5 : 0);
+	int command = ((intCode >> 2 & 1) << 1) //Bit 2 of intCode
+		| (methodBit << 2)
+		| ((intCode & 1) << 3) //Bit 0 of intCode
+		| ((intCode >> 1 & 1) << 4); //Bit 1 of intCode
 
-	for( int i = 0; i < 3; ++i ) {
-		strReturn.append( B0 );
-		strComplement.append( B1 );
-	}
-
-	strReturn.append( strComplement );
-	strReturn.append( reinterpret_cast<const char*>(STOP_CODE) );
-	strReturn.append("+");
-	return strReturn;
+	PulseTrain<> train;
+	train.append(START_CODE);
+	train.appendBitsReversed(X10, address, 8);
+	train.appendBitsReversed(X10_COMPLEMENT, address, 8);
+	train.appendBitsReversed(X10, command, 8);
+	train.appendBitsReversed(X10_COMPLEMENT, command, 8);
+	train.append(STOP_CODE);
+	train.append('+');
+	return train.str();
 
 }
 
-std::string ProtocolX10::decodeData(ControllerMessage& dataMsg) {
-	int intData = 0, currentBit = 31;
+std::string ProtocolX10::decodeData(const ControllerMessage &dataMsg) {
+	int currentBit = 31;
 	bool method=0;
-	sscanf(dataMsg.getParameter("data").c_str(), "%X", &intData);
+	uint64_t data = 0;
+	if (!dataMsg.getHexParameter("data", &data) || data > 0xFFFFFFFF) {
+		return "";
+	}
+	int intData = (int)data;
 
 	int unit = 0;
 	int rawHouse = 0;
@@ -10,7 +10,7 @@ public:
 	int methods() const;
 	virtual std::string getStringForMethod(int method, unsigned char data, Controller *controller);
 
-	static std::string decodeData(ControllerMessage& dataMsg);
+	static std::string decodeData(const ControllerMessage &dataMsg);
 };
 
 #endif //PROTOCOLX10_H
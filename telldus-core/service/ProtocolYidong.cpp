@@ -1,24 +1,24 @@
 #include "ProtocolYidong.h"
 
 std::string ProtocolYidong::getStringForMethod(int method, unsigned char, Controller *) {
-	int intCode = this->getIntParameter(L"unit", 1, 4);
-	std::wstring strCode = L"111";
+	int intCode = this->getIntParameter("unit", 1, 4);
+	std::string strCode = "111";
 
 	switch(intCode) {
 	case 1:
-		strCode.append(L"0010");
+		strCode.append("0010");
 		break;
 	case 2:
-		strCode.append(L"0001");
+		strCode.append("0001");
 		break;
 	case 3:
-		strCode.append(L"0100");
+		strCode.append("0100");
 		break;
 	case 4:
-		strCode.append(L"1000");
+		strCode.append("1000");
 		break;
 	}
 
-	strCode.append(L"110");
+	strCode.append("110");
 	return getStringForCode(strCode, method);
 }
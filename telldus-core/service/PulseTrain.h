@@ -0,0 +1,136 @@
+#ifndef PULSETRAIN_H
+#define PULSETRAIN_H
+
+#include <string>
+
+/**
+ * How a protocol sends one bit: the pulses for a 0 and the pulses for a 1.
+ * Protocols declare these as constants, built from their symbol timings.
+ */
+class BitCoding {
+public:
+	const char *zero;
+	const char *one;
+};
+
+/**
+ * Builds the packet for one transmission.
+ *
+ * The packet is assembled in a fixed buffer whose capacity is chosen by
+ * the protocol at compile time. Nothing is allocated until the finished
+ * packet is fetched. If the buffer overflows, the packet is discarded
+ * and an empty string is returned, the same as for an unsupported method.
+ *
+ * In an S-packet every byte is a pulse length in units of 10 microseconds.
+ * For a T-packet the pulses are the digits '0'-'3', each an index into the
+ * four pulse lengths given to tPacket().
+ */
+template<size_t CAPACITY = 256>
+class PulseTrain {
+public:
+	PulseTrain() : length(0), overflow(false) {}
+
+	//Firmware prefixes, these must come first
+	PulseTrain &repeat(int times) { append('R'); return append((char)times); }
+	PulseTrain &pause(int time) { append('P'); return append((char)time); }
+
+	PulseTrain &append(char pulse) {
+		if (length >= CAPACITY) {
+			overflow = true;
+			return *this;
+		}
+		buffer[length++] = pulse;
+		return *this;
+	}
+
+	PulseTrain &append(const char *pulses) {
+		for(; *pulses; ++pulses) {
+			append(*pulses);
+		}
+		return *this;
+	}
+
+	PulseTrain &appendBit(const BitCoding &coding, bool bit) {
+		return append(bit ? coding.one : coding.zero);
+	}
+
+	//The lowest bits of value, most significant first
+	PulseTrain &appendBits(const BitCoding &coding, unsigned long value, int bits) {
+		for(int i = bits-1; i >= 0; --i) {
+			appendBit(coding, (value >> i) & 1);
+		}
+		return *this;
+	}
+
+	//The lowest bits of value, least significant first
+	PulseTrain &appendBitsReversed(const BitCoding &coding, unsigned long value, int bits) {
+		for(int i = 0; i < bits; ++i) {
+			appendBit(coding, (value >> i) & 1);
+		}
+		return *this;
+	}
+
+	//Drops the last pulse, for protocols where the final gap isn't sent
+	PulseTrain &removeLast() {
+		if (length > 0) {
+			--length;
+		}
+		return *this;
+	}
+
+	size_t size() const { return length; }
+
+	std::string str() const {
+		if (overflow) {
+			return "";
+		}
+		return std::string(buffer, length);
+	}
+
+	/**
+	 * Packs the pulse indices into a T-packet.
+	 * @param pulses the number of pulses to send, defaults to all of them.
+	 * Any indices after these are packed but not sent.
+	 */
+	std::string tPacket(unsigned char t0, unsigned char t1, unsigned char t2, unsigned char t3, int pulses = -1) const {
+		if (overflow || length > 255*4) {
+			return "";
+		}
+		if (pulses < 0) {
+			pulses = (int)length;
+		}
+		if (pulses > 255) {
+			return "";
+		}
+		char packet[7 + (CAPACITY+3)/4 + 1];
+		size_t packetLength = 0;
+		packet[packetLength++] = 'T';
+		packet[packetLength++] = (char)t0;
+		packet[packetLength++] = (char)t1;
+		packet[packetLength++] = (char)t2;
+		packet[packetLength++] = (char)t3;
+		packet[packetLength++] = (char)pulses;
+		unsigned char dataByte = 0;
+		for (size_t i = 0; i < length; ++i) {
+			dataByte = (dataByte << 2) | ((buffer[i] - '0') & 0x3);
+			if ((i+1) % 4 == 0) {
+				packet[packetLength++] = (char)dataByte;
+				dataByte = 0;
+			}
+		}
+		if (length % 4 != 0) {
+			//Left align the last pulses
+			dataByte <<= (4 - length % 4)*2;
+			packet[packetLength++] = (char)dataByte;
+		}
+		packet[packetLength++] = '+';
+		return std::string(packet, packetLength);
+	}
+
+private:
+	char buffer[CAPACITY];
+	size_t length;
+	bool overflow;
+};
+
+#endif //PULSETRAIN_H
@@ -0,0 +1,236 @@
+#include "Scheduler.h"
+#include "DeviceManager.h"
+#include "EventHandler.h"
+#include "Log.h"
+#include "Message.h"
+#include "Mutex.h"
+#include "Settings.h"
+#include "Strings.h"
+#include "Timer.h"
+#include "TimerWheel.h"
+#include "../client/telldus-core.h"
+
+#include <stdlib.h>
+#include <map>
+#include <vector>
+
+typedef std::map<int, SchedulerJob> JobMap;
+
+namespace {
+	//The job fields saved in the settings, in the order of SchedulerJob
+	const char *JOB_DEVICE = "device";
+	const char *JOB_METHOD = "method";
+	const char *JOB_VALUE = "value";
+	const char *JOB_TYPE = "type";
+	const char *JOB_HOUR = "hour";
+	const char *JOB_MINUTE = "minute";
+	const char *JOB_OFFSET = "offset";
+	const char *JOB_WEEKDAYS = "weekdays";
+}
+
+class Scheduler::PrivateData {
+public:
+	PrivateData() : wheel(time(NULL)) {}
+
+	TelldusCore::EventHandler eventHandler;
+	TelldusCore::EventRef stopEvent, tickEvent;
+	Timer *timer;
+	DeviceManager *deviceManager;
+	Settings set;
+	TelldusCore::Mutex lock;
+	JobMap jobs;
+	TimerWheel wheel;
+	bool hasPosition;
+	double latitude, longitude;
+};
+
+Scheduler::Scheduler(DeviceManager *deviceManager)
+	:Thread()
+{
+	d = new PrivateData;
+	d->stopEvent = d->eventHandler.addEvent();
+	d->tickEvent = d->eventHandler.addEvent();
+	d->timer = new Timer(d->tickEvent);
+	d->timer->setInterval(1);
+	d->deviceManager = deviceManager;
+
+	std::string latitude = d->set.getSetting("schedulerLatitude");
+	std::string longitude = d->set.getSetting("schedulerLongitude");
+	d->hasPosition = (latitude.length() && longitude.length());
+	d->latitude = strtod(latitude.c_str(), NULL);
+	d->longitude = strtod(longitude.c_str(), NULL);
+
+	loadJobs();
+}
+
+Scheduler::~Scheduler() {
+	stop();
+	wait();
+	delete d->timer;
+	delete d;
+}
+
+int Scheduler::addJob(const SchedulerJob &job) {
+	if (!job.isValid()) {
+		return TELLSTICK_ERROR_SYNTAX;
+	}
+	TelldusCore::MutexLocker locker(&d->lock);
+	int id = d->set.addNode(Settings::Job);
+	if (id < 0) {
+		return id;
+	}
+	std::map<std::string, int> values;
+	values[JOB_DEVICE] = job.deviceId;
+	values[JOB_METHOD] = job.method;
+	values[JOB_VALUE] = job.methodValue;
+	values[JOB_TYPE] = job.type;
+	values[JOB_HOUR] = job.hour;
+	values[JOB_MINUTE] = job.minute;
+	values[JOB_OFFSET] = job.offset;
+	values[JOB_WEEKDAYS] = job.weekdays;
+	//Some backends only count nodes with a name
+	int retval = d->set.setJob(id, "", values);
+	if (retval != TELLSTICK_SUCCESS) {
+		d->set.removeNode(Settings::Job, id);
+		return retval;
+	}
+
+	SchedulerJob &added = d->jobs[id];
+	added = job;
+	added.id = id;
+	scheduleJob(added, time(NULL));
+	return id;
+}
+
+int Scheduler::removeJob(int jobId) {
+	TelldusCore::MutexLocker locker(&d->lock);
+	JobMap::iterator it = d->jobs.find(jobId);
+	if (it == d->jobs.end()) {
+		return TELLSTICK_ERROR_NOT_FOUND;
+	}
+	d->wheel.cancel(jobId);
+	d->jobs.erase(it);
+	return d->set.removeNode(Settings::Job, jobId);
+}
+
+std::string Scheduler::getJobs() const {
+	TelldusCore::MutexLocker locker(&d->lock);
+	time_t now = time(NULL);
+	TelldusCore::Message msg;
+	msg.addArgument((int)d->jobs.size());
+	for (JobMap::const_iterator it = d->jobs.begin(); it != d->jobs.end(); ++it) {
+		const SchedulerJob &job = it->second;
+		msg.addArgument(job.id);
+		msg.addArgument(job.deviceId);
+		msg.addArgument(job.method);
+		msg.addArgument(job.methodValue);
+		msg.addArgument(job.type);
+		msg.addArgument(job.hour);
+		msg.addArgument(job.minute);
+		msg.addArgument(job.offset);
+		msg.addArgument(job.weekdays);
+		int nextRunTime = 0;
+		if (d->wheel.isScheduled(job.id)) {
+			nextRunTime = (int)job.nextRunTime(now, d->latitude, d->longitude);
+		}
+		msg.addArgument(nextRunTime);
+	}
+	return msg;
+}
+
+void Scheduler::stop() {
+	d->stopEvent->signal();
+}
+
+void Scheduler::run() {
+	d->timer->start();
+	while(!d->stopEvent->isSignaled()) {
+		if (!d->eventHandler.waitForAny()) {
+			continue;
+		}
+		if (d->tickEvent->isSignaled()) {
+			//A late tick catches up on all seconds passed
+			while(d->tickEvent->isSignaled()) {
+				d->tickEvent->popSignal();
+			}
+			tick();
+		}
+	}
+	d->timer->stop();
+}
+
+void Scheduler::loadJobs() {
+	time_t now = time(NULL);
+	TelldusCore::MutexLocker locker(&d->lock);
+	int numberOfJobs = d->set.getNumberOfNodes(Settings::Job);
+	for (int i = 0; i < numberOfJobs; ++i) {
+		int id = d->set.getNodeId(Settings::Job, i);
+		if (id <= 0) {
+			continue;
+		}
+		SchedulerJob job;
+		job.id = id;
+		job.deviceId = d->set.getJobValue(id, JOB_DEVICE);
+		job.method = d->set.getJobValue(id, JOB_METHOD);
+		job.methodValue = d->set.getJobValue(id, JOB_VALUE);
+		job.type = d->set.getJobValue(id, JOB_TYPE);
+		job.hour = d->set.getJobValue(id, JOB_HOUR);
+		job.minute = d->set.getJobValue(id, JOB_MINUTE);
+		job.offset = d->set.getJobValue(id, JOB_OFFSET);
+		job.weekdays = d->set.getJobValue(id, JOB_WEEKDAYS);
+		if (!job.isValid()) {
+			Log::warning("Scheduled job %i is not valid, ignored", id);
+			continue;
+		}
+		d->jobs[id] = job;
+		scheduleJob(job, now);
+	}
+}
+
+void Scheduler::scheduleJob(const SchedulerJob &job, time_t after) {
+	//Private, the lock must be held
+	if (job.type != TELLSTICK_SCHEDULE_TIME && !d->hasPosition) {
+		Log::warning("Scheduled job %i needs schedulerLatitude and schedulerLongitude to be set", job.id);
+		return;
+	}
+	time_t runTime = job.nextRunTime(after, d->latitude, d->longitude);
+	if (runTime == 0) {
+		Log::warning("Scheduled job %i will never run", job.id);
+		return;
+	}
+	d->wheel.schedule(job.id, runTime);
+}
+
+void Scheduler::tick() {
+	time_t now = time(NULL);
+	std::vector<SchedulerJob> due;
+	{
+		TelldusCore::MutexLocker locker(&d->lock);
+		std::vector<int> expired;
+		d->wheel.advance(now, &expired);
+		for (size_t i = 0; i < expired.size(); ++i) {
+			JobMap::iterator it = d->jobs.find(expired[i]);
+			if (it == d->jobs.end()) {
+				continue;
+			}
+			due.push_back(it->second);
+			if (it->second.runsOnce()) {
+				d->jobs.erase(it);
+				d->set.removeNode(Settings::Job, expired[i]);
+			} else {
+				scheduleJob(it->second, now);
+			}
+		}
+	}
+
+	//Not under the lock, sending may take a while
+	for (size_t i = 0; i < due.size(); ++i) {
+		const SchedulerJob &job = due[i];
+		int retval = d->deviceManager->doAction(job.deviceId, job.method, (unsigned char)job.methodValue);
+		if (retval == TELLSTICK_SUCCESS) {
+			Log::notice("Scheduled job %i run on device %i", job.id, job.deviceId);
+		} else {
+			Log::warning("Scheduled job %i on device %i failed: %i", job.id, job.deviceId, retval);
+		}
+	}
+}
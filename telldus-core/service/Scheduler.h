@@ -0,0 +1,43 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "Thread.h"
+#include "SchedulerJob.h"
+#include <string>
+
+class DeviceManager;
+
+/**
+ * Runs scheduled jobs on devices, without needing a client to be running.
+ *
+ * The jobs are saved in the settings and put in a timer wheel with the time
+ * they should run next. Once a second the wheel is advanced and the jobs due
+ * are run by the DeviceManager. Jobs missed while the service was not
+ * running are not run afterwards.
+ */
+class Scheduler : public TelldusCore::Thread
+{
+public:
+	Scheduler(DeviceManager *deviceManager);
+	~Scheduler();
+
+	//Returns the id of the new job
+	int addJob(const SchedulerJob &job);
+	int removeJob(int jobId);
+	std::string getJobs() const;
+
+	void stop();
+
+protected:
+	void run();
+
+private:
+	void loadJobs();
+	void scheduleJob(const SchedulerJob &job, time_t after);
+	void tick();
+
+	class PrivateData;
+	PrivateData *d;
+};
+
+#endif // SCHEDULER_H
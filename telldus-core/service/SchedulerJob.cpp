@@ -0,0 +1,75 @@
+#include "SchedulerJob.h"
+#include "SunCalculator.h"
+#include "../client/telldus-core.h"
+
+namespace {
+	//Enough to find the next sunrise after a polar night
+	const int MAX_DAYS_AHEAD = 366;
+}
+
+SchedulerJob::SchedulerJob()
+	:id(0), deviceId(0), method(0), methodValue(0), type(TELLSTICK_SCHEDULE_TIME), hour(0), minute(0), offset(0), weekdays(0)
+{
+}
+
+bool SchedulerJob::isValid() const {
+	if (type != TELLSTICK_SCHEDULE_TIME && type != TELLSTICK_SCHEDULE_SUNRISE && type != TELLSTICK_SCHEDULE_SUNSET) {
+		return false;
+	}
+	if (hour < 0 || hour > 23 || minute < 0 || minute > 59) {
+		return false;
+	}
+	if (offset < -24*60 || offset > 24*60) {
+		return false;
+	}
+	return (weekdays >= 0 && weekdays <= 0x7F);
+}
+
+bool SchedulerJob::runsOnce() const {
+	return weekdays == 0;
+}
+
+time_t SchedulerJob::nextRunTime(time_t after, double latitude, double longitude) const {
+	struct tm today;
+#ifdef _WINDOWS
+	localtime_s(&today, &after);
+#else
+	localtime_r(&after, &today);
+#endif
+
+	//A negative offset may move the time back from the next day, start a day early
+	for (int i = -1; i <= MAX_DAYS_AHEAD; ++i) {
+		struct tm date = today;
+		date.tm_mday += i;
+		date.tm_hour = 12;
+		date.tm_min = 0;
+		date.tm_sec = 0;
+		date.tm_isdst = -1;
+		if (mktime(&date) == -1) {
+			continue;
+		}
+		//tm_wday is 0 for Sunday
+		if (weekdays && !(weekdays & (1 << ((date.tm_wday + 6) % 7)))) {
+			continue;
+		}
+
+		time_t runTime;
+		if (type == TELLSTICK_SCHEDULE_TIME) {
+			date.tm_hour = hour;
+			date.tm_min = minute;
+			date.tm_isdst = -1;
+			runTime = mktime(&date);
+		} else {
+			time_t sunrise, sunset;
+			if (!SunCalculator::calculate(date.tm_year + 1900, date.tm_mon + 1, date.tm_mday, latitude, longitude, &sunrise, &sunset)) {
+				continue;
+			}
+			runTime = (type == TELLSTICK_SCHEDULE_SUNRISE ? sunrise : sunset);
+		}
+		runTime += offset*60;
+		if (runTime > after) {
+			return runTime;
+		}
+	}
+	return 0;
+}
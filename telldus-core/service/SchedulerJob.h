@@ -0,0 +1,36 @@
+#ifndef SCHEDULERJOB_H
+#define SCHEDULERJOB_H
+
+#include <time.h>
+
+/**
+ * A device action run by the scheduler at a time of day, or at sunrise or
+ * sunset, on some days of the week.
+ */
+class SchedulerJob
+{
+public:
+	SchedulerJob();
+
+	int id, deviceId, method, methodValue;
+	//One of TELLSTICK_SCHEDULE_TIME, TELLSTICK_SCHEDULE_SUNRISE or TELLSTICK_SCHEDULE_SUNSET
+	int type;
+	//Local time for TELLSTICK_SCHEDULE_TIME
+	int hour, minute;
+	//Minutes added to the time, may be negative
+	int offset;
+	//Bit 0 is Monday, bit 6 is Sunday. 0 runs the job once.
+	int weekdays;
+
+	bool isValid() const;
+	bool runsOnce() const;
+
+	/**
+	 * The first time after after the job should run, 0 if never. Times of
+	 * day are local time, with daylight saving time as it is on that day.
+	 * The position is needed for sunrise and sunset.
+	 */
+	time_t nextRunTime(time_t after, double latitude, double longitude) const;
+};
+
+#endif // SCHEDULERJOB_H
@@ -1,34 +1,55 @@
 #include "Sensor.h"
 #include "common.h"
 #include "../client/telldus-core.h"
-#include <map>
 
 class Sensor::PrivateData {
 public:
-	std::wstring protocol, model;
+	std::string protocol, model;
 	int id;
-	std::map<int, std::string> values;
+	Readings readings;
 	time_t timestamp;
+	bool pinned;
+	Readings signalled;
+	int suppressed;
+	Retention retention;
+	//Created for a data type when its first value arrives, so each type
+	//gets the full history depth
+	SensorHistory *histories[MAX_DATA_TYPES];
+	SensorRollup *rollups[MAX_DATA_TYPES];
 };
 
-Sensor::Sensor(const std::wstring &protocol, const std::wstring &model, int id)
+Sensor::Sensor(const std::string &protocol, const std::string &model, int id, const Retention &retention)
 	:Mutex()
 {
 	d = new PrivateData;
+	d->retention = retention;
+	for (int i = 0; i < MAX_DATA_TYPES; ++i) {
+		d->histories[i] = 0;
+		d->rollups[i] = 0;
+	}
 	d->protocol = protocol;
 	d->model = model;
 	d->id = id;
+	d->readings.dataTypes = 0;
+	d->timestamp = 0;
+	d->pinned = false;
+	d->signalled.dataTypes = 0;
+	d->suppressed = 0;
 }
 
 Sensor::~Sensor() {
+	for (int i = 0; i < MAX_DATA_TYPES; ++i) {
+		delete d->histories[i];
+		delete d->rollups[i];
+	}
 	delete d;
 }
 
-std::wstring Sensor::protocol() const {
+std::string Sensor::protocol() const {
 	return d->protocol;
 }
 
-std::wstring Sensor::model() const {
+std::string Sensor::model() const {
 	return d->model;
 }
 
@@ -40,28 +61,111 @@ time_t Sensor::timestamp() const {
 	return d->timestamp;
 }
 
-int Sensor::dataTypes() const {
-	int retval = 0;
-	for (std::map<int, std::string>::iterator it = d->values.begin(); it != d->values.end(); ++it) {
-		retval |= (*it).first;
+time_t Sensor::timestamp(int type) const {
+	const Reading *reading = d->readings.find(type);
+	if (!reading) {
+		return 0;
 	}
-	return retval;
+	return reading->timestamp;
+}
+
+int Sensor::dataTypes() const {
+	return d->readings.dataTypes;
+}
+
+bool Sensor::isPinned() const {
+	return d->pinned;
+}
+
+void Sensor::setPinned(bool pinned) {
+	d->pinned = pinned;
 }
 
-void Sensor::setValue(int type, const std::string &value, time_t timestamp) {
-	if (value.substr(0,2).compare("0x") == 0) {
-		int intval = strtol(value.c_str(), NULL, 16);
-		d->values[type] = TelldusCore::intToString(intval);
-	} else {
-		d->values[type] = value;
+void Sensor::setValue(const SensorRecord::Value &value, time_t timestamp) {
+	int slot = slotForDataType(value.dataType);
+	if (slot < 0) {
+		return;
 	}
+	d->readings.values[slot].value = value.value;
+	d->readings.values[slot].decimals = value.decimals;
+	d->readings.values[slot].timestamp = timestamp;
+	d->readings.dataTypes |= value.dataType;
 	d->timestamp = timestamp;
+	if (!d->histories[slot]) {
+		d->histories[slot] = new SensorHistory(d->retention.history);
+	}
+	d->histories[slot]->append(value.dataType, value.value, value.decimals, timestamp);
+	if (!d->rollups[slot]) {
+		d->rollups[slot] = new SensorRollup(d->retention.rollups);
+	}
+	d->rollups[slot]->add(value.value, value.decimals, timestamp);
 }
 
 std::string Sensor::value(int type) const {
-	std::map<int, std::string>::const_iterator it = d->values.find(type);
-	if (it == d->values.end()) {
+	const Reading *reading = d->readings.find(type);
+	if (!reading) {
 		return "";
 	}
-	return (*it).second;
+	//Kept in fixed point, only formatted when asked for
+	return SensorRecord::formatValue(reading->value, reading->decimals);
+}
+
+const Sensor::Reading *Sensor::lastSignalled(int dataType) const {
+	return d->signalled.find(dataType);
+}
+
+void Sensor::setSignalled(const SensorRecord::Value &value, time_t timestamp) {
+	int slot = slotForDataType(value.dataType);
+	if (slot < 0) {
+		return;
+	}
+	d->signalled.values[slot].value = value.value;
+	d->signalled.values[slot].decimals = value.decimals;
+	d->signalled.values[slot].timestamp = timestamp;
+	d->signalled.dataTypes |= value.dataType;
+}
+
+void Sensor::countSuppressed() {
+	++d->suppressed;
+}
+
+int Sensor::suppressed() const {
+	return d->suppressed;
+}
+
+void Sensor::readings(Readings *readings) const {
+	*readings = d->readings;
+}
+
+void Sensor::history(int dataType, time_t from, time_t to, std::vector<SensorHistory::Sample> *samples) const {
+	int slot = slotForDataType(dataType);
+	if (slot < 0 || !d->histories[slot]) {
+		return;
+	}
+	d->histories[slot]->range(dataType, from, to, samples);
+}
+
+void Sensor::rollup(int dataType, int resolution, time_t from, time_t to, std::vector<SensorRollup::Bucket> *buckets) const {
+	int slot = slotForDataType(dataType);
+	if (slot < 0 || !d->rollups[slot]) {
+		return;
+	}
+	d->rollups[slot]->range(resolution, from, to, buckets);
+}
+
+int Sensor::slotForDataType(int dataType) {
+	for (int slot = 0; slot < MAX_DATA_TYPES; ++slot) {
+		if (dataType == (1 << slot)) {
+			return slot;
+		}
+	}
+	return -1;
+}
+
+const Sensor::Reading *Sensor::Readings::find(int dataType) const {
+	int slot = Sensor::slotForDataType(dataType);
+	if (slot < 0 || !(dataTypes & dataType)) {
+		return 0;
+	}
+	return &values[slot];
 }
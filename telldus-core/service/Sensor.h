@@ -2,24 +2,90 @@
 #define SENSOR_H
 
 #include "Mutex.h"
+#include "SensorHistory.h"
+#include "SensorRecord.h"
+#include "SensorRollup.h"
 #include <string>
+#include <time.h>
 
 class Sensor : public TelldusCore::Mutex
 {
 public:
-	Sensor(const std::wstring &protocol, const std::wstring &model, int id);
+	//Data types are single bits, one slot is kept for each
+	enum { MAX_DATA_TYPES = 8 };
+
+	class Reading {
+	public:
+		int value, decimals;
+		time_t timestamp;
+	};
+
+	/**
+	 * A copy of everything the sensor has reported, indexed by the bit
+	 * number of the data type.
+	 */
+	class Readings {
+	public:
+		int dataTypes;
+		Reading values[MAX_DATA_TYPES];
+
+		const Reading *find(int dataType) const;
+	};
+
+	//How much the sensor keeps of the values it has reported, per data type
+	class Retention {
+	public:
+		size_t history;
+		size_t rollups[SensorRollup::NUMBER_OF_RESOLUTIONS];
+	};
+
+	Sensor(const std::string &protocol, const std::string &model, int id, const Retention &retention);
 	~Sensor();
 
-	std::wstring protocol() const;
-	std::wstring model() const;
+	std::string protocol() const;
+	std::string model() const;
 	int id() const;
 	time_t timestamp() const;
+	time_t timestamp(int type) const;
 
 	int dataTypes() const;
 
-	void setValue(int type, const std::string &value, time_t timestamp);
+	//Pinned sensors are never evicted from the service's list of sensors
+	bool isPinned() const;
+	void setPinned(bool pinned);
+
+	void setValue(const SensorRecord::Value &value, time_t timestamp);
+
+	/**
+	 * The last value of a data type signalled to the clients, 0 if none.
+	 * Values held back by the event policy are only counted.
+	 */
+	const Reading *lastSignalled(int dataType) const;
+	void setSignalled(const SensorRecord::Value &value, time_t timestamp);
+	void countSuppressed();
+	int suppressed() const;
 	std::string value(int type) const;
 
+	/**
+	 * Copies all values and their timestamps at once, so the lock on the
+	 * sensor only has to be held for this call.
+	 */
+	void readings(Readings *readings) const;
+
+	/**
+	 * The values of one data type received between from and to, from the
+	 * sensor's history. Oldest first.
+	 */
+	void history(int dataType, time_t from, time_t to, std::vector<SensorHistory::Sample> *samples) const;
+
+	/**
+	 * The min, max and average of one data type per minute, hour or day,
+	 * for the buckets starting between from and to. Oldest first.
+	 */
+	void rollup(int dataType, int resolution, time_t from, time_t to, std::vector<SensorRollup::Bucket> *buckets) const;
+
+	static int slotForDataType(int dataType);
+
 private:
 	class PrivateData;
 	PrivateData *d;
@@ -0,0 +1,79 @@
+#include "SensorEventPolicy.h"
+#include "Strings.h"
+#include <vector>
+
+namespace {
+	int64_t scaled(int value, int decimals, int toDecimals) {
+		int64_t retval = value;
+		for (int i = decimals; i < toDecimals; ++i) {
+			retval *= 10;
+		}
+		return retval;
+	}
+}
+
+class SensorEventPolicy::PrivateData {
+public:
+	std::vector<SensorRecord::Value> deadbands;
+	int heartbeat;
+};
+
+SensorEventPolicy::SensorEventPolicy() {
+	d = new PrivateData;
+	d->heartbeat = 0;
+}
+
+SensorEventPolicy::~SensorEventPolicy() {
+	delete d;
+}
+
+void SensorEventPolicy::setDeadband(int dataType, int value, int decimals) {
+	SensorRecord::Value deadband;
+	deadband.dataType = dataType;
+	deadband.value = (value < 0 ? -value : value);
+	deadband.decimals = decimals;
+	for (size_t i = 0; i < d->deadbands.size(); ++i) {
+		if (d->deadbands[i].dataType == dataType) {
+			d->deadbands[i] = deadband;
+			return;
+		}
+	}
+	d->deadbands.push_back(deadband);
+}
+
+void SensorEventPolicy::setHeartbeat(int seconds) {
+	d->heartbeat = seconds;
+}
+
+bool SensorEventPolicy::shouldSignal(const Sensor::Reading *last, const SensorRecord::Value &value, time_t timestamp) const {
+	if (!last) {
+		return true;
+	}
+	const SensorRecord::Value *deadband = 0;
+	for (size_t i = 0; i < d->deadbands.size(); ++i) {
+		if (d->deadbands[i].dataType == value.dataType) {
+			deadband = &d->deadbands[i];
+			break;
+		}
+	}
+	if (!deadband) {
+		return true;
+	}
+	if (d->heartbeat > 0 && timestamp - last->timestamp >= d->heartbeat) {
+		return true;
+	}
+
+	//Compared with the most decimals of the three
+	int decimals = value.decimals;
+	if (last->decimals > decimals) {
+		decimals = last->decimals;
+	}
+	if (deadband->decimals > decimals) {
+		decimals = deadband->decimals;
+	}
+	int64_t difference = scaled(value.value, value.decimals, decimals) - scaled(last->value, last->decimals, decimals);
+	if (difference < 0) {
+		difference = -difference;
+	}
+	return difference > scaled(deadband->value, deadband->decimals, decimals);
+}
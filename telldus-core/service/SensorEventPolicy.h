@@ -0,0 +1,38 @@
+#ifndef SENSOREVENTPOLICY_H
+#define SENSOREVENTPOLICY_H
+
+#include "Sensor.h"
+#include "SensorRecord.h"
+#include <time.h>
+
+/**
+ * Decides which sensor values are signalled to the clients.
+ *
+ * By default every value is. Sensors repeat their value every minute or so,
+ * often several frames at a time, so a deadband can be set per data type.
+ * Then a value is only signalled if it differs from the last one signalled
+ * by more than the deadband, or if the heartbeat interval has passed since.
+ */
+class SensorEventPolicy
+{
+public:
+	SensorEventPolicy();
+	~SensorEventPolicy();
+
+	//The deadband is a fixed point value, like the sensor values
+	void setDeadband(int dataType, int value, int decimals);
+
+	//0 to never signal a value within the deadband
+	void setHeartbeat(int seconds);
+
+	/**
+	 * @param last The last value signalled for the data type, 0 if none.
+	 */
+	bool shouldSignal(const Sensor::Reading *last, const SensorRecord::Value &value, time_t timestamp) const;
+
+private:
+	class PrivateData;
+	PrivateData *d;
+};
+
+#endif // SENSOREVENTPOLICY_H
@@ -0,0 +1,60 @@
+#include "SensorHistory.h"
+
+class SensorHistory::PrivateData {
+public:
+	std::vector<Sample> samples;
+	size_t first, count;
+};
+
+SensorHistory::SensorHistory(size_t depth)
+{
+	d = new PrivateData;
+	//Allocated once, up front, so appending never allocates
+	d->samples.resize(depth);
+	d->first = 0;
+	d->count = 0;
+}
+
+SensorHistory::~SensorHistory() {
+	delete d;
+}
+
+size_t SensorHistory::depth() const {
+	return d->samples.size();
+}
+
+size_t SensorHistory::size() const {
+	return d->count;
+}
+
+void SensorHistory::append(int dataType, int value, int decimals, time_t timestamp) {
+	size_t depth = d->samples.size();
+	if (depth == 0) {
+		return;
+	}
+	size_t index;
+	if (d->count < depth) {
+		index = (d->first + d->count) % depth;
+		++d->count;
+	} else {
+		//Full, overwrite the oldest
+		index = d->first;
+		d->first = (d->first + 1) % depth;
+	}
+	Sample &sample = d->samples[index];
+	sample.timestamp = timestamp;
+	sample.dataType = dataType;
+	sample.value = value;
+	sample.decimals = decimals;
+}
+
+void SensorHistory::range(int dataType, time_t from, time_t to, std::vector<Sample> *samples) const {
+	size_t depth = d->samples.size();
+	for (size_t i = 0; i < d->count; ++i) {
+		const Sample &sample = d->samples[(d->first + i) % depth];
+		if (sample.dataType != dataType || sample.timestamp < from || sample.timestamp > to) {
+			continue;
+		}
+		samples->push_back(sample);
+	}
+}
@@ -0,0 +1,39 @@
+#ifndef SENSORHISTORY_H
+#define SENSORHISTORY_H
+
+#include <time.h>
+#include <vector>
+
+/**
+ * The latest values received from one sensor, kept in a ring buffer of
+ * fixed depth. When it is full the oldest sample is overwritten.
+ */
+class SensorHistory
+{
+public:
+	class Sample {
+	public:
+		time_t timestamp;
+		int dataType, value, decimals;
+	};
+
+	SensorHistory(size_t depth);
+	~SensorHistory();
+
+	size_t depth() const;
+	size_t size() const;
+
+	void append(int dataType, int value, int decimals, time_t timestamp);
+
+	/**
+	 * Appends the samples of a data type received between from and to,
+	 * inclusive, to samples. Oldest first.
+	 */
+	void range(int dataType, time_t from, time_t to, std::vector<Sample> *samples) const;
+
+private:
+	class PrivateData;
+	PrivateData *d;
+};
+
+#endif // SENSORHISTORY_H
@@ -0,0 +1,155 @@
+#include "SensorRecord.h"
+#include "ControllerMessage.h"
+#include "Strings.h"
+#include "../client/telldus-core.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+	//The name of each data type in the message format
+	const struct {
+		const char *name;
+		int dataType;
+	} dataTypeNames[] = {
+		{"temp", TELLSTICK_TEMPERATURE},
+		{"humidity", TELLSTICK_HUMIDITY}
+	};
+	const size_t numberOfDataTypes = sizeof(dataTypeNames)/sizeof(dataTypeNames[0]);
+
+	void copyName(char *dest, size_t size, const char *src) {
+		strncpy(dest, src, size-1);
+		dest[size-1] = '\0';
+	}
+}
+
+SensorRecord::SensorRecord()
+	:id(0), numberOfValues(0)
+{
+	protocol[0] = '\0';
+	model[0] = '\0';
+}
+
+SensorRecord::SensorRecord(const char *protocolName, const char *modelName, int sensorId)
+	:id(sensorId), numberOfValues(0)
+{
+	copyName(protocol, sizeof(protocol), protocolName);
+	copyName(model, sizeof(model), modelName);
+}
+
+bool SensorRecord::isValid() const {
+	return (protocol[0] != '\0' && numberOfValues > 0);
+}
+
+void SensorRecord::addValue(int dataType, int value, int decimals) {
+	if (numberOfValues >= MAX_VALUES) {
+		return;
+	}
+	values[numberOfValues].dataType = dataType;
+	values[numberOfValues].value = value;
+	values[numberOfValues].decimals = decimals;
+	++numberOfValues;
+}
+
+const SensorRecord::Value *SensorRecord::findValue(int dataType) const {
+	for (int i = 0; i < numberOfValues; ++i) {
+		if (values[i].dataType == dataType) {
+			return &values[i];
+		}
+	}
+	return 0;
+}
+
+std::string SensorRecord::toString() const {
+	std::string retval = "class:sensor;protocol:";
+	retval.append(protocol).append(";model:").append(model);
+	retval.append(";id:").append(TelldusCore::intToString(id)).append(";");
+	for (int i = 0; i < numberOfValues; ++i) {
+		for (size_t j = 0; j < numberOfDataTypes; ++j) {
+			if (dataTypeNames[j].dataType == values[i].dataType) {
+				retval.append(dataTypeNames[j].name).append(":");
+				retval.append(formatValue(values[i].value, values[i].decimals)).append(";");
+				break;
+			}
+		}
+	}
+	return retval;
+}
+
+std::string SensorRecord::formatValue(int value, int decimals) {
+	char buf[24];
+	char *p = buf + sizeof(buf);
+	*--p = '\0';
+	if (decimals < 0 || decimals > 9) {
+		decimals = 0;
+	}
+	bool negative = (value < 0);
+	unsigned int v = (negative ? 0u - (unsigned int)value : (unsigned int)value);
+	for (int i = 0; i < decimals; ++i) {
+		*--p = '0' + (v % 10);
+		v /= 10;
+	}
+	if (decimals > 0) {
+		*--p = '.';
+	}
+	do {
+		*--p = '0' + (v % 10);
+		v /= 10;
+	} while (v > 0);
+	if (negative) {
+		*--p = '-';
+	}
+	return p;
+}
+
+bool SensorRecord::parseValue(const std::string &text, int *value, int *decimals) {
+	const char *p = text.c_str();
+	if (text.substr(0, 2).compare("0x") == 0) {
+		*value = strtol(p, NULL, 16);
+		*decimals = 0;
+		return true;
+	}
+	bool negative = (*p == '-');
+	if (negative) {
+		++p;
+	}
+	int v = 0, d = 0;
+	bool fraction = false, digits = false;
+	for (; *p; ++p) {
+		if (*p == '.' && !fraction) {
+			fraction = true;
+			continue;
+		}
+		if (*p < '0' || *p > '9') {
+			break;
+		}
+		if (fraction) {
+			if (d >= 3) {
+				continue; //More precision than any sensor reports
+			}
+			++d;
+		}
+		v = v*10 + (*p - '0');
+		digits = true;
+	}
+	if (!digits) {
+		return false;
+	}
+	*value = (negative ? -v : v);
+	*decimals = d;
+	return true;
+}
+
+bool SensorRecord::fromMessage(const ControllerMessage &msg, SensorRecord *record) {
+	if (!msg.isClass("sensor")) {
+		return false;
+	}
+	*record = SensorRecord(msg.protocol().c_str(), msg.model().c_str(), msg.getIntParameter("id"));
+	for (size_t i = 0; i < numberOfDataTypes; ++i) {
+		int value, decimals;
+		if (msg.hasParameter(dataTypeNames[i].name) && parseValue(msg.getParameter(dataTypeNames[i].name), &value, &decimals)) {
+			record->addValue(dataTypeNames[i].dataType, value, decimals);
+		}
+	}
+	return true;
+}
@@ -0,0 +1,52 @@
+#ifndef SENSORRECORD_H
+#define SENSORRECORD_H
+
+#include <string>
+
+class ControllerMessage;
+
+/**
+ * A decoded sensor reading.
+ *
+ * Values are fixed point, the real value is value/10^decimals. Text is only
+ * produced from a record when it is handed to a client.
+ */
+class SensorRecord {
+public:
+	enum { MAX_VALUES = 4 };
+
+	class Value {
+	public:
+		int dataType, value, decimals;
+	};
+
+	SensorRecord();
+	SensorRecord(const char *protocol, const char *model, int id);
+
+	bool isValid() const;
+	void addValue(int dataType, int value, int decimals);
+	const Value *findValue(int dataType) const;
+
+	/**
+	 * The record in the message format used by the controllers, like
+	 * "class:sensor;protocol:fineoffset;model:temperature;id:12;temp:21.5;"
+	 */
+	std::string toString() const;
+
+	static std::string formatValue(int value, int decimals);
+	static bool parseValue(const std::string &text, int *value, int *decimals);
+
+	/**
+	 * Fills the record from a message in text form.
+	 * @return false if this isn't a sensor message.
+	 */
+	static bool fromMessage(const ControllerMessage &msg, SensorRecord *record);
+
+	char protocol[16];
+	char model[32];
+	int id;
+	int numberOfValues;
+	Value values[MAX_VALUES];
+};
+
+#endif //SENSORRECORD_H
@@ -0,0 +1,119 @@
+#include "SensorRollup.h"
+
+namespace {
+	const int INTERVALS[SensorRollup::NUMBER_OF_RESOLUTIONS] = {60, 60*60, 24*60*60};
+
+	int rescale(int value, int fromDecimals, int toDecimals) {
+		for(; fromDecimals < toDecimals; ++fromDecimals) {
+			value *= 10;
+		}
+		for(; fromDecimals > toDecimals; --fromDecimals) {
+			value /= 10;
+		}
+		return value;
+	}
+
+	//The buckets of one resolution
+	class Series {
+	public:
+		std::vector<SensorRollup::Bucket> buckets;
+		size_t depth, first;
+
+		SensorRollup::Bucket *newest() {
+			if (buckets.empty()) {
+				return 0;
+			}
+			return &buckets[(first + buckets.size() - 1) % buckets.size()];
+		}
+
+		void append(const SensorRollup::Bucket &bucket) {
+			if (buckets.size() < depth) {
+				//Still growing, the oldest is at index 0
+				if (buckets.empty()) {
+					//All at once, growing by doubling could take up to twice the depth
+					buckets.reserve(depth);
+				}
+				buckets.push_back(bucket);
+				return;
+			}
+			buckets[first] = bucket;
+			first = (first + 1) % depth;
+		}
+	};
+}
+
+class SensorRollup::PrivateData {
+public:
+	Series series[NUMBER_OF_RESOLUTIONS];
+};
+
+SensorRollup::SensorRollup(const size_t depths[NUMBER_OF_RESOLUTIONS])
+{
+	d = new PrivateData;
+	for (int i = 0; i < NUMBER_OF_RESOLUTIONS; ++i) {
+		d->series[i].depth = depths[i];
+		d->series[i].first = 0;
+	}
+}
+
+SensorRollup::~SensorRollup() {
+	delete d;
+}
+
+void SensorRollup::add(int value, int decimals, time_t timestamp) {
+	for (int i = 0; i < NUMBER_OF_RESOLUTIONS; ++i) {
+		Series &series = d->series[i];
+		if (series.depth == 0) {
+			continue;
+		}
+		time_t start = timestamp - (timestamp % INTERVALS[i]);
+		Bucket *bucket = series.newest();
+		if (bucket && bucket->start == start) {
+			int v = rescale(value, decimals, bucket->decimals);
+			bucket->min = (v < bucket->min ? v : bucket->min);
+			bucket->max = (v > bucket->max ? v : bucket->max);
+			bucket->sum += v;
+			++bucket->count;
+		} else if (!bucket || start > bucket->start) {
+			Bucket newBucket;
+			newBucket.start = start;
+			newBucket.min = newBucket.max = value;
+			newBucket.sum = value;
+			newBucket.count = 1;
+			newBucket.decimals = decimals;
+			series.append(newBucket);
+		}
+		//Else the clock has been set back, the bucket is already gone
+	}
+}
+
+void SensorRollup::range(int resolution, time_t from, time_t to, std::vector<Bucket> *buckets) const {
+	if (resolution < 0 || resolution >= NUMBER_OF_RESOLUTIONS) {
+		return;
+	}
+	const Series &series = d->series[resolution];
+	size_t size = series.buckets.size();
+	for (size_t i = 0; i < size; ++i) {
+		const Bucket &bucket = series.buckets[(series.first + i) % size];
+		if (bucket.start < from || bucket.start > to) {
+			continue;
+		}
+		buckets->push_back(bucket);
+	}
+}
+
+int SensorRollup::interval(int resolution) {
+	if (resolution < 0 || resolution >= NUMBER_OF_RESOLUTIONS) {
+		return 0;
+	}
+	return INTERVALS[resolution];
+}
+
+int SensorRollup::Bucket::average() const {
+	if (count == 0) {
+		return 0;
+	}
+	//Rounded half away from zero, as the values themselves
+	int64_t half = count/2;
+	return (int)(sum >= 0 ? (sum + half) / count : (sum - half) / count);
+}
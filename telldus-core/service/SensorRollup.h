@@ -0,0 +1,49 @@
+#ifndef SENSORROLLUP_H
+#define SENSORROLLUP_H
+
+#include "Strings.h"
+#include <time.h>
+#include <vector>
+
+/**
+ * Min, max and average of one sensor value per minute, hour and day.
+ *
+ * Each value received updates the current bucket of every resolution in
+ * constant time. The buckets of a resolution are kept in a ring buffer
+ * that grows up to its depth, after that the oldest bucket is reused.
+ * Buckets are aligned to UTC.
+ */
+class SensorRollup
+{
+public:
+	enum { MINUTE = 0, HOUR, DAY, NUMBER_OF_RESOLUTIONS };
+
+	class Bucket {
+	public:
+		time_t start;
+		int min, max, count, decimals;
+		int64_t sum;
+
+		int average() const;
+	};
+
+	SensorRollup(const size_t depths[NUMBER_OF_RESOLUTIONS]);
+	~SensorRollup();
+
+	void add(int value, int decimals, time_t timestamp);
+
+	/**
+	 * Appends the buckets of a resolution starting between from and to,
+	 * inclusive, to buckets. Oldest first.
+	 */
+	void range(int resolution, time_t from, time_t to, std::vector<Bucket> *buckets) const;
+
+	//The length of a bucket, in seconds
+	static int interval(int resolution);
+
+private:
+	class PrivateData;
+	PrivateData *d;
+};
+
+#endif // SENSORROLLUP_H
@@ -0,0 +1,55 @@
+#ifndef SENSORSTORE_H
+#define SENSORSTORE_H
+
+#include "SensorRecord.h"
+#include <string>
+#include <time.h>
+
+/**
+ * Sensor values saved to disk so they survive a restart.
+ *
+ * The file holds a fixed number of fixed size records and is memory
+ * mapped. When it is full the oldest record is overwritten. New values are
+ * collected in memory and written to the file together by a background
+ * thread, once per flush interval, to spare flash media. Appending never
+ * waits for the file.
+ */
+class SensorStore
+{
+public:
+	class Entry {
+	public:
+		char protocol[16];
+		char model[32];
+		int id;
+		SensorRecord::Value value;
+		time_t timestamp;
+	};
+
+	SensorStore();
+	~SensorStore();
+
+	/**
+	 * Opens the store, creating the file if needed. A file of another
+	 * capacity is resized, keeping the newest entries.
+	 */
+	bool open(const std::string &path, size_t capacity, int flushInterval);
+	bool isOpen() const;
+
+	//The number of entries in the file, not counting those not yet written
+	size_t size() const;
+
+	//Entries in the file, oldest first
+	bool entry(size_t index, Entry *entry) const;
+
+	void append(const Entry &entry);
+
+	//Writes the collected entries now
+	void flush();
+
+private:
+	class PrivateData;
+	PrivateData *d;
+};
+
+#endif // SENSORSTORE_H
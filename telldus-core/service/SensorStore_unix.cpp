@@ -0,0 +1,313 @@
+#include "SensorStore.h"
+#include "Log.h"
+#include "Mutex.h"
+#include "Strings.h"
+#include "Thread.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <deque>
+#include <vector>
+
+namespace {
+	const char MAGIC[4] = {'T', 'D', 'S', 'S'};
+	const uint32_t FILE_VERSION = 1;
+
+	//Everything is stored in the byte order of the host
+	class FileHeader {
+	public:
+		char magic[4];
+		uint32_t version, recordSize, capacity, first, count;
+	};
+
+	class FileRecord {
+	public:
+		uint32_t timestamp;
+		int32_t value, id;
+		uint8_t dataType;
+		int8_t decimals;
+		uint8_t reserved[2];
+		char protocol[16];
+		char model[32];
+	};
+
+	//The records start after this, to keep them aligned
+	const size_t HEADER_SIZE = 64;
+
+	size_t fileSize(size_t capacity) {
+		return HEADER_SIZE + capacity*sizeof(FileRecord);
+	}
+
+	void copyString(char *dest, const char *src, size_t size) {
+		strncpy(dest, src, size);
+		dest[size-1] = 0;
+	}
+
+	//Writes the pending entries once per flush interval
+	class Flusher : public TelldusCore::Thread {
+	public:
+		Flusher(SensorStore *store, int interval);
+		~Flusher();
+
+	protected:
+		void run();
+
+	private:
+		SensorStore *store;
+		int interval;
+		bool running;
+		pthread_mutex_t mutex;
+		pthread_cond_t cond;
+	};
+
+	Flusher::Flusher(SensorStore *s, int i)
+		:TelldusCore::Thread(), store(s), interval(i > 0 ? i : 1), running(true)
+	{
+		pthread_mutex_init(&mutex, NULL);
+		pthread_cond_init(&cond, NULL);
+	}
+
+	Flusher::~Flusher() {
+		pthread_mutex_lock(&mutex);
+		running = false;
+		pthread_cond_signal(&cond);
+		pthread_mutex_unlock(&mutex);
+		this->wait();
+		pthread_cond_destroy(&cond);
+		pthread_mutex_destroy(&mutex);
+	}
+
+	void Flusher::run() {
+		pthread_mutex_lock(&mutex);
+		while (running) {
+			struct timeval tp;
+			gettimeofday(&tp, NULL);
+			struct timespec ts;
+			ts.tv_sec = tp.tv_sec + interval;
+			ts.tv_nsec = tp.tv_usec * 1000;
+			int rc = pthread_cond_timedwait(&cond, &mutex, &ts);
+			if (rc == ETIMEDOUT && running) {
+				pthread_mutex_unlock(&mutex);
+				store->flush();
+				pthread_mutex_lock(&mutex);
+			}
+		}
+		pthread_mutex_unlock(&mutex);
+	}
+}
+
+class SensorStore::PrivateData {
+public:
+	int fd;
+	char *map;
+	size_t mapSize;
+	FileHeader *header;
+	FileRecord *records;
+	//Held by append(), only for as long as it takes to queue the entry
+	TelldusCore::Mutex pendingLock;
+	std::deque<Entry> pending;
+	//Held while the file is written
+	TelldusCore::Mutex fileLock;
+	Flusher *flusher;
+
+	bool mapFile(size_t size);
+	void unmapFile();
+	bool isValid(size_t size) const;
+	void write(const Entry &entry);
+};
+
+bool SensorStore::PrivateData::mapFile(size_t size) {
+	mapSize = size;
+	void *m = mmap(0, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (m == MAP_FAILED) {
+		return false;
+	}
+	map = reinterpret_cast<char *>(m);
+	header = reinterpret_cast<FileHeader *>(map);
+	records = reinterpret_cast<FileRecord *>(map + HEADER_SIZE);
+	return true;
+}
+
+void SensorStore::PrivateData::unmapFile() {
+	if (map) {
+		munmap(map, mapSize);
+	}
+	map = 0;
+	header = 0;
+	records = 0;
+}
+
+bool SensorStore::PrivateData::isValid(size_t size) const {
+	if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != FILE_VERSION || header->recordSize != sizeof(FileRecord)) {
+		return false;
+	}
+	if (header->capacity == 0 || size != fileSize(header->capacity)) {
+		return false;
+	}
+	return (header->first < header->capacity && header->count <= header->capacity);
+}
+
+void SensorStore::PrivateData::write(const Entry &entry) {
+	uint32_t index;
+	if (header->count < header->capacity) {
+		index = (header->first + header->count) % header->capacity;
+		++header->count;
+	} else {
+		//Full, overwrite the oldest
+		index = header->first;
+		header->first = (header->first + 1) % header->capacity;
+	}
+	FileRecord &record = records[index];
+	memset(&record, 0, sizeof(FileRecord));
+	record.timestamp = (uint32_t)entry.timestamp;
+	record.value = entry.value.value;
+	record.id = entry.id;
+	record.dataType = (uint8_t)entry.value.dataType;
+	record.decimals = (int8_t)entry.value.decimals;
+	copyString(record.protocol, entry.protocol, sizeof(record.protocol));
+	copyString(record.model, entry.model, sizeof(record.model));
+}
+
+SensorStore::SensorStore() {
+	d = new PrivateData;
+	d->fd = -1;
+	d->map = 0;
+	d->mapSize = 0;
+	d->header = 0;
+	d->records = 0;
+	d->flusher = 0;
+}
+
+SensorStore::~SensorStore() {
+	delete d->flusher;
+	flush();
+	d->unmapFile();
+	if (d->fd >= 0) {
+		close(d->fd);
+	}
+	delete d;
+}
+
+bool SensorStore::open(const std::string &path, size_t capacity, int flushInterval) {
+	if (isOpen() || capacity == 0) {
+		return false;
+	}
+	d->fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (d->fd < 0) {
+		return false;
+	}
+	struct stat st;
+	if (fstat(d->fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+		//Never truncate a device or anything else the path might point at
+		Log::warning("Sensor store %s is not a regular file", path.c_str());
+		close(d->fd);
+		d->fd = -1;
+		return false;
+	}
+	size_t size = st.st_size;
+
+	std::vector<FileRecord> kept;
+	if (size >= HEADER_SIZE && d->mapFile(size)) {
+		if (d->isValid(size) && d->header->capacity == capacity) {
+			d->flusher = new Flusher(this, flushInterval);
+			d->flusher->start();
+			return true;
+		}
+		if (d->isValid(size)) {
+			//Another capacity, keep the newest
+			uint32_t count = d->header->count;
+			uint32_t skip = (count > capacity ? count - capacity : 0);
+			for (uint32_t i = skip; i < count; ++i) {
+				kept.push_back(d->records[(d->header->first + i) % d->header->capacity]);
+			}
+		} else {
+			Log::warning("Sensor store %s has an unknown header or size, discarding it", path.c_str());
+		}
+		d->unmapFile();
+	} else if (size > 0) {
+		Log::warning("Sensor store %s is too small to be a sensor store, discarding it", path.c_str());
+	}
+
+	//Start over, with what was kept from the old file
+	if (ftruncate(d->fd, 0) != 0 || ftruncate(d->fd, fileSize(capacity)) != 0 || !d->mapFile(fileSize(capacity))) {
+		d->unmapFile();
+		close(d->fd);
+		d->fd = -1;
+		return false;
+	}
+	memset(d->header, 0, HEADER_SIZE);
+	memcpy(d->header->magic, MAGIC, sizeof(MAGIC));
+	d->header->version = FILE_VERSION;
+	d->header->recordSize = sizeof(FileRecord);
+	d->header->capacity = capacity;
+	d->header->first = 0;
+	d->header->count = kept.size();
+	for (size_t i = 0; i < kept.size(); ++i) {
+		d->records[i] = kept[i];
+	}
+	msync(d->map, d->mapSize, MS_SYNC);
+	d->flusher = new Flusher(this, flushInterval);
+	d->flusher->start();
+	return true;
+}
+
+bool SensorStore::isOpen() const {
+	return d->map != 0;
+}
+
+size_t SensorStore::size() const {
+	if (!isOpen()) {
+		return 0;
+	}
+	return d->header->count;
+}
+
+bool SensorStore::entry(size_t index, Entry *entry) const {
+	if (index >= size()) {
+		return false;
+	}
+	const FileRecord &record = d->records[(d->header->first + index) % d->header->capacity];
+	copyString(entry->protocol, record.protocol, sizeof(entry->protocol));
+	copyString(entry->model, record.model, sizeof(entry->model));
+	entry->id = record.id;
+	entry->value.dataType = record.dataType;
+	entry->value.value = record.value;
+	entry->value.decimals = record.decimals;
+	entry->timestamp = record.timestamp;
+	return true;
+}
+
+void SensorStore::append(const Entry &entry) {
+	if (!isOpen()) {
+		return;
+	}
+	TelldusCore::MutexLocker locker(&d->pendingLock);
+	d->pending.push_back(entry);
+	//Only the newest fit in the file anyway
+	if (d->pending.size() > d->header->capacity) {
+		d->pending.pop_front();
+	}
+}
+
+void SensorStore::flush() {
+	TelldusCore::MutexLocker fileLocker(&d->fileLock);
+	std::deque<Entry> entries;
+	{
+		TelldusCore::MutexLocker pendingLocker(&d->pendingLock);
+		entries.swap(d->pending);
+	}
+	if (!isOpen() || entries.empty()) {
+		return;
+	}
+	for (size_t i = 0; i < entries.size(); ++i) {
+		d->write(entries[i]);
+	}
+	//Only the pages touched are written. Appending never waits for this.
+	msync(d->map, d->mapSize, MS_SYNC);
+}
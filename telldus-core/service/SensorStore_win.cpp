@@ -0,0 +1,32 @@
+#include "SensorStore.h"
+
+//The store is not available on Windows yet, the values are kept in memory only
+
+SensorStore::SensorStore() {
+	d = 0;
+}
+
+SensorStore::~SensorStore() {
+}
+
+bool SensorStore::open(const std::string &, size_t, int) {
+	return false;
+}
+
+bool SensorStore::isOpen() const {
+	return false;
+}
+
+size_t SensorStore::size() const {
+	return 0;
+}
+
+bool SensorStore::entry(size_t, Entry *) const {
+	return false;
+}
+
+void SensorStore::append(const Entry &) {
+}
+
+void SensorStore::flush() {
+}
@@ -1,59 +1,60 @@
 #include "Settings.h"
+#include "../client/telldus-core.h"
 
 TelldusCore::Mutex Settings::mutex;
 
 /*
 * Get the name of the device
 */
-std::wstring Settings::getName(Node type, int intNodeId) const {
+std::string Settings::getName(Node type, int intNodeId) const {
 	TelldusCore::MutexLocker locker(&mutex);
-	return getStringSetting(type, intNodeId, L"name", false);
+	return getStringSetting(type, intNodeId, "name", false);
 }
 
 /*
 * Set the name of the device
 */
-int Settings::setName(Node type, int intDeviceId, const std::wstring &strNewName){
+int Settings::setName(Node type, int intDeviceId, const std::string &strNewName){
 	TelldusCore::MutexLocker locker(&mutex);
-	return setStringSetting(type, intDeviceId, L"name", strNewName, false);
+	return setStringSetting(type, intDeviceId, "name", strNewName, false);
 }
 
 /*
 * Get the device vendor
 */
-std::wstring Settings::getProtocol(int intDeviceId) const {
+std::string Settings::getProtocol(int intDeviceId) const {
 	TelldusCore::MutexLocker locker(&mutex);
-	return getStringSetting(Device, intDeviceId, L"protocol", false);
+	return getStringSetting(Device, intDeviceId, "protocol", false);
 }
 
 /*
 * Set the device vendor
 */
-int Settings::setProtocol(int intDeviceId, const std::wstring &strVendor){
+int Settings::setProtocol(int intDeviceId, const std::string &strVendor){
 	TelldusCore::MutexLocker locker(&mutex);
-	return setStringSetting(Device, intDeviceId, L"protocol", strVendor, false);
+	return setStringSetting(Device, intDeviceId, "protocol", strVendor, false);
 }
 
 /*
 * Get the device model
 */
-std::wstring Settings::getModel(int intDeviceId) const {
+std::string Settings::getModel(int intDeviceId) const {
 	TelldusCore::MutexLocker locker(&mutex);
-	return getStringSetting(Device, intDeviceId, L"model", false);
+	return getStringSetting(Device, intDeviceId, "model", false);
 }
 
 /*
 * Set the device model
 */
-int Settings::setModel(int intDeviceId, const std::wstring &strModel){
+int Settings::setModel(int intDeviceId, const std::string &strModel){
 	TelldusCore::MutexLocker locker(&mutex);
-	return setStringSetting(Device, intDeviceId, L"model", strModel, false);
+	return setStringSetting(Device, intDeviceId, "model", strModel, false);
 }
 
 /*
 * Set device argument
 */
-int Settings::setDeviceParameter(int intDeviceId, const std::wstring &strName, const std::wstring &strValue){
+int Settings::setDeviceParameter(int intDeviceId, const std::string &strName, const std::string &strValue){
 	TelldusCore::MutexLocker locker(&mutex);
 	return setStringSetting(Device, intDeviceId, strName, strValue, true);
 }
@@ -61,7 +62,7 @@ int Settings::setDeviceParameter(int intDeviceId, const std::wstring &strName, c
 /*
 * Get device argument
 */
-std::wstring Settings::getDeviceParameter(int intDeviceId, const std::wstring &strName) const {
+std::string Settings::getDeviceParameter(int intDeviceId, const std::string &strName) const {
 	TelldusCore::MutexLocker locker(&mutex);
 	return getStringSetting(Device, intDeviceId, strName, true);
 }
@@ -71,7 +72,7 @@ std::wstring Settings::getDeviceParameter(int intDeviceId, const std::wstring &s
 */
 int Settings::setPreferredControllerId(int intDeviceId, int value){
 	TelldusCore::MutexLocker locker(&mutex);
-	return setIntSetting(Device, intDeviceId,  L"controller", value, false);
+	return setIntSetting(Device, intDeviceId,  "controller", value, false);
 }
 
 /*
@@ -79,27 +80,32 @@ int Settings::setPreferredControllerId(int intDeviceId, int value){
 */
 int Settings::getPreferredControllerId(int intDeviceId) {
 	TelldusCore::MutexLocker locker(&mutex);
-	return getIntSetting(Device, intDeviceId, L"controller", false);
+	return getIntSetting(Device, intDeviceId, "controller", false);
 }
 
-std::wstring Settings::getControllerSerial(int intControllerId) const {
+std::string Settings::getControllerSerial(int intControllerId) const {
 	TelldusCore::MutexLocker locker(&mutex);
-	return getStringSetting(Controller, intControllerId, L"serial", false);
+	return getStringSetting(Controller, intControllerId, "serial", false);
 }
 
-int Settings::setControllerSerial(int intControllerId, const std::wstring &serial) {
+int Settings::setControllerSerial(int intControllerId, const std::string &serial) {
 	TelldusCore::MutexLocker locker(&mutex);
-	return setStringSetting(Controller, intControllerId,  L"serial", serial, false);
+	return setStringSetting(Controller, intControllerId,  "serial", serial, false);
 }
 
 int Settings::getControllerType(int intControllerId) const {
 	TelldusCore::MutexLocker locker(&mutex);
-	return getIntSetting(Controller, intControllerId, L"type", false);
+	return getIntSetting(Controller, intControllerId, "type", false);
 }
 
 int Settings::setControllerType(int intControllerId, int type) {
 	TelldusCore::MutexLocker locker(&mutex);
-	return setIntSetting(Controller, intControllerId,  L"type", type, false);
+	return setIntSetting(Controller, intControllerId,  "type", type, false);
+}
+
+int Settings::getJobValue(int intJobId, const std::string &strName) const {
+	TelldusCore::MutexLocker locker(&mutex);
+	return getIntSetting(Job, intJobId, strName, false);
 }
 
 std::string Settings::getNodeString(Settings::Node type) const {
@@ -107,26 +113,37 @@ std::string Settings::getNodeString(Settings::Node type) const {
 		return "device";
 	} else if (type == Controller) {
 		return "controller";
+	} else if (type == Job) {
+		return "job";
 	}
 }
 
 #ifndef _CONFUSE
 
-bool Settings::setDeviceState( int intDeviceId, int intDeviceState, const std::wstring &strDeviceStateValue ) {
+bool Settings::setDeviceState( int intDeviceId, int intDeviceState, const std::string &strDeviceStateValue ) {
 	TelldusCore::MutexLocker locker(&mutex);
-	bool retval = setIntSetting( Settings::Device, intDeviceId, L"state", intDeviceState, true );
-	setStringSetting( Settings::Device, intDeviceId, L"stateValue", strDeviceStateValue, true );
+	bool retval = setIntSetting( Settings::Device, intDeviceId, "state", intDeviceState, true );
+	setStringSetting( Settings::Device, intDeviceId, "stateValue", strDeviceStateValue, true );
 	return retval;
 }
 
 int Settings::getDeviceState( int intDeviceId ) const {
 	TelldusCore::MutexLocker locker(&mutex);
-	return getIntSetting( Settings::Device, intDeviceId, L"state", true );
+	return getIntSetting( Settings::Device, intDeviceId, "state", true );
+}
+
+std::string Settings::getDeviceStateValue( int intDeviceId ) const {
+	TelldusCore::MutexLocker locker(&mutex);
+	return getStringSetting( Settings::Device, intDeviceId, "stateValue", true );
 }
 
-std::wstring Settings::getDeviceStateValue( int intDeviceId ) const {
+int Settings::setJob(int intJobId, const std::string &strName, const std::map<std::string, int> &values) {
 	TelldusCore::MutexLocker locker(&mutex);
-	return getStringSetting( Settings::Device, intDeviceId, L"stateValue", true );
+	int retval = setStringSetting(Job, intJobId, "name", strName, false);
+	for (std::map<std::string, int>::const_iterator it = values.begin(); it != values.end() && retval == TELLSTICK_SUCCESS; ++it) {
+		retval = setIntSetting(Job, intJobId, it->first, it->second, false);
+	}
+	return retval;
 }
 
 #endif
@@ -1,29 +1,30 @@
 #ifndef SETTINGS_H
 #define SETTINGS_H
 
+#include <map>
 #include <string>
 #include "Mutex.h"
 
 class Settings {
 public:
-	enum Node { Device, Controller };
+	enum Node { Device, Controller, Job };
 
 	Settings(void);
 	virtual ~Settings(void);
 
-	std::wstring getSetting(const std::wstring &strName) const;
+	std::string getSetting(const std::string &strName) const;
 	int getNumberOfNodes(Node type) const;
-	std::wstring getName(Node type, int intNodeId) const;
-	int setName(Node type, int intDeviceId, const std::wstring &strNewName);
-	std::wstring getProtocol(int intDeviceId) const;
-	int setProtocol(int intDeviceId, const std::wstring &strVendor);
-	std::wstring getModel(int intDeviceId) const;
-	int setModel(int intDeviceId, const std::wstring &strModel);
-	std::wstring getDeviceParameter(int intDeviceId, const std::wstring &strName) const;
-	int setDeviceParameter(int intDeviceId, const std::wstring &strName, const std::wstring &strValue);
-	bool setDeviceState( int intDeviceId, int intDeviceState, const std::wstring &strDeviceStateValue );
+	std::string getName(Node type, int intNodeId) const;
+	int setName(Node type, int intDeviceId, const std::string &strNewName);
+	std::string getProtocol(int intDeviceId) const;
+	int setProtocol(int intDeviceId, const std::string &strVendor);
+	std::string getModel(int intDeviceId) const;
+	int setModel(int intDeviceId, const std::string &strModel);
+	std::string getDeviceParameter(int intDeviceId, const std::string &strName) const;
+	int setDeviceParameter(int intDeviceId, const std::string &strName, const std::string &strValue);
+	bool setDeviceState( int intDeviceId, int intDeviceState, const std::string &strDeviceStateValue );
 	int getDeviceState( int intDeviceId ) const;
-	std::wstring getDeviceStateValue( int intDeviceId ) const;
+	std::string getDeviceStateValue( int intDeviceId ) const;
 	int getPreferredControllerId(int intDeviceId);
 	int setPreferredControllerId(int intDeviceId, int value);
 
@@ -31,16 +32,20 @@ public:
 	int getNodeId(Node type, int intDeviceIndex) const;
 	int removeNode(Node type, int intNodeId);
 
-	std::wstring getControllerSerial(int intControllerId) const;
-	int setControllerSerial(int intControllerId, const std::wstring &serial);
+	std::string getControllerSerial(int intControllerId) const;
+	int setControllerSerial(int intControllerId, const std::string &serial);
 	int getControllerType(int intControllerId) const;
 	int setControllerType(int intControllerId, int type);
 
+	int getJobValue(int intJobId, const std::string &strName) const;
+	//Writes the name and all values of a job at once
+	int setJob(int intJobId, const std::string &strName, const std::map<std::string, int> &values);
+
 protected:
-	std::wstring getStringSetting(Node type, int intNodeId, const std::wstring &name, bool parameter) const;
-	int setStringSetting(Node type, int intDeviceId, const std::wstring &name, const std::wstring &value, bool parameter);
-	int getIntSetting(Node type, int intDeviceId, const std::wstring &name, bool parameter) const;
-	int setIntSetting(Node type, int intDeviceId, const std::wstring &name, int value, bool parameter);
+	std::string getStringSetting(Node type, int intNodeId, const std::string &name, bool parameter) const;
+	int setStringSetting(Node type, int intDeviceId, const std::string &name, const std::string &value, bool parameter);
+	int getIntSetting(Node type, int intDeviceId, const std::string &name, bool parameter) const;
+	int setIntSetting(Node type, int intDeviceId, const std::string &name, int value, bool parameter);
 
 private:
 	int getNextNodeId(Node type) const;
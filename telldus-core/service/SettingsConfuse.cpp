@@ -32,6 +32,18 @@ bool readVarConfig(cfg_t **cfg);
 const char* CONFIG_FILE = CONFIG_PATH "/tellstick.conf";
 const char* VAR_CONFIG_FILE = VAR_CONFIG_PATH "/telldus-core.conf";
 
+/*
+* Every Settings instance holds its own copy of the config-file. Writing
+* the copy back would undo what another instance has written since it was
+* read, so it is read again before each write. The mutex must be held.
+*/
+void reloadConfig(cfg_t **cfg) {
+	if (*cfg != 0) {
+		cfg_free(*cfg);
+	}
+	readConfig(cfg);
+}
+
 /*
 * Constructor
 */
@@ -61,13 +73,13 @@ Settings::~Settings(void)
 /*
 * Return a setting
 */
-std::wstring Settings::getSetting(const std::wstring &strName) const {
+std::string Settings::getSetting(const std::string &strName) const {
 	TelldusCore::MutexLocker locker(&mutex);
 	if (d->cfg > 0) {
-		std::string setting(cfg_getstr(d->cfg, TelldusCore::wideToString(strName).c_str()));
-		return TelldusCore::charToWstring(setting.c_str());
+		std::string setting(cfg_getstr(d->cfg, strName.c_str()));
+		return setting;
 	}
-	return L"";
+	return "";
 }
 
 /*
@@ -76,11 +88,7 @@ std::wstring Settings::getSetting(const std::wstring &strName) const {
 int Settings::getNumberOfNodes(Node node) const {
 	TelldusCore::MutexLocker locker(&mutex);
 	if (d->cfg > 0) {
-		if (node == Device) {
-			return cfg_size(d->cfg, "device");
-		} else if (node == Controller) {
-			return cfg_size(d->cfg, "controller");
-		}
+		return cfg_size(d->cfg, getNodeString(node).c_str());
 	}
 	return 0;
 }
@@ -90,12 +98,7 @@ int Settings::getNodeId(Node type, int intDeviceIndex) const {
 		return -1;
 	}
 	TelldusCore::MutexLocker locker(&mutex);
-	cfg_t *cfg_node;
-	if (type == Device) {
-		cfg_node = cfg_getnsec(d->cfg, "device", intDeviceIndex);
-	} else if (type == Controller) {
-		cfg_node = cfg_getnsec(d->cfg, "controller", intDeviceIndex);
-	}
+	cfg_t *cfg_node = cfg_getnsec(d->cfg, getNodeString(type).c_str(), intDeviceIndex);
 	int id = cfg_getint(cfg_node, "id");
 	return id;
 }
@@ -105,6 +108,10 @@ int Settings::getNodeId(Node type, int intDeviceIndex) const {
 */
 int Settings::addNode(Node type){
 	TelldusCore::MutexLocker locker(&mutex);
+	reloadConfig(&d->cfg);
+	if (d->cfg == 0) {
+		return TELLSTICK_ERROR_PERMISSION_DENIED;
+	}
 	int intNodeId = getNextNodeId(type);
 
 	FILE *fp = fopen(CONFIG_FILE, "w");
@@ -112,11 +119,7 @@ int Settings::addNode(Node type){
 		return TELLSTICK_ERROR_PERMISSION_DENIED;
 	}
 	cfg_print(d->cfg, fp); //Print the config-file
-	if (type == Device) {
-		fprintf(fp, "device {\n  id=%d\n}\n", intNodeId); //Print the new device
-	} else if (type == Controller) {
-		fprintf(fp, "controller {\n  id=%d\n}\n", intNodeId); //Print the new controller
-	}
+	fprintf(fp, "%s {\n  id=%d\n}\n", getNodeString(type).c_str(), intNodeId); //Print the new node
 	fclose(fp);
 
 	//Re-read config-file
@@ -132,12 +135,7 @@ int Settings::getNextNodeId(Node type) const {
 	//Private, no locks needed
 	int intNodeId = 0;
 	cfg_t *cfg_node;
-	std::string strType;
-	if (type == Device) {
-		strType = "device";
-	} else if (type == Controller) {
-		strType = "controller";
-	}
+	std::string strType = getNodeString(type);
 	for (int i = 0; i < cfg_size(d->cfg, strType.c_str()); ++i) {
 		cfg_node = cfg_getnsec(d->cfg, strType.c_str(), i);
 		if (cfg_getint(cfg_node, "id") >= intNodeId)  {
@@ -153,6 +151,10 @@ int Settings::getNextNodeId(Node type) const {
 */
 int Settings::removeNode(Node type, int intNodeId){
 	TelldusCore::MutexLocker locker(&mutex);
+	reloadConfig(&d->cfg);
+	if (d->cfg == 0) {
+		return TELLSTICK_ERROR_PERMISSION_DENIED;
+	}
 	FILE *fp = fopen(CONFIG_FILE, "w");
 	if (!fp) {
 		return TELLSTICK_ERROR_PERMISSION_DENIED;
@@ -188,7 +190,7 @@ int Settings::removeNode(Node type, int intNodeId){
 	return TELLSTICK_SUCCESS;
 }
 
-bool Settings::setDeviceState( int intDeviceId, int intDeviceState, const std::wstring &strDeviceStateValue ) {
+bool Settings::setDeviceState( int intDeviceId, int intDeviceState, const std::string &strDeviceStateValue ) {
 	TelldusCore::MutexLocker locker(&mutex);
 	if (d->var_cfg == 0) {
 		return false;
@@ -199,7 +201,7 @@ bool Settings::setDeviceState( int intDeviceId, int intDeviceState, const std::w
 		int deviceId = atoi(cfg_title(cfg_device));
 		if (deviceId == intDeviceId)  {
 			cfg_setint(cfg_device, "state", intDeviceState);
-			cfg_setstr(cfg_device, "stateValue", TelldusCore::wideToString(strDeviceStateValue).c_str());
+			cfg_setstr(cfg_device, "stateValue", strDeviceStateValue.c_str());
 
 			FILE *fp = fopen(VAR_CONFIG_FILE, "w");
 			if(fp == 0){
@@ -245,10 +247,10 @@ int Settings::getDeviceState( int intDeviceId ) const {
 	return TELLSTICK_TURNOFF;
 }
 
-std::wstring Settings::getDeviceStateValue( int intDeviceId ) const {
+std::string Settings::getDeviceStateValue( int intDeviceId ) const {
 	TelldusCore::MutexLocker locker(&mutex);
 	if (d->var_cfg == 0) {
-		return L"";
+		return "";
 	}
 	cfg_t *cfg_device;
 	for (int i = 0; i < cfg_size(d->var_cfg, "device"); ++i) {
@@ -256,16 +258,16 @@ std::wstring Settings::getDeviceStateValue( int intDeviceId ) const {
 		int deviceId = atoi(cfg_title(cfg_device));
 		if (deviceId == intDeviceId)  {
 			std::string value(cfg_getstr(cfg_device, "stateValue"));
-			return TelldusCore::charToWstring(value.c_str());
+			return value;
 		}
 	}
-	return L"";
+	return "";
 }
 
-std::wstring Settings::getStringSetting(Node type, int intNodeId, const std::wstring &name, bool parameter) const {
+std::string Settings::getStringSetting(Node type, int intNodeId, const std::string &name, bool parameter) const {
 	//already locked
 	if (d->cfg == 0) {
-		return L"";
+		return "";
 	}
 	std::string strType = getNodeString(type);
 
@@ -276,19 +278,20 @@ std::wstring Settings::getStringSetting(Node type, int intNodeId, const std::wst
 			if (parameter) {
 				cfg_device = cfg_getsec(cfg_device, "parameters");
 			}
-			std::wstring setting;
-			char *cSetting = cfg_getstr(cfg_device, TelldusCore::wideToString(name).c_str());
+			std::string setting;
+			char *cSetting = cfg_getstr(cfg_device, name.c_str());
 			if (cSetting) {
-				setting = TelldusCore::charToWstring(cSetting);
+				setting = cSetting;
 			}
 			return setting;
 		}
 	}
-	return L"";
+	return "";
 }
 
-int Settings::setStringSetting(Node type, int intDeviceId, const std::wstring &name, const std::wstring &value, bool parameter) {
+int Settings::setStringSetting(Node type, int intDeviceId, const std::string &name, const std::string &value, bool parameter) {
 	//already locked
+	reloadConfig(&d->cfg);
 	if (d->cfg == 0) {
 		return TELLSTICK_ERROR_PERMISSION_DENIED;
 	}
@@ -297,12 +300,11 @@ int Settings::setStringSetting(Node type, int intDeviceId, const std::wstring &n
 	for (int i = 0; i < cfg_size(d->cfg, strType.c_str()); ++i) {
 		cfg_device = cfg_getnsec(d->cfg, strType.c_str(), i);
 		if (cfg_getint(cfg_device, "id") == intDeviceId)  {
-			std::string newValue = TelldusCore::wideToString(value);
 			if (parameter) {
 				cfg_t *cfg_parameters = cfg_getsec(cfg_device, "parameters");
-				cfg_setstr(cfg_parameters, TelldusCore::wideToString(name).c_str(), newValue.c_str());
+				cfg_setstr(cfg_parameters, name.c_str(), value.c_str());
 			} else {
-				cfg_setstr(cfg_device, TelldusCore::wideToString(name).c_str(), newValue.c_str());
+				cfg_setstr(cfg_device, name.c_str(), value.c_str());
 			}
 			FILE *fp = fopen(CONFIG_FILE, "w");
 			if (!fp) {
@@ -316,7 +318,7 @@ int Settings::setStringSetting(Node type, int intDeviceId, const std::wstring &n
 	return TELLSTICK_ERROR_DEVICE_NOT_FOUND;
 }
 
-int Settings::getIntSetting(Node type, int intDeviceId, const std::wstring &name, bool parameter) const {
+int Settings::getIntSetting(Node type, int intDeviceId, const std::string &name, bool parameter) const {
 	//already locked
 	if (d->cfg == 0) {
 		return 0;
@@ -329,14 +331,15 @@ int Settings::getIntSetting(Node type, int intDeviceId, const std::wstring &name
 			if (parameter) {
 				cfg_node = cfg_getsec(cfg_node, "parameters");
 			}
-			return cfg_getint(cfg_node, TelldusCore::wideToString(name).c_str());
+			return cfg_getint(cfg_node, name.c_str());
 		}
 	}
 	return 0;
 }
 
-int Settings::setIntSetting(Node type, int intDeviceId, const std::wstring &name, int value, bool parameter) {
+int Settings::setIntSetting(Node type, int intDeviceId, const std::string &name, int value, bool parameter) {
 	//already locked
+	reloadConfig(&d->cfg);
 	if (d->cfg == 0) {
 		return TELLSTICK_ERROR_PERMISSION_DENIED;
 	}
@@ -347,9 +350,9 @@ int Settings::setIntSetting(Node type, int intDeviceId, const std::wstring &name
 		if (cfg_getint(cfg_device, "id") == intDeviceId)  {
 			if (parameter) {
 				cfg_t *cfg_parameters = cfg_getsec(cfg_device, "parameters");
-				cfg_setint(cfg_parameters, TelldusCore::wideToString(name).c_str(), value);
+				cfg_setint(cfg_parameters, name.c_str(), value);
 			} else {
-				cfg_setint(cfg_device, TelldusCore::wideToString(name).c_str(), value);
+				cfg_setint(cfg_device, name.c_str(), value);
 			}
 			FILE *fp = fopen(CONFIG_FILE, "w");
 			if (!fp) {
@@ -364,6 +367,34 @@ int Settings::setIntSetting(Node type, int intDeviceId, const std::wstring &name
 }
 
 
+int Settings::setJob(int intJobId, const std::string &strName, const std::map<std::string, int> &values) {
+	TelldusCore::MutexLocker locker(&mutex);
+	reloadConfig(&d->cfg);
+	if (d->cfg == 0) {
+		return TELLSTICK_ERROR_PERMISSION_DENIED;
+	}
+	std::string strType = getNodeString(Job);
+	for (int i = 0; i < cfg_size(d->cfg, strType.c_str()); ++i) {
+		cfg_t *cfg_job = cfg_getnsec(d->cfg, strType.c_str(), i);
+		if (cfg_getint(cfg_job, "id") != intJobId) {
+			continue;
+		}
+		cfg_setstr(cfg_job, "name", strName.c_str());
+		for (std::map<std::string, int>::const_iterator it = values.begin(); it != values.end(); ++it) {
+			cfg_setint(cfg_job, it->first.c_str(), it->second);
+		}
+		//The whole job in one write
+		FILE *fp = fopen(CONFIG_FILE, "w");
+		if (!fp) {
+			return TELLSTICK_ERROR_PERMISSION_DENIED;
+		}
+		cfg_print(d->cfg, fp);
+		fclose(fp);
+		return TELLSTICK_SUCCESS;
+	}
+	return TELLSTICK_ERROR_NOT_FOUND;
+}
+
 bool readConfig(cfg_t **cfg) {
 	//All the const_cast keywords is to remove the compiler warnings generated by the C++-compiler.
 	cfg_opt_t controller_opts[] = {
@@ -399,13 +430,52 @@ bool readConfig(cfg_t **cfg) {
 		CFG_END()
 	};
 
+	cfg_opt_t job_opts[] = {
+		CFG_INT(const_cast<char *>("id"), -1, CFGF_NONE),
+		CFG_STR(const_cast<char *>("name"), const_cast<char *>(""), CFGF_NONE),
+		CFG_INT(const_cast<char *>("device"), 0, CFGF_NONE),
+		CFG_INT(const_cast<char *>("method"), 0, CFGF_NONE),
+		CFG_INT(const_cast<char *>("value"), 0, CFGF_NONE),
+		CFG_INT(const_cast<char *>("type"), 0, CFGF_NONE),
+		CFG_INT(const_cast<char *>("hour"), 0, CFGF_NONE),
+		CFG_INT(const_cast<char *>("minute"), 0, CFGF_NONE),
+		CFG_INT(const_cast<char *>("offset"), 0, CFGF_NONE),
+		CFG_INT(const_cast<char *>("weekdays"), 0, CFGF_NONE),
+		CFG_END()
+	};
+
 	cfg_opt_t opts[] = {
 		CFG_STR(const_cast<char *>("user"), const_cast<char *>("nobody"), CFGF_NONE),
 		CFG_STR(const_cast<char *>("group"), const_cast<char *>("plugdev"), CFGF_NONE),
 		CFG_STR(const_cast<char *>("deviceNode"), const_cast<char *>("/dev/tellstick"), CFGF_NONE),
 		CFG_STR(const_cast<char *>("ignoreControllerConfirmation"), const_cast<char *>("false"), CFGF_NONE),
+		CFG_STR(const_cast<char *>("duoPipelineFirmware"), const_cast<char *>(""), CFGF_NONE),
+		CFG_STR(const_cast<char *>("transmitDutyCycle"), const_cast<char *>("100"), CFGF_NONE),
+		CFG_STR(const_cast<char *>("receiveGap"), const_cast<char *>("100"), CFGF_NONE),
+		CFG_STR(const_cast<char *>("virtualController"), const_cast<char *>(""), CFGF_NONE),
+		CFG_STR(const_cast<char *>("virtualControllerFirmware"), const_cast<char *>(""), CFGF_NONE),
+		CFG_STR(const_cast<char *>("virtualControllerAckDelay"), const_cast<char *>("10"), CFGF_NONE),
+		CFG_STR(const_cast<char *>("virtualControllerScript"), const_cast<char *>(""), CFGF_NONE),
+		CFG_STR(const_cast<char *>("networkControllers"), const_cast<char *>(""), CFGF_NONE),
+		CFG_STR(const_cast<char *>("networkControllerAckTimeout"), const_cast<char *>("5"), CFGF_NONE),
+		CFG_STR(const_cast<char *>("sensorHistoryDepth"), const_cast<char *>("256"), CFGF_NONE),
+		CFG_STR(const_cast<char *>("sensorRollupMinutes"), const_cast<char *>("0"), CFGF_NONE),
+		CFG_STR(const_cast<char *>("sensorRollupHours"), const_cast<char *>("168"), CFGF_NONE),
+		CFG_STR(const_cast<char *>("sensorRollupDays"), const_cast<char *>("365"), CFGF_NONE),
+		CFG_STR(const_cast<char *>("sensorCapacity"), const_cast<char *>("128"), CFGF_NONE),
+		CFG_STR(const_cast<char *>("sensorTimeout"), const_cast<char *>("604800"), CFGF_NONE),
+		CFG_STR(const_cast<char *>("pinnedSensors"), const_cast<char *>(""), CFGF_NONE),
+		CFG_STR(const_cast<char *>("sensorDeadbandTemperature"), const_cast<char *>(""), CFGF_NONE),
+		CFG_STR(const_cast<char *>("sensorDeadbandHumidity"), const_cast<char *>(""), CFGF_NONE),
+		CFG_STR(const_cast<char *>("sensorEventHeartbeat"), const_cast<char *>("600"), CFGF_NONE),
+		CFG_STR(const_cast<char *>("sensorStore"), const_cast<char *>(VAR_CONFIG_PATH "/telldus-core-sensors.dat"), CFGF_NONE),
+		CFG_STR(const_cast<char *>("sensorStoreSize"), const_cast<char *>("0"), CFGF_NONE),
+		CFG_STR(const_cast<char *>("sensorStoreFlushInterval"), const_cast<char *>("300"), CFGF_NONE),
+		CFG_STR(const_cast<char *>("schedulerLatitude"), const_cast<char *>(""), CFGF_NONE),
+		CFG_STR(const_cast<char *>("schedulerLongitude"), const_cast<char *>(""), CFGF_NONE),
 		CFG_SEC(const_cast<char *>("device"), device_opts, CFGF_MULTI),
 		CFG_SEC(const_cast<char *>("controller"), controller_opts, CFGF_MULTI),
+		CFG_SEC(const_cast<char *>("job"), job_opts, CFGF_MULTI),
 		CFG_END()
 	};
 
@@ -53,8 +53,8 @@ Settings::~Settings(void)
 /*
 * Return a setting
 */
-std::wstring Settings::getSetting(const std::wstring &strName) const {
-	return L"";
+std::string Settings::getSetting(const std::string &strName) const {
+	return "";
 }
 
 /*
@@ -74,6 +74,8 @@ int Settings::getNumberOfNodes(Node type) const {
 			++nodes;
 		} else if (type == Controller && CFStringHasPrefix( key, CFSTR("controllers.") )) {
 			++nodes;
+		} else if (type == Job && CFStringHasPrefix( key, CFSTR("jobs.") )) {
+			++nodes;
 		}
 	}
 	return nodes;
@@ -99,6 +101,10 @@ int Settings::getNodeId(Node type, int intNodeIndex) const {
 			CFRelease( key );
 			continue;
 		}
+		if ( type == Job && !CFStringHasPrefix(key, CFSTR("jobs.")) ) {
+			CFRelease( key );
+			continue;
+		}
 		if (index == intNodeIndex) {
 			CFArrayRef split = CFStringCreateArrayBySeparatingStrings( 0, key, CFSTR(".") );
 			if ( !split || CFArrayGetCount( split ) != 3 ) continue;
@@ -138,10 +144,10 @@ int Settings::getNodeId(Node type, int intNodeIndex) const {
 */
 int Settings::addNode(Node type) {
 	int id = getNextNodeId(type);
-	setStringSetting( type, id, L"name", L"", false ); //Create a empty name so the node has an entry
+	setStringSetting( type, id, "name", "", false ); //Create a empty name so the node has an entry
 	if (type == Device) {
 		//Is there a reason we do this?
-		setStringSetting( type, id, L"model", L"", false );
+		setStringSetting( type, id, "model", "", false );
 	}
 	return id;
 }
@@ -186,8 +192,7 @@ int Settings::removeNode(Node type, int intNodeId){
 	return ret;
 }
 
-std::wstring Settings::getStringSetting(Node type, int intNodeId, const std::wstring &wname, bool parameter) const {
-	std::string name(TelldusCore::wideToString(wname));
+std::string Settings::getStringSetting(Node type, int intNodeId, const std::string &name, bool parameter) const {
 	CFStringRef cfname = CFStringCreateWithCString( 0, name.c_str(), kCFStringEncodingUTF8 );
 
 	CFStringRef key;
@@ -201,10 +206,10 @@ std::wstring Settings::getStringSetting(Node type, int intNodeId, const std::wst
 
 	value = (CFStringRef)CFPreferencesCopyValue(key, d->app_ID, d->userName, d->hostName);
 	if (!value) {
-		return L"";
+		return "";
 	}
 
-	std::wstring retval;
+	std::string retval;
 	char *cp = NULL;
 	CFIndex size = CFStringGetMaximumSizeForEncoding( CFStringGetLength( value ), kCFStringEncodingUTF8) + 1;
 	cp = (char *)malloc(size);
@@ -212,10 +217,10 @@ std::wstring Settings::getStringSetting(Node type, int intNodeId, const std::wst
 	char *newcp = (char *)realloc( cp, strlen(cp) + 1);
 	if (newcp != NULL) {
 		cp = newcp;
-		retval = TelldusCore::charToWstring(cp);
+		retval = cp;
 	} else {
 		//Should not happen
-		retval = L"";
+		retval = "";
 	}
 	free(cp);
 
@@ -223,9 +228,7 @@ std::wstring Settings::getStringSetting(Node type, int intNodeId, const std::wst
 	return retval;
 }
 
-int Settings::setStringSetting(Node type, int intNodeId, const std::wstring &wname, const std::wstring &wvalue, bool parameter) {
-	std::string name(TelldusCore::wideToString(wname));
-	std::string value(TelldusCore::wideToString(wvalue));
+int Settings::setStringSetting(Node type, int intNodeId, const std::string &name, const std::string &value, bool parameter) {
 	CFStringRef cfname = CFStringCreateWithCString( 0, name.c_str(), kCFStringEncodingUTF8 );
 	CFStringRef cfvalue = CFStringCreateWithCString( 0, value.c_str(), kCFStringEncodingUTF8 );
 
@@ -241,9 +244,8 @@ int Settings::setStringSetting(Node type, int intNodeId, const std::wstring &wna
 	return TELLSTICK_SUCCESS;
 }
 
-int Settings::getIntSetting(Node type, int intNodeId, const std::wstring &wname, bool parameter) const {
+int Settings::getIntSetting(Node type, int intNodeId, const std::string &name, bool parameter) const {
 	int retval = 0;
-	std::string name(TelldusCore::wideToString(wname));
 	CFStringRef cfname = CFStringCreateWithCString( 0, name.c_str(), kCFStringEncodingUTF8 );
 	CFNumberRef cfvalue;
 
@@ -272,8 +274,7 @@ int Settings::getIntSetting(Node type, int intNodeId, const std::wstring &wname,
 	return retval;
 }
 
-int Settings::setIntSetting(Node type, int intNodeId, const std::wstring &wname, int value, bool parameter) {
-	std::string name(TelldusCore::wideToString(wname));
+int Settings::setIntSetting(Node type, int intNodeId, const std::string &name, int value, bool parameter) {
 	CFStringRef cfname = CFStringCreateWithCString( 0, name.c_str(), kCFStringEncodingUTF8 );
 	CFNumberRef cfvalue = CFNumberCreate(NULL, kCFNumberIntType, &value);
 
@@ -24,6 +24,8 @@ std::wstring Settings::PrivateData::getNodePath(Settings::Node type) {
 		return L"SOFTWARE\\Telldus\\Devices\\";
 	} else if (type == Settings::Controller) {
 		return L"SOFTWARE\\Telldus\\Controllers\\";
+	} else if (type == Settings::Job) {
+		return L"SOFTWARE\\Telldus\\Jobs\\";
 	}
 	return L"";
 }
@@ -108,7 +110,7 @@ int Settings::addNode(Node type) {
 		
 	if (RegCreateKeyEx(d->rootKey, strCompleteRegPath.c_str(), 0, NULL, REG_OPTION_NON_VOLATILE, KEY_ALL_ACCESS, NULL, &hk, &dwDisp)) {
 		//fail
-		intNodeId = -1;
+		return -1;
 	}
 
 	RegCloseKey(hk);
@@ -140,9 +142,8 @@ int Settings::getNextNodeId(Node type) const {
 		}
 		DWORD dwVal = intReturn;
 		RegSetValueEx (hk, L"LastUsedId", 0L, REG_DWORD, (CONST BYTE*) &dwVal, sizeof(DWORD));
-			
+		RegCloseKey(hk);
 	}
-	RegCloseKey(hk);
 	return intReturn;
 }
 
@@ -165,8 +166,8 @@ int Settings::removeNode(Node type, int intNodeId) {
 	return TELLSTICK_ERROR_UNKNOWN;
 }
 
-std::wstring Settings::getSetting(const std::wstring &strName) const{
-	std::wstring strReturn;
+std::string Settings::getSetting(const std::string &strName) const{
+	std::string strReturn;
 	HKEY hk;
 
 	std::wstring strCompleteRegPath = d->strRegPath;
@@ -175,25 +176,26 @@ std::wstring Settings::getSetting(const std::wstring &strName) const{
 	if(lnExists == ERROR_SUCCESS){
 		wchar_t* Buff = new wchar_t[intMaxRegValueLength];
 		DWORD dwLength = sizeof(wchar_t)*intMaxRegValueLength;
-		long lngStatus = RegQueryValueEx(hk, strName.c_str(), NULL, NULL, (LPBYTE)Buff, &dwLength);
+		std::wstring name = TelldusCore::charToWstring(strName.c_str());
+		long lngStatus = RegQueryValueEx(hk, name.c_str(), NULL, NULL, (LPBYTE)Buff, &dwLength);
 
 		if(lngStatus == ERROR_MORE_DATA){
 			//The buffer is to small, recreate it
 			delete[] Buff;
 			Buff = new wchar_t[dwLength];
-			lngStatus = RegQueryValueEx(hk, strName.c_str(), NULL, NULL, (LPBYTE)Buff, &dwLength);
+			lngStatus = RegQueryValueEx(hk, name.c_str(), NULL, NULL, (LPBYTE)Buff, &dwLength);
 		}
 		if (lngStatus == ERROR_SUCCESS) {
-			strReturn = Buff;
+			strReturn = TelldusCore::wideToString(Buff);
 		}
 		delete[] Buff;
+		RegCloseKey(hk);
 	}
-	RegCloseKey(hk);
 	return strReturn;
 }
 
-std::wstring Settings::getStringSetting(Node type, int intNodeId, const std::wstring &name, bool parameter) const {
-	std::wstring strReturn;
+std::string Settings::getStringSetting(Node type, int intNodeId, const std::string &strName, bool parameter) const {
+	std::string strReturn;
 	HKEY hk;
 
 	std::wstring strCompleteRegPath = d->getNodePath(type);
@@ -203,6 +205,7 @@ std::wstring Settings::getStringSetting(Node type, int intNodeId, const std::wst
 	if(lnExists == ERROR_SUCCESS){
 		wchar_t* Buff = new wchar_t[intMaxRegValueLength];
 		DWORD dwLength = sizeof(wchar_t)*intMaxRegValueLength;
+		std::wstring name = TelldusCore::charToWstring(strName.c_str());
 		long lngStatus = RegQueryValueEx(hk, name.c_str(), NULL, NULL, (LPBYTE)Buff, &dwLength);
 
 		if(lngStatus == ERROR_MORE_DATA){
@@ -212,15 +215,15 @@ std::wstring Settings::getStringSetting(Node type, int intNodeId, const std::wst
 			lngStatus = RegQueryValueEx(hk, name.c_str(), NULL, NULL, (LPBYTE)Buff, &dwLength);
 		}
 		if (lngStatus == ERROR_SUCCESS) {
-			strReturn = Buff;
+			strReturn = TelldusCore::wideToString(Buff);
 		}
 		delete[] Buff;
+		RegCloseKey(hk);
 	}
-	RegCloseKey(hk);
 	return strReturn;
 }
 
-int Settings::setStringSetting(Node type, int intNodeId, const std::wstring &name, const std::wstring &value, bool parameter) {
+int Settings::setStringSetting(Node type, int intNodeId, const std::string &name, const std::string &value, bool parameter) {
 
 	HKEY hk;
 	int ret = TELLSTICK_SUCCESS;
@@ -231,29 +234,40 @@ int Settings::setStringSetting(Node type, int intNodeId, const std::wstring &nam
 	long lnExists = RegOpenKeyEx(d->rootKey, strCompleteRegPath.c_str(), 0, KEY_WRITE, &hk);
 				
 	if (lnExists == ERROR_SUCCESS){
-		int length = (int)value.length() * sizeof(wchar_t);
-		RegSetValueEx(hk, name.c_str(), 0, REG_SZ, (LPBYTE)value.c_str(), length+1);
+		//The registry is UTF-16
+		std::wstring wideValue = TelldusCore::charToWstring(value.c_str());
+		int length = (int)wideValue.length() * sizeof(wchar_t);
+		RegSetValueEx(hk, TelldusCore::charToWstring(name.c_str()).c_str(), 0, REG_SZ, (LPBYTE)wideValue.c_str(), length+1);
+		RegCloseKey(hk);
 	} else {
 		ret = TELLSTICK_ERROR_UNKNOWN;
 	}
-	RegCloseKey(hk);
 
 	return ret;
 
 }
 
-int Settings::getIntSetting(Node type, int intNodeId, const std::wstring &name, bool parameter) const {
+int Settings::getIntSetting(Node type, int intNodeId, const std::string &name, bool parameter) const {
 	int intReturn = 0;
+	HKEY hk;
 
-	std::wstring strSetting = getStringSetting(type, intNodeId, name, parameter);
-	if (strSetting.length()) {
-		intReturn = (int)strSetting[0]; //TODO: do real conversion instead
+	std::wstring strCompleteRegPath = d->getNodePath(type);
+	strCompleteRegPath.append(TelldusCore::intToWstring(intNodeId));
+	long lnExists = RegOpenKeyEx(d->rootKey, strCompleteRegPath.c_str(), 0, KEY_QUERY_VALUE, &hk);
+	if (lnExists == ERROR_SUCCESS) {
+		//Read as a number, it is no longer converted as text
+		DWORD dwVal = 0;
+		DWORD dwLength = sizeof(DWORD);
+		long lngStatus = RegQueryValueEx(hk, TelldusCore::charToWstring(name.c_str()).c_str(), NULL, NULL, reinterpret_cast<LPBYTE>(&dwVal), &dwLength);
+		if (lngStatus == ERROR_SUCCESS) {
+			intReturn = (int)dwVal;
+		}
+		RegCloseKey(hk);
 	}
-
 	return intReturn;
 }
 
-int Settings::setIntSetting(Node type, int intNodeId, const std::wstring &name, int value, bool parameter) {
+int Settings::setIntSetting(Node type, int intNodeId, const std::string &name, int value, bool parameter) {
 	int intReturn = TELLSTICK_ERROR_UNKNOWN;
 	HKEY hk;
 
@@ -262,11 +276,11 @@ int Settings::setIntSetting(Node type, int intNodeId, const std::wstring &name,
 	long lnExists = RegOpenKeyEx(d->rootKey, strCompleteRegPath.c_str(), 0, KEY_WRITE, &hk);
 	if (lnExists == ERROR_SUCCESS) {
 		DWORD dwVal = value;
-		lnExists = RegSetValueEx (hk, name.c_str(), 0L, REG_DWORD, (CONST BYTE*) &dwVal, sizeof(DWORD));
+		lnExists = RegSetValueEx (hk, TelldusCore::charToWstring(name.c_str()).c_str(), 0L, REG_DWORD, (CONST BYTE*) &dwVal, sizeof(DWORD));
 		if (lnExists == ERROR_SUCCESS) {
 			intReturn = TELLSTICK_SUCCESS;
 		}
+		RegCloseKey(hk);
 	}
-	RegCloseKey(hk);
 	return intReturn;
 }
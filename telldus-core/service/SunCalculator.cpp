@@ -0,0 +1,53 @@
+#include "SunCalculator.h"
+#include <math.h>
+
+namespace {
+	const double PI = 3.14159265358979323846;
+	const double J2000 = 2451545.0;
+	const double UNIX_EPOCH = 2440587.5;
+
+	double toRadians(double degrees) {
+		return degrees*PI/180.0;
+	}
+
+	double toDegrees(double radians) {
+		return radians*180.0/PI;
+	}
+
+	//Days since 1970-01-01 in the proleptic Gregorian calendar
+	long daysFromCivil(int year, int month, int day) {
+		year -= (month <= 2);
+		long era = (year >= 0 ? year : year-399) / 400;
+		long yearOfEra = year - era*400;
+		long dayOfYear = (153*(month + (month > 2 ? -3 : 9)) + 2)/5 + day-1;
+		long dayOfEra = yearOfEra*365 + yearOfEra/4 - yearOfEra/100 + dayOfYear;
+		return era*146097 + dayOfEra - 719468;
+	}
+}
+
+//The sunrise equation, see http://en.wikipedia.org/wiki/Sunrise_equation
+bool SunCalculator::calculate(int year, int month, int day, double latitude, double longitude, time_t *sunrise, time_t *sunset) {
+	//Noon UTC, as a Julian date
+	double julianNoon = UNIX_EPOCH + daysFromCivil(year, month, day) + 0.5;
+	double meanSolarNoon = julianNoon - J2000 + 0.0008 - longitude/360.0;
+
+	double meanAnomaly = fmod(357.5291 + 0.98560028*meanSolarNoon, 360.0);
+	double m = toRadians(meanAnomaly);
+	double center = 1.9148*sin(m) + 0.0200*sin(2*m) + 0.0003*sin(3*m);
+	double eclipticLongitude = toRadians(fmod(meanAnomaly + center + 180.0 + 102.9372, 360.0));
+	double transit = J2000 + meanSolarNoon + 0.0053*sin(m) - 0.0069*sin(2*eclipticLongitude);
+
+	double declination = asin(sin(eclipticLongitude)*sin(toRadians(23.4397)));
+	double phi = toRadians(latitude);
+	//-0.833 degrees for the refraction and the size of the sun
+	double cosHourAngle = (sin(toRadians(-0.833)) - sin(phi)*sin(declination)) / (cos(phi)*cos(declination));
+	if (cosHourAngle < -1.0 || cosHourAngle > 1.0) {
+		//Midnight sun or polar night
+		return false;
+	}
+	double hourAngle = toDegrees(acos(cosHourAngle));
+
+	*sunrise = (time_t)floor(((transit - hourAngle/360.0) - UNIX_EPOCH)*86400.0 + 0.5);
+	*sunset = (time_t)floor(((transit + hourAngle/360.0) - UNIX_EPOCH)*86400.0 + 0.5);
+	return true;
+}
@@ -0,0 +1,18 @@
+#ifndef SUNCALCULATOR_H
+#define SUNCALCULATOR_H
+
+#include <time.h>
+
+class SunCalculator
+{
+public:
+	/**
+	 * Calculates when the sun rises and sets on a date, at a position given
+	 * in degrees, north and east positive. The date is the calendar day at
+	 * the position, the times returned are ordinary timestamps.
+	 * @return false if the sun doesn't rise or doesn't set that day.
+	 */
+	static bool calculate(int year, int month, int day, double latitude, double longitude, time_t *sunrise, time_t *sunset);
+};
+
+#endif // SUNCALCULATOR_H
@@ -10,44 +10,218 @@
 //
 //
 #include "TellStick.h"
+#include "Strings.h"
+#include "common.h"
+#include "../client/telldus-core.h"
 
-#include <map>
 #include <stdio.h>
 
+//The repeat count and pause (ms) the firmware uses unless the packet sets them with R and P
+const int DEFAULT_REPEATS = 10;
+const int DEFAULT_PAUSE = 11;
+const size_t DUO_BUFFER_SIZE = 512; //bytes
+
+int TellStick::doStartSend( const std::string &strMessage, int *ticket ) {
+	bool waitForAck = true;
+	if(strMessage.compare("N+") == 0 && ((pid() == 0x0C31 && firmwareVersion() < 5) || (pid() == 0x0C30 && firmwareVersion() < 6))){
+		//these firmware versions doesn't implement ack to noop, just check that the noop can be sent correctly
+		waitForAck = false;
+	} else if(ignoreControllerConfirmation){
+		waitForAck = false;
+	}
+	//A Duo with buffering firmware takes the next commands while sending, all others get one command at a time
+	bool pipeline = (waitForAck && pid() == 0x0C31 && pipelineFirmware > 0 && firmwareVersion() >= pipelineFirmware);
+
+	//Commands must be written in the same order as their acks are queued
+	TelldusCore::MutexLocker sendLocker(&sendMutex);
+
+	if (!acks.waitForRoom(strMessage.length(), (pipeline ? DUO_BUFFER_SIZE : 0), ackTimeout*1000)) {
+		return TELLSTICK_ERROR_COMMUNICATION;
+	}
+
+	//Queue before writing so an early ack seen by the reader thread isn't lost
+	int queued = 0;
+	if (waitForAck) {
+		queued = acks.queue(strMessage.length());
+	}
+	int retval = writeData(strMessage);
+	if (retval != TELLSTICK_SUCCESS) {
+		if (waitForAck) {
+			acks.cancel(queued);
+		}
+		return retval;
+	}
+
+	if (!waitForAck && ignoreControllerConfirmation) {
+		//allow TellStick to finish its air-sending
+		msleep(1000);
+	}
+	//The reader thread receives the ack, the next command can be written meanwhile
+	*ticket = queued;
+	return TELLSTICK_SUCCESS;
+}
+
+int TellStick::doFinishSend( int ticket ) {
+	return acks.wait(ticket, ackTimeout*1000);
+}
+
+void TellStick::processData( const char *data, size_t length ) {
+	const char *line;
+	size_t lineLength;
+	while (length > 0) {
+		size_t consumed = framer.append(data, length);
+		data += consumed;
+		length -= consumed;
+		while (framer.nextLine(&line, &lineLength)) {
+			char type = (lineLength >= 2 && line[0] == '+' ? line[1] : 0);
+			if (type == 'V') {
+				setFirmwareVersion(TelldusCore::charToInteger(line+2));
+			} else if (type == 'R') {
+				this->publishData(std::string(line+2, lineLength-2));
+			} else if (type == 'W') {
+				this->decodePublishData(std::string(line+2, lineLength-2));
+			} else {
+				//Anything else is the confirmation of a sent command
+				acks.signal(TELLSTICK_SUCCESS);
+			}
+		}
+	}
+}
+
+void TellStick::clearData() {
+	framer.clear();
+}
+
+void TellStick::failPendingAcks( int result ) {
+	acks.signal(result);
+}
+
+bool TellStick::isAwaitingAck() const {
+	return acks.isWaiting();
+}
+
+void TellStick::setAckTimeout( int seconds ) {
+	ackTimeout = (seconds < 1 ? 1 : seconds);
+}
+
+void TellStick::setPipelineFirmware( const std::string &version ) {
+	//Empty, or 0, keeps every controller at one command at a time
+	pipelineFirmware = (version.length() ? TelldusCore::charToInteger(version.c_str()) : 0);
+}
+
+int TellStick::estimateAirtime( const std::string &message ) const {
+	return TellStick::packetAirtime(message);
+}
+
+int TellStick::estimateTransferTime( const std::string &message ) const {
+	//8N1 framing, ten bits on the wire for every byte
+	int baud = (pid() == 0x0C31 ? 9600 : 4800);
+	return (int)(message.length()*10*1000/baud);
+}
+
+int TellStick::packetAirtime( const std::string &packet ) {
+	int repeats = DEFAULT_REPEATS, pause = DEFAULT_PAUSE;
+	long pulses = 0; //In units of 10us
+	size_t i = 0;
+	while (i < packet.length()) {
+		char command = packet[i];
+		if (command == 'R' && i+1 < packet.length()) {
+			repeats = (unsigned char)packet[i+1];
+			i += 2;
+		} else if (command == 'P' && i+1 < packet.length()) {
+			pause = (unsigned char)packet[i+1];
+			i += 2;
+		} else if (command == 'S') {
+			for (++i; i < packet.length() && packet[i] != '+'; ++i) {
+				pulses += (unsigned char)packet[i];
+			}
+			break;
+		} else if (command == 'T' && i+5 < packet.length()) {
+			unsigned char times[4];
+			for (int j = 0; j < 4; ++j) {
+				times[j] = packet[i+1+j];
+			}
+			size_t length = (unsigned char)packet[i+5];
+			i += 6;
+			for (size_t j = 0; j < length && i+j/4 < packet.length(); ++j) {
+				unsigned char dataByte = packet[i+j/4];
+				pulses += times[(dataByte >> (6-(j%4)*2)) & 3];
+			}
+			break;
+		} else {
+			//Not something sent on air
+			return 0;
+		}
+	}
+	if (!pulses || !repeats) {
+		return 0;
+	}
+	return (int)((pulses*repeats + 99)/100) + pause*(repeats-1);
+}
+
+std::string TellStick::encodePacket( const std::string &code, int pid ) {
+	//Keep any repeat and pause prefixes as they are
+	size_t start = 0;
+	while (start+1 < code.length() && (code[start] == 'R' || code[start] == 'P')) {
+		start += 2;
+	}
+	std::string pulses;
+	if (start < code.length() && code[start] == 'S' && code[code.length()-1] == '+') {
+		pulses = code.substr(start+1, code.length()-start-2);
+	} else if (start == 0 && code.length() && code[0] != 'S' && code[0] != 'T') {
+		pulses = code;
+	} else {
+		//Already a T-packet, or something we don't know how to encode
+		return code;
+	}
+
+	std::string packet;
+	unsigned int maxlength = 80;
+	if (pid == 0x0c31) {
+		maxlength = 512;
+	}
+	//An S-packet ends at the first '+' so it cannot hold a pulse of that length
+	if (pulses.length() <= maxlength && pulses.find('+') == std::string::npos) {
+		packet = "S" + pulses + "+";
+	}
+	std::string tPacket = TellStick::createTPacket(pulses);
+	if (tPacket.length() && (!packet.length() || tPacket.length() < packet.length())) {
+		packet = tPacket;
+	}
+	if (!packet.length()) {
+		return "";
+	}
+	return code.substr(0, start) + packet;
+}
+
 std::string TellStick::createTPacket( const std::string &msg ) {
-	std::map<unsigned char, char> times;
+	unsigned char times[4] = {1, 1, 1, 1};
+	int numberOfTimes = 0;
 	std::string data;
-	int index = 0;
+	data.reserve(msg.length());
 	for(size_t i = 0; i < msg.length(); ++i) {
 		//Search to se if it already exists and get the index
-		if (times.find(msg.at(i)) == times.end()) {
-			times[msg.at(i)] = index++;
-			if (times.size() > 4) {
+		unsigned char pulse = msg[i];
+		int index = 0;
+		while (index < numberOfTimes && times[index] != pulse) {
+			++index;
+		}
+		if (index == numberOfTimes) {
+			if (numberOfTimes == 4) {
 				return "";
 			}
+			times[numberOfTimes++] = pulse;
 		}
-		data.append(1, times[msg.at(i)]);
-	}
-	//Reorder the times
-	unsigned char t0 = 1, t1 = 1, t2 = 1, t3 = 1;
-	for(std::map<unsigned char, char>::const_iterator it = times.begin(); it != times.end(); ++it) {
-		if ((*it).second == 0) {
-			t0 = (*it).first;
-		} else if ((*it).second == 1) {
-			t1 = (*it).first;
-		} else if ((*it).second == 2) {
-			t2 = (*it).first;
-		} else if ((*it).second == 3) {
-			t3 = (*it).first;
-		}
+		data.append(1, index);
 	}
 
-	return TellStick::convertSToT(t0,t1,t2,t3,data);
+	return TellStick::convertSToT(times[0], times[1], times[2], times[3], data);
 }
 
 std::string TellStick::convertSToT( unsigned char t0, unsigned char t1, unsigned char t2, unsigned char t3, const std::string &data ) {
 	unsigned char dataByte = 0;
 	std::string retString = "T";
+	retString.reserve(7 + (data.length()+3)/4);
 	retString.append(1, t0);
 	retString.append(1, t1);
 	retString.append(1, t2);
@@ -74,7 +248,8 @@ std::string TellStick::convertSToT( unsigned char t0, unsigned char t1, unsigned
 		}
 	}
 	if (data.length() % 4 != 0) {
-		dataByte <<= (data.length() % 4)*2;
+		//Left align the last pulses
+		dataByte <<= (4 - data.length() % 4)*2;
 		retString.append(1, dataByte);
 	}
 
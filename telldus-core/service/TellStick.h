@@ -13,6 +13,9 @@
 #define TELLSTICK_H
 
 #include "Controller.h"
+#include "ControllerAckQueue.h"
+#include "ControllerLineFramer.h"
+#include "Mutex.h"
 #include "Thread.h"
 #include <list>
 
@@ -32,18 +35,40 @@ public:
 	virtual std::string serial() const;
 
 	bool isOpen() const;
-	bool isSameAsDescriptor(const TellStickDescriptor &d) const;
+	virtual bool isSameAsDescriptor(const TellStickDescriptor &d) const;
 	virtual int reset();
-	virtual int send( const std::string &message );
-	bool stillConnected() const;
+	virtual bool stillConnected() const;
 
 	static std::list<TellStickDescriptor> findAll();
 
+	static int packetAirtime( const std::string &packet );
+	static std::string encodePacket( const std::string &code, int pid );
 	static std::string createTPacket( const std::string & );
 	static std::string convertSToT(  unsigned char t0, unsigned char t1, unsigned char t2, unsigned char t3, const std::string &data );
 
 protected:
-	void processData( const std::string &data );
+	//For controllers emulating a TellStick, no device is opened
+	TellStick(int controllerId, TelldusCore::EventRef event, TelldusCore::EventRef updateEvent);
+
+	virtual int doStartSend( const std::string &message, int *ticket );
+	virtual int doFinishSend( int ticket );
+	virtual int estimateAirtime( const std::string &message ) const;
+	virtual int estimateTransferTime( const std::string &message ) const;
+
+	//Writes a command to the controller, in the order the commands are sent
+	virtual int writeData( const std::string &message );
+	//Splits the data read from the controller into lines and dispatches them, the acks included.
+	//Only called from the reader thread.
+	void processData( const char *data, size_t length );
+	//Drops a partially read line, for when the reader starts over on a new connection
+	void clearData();
+	//Fails all commands waiting for their ack, for when the controller can't be read
+	void failPendingAcks( int result );
+	bool isAwaitingAck() const;
+	void setAckTimeout( int seconds );
+	//The first TellStick Duo firmware known to buffer commands while sending, from the setting duoPipelineFirmware
+	void setPipelineFirmware( const std::string &version );
+
 	void run();
 	void setBaud( int baud );
 	void stop();
@@ -51,6 +76,15 @@ protected:
 private:
 	static std::list<TellStickDescriptor> findAllByVIDPID( int vid, int pid );
 
+	static const int ACK_TIMEOUT = 5; //seconds
+
+	//Shared by all kinds of TellSticks, see TellStick.cpp
+	ControllerLineFramer framer;
+	ControllerAckQueue acks;
+	TelldusCore::Mutex sendMutex;
+	bool ignoreControllerConfirmation;
+	int ackTimeout, pipelineFirmware;
+
 	class PrivateData;
 	PrivateData *d;
 };
@@ -23,9 +23,9 @@
 
 class TellStick::PrivateData {
 public:
-	bool open, running, ignoreControllerConfirmation;
+	bool open, running;
 	int vid, pid;
-	std::string serial, message;
+	std::string serial;
 	FT_HANDLE ftHandle;
 	TelldusCore::Mutex mutex;
 
@@ -41,7 +41,10 @@ public:
 };
 
 TellStick::TellStick(int controllerId, TelldusCore::EventRef event, TelldusCore::EventRef updateEvent, const TellStickDescriptor &td )
-	:Controller(controllerId, event, updateEvent)
+	:Controller(controllerId, event, updateEvent),
+	ignoreControllerConfirmation(false),
+	ackTimeout(ACK_TIMEOUT),
+	pipelineFirmware(0)
 {
 	d = new PrivateData;
 #ifdef _WINDOWS
@@ -56,7 +59,15 @@ TellStick::TellStick(int controllerId, TelldusCore::EventRef event, TelldusCore:
 	d->pid = td.pid;
 	d->serial = td.serial;
 	Settings set;
-	d->ignoreControllerConfirmation = set.getSetting(L"ignoreControllerConfirmation")==L"true";
+	ignoreControllerConfirmation = set.getSetting("ignoreControllerConfirmation")=="true";
+	setPipelineFirmware(set.getSetting("duoPipelineFirmware"));
+	int receiveGap = 0;
+	if (td.pid == 0x0C31) {
+		//Leave the Duo some time between transmissions to receive
+		std::string value = set.getSetting("receiveGap");
+		receiveGap = (value.length() ? TelldusCore::charToInteger(value.c_str()) : 100);
+	}
+	setTransmitPacing(TelldusCore::charToInteger(set.getSetting("transmitDutyCycle").c_str()), receiveGap);
 
 	char *tempSerial = new char[td.serial.size()+1];
 #ifdef _WINDOWS
@@ -86,8 +97,29 @@ TellStick::TellStick(int controllerId, TelldusCore::EventRef event, TelldusCore:
 	}
 }
 
+TellStick::TellStick(int controllerId, TelldusCore::EventRef event, TelldusCore::EventRef updateEvent)
+	:Controller(controllerId, event, updateEvent),
+	ignoreControllerConfirmation(false),
+	ackTimeout(ACK_TIMEOUT),
+	pipelineFirmware(0)
+{
+	d = new PrivateData;
+#ifdef _WINDOWS
+	d->eh = CreateEvent( NULL, false, false, NULL );
+#else
+	pthread_mutex_init(&d->eh.eMutex, NULL);
+	pthread_cond_init(&d->eh.eCondVar, NULL);
+#endif
+	d->open = false;
+	d->running = false;
+	d->vid = 0;
+	d->pid = 0;
+}
+
 TellStick::~TellStick() {
-	Log::warning("Disconnected TellStick (%X/%X) with serial %s", d->vid, d->pid, d->serial.c_str());
+	if (d->open) {
+		Log::warning("Disconnected TellStick (%X/%X) with serial %s", d->vid, d->pid, d->serial.c_str());
+	}
 	if (d->running) {
 		TelldusCore::MutexLocker locker(&d->mutex);
 		d->running = false;
@@ -97,8 +129,10 @@ TellStick::~TellStick() {
 		pthread_cond_broadcast(&d->eh.eCondVar);
 #endif
 	}
-	this->wait();
+	//Unlock anyone waiting for an ack
+	failPendingAcks(TELLSTICK_ERROR_BROKEN_PIPE);
 	if (d->open) {
+		this->wait();
 		FT_Close(d->ftHandle);
 	}
 	delete d;
@@ -137,25 +171,6 @@ bool TellStick::isSameAsDescriptor(const TellStickDescriptor &td) const {
 	return true;
 }
 
-void TellStick::processData( const std::string &data ) {
-	for (unsigned int i = 0; i < data.length(); ++i) {
-		if (data[i] == 13) { // Skip \r
-			continue;
-		} else if (data[i] == 10) { // \n found
-			if (d->message.substr(0,2).compare("+V") == 0) {
-				setFirmwareVersion(TelldusCore::charToInteger(d->message.substr(2).c_str()));
-			} else if (d->message.substr(0,2).compare("+R") == 0) {
-				this->publishData(d->message.substr(2));
-			} else if(d->message.substr(0,2).compare("+W") == 0) {
-				this->decodePublishData(d->message.substr(2));
-			}
-			d->message.clear();
-		} else { // Append the character
-			d->message.append( 1, data[i] );
-		}
-	}
-}
-
 int TellStick::reset(){
 #ifndef _WINDOWS
 	return TELLSTICK_SUCCESS; //nothing to be done on other platforms
@@ -172,7 +187,7 @@ void TellStick::run() {
 	d->running = true;
 	DWORD dwBytesInQueue = 0;
 	DWORD dwBytesRead = 0;
-	char *buf = 0;
+	char buf[1024];
 
 	//Send a firmware version request
 	char msg[] = "V+";
@@ -195,26 +210,23 @@ void TellStick::run() {
 		}
 		FT_GetQueueStatus(d->ftHandle, &dwBytesInQueue);
 		if (dwBytesInQueue < 1) {
-			d->mutex.unlock();
 			continue;
 		}
-		buf = (char*)malloc(sizeof(buf) * (dwBytesInQueue+1));
-		memset(buf, 0, dwBytesInQueue+1);
-		FT_Read(d->ftHandle, buf, dwBytesInQueue, &dwBytesRead);
-		processData( buf );
-		free(buf);
+		while (dwBytesInQueue > 0) {
+			DWORD dwBytesToRead = (dwBytesInQueue > sizeof(buf) ? sizeof(buf) : dwBytesInQueue);
+			if (FT_Read(d->ftHandle, buf, dwBytesToRead, &dwBytesRead) != FT_OK || dwBytesRead == 0) {
+				break;
+			}
+			processData( buf, dwBytesRead );
+			dwBytesInQueue -= dwBytesRead;
+		}
 	}
 }
 
-int TellStick::send( const std::string &strMessage ) {
+int TellStick::writeData( const std::string &strMessage ) {
 	if (!d->open) {
 		return TELLSTICK_ERROR_NOT_FOUND;
 	}
-	
-	//This lock does two things
-	// 1 Prevents two calls from different threads to this function
-	// 2 Prevents our running thread from receiving the data we are interested in here
-	TelldusCore::MutexLocker locker(&d->mutex);
 
 	char *tempMessage = (char *)malloc(sizeof(char) * (strMessage.size()+1));
 #ifdef _WINDOWS
@@ -223,44 +235,19 @@ int TellStick::send( const std::string &strMessage ) {
 	strcpy(tempMessage, strMessage.c_str());
 #endif
 
-	ULONG bytesWritten, bytesRead;
-	char in;
+	ULONG bytesWritten;
 	FT_STATUS ftStatus;
-	ftStatus = FT_Write(d->ftHandle, tempMessage, (DWORD)strMessage.length(), &bytesWritten);
+	{
+		TelldusCore::MutexLocker locker(&d->mutex);
+		ftStatus = FT_Write(d->ftHandle, tempMessage, (DWORD)strMessage.length(), &bytesWritten);
+	}
 	free(tempMessage);
-	
+
 	if(ftStatus != FT_OK){
 		Log::debug("Broken pipe on send");
 		return TELLSTICK_ERROR_BROKEN_PIPE;
 	}
-
-	if(strMessage.compare("N+") == 0 && ((pid() == 0x0C31 && firmwareVersion() < 5) || (pid() == 0x0C30 && firmwareVersion() < 6))){
-		//these firmware versions doesn't implement ack to noop, just check that the noop can be sent correctly
-		return TELLSTICK_SUCCESS;
-	}
-	if(d->ignoreControllerConfirmation){
-		//wait for TellStick to finish its air-sending
-		msleep(1000);
-		return TELLSTICK_SUCCESS;
-	}
-
-	while(1) {
-		ftStatus = FT_Read(d->ftHandle,&in,1,&bytesRead);
-		if (ftStatus == FT_OK) {
-			if (bytesRead == 1) {
-				if (in == '\n') {
-					return TELLSTICK_SUCCESS;
-				} else {
-					continue;
-				}
-			} else { //Timeout
-				return TELLSTICK_ERROR_COMMUNICATION;
-			}
-		} else { //Error
-			Log::debug("Broken pipe on read");
-			return TELLSTICK_ERROR_BROKEN_PIPE;
-		}
-	}
+	return TELLSTICK_SUCCESS;
 }
 
 bool TellStick::stillConnected() const {
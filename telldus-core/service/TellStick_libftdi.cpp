@@ -25,25 +25,21 @@
 
 #include <unistd.h>
 
-typedef struct _EVENT_HANDLE {
-	pthread_cond_t eCondVar;
-	pthread_mutex_t eMutex;
-} EVENT_HANDLE;
-typedef int DWORD;
-
 class TellStick::PrivateData {
 public:
-	bool open, ignoreControllerConfirmation;
+	bool open;
 	int vid, pid;
-	std::string serial, message;
+	std::string serial;
 	ftdi_context ftHandle;
-	EVENT_HANDLE eh;
 	bool running;
 	TelldusCore::Mutex mutex;
 };
 
 TellStick::TellStick(int controllerId, TelldusCore::EventRef event, TelldusCore::EventRef updateEvent, const TellStickDescriptor &td )
-	:Controller(controllerId, event, updateEvent)
+	:Controller(controllerId, event, updateEvent),
+	ignoreControllerConfirmation(false),
+	ackTimeout(ACK_TIMEOUT),
+	pipelineFirmware(0)
 {
 	d = new PrivateData;
 	d->open = false;
@@ -53,7 +49,15 @@ TellStick::TellStick(int controllerId, TelldusCore::EventRef event, TelldusCore:
 	d->running = false;
 
 	Settings set;
-	d->ignoreControllerConfirmation = set.getSetting(L"ignoreControllerConfirmation")==L"true";
+	ignoreControllerConfirmation = set.getSetting("ignoreControllerConfirmation")=="true";
+	setPipelineFirmware(set.getSetting("duoPipelineFirmware"));
+	int receiveGap = 0;
+	if (td.pid == 0x0C31) {
+		//Leave the Duo some time between transmissions to receive
+		std::string value = set.getSetting("receiveGap");
+		receiveGap = (value.length() ? TelldusCore::charToInteger(value.c_str()) : 100);
+	}
+	setTransmitPacing(TelldusCore::charToInteger(set.getSetting("transmitDutyCycle").c_str()), receiveGap);
 
 	ftdi_init(&d->ftHandle);
 	ftdi_set_interface(&d->ftHandle, INTERFACE_ANY);
@@ -82,13 +86,26 @@ TellStick::TellStick(int controllerId, TelldusCore::EventRef event, TelldusCore:
 	}
 }
 
+TellStick::TellStick(int controllerId, TelldusCore::EventRef event, TelldusCore::EventRef updateEvent)
+	:Controller(controllerId, event, updateEvent),
+	ignoreControllerConfirmation(false),
+	ackTimeout(ACK_TIMEOUT),
+	pipelineFirmware(0)
+{
+	d = new PrivateData;
+	d->open = false;
+	d->vid = 0;
+	d->pid = 0;
+	d->running = false;
+}
+
 TellStick::~TellStick() {
-	Log::warning("Disconnected TellStick (%X/%X) with serial %s", d->vid, d->pid, d->serial.c_str());
 	if (d->running) {
 		stop();
 	}
 
 	if (d->open) {
+		Log::warning("Disconnected TellStick (%X/%X) with serial %s", d->vid, d->pid, d->serial.c_str());
 		ftdi_usb_close(&d->ftHandle);
 		ftdi_deinit(&d->ftHandle);
 	}
@@ -124,25 +141,6 @@ bool TellStick::isSameAsDescriptor(const TellStickDescriptor &td) const {
 	return true;
 }
 
-void TellStick::processData( const std::string &data ) {
-	for (unsigned int i = 0; i < data.length(); ++i) {
-		if (data[i] == 13) { // Skip \r
-			continue;
-		} else if (data[i] == 10) { // \n found
-			if (d->message.substr(0,2).compare("+V") == 0) {
-				setFirmwareVersion(TelldusCore::charToInteger(d->message.substr(2).c_str()));
-			} else if (d->message.substr(0,2).compare("+R") == 0) {
-				this->publishData(d->message.substr(2));
-			} else if(d->message.substr(0,2).compare("+W") == 0) {
-				this->decodePublishData(d->message.substr(2));
-			}
-			d->message.clear();
-		} else { // Append the character
-			d->message.append( 1, data[i] );
-		}
-	}
-}
-
 int TellStick::reset(){
 	int success = ftdi_usb_reset( &d->ftHandle );
 	if(success < 0){
@@ -155,40 +153,44 @@ void TellStick::run() {
 	int dwBytesRead = 0;
 	unsigned char buf[1024];     // = 0;
 
-	pthread_mutex_init(&d->eh.eMutex, NULL);
-	pthread_cond_init(&d->eh.eCondVar, NULL);
-
 	{
 		TelldusCore::MutexLocker locker(&d->mutex);
 		d->running = true;
-	}
 
-	//Send a firmware version request
-	unsigned char msg[] = "V+";
-	ftdi_write_data( &d->ftHandle, msg, 2 ) ;
+		//Send a firmware version request
+		unsigned char msg[] = "V+";
+		ftdi_write_data( &d->ftHandle, msg, 2 ) ;
+	}
 
 	while(1) {
-		//Is there any better way then sleeping between reads?
-		msleep(100);
-		TelldusCore::MutexLocker locker(&d->mutex);
-		if (!d->running) {
-			break;
+		//This thread owns all input from the TellStick, including the ack for sent commands.
+		//Don't sleep between reads while someone is waiting for an ack, ftdi_read_data()
+		//will pace us according to the latency timer.
+		if (!isAwaitingAck()) {
+			msleep(100);
+		}
+		{
+			TelldusCore::MutexLocker locker(&d->mutex);
+			if (!d->running) {
+				break;
+			}
+			dwBytesRead = ftdi_read_data(&d->ftHandle, buf, sizeof(buf));
 		}
-		memset(buf, 0, sizeof(buf));
-		dwBytesRead = ftdi_read_data(&d->ftHandle, buf, sizeof(buf));
 		if (dwBytesRead < 0) {
-			//An error occured, avoid flooding by sleeping longer
-			//Hopefully if will start working again
+			//An error occured, let any pending send know
+			Log::debug("Broken pipe on read");
+			failPendingAcks(TELLSTICK_ERROR_BROKEN_PIPE);
+			//Avoid flooding by sleeping longer, hopefully if will start working again
 			msleep(1000); //1s
 		}
 		if (dwBytesRead < 1) {
 			continue;
 		}
-		processData( reinterpret_cast<char *>(&buf) );
+		processData( reinterpret_cast<char *>(&buf), dwBytesRead );
 	}
 }
 
-int TellStick::send( const std::string &strMessage ) {
+int TellStick::writeData( const std::string &strMessage ) {
 	if (!d->open) {
 		return TELLSTICK_ERROR_NOT_FOUND;
 	}
@@ -197,13 +199,11 @@ int TellStick::send( const std::string &strMessage ) {
 	unsigned char *tempMessage = new unsigned char[strMessage.size()];
 	memcpy(tempMessage, strMessage.c_str(), strMessage.size());
 
-	//This lock does two things
-	// 1 Prevents two calls from different threads to this function
-	// 2 Prevents our running thread from receiving the data we are interested in here
-	TelldusCore::MutexLocker locker(&d->mutex);
-
 	int ret;
-	ret = ftdi_write_data( &d->ftHandle, tempMessage, strMessage.length() ) ;
+	{
+		TelldusCore::MutexLocker locker(&d->mutex);
+		ret = ftdi_write_data( &d->ftHandle, tempMessage, strMessage.length() ) ;
+	}
 	if(ret < 0) {
 		c = false;
 	} else if(ret != strMessage.length()) {
@@ -216,35 +216,7 @@ int TellStick::send( const std::string &strMessage ) {
 		Log::debug("Broken pipe on send");
 		return TELLSTICK_ERROR_BROKEN_PIPE;
 	}
-
-	if(strMessage.compare("N+") == 0 && ((pid() == 0x0C31 && firmwareVersion() < 5) || (pid() == 0x0C30 && firmwareVersion() < 6))){
-		//these firmware versions doesn't implement ack to noop, just check that the noop can be sent correctly
-		return TELLSTICK_SUCCESS;
-	}
-
-	if(d->ignoreControllerConfirmation){
-		//allow TellStick to finish its air-sending
-		msleep(1000);
-		return TELLSTICK_SUCCESS;
-	}
-
-	int retrycnt = 250;
-	unsigned char in;
-	while(--retrycnt) {
-		ret = ftdi_read_data( &d->ftHandle, &in, 1);
-		if (ret > 0) {
-			if (in == '\n') {
-				return TELLSTICK_SUCCESS;
-			}
-		} else if(ret == 0) { // No data available
-			usleep(100);
-		} else { //Error
-			Log::debug("Broken pipe on read");
-			return TELLSTICK_ERROR_BROKEN_PIPE;
-		}
-	}
-
-	return TELLSTICK_ERROR_COMMUNICATION;
+	return TELLSTICK_SUCCESS;
 }
 
 void TellStick::setBaud(int baud) {
@@ -324,11 +296,10 @@ void TellStick::stop() {
 	if (d->running) {
 		{
 			TelldusCore::MutexLocker locker(&d->mutex);
-				d->running = false;
+			d->running = false;
 		}
-		//Unlock the wait-condition
-
-		pthread_cond_broadcast(&d->eh.eCondVar);
+		//Unlock anyone waiting for an ack
+		failPendingAcks(TELLSTICK_ERROR_BROKEN_PIPE);
 	}
 	this->wait();
 }
@@ -6,6 +6,7 @@
 #include "ControllerManager.h"
 #include "ControllerListener.h"
 #include "EventUpdateManager.h"
+#include "Scheduler.h"
 #include "Timer.h"
 #include "Log.h"
 
@@ -57,6 +58,9 @@ void TelldusMain::suspend() {
 }
 
 void TelldusMain::start(void) {
+	//Keep the callers, the transmit path included, from waiting on syslog
+	Log::setAsynchronous(true);
+
 	TelldusCore::EventRef clientEvent = d->eventHandler.addEvent();
 	TelldusCore::EventRef dataEvent = d->eventHandler.addEvent();
 	TelldusCore::EventRef janitor = d->eventHandler.addEvent(); //Used for regular cleanups
@@ -69,16 +73,19 @@ void TelldusMain::start(void) {
 	eventUpdateManager.start();
 	ControllerManager controllerManager(dataEvent, deviceUpdateEvent);
 	DeviceManager deviceManager(&controllerManager, deviceUpdateEvent);
+	Scheduler scheduler(&deviceManager);
+	scheduler.start();
 
-	ConnectionListener clientListener(L"TelldusClient", clientEvent);
+	ConnectionListener clientListener("TelldusClient", clientEvent);
 
 	std::list<ClientCommunicationHandler *> clientCommunicationHandlerList;
 
 	TelldusCore::EventRef handlerEvent = d->eventHandler.addEvent();
 
-#ifdef _MACOSX
-	//This is only needed on OS X
+#if defined(_MACOSX) || defined(_NETLINK)
+	//Get notified when a TellStick is plugged in or removed instead of polling for it
 	ControllerListener controllerListener(d->controllerChangeEvent);
+	controllerManager.setHotplugMonitored(controllerListener.isMonitoring());
 #endif
 
 
@@ -91,7 +98,7 @@ void TelldusMain::start(void) {
 			TelldusCore::EventDataRef eventDataRef = clientEvent->takeSignal();
 			ConnectionListenerEventData *data = reinterpret_cast<ConnectionListenerEventData*>(eventDataRef.get());
 			if (data) {
-				ClientCommunicationHandler *clientCommunication = new ClientCommunicationHandler(data->socket, handlerEvent, &deviceManager, deviceUpdateEvent, &controllerManager);
+				ClientCommunicationHandler *clientCommunication = new ClientCommunicationHandler(data->socket, handlerEvent, &deviceManager, deviceUpdateEvent, &controllerManager, &scheduler);
 				clientCommunication->start();
 				clientCommunicationHandlerList.push_back(clientCommunication);
 			}
@@ -135,6 +142,8 @@ void TelldusMain::start(void) {
 	}
 
 	supervisor.stop();
+	scheduler.stop();
+	Log::setAsynchronous(false);
 }
 
 void TelldusMain::stop(void){
@@ -0,0 +1,159 @@
+#include "TimerWheel.h"
+#include <list>
+#include <map>
+
+namespace {
+	const int FIRST_BITS = 8, LEVEL_BITS = 6, LEVELS = 4;
+	const time_t FIRST_SIZE = 1 << FIRST_BITS, LEVEL_SIZE = 1 << LEVEL_BITS;
+
+	class Timer {
+	public:
+		int id;
+		time_t expires;
+	};
+	typedef std::list<Timer> Slot;
+
+	class Location {
+	public:
+		Slot *slot;
+		Slot::iterator it;
+	};
+}
+
+class TimerWheel::PrivateData {
+public:
+	time_t current;
+	std::vector<Slot> wheels[LEVELS];
+	//Timers beyond the last wheel
+	Slot overflow;
+	std::map<int, Location> timers;
+
+	void insert(const Timer &timer);
+	void cascade(int level);
+	void rebuild(time_t now, std::vector<int> *expired);
+};
+
+void TimerWheel::PrivateData::insert(const Timer &timer) {
+	time_t expires = timer.expires;
+	if (expires < current) {
+		expires = current;
+	}
+	time_t delta = expires - current;
+	Slot *slot;
+	if (delta < FIRST_SIZE) {
+		slot = &wheels[0][expires & (FIRST_SIZE-1)];
+	} else {
+		slot = &overflow;
+		for (int level = 1; level < LEVELS; ++level) {
+			int shift = FIRST_BITS + level*LEVEL_BITS;
+			if (delta < ((time_t)1 << shift)) {
+				slot = &wheels[level][(expires >> (shift - LEVEL_BITS)) & (LEVEL_SIZE-1)];
+				break;
+			}
+		}
+	}
+	Location location;
+	location.slot = slot;
+	location.it = slot->insert(slot->end(), timer);
+	timers[timer.id] = location;
+}
+
+void TimerWheel::PrivateData::cascade(int level) {
+	Slot timersInSlot;
+	if (level < LEVELS) {
+		int shift = FIRST_BITS + (level-1)*LEVEL_BITS;
+		timersInSlot.swap(wheels[level][(current >> shift) & (LEVEL_SIZE-1)]);
+	} else {
+		timersInSlot.swap(overflow);
+	}
+	for (Slot::iterator it = timersInSlot.begin(); it != timersInSlot.end(); ++it) {
+		insert(*it);
+	}
+}
+
+void TimerWheel::PrivateData::rebuild(time_t now, std::vector<int> *expired) {
+	std::multimap<time_t, Timer> all;
+	for (std::map<int, Location>::const_iterator it = timers.begin(); it != timers.end(); ++it) {
+		all.insert(std::make_pair(it->second.it->expires, *it->second.it));
+	}
+	for (int level = 0; level < LEVELS; ++level) {
+		for (size_t i = 0; i < wheels[level].size(); ++i) {
+			wheels[level][i].clear();
+		}
+	}
+	overflow.clear();
+	timers.clear();
+
+	current = now;
+	for (std::multimap<time_t, Timer>::const_iterator it = all.begin(); it != all.end(); ++it) {
+		if (it->first <= now) {
+			expired->push_back(it->second.id);
+		} else {
+			insert(it->second);
+		}
+	}
+}
+
+TimerWheel::TimerWheel(time_t now) {
+	d = new PrivateData;
+	d->current = now;
+	d->wheels[0].resize(FIRST_SIZE);
+	for (int level = 1; level < LEVELS; ++level) {
+		d->wheels[level].resize(LEVEL_SIZE);
+	}
+}
+
+TimerWheel::~TimerWheel() {
+	delete d;
+}
+
+void TimerWheel::schedule(int id, time_t expires) {
+	cancel(id);
+	Timer timer;
+	timer.id = id;
+	//The current second has already been handled
+	timer.expires = (expires > d->current ? expires : d->current + 1);
+	d->insert(timer);
+}
+
+void TimerWheel::cancel(int id) {
+	std::map<int, Location>::iterator it = d->timers.find(id);
+	if (it == d->timers.end()) {
+		return;
+	}
+	it->second.slot->erase(it->second.it);
+	d->timers.erase(it);
+}
+
+bool TimerWheel::isScheduled(int id) const {
+	return d->timers.find(id) != d->timers.end();
+}
+
+size_t TimerWheel::size() const {
+	return d->timers.size();
+}
+
+void TimerWheel::advance(time_t now, std::vector<int> *expired) {
+	if (now < d->current || now - d->current > FIRST_SIZE*LEVEL_SIZE) {
+		//Stepping through would take longer than sorting them in again
+		d->rebuild(now, expired);
+		return;
+	}
+	while (d->current < now) {
+		++d->current;
+		//Move the timers of the next slot of each wheel down when the one below wraps
+		for (int level = 1; level <= LEVELS; ++level) {
+			int shift = FIRST_BITS + (level-1)*LEVEL_BITS;
+			if ((d->current & (((time_t)1 << shift) - 1)) != 0) {
+				break;
+			}
+			d->cascade(level);
+		}
+		Slot &slot = d->wheels[0][d->current & (FIRST_SIZE-1)];
+		while (!slot.empty()) {
+			expired->push_back(slot.front().id);
+			d->timers.erase(slot.front().id);
+			slot.pop_front();
+		}
+	}
+}
@@ -0,0 +1,44 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <time.h>
+#include <vector>
+
+/**
+ * A hierarchical timer wheel with a resolution of one second.
+ *
+ * The first wheel has a slot for each of the next 256 seconds, each of the
+ * following wheels has 64 slots covering 64 slots of the one below. A timer
+ * is put in the slot of the wheel its expiry falls within, and is moved down
+ * a wheel when the wheel below wraps. Adding and cancelling a timer is done
+ * in constant time and so is each second the wheel advances, no matter how
+ * many timers there are.
+ */
+class TimerWheel
+{
+public:
+	TimerWheel(time_t now);
+	~TimerWheel();
+
+	/**
+	 * Adds a timer, replacing any timer with the same id. A timer that has
+	 * already expired expires at the next advance().
+	 */
+	void schedule(int id, time_t expires);
+	void cancel(int id);
+	bool isScheduled(int id) const;
+	size_t size() const;
+
+	/**
+	 * Moves the wheel to now and appends the ids of the timers that expired
+	 * to expired, in the order they expired. If the clock has been set back,
+	 * or forward by a lot, the timers are sorted in again from scratch.
+	 */
+	void advance(time_t now, std::vector<int> *expired);
+
+private:
+	class PrivateData;
+	PrivateData *d;
+};
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,160 @@
+#include "VirtualTellStick.h"
+#include "Settings.h"
+#include "Strings.h"
+#include "Mutex.h"
+#include "Log.h"
+#include "common.h"
+#include "../client/telldus-core.h"
+
+#include <fstream>
+
+class VirtualTellStick::PrivateData {
+public:
+	int pid, firmwareVersion, ackDelay;
+	bool running;
+	std::string script;
+	TelldusCore::Mutex mutex;
+
+	bool isRunning();
+	bool sleep(int msec);
+};
+
+namespace {
+	std::string typeOverride;
+}
+
+bool VirtualTellStick::PrivateData::isRunning() {
+	TelldusCore::MutexLocker locker(&mutex);
+	return running;
+}
+
+bool VirtualTellStick::PrivateData::sleep(int msec) {
+	//Sleep in small steps so we can be stopped
+	for(; msec > 0; msec -= 10) {
+		if (!isRunning()) {
+			return false;
+		}
+		msleep(msec < 10 ? msec : 10);
+	}
+	return isRunning();
+}
+
+VirtualTellStick::VirtualTellStick(int controllerId, TelldusCore::EventRef event, TelldusCore::EventRef updateEvent, int pid)
+	:TellStick(controllerId, event, updateEvent)
+{
+	d = new PrivateData;
+	d->pid = pid;
+	d->running = true;
+
+	Settings set;
+	std::string value = set.getSetting("virtualControllerFirmware");
+	if (value.length()) {
+		d->firmwareVersion = TelldusCore::charToInteger(value.c_str());
+	} else {
+		d->firmwareVersion = (pid == 0x0C31 ? 11 : 6);
+	}
+	value = set.getSetting("virtualControllerAckDelay");
+	d->ackDelay = (value.length() ? TelldusCore::charToInteger(value.c_str()) : 10);
+	d->script = set.getSetting("virtualControllerScript");
+
+	int receiveGap = 0;
+	if (pid == 0x0C31) {
+		value = set.getSetting("receiveGap");
+		receiveGap = (value.length() ? TelldusCore::charToInteger(value.c_str()) : 100);
+	}
+	setTransmitPacing(TelldusCore::charToInteger(set.getSetting("transmitDutyCycle").c_str()), receiveGap);
+
+	Log::notice("Starting virtual %s", (pid == 0x0C31 ? "TellStick Duo" : "TellStick"));
+	this->start();
+}
+
+VirtualTellStick::~VirtualTellStick() {
+	{
+		TelldusCore::MutexLocker locker(&d->mutex);
+		d->running = false;
+	}
+	this->wait();
+	delete d;
+}
+
+int VirtualTellStick::pid() const {
+	return d->pid;
+}
+
+int VirtualTellStick::vid() const {
+	return 0x1781;
+}
+
+std::string VirtualTellStick::serial() const {
+	return "VIRTUAL";
+}
+
+int VirtualTellStick::reset() {
+	return TELLSTICK_SUCCESS;
+}
+
+bool VirtualTellStick::stillConnected() const {
+	return true;
+}
+
+std::string VirtualTellStick::configuredType() {
+	if (typeOverride.length()) {
+		return typeOverride;
+	}
+	Settings set;
+	return set.getSetting("virtualController");
+}
+
+void VirtualTellStick::setConfiguredType(const std::string &type) {
+	typeOverride = type;
+}
+
+int VirtualTellStick::doStartSend( const std::string &message, int * /*ticket*/ ) {
+	//Answers right away, there is never an ack left to wait for
+	if (message.compare("N+") == 0) {
+		if ((d->pid == 0x0C31 && d->firmwareVersion < 5) || (d->pid == 0x0C30 && d->firmwareVersion < 6)) {
+			//No ack to noop in these firmwares
+			return TELLSTICK_SUCCESS;
+		}
+	} else if (!message.length() || (message[0] != 'S' && message[0] != 'T' && message[0] != 'R' && message[0] != 'P')) {
+		//The firmware doesn't answer commands it doesn't know
+		return TELLSTICK_ERROR_COMMUNICATION;
+	}
+	//Ack when the packet would have been sent on air
+	d->sleep(TellStick::packetAirtime(message) + d->ackDelay);
+	return TELLSTICK_SUCCESS;
+}
+
+void VirtualTellStick::run() {
+	std::string version = "+V" + TelldusCore::intToString(d->firmwareVersion) + "\r\n";
+	processData(version.c_str(), version.length());
+
+	if (!d->script.length()) {
+		return;
+	}
+	std::ifstream script(d->script.c_str());
+	if (!script) {
+		Log::warning("Could not open virtual controller script %s", d->script.c_str());
+		return;
+	}
+	//Each line is a delay in ms followed by the data the controller should report, like:
+	//1000 +Wclass:command;protocol:arctech;model:selflearning;data:0x4C9AF29A;
+	std::string line;
+	while (std::getline(script, line)) {
+		if (line.length() && line[line.length()-1] == '\r') {
+			line.erase(line.length()-1);
+		}
+		if (!line.length() || line[0] == '#') {
+			continue;
+		}
+		size_t separator = line.find(' ');
+		if (separator == std::string::npos) {
+			continue;
+		}
+		if (!d->sleep(TelldusCore::charToInteger(line.substr(0, separator).c_str()))) {
+			return;
+		}
+		std::string data = line.substr(separator+1) + "\r\n";
+		processData(data.c_str(), data.length());
+	}
+}
@@ -0,0 +1,34 @@
+#ifndef VIRTUALTELLSTICK_H
+#define VIRTUALTELLSTICK_H
+
+#include "TellStick.h"
+
+/**
+ * A controller emulating a TellStick or TellStick Duo in software.
+ * Used for testing and benchmarking the service without any hardware.
+ */
+class VirtualTellStick : public TellStick {
+public:
+	VirtualTellStick(int controllerId, TelldusCore::EventRef event, TelldusCore::EventRef updateEvent, int pid);
+	virtual ~VirtualTellStick();
+
+	virtual int pid() const;
+	virtual int vid() const;
+	virtual std::string serial() const;
+
+	virtual int reset();
+	virtual bool stillConnected() const;
+
+	static std::string configuredType();
+	static void setConfiguredType(const std::string &type);
+
+protected:
+	virtual int doStartSend( const std::string &message, int *ticket );
+	void run();
+
+private:
+	class PrivateData;
+	PrivateData *d;
+};
+
+#endif //VIRTUALTELLSTICK_H
@@ -12,6 +12,7 @@
 #include "Settings.h"
 #include "Strings.h"
 #include "Log.h"
+#include "VirtualTellStick.h"
 
 #define DAEMON_NAME "telldusd"
 #define PID_FILE "/var/run/" DAEMON_NAME ".pid"
@@ -32,6 +33,18 @@ void signalHandler(int sig) {
 		case SIGPIPE:
 			Log::warning("Received SIGPIPE signal.");
 			break;
+		case SIGUSR1:
+			//More verbose
+			if (Log::level() > Log::Debug) {
+				Log::setLevel((Log::LogLevel)(Log::level() - 1));
+			}
+			break;
+		case SIGUSR2:
+			//Less verbose
+			if (Log::level() < Log::Error) {
+				Log::setLevel((Log::LogLevel)(Log::level() + 1));
+			}
+			break;
 		default:
 			Log::warning("Unhandled signal (%d) %s", sig, strsignal(sig));
 			break;
@@ -49,8 +62,27 @@ int main(int argc, char **argv) {
 			Log::setLogOutput(Log::StdOut);
 		} else if (strcmp(argv[i], "--debug") == 0) {
 			Log::setDebug();
+		} else if (strncmp(argv[i], "--log-level=", 12) == 0) {
+			const char *level = argv[i] + 12;
+			if (strcmp(level, "debug") == 0) {
+				Log::setDebug();
+			} else if (strcmp(level, "notice") == 0) {
+				Log::setLevel(Log::Notice);
+			} else if (strcmp(level, "warning") == 0) {
+				Log::setLevel(Log::Warning);
+			} else if (strcmp(level, "error") == 0) {
+				Log::setLevel(Log::Error);
+			} else {
+				printf("Unknown log level %s\n", level);
+				exit(EXIT_FAILURE);
+			}
+		} else if (strncmp(argv[i], "--virtual-controller=", 21) == 0) {
+			VirtualTellStick::setConfiguredType(argv[i] + 21);
 		} else if (strcmp(argv[i], "--help") == 0) {
-			printf("Telldus TellStick background service\n\nStart with --nodaemon to not run as daemon\n\n");
+			printf("Telldus TellStick background service\n\nStart with --nodaemon to not run as daemon\n");
+			printf("Start with --virtual-controller=tellstick or --virtual-controller=duo to emulate a controller\n");
+			printf("Start with --log-level=debug, notice, warning or error to set what is logged\n");
+			printf("Send SIGUSR1 or SIGUSR2 to log more or less while running\n\n");
 			printf("Report bugs to <info.tech@telldus.com>\n");
 			exit(EXIT_SUCCESS);
 		} else if (strcmp(argv[i], "--version") == 0) {
@@ -109,8 +141,8 @@ int main(int argc, char **argv) {
 	/* Reduce our permissions (change user and group) */
 	if (getuid() == 0 || geteuid() == 0) {
 		Settings settings;
-		std::string user = TelldusCore::wideToString(settings.getSetting(L"user"));
-		std::string group = TelldusCore::wideToString(settings.getSetting(L"group"));
+		std::string user = settings.getSetting("user");
+		std::string group = settings.getSetting("group");
 
 		struct group *grp = getgrnam(group.c_str());
 		if (grp) {
@@ -137,6 +169,8 @@ int main(int argc, char **argv) {
 	signal(SIGTERM, signalHandler);
 	signal(SIGINT,  signalHandler);
 	signal(SIGPIPE, signalHandler);
+	signal(SIGUSR1, signalHandler);
+	signal(SIGUSR2, signalHandler);
 
 	tm.start();
 
@@ -119,6 +119,114 @@ void print_device( int index ) {
 	printf("\n");
 }
 
+typedef struct {
+	char protocol[DATA_LENGTH], model[DATA_LENGTH];
+	int id, dataTypes;
+	char temperature[DATA_LENGTH], humidity[DATA_LENGTH];
+	time_t timestamp;
+} SensorValues;
+
+typedef void (*SensorValuesCallback)(const SensorValues *sensor, void *context);
+
+/* Fetches the values of all sensors with one call to the service and
+ * calls callback once per sensor. Returns the number of sensors. */
+/* Copies src to dest, truncating it to fit */
+void copy_field(char *dest, const char *src, size_t size) {
+	strncpy(dest, src, size);
+	dest[size-1] = 0;
+}
+
+int for_each_sensor(SensorValuesCallback callback, void *context) {
+	char *snapshot = tdSensorSnapshot();
+	SensorValues sensor;
+	int count = 0;
+	/* The whole names of the current sensor, the copies in sensor may be truncated */
+	const char *currentProtocol = 0, *currentModel = 0;
+
+	/* One value per line, the values of a sensor are on consecutive lines */
+	char *line = snapshot;
+	while (line && *line) {
+		char *next = strchr(line, '\n');
+		if (next) {
+			*next++ = 0;
+		}
+		/* "protocol model id dataType value timestamp", names of any length */
+		size_t length = strlen(line);
+		char *fields[7];
+		int numberOfFields = 0;
+		for (char *field = strtok(line, " "); field && numberOfFields < 7; field = strtok(NULL, " ")) {
+			fields[numberOfFields++] = field;
+		}
+		if (numberOfFields != 6) {
+			/* Put the separators back, strtok() replaced them */
+			for (size_t i = 0; i < length; ++i) {
+				if (line[i] == 0) {
+					line[i] = ' ';
+				}
+			}
+			fprintf(stderr, "Could not parse the sensor value: %s\n", line);
+			line = next;
+			continue;
+		}
+		const char *protocol = fields[0], *model = fields[1], *value = fields[4];
+		int id = atoi(fields[2]), dataType = atoi(fields[3]), timestamp = atoi(fields[5]);
+
+		if (!currentProtocol || sensor.id != id || strcmp(currentProtocol, protocol) != 0 || strcmp(currentModel, model) != 0) {
+			if (currentProtocol) {
+				callback(&sensor, context);
+				++count;
+			}
+			memset(&sensor, 0, sizeof(sensor));
+			copy_field(sensor.protocol, protocol, sizeof(sensor.protocol));
+			copy_field(sensor.model, model, sizeof(sensor.model));
+			sensor.id = id;
+			currentProtocol = protocol;
+			currentModel = model;
+		}
+		if (dataType == TELLSTICK_TEMPERATURE) {
+			copy_field(sensor.temperature, value, sizeof(sensor.temperature));
+		} else if (dataType == TELLSTICK_HUMIDITY) {
+			copy_field(sensor.humidity, value, sizeof(sensor.humidity));
+		}
+		sensor.dataTypes |= dataType;
+		if (timestamp > sensor.timestamp) {
+			sensor.timestamp = timestamp;
+		}
+		line = next;
+	}
+	if (currentProtocol) {
+		callback(&sensor, context);
+		++count;
+	}
+	tdReleaseString(snapshot);
+	return count;
+}
+
+void print_sensor(const SensorValues *sensor, void *context) {
+	bool *first = static_cast<bool *>(context);
+	if (*first) {
+		printf("\n\nSENSORS:\n\n%-20s\t%-20s\t%-5s\t%-5s\t%-8s\t%-20s\n", "PROTOCOL", "MODEL", "ID", "TEMP", "HUMIDITY", "LAST UPDATED");
+		*first = false;
+	}
+	char tempvalue[DATA_LENGTH + 4];
+	tempvalue[0] = 0;
+	char humidityvalue[DATA_LENGTH + 1];
+	humidityvalue[0] = 0;
+	char timeBuf[80];
+	timeBuf[0] = 0;
+
+	if (sensor->dataTypes & TELLSTICK_TEMPERATURE) {
+		sprintf(tempvalue, "%s%s", sensor->temperature, DEGREE);
+	}
+	if (sensor->dataTypes & TELLSTICK_HUMIDITY) {
+		sprintf(humidityvalue, "%s%%", sensor->humidity);
+	}
+	if (sensor->dataTypes & (TELLSTICK_TEMPERATURE | TELLSTICK_HUMIDITY)) {
+		strftime(timeBuf, sizeof(timeBuf), "%Y-%m-%d %H:%M:%S", localtime(&sensor->timestamp));
+	}
+	printf("%-20s\t%-20s\t%-5i\t%-5s\t%-8s\t%-20s\n", sensor->protocol, sensor->model, sensor->id, tempvalue, humidityvalue, timeBuf);
+}
+
 int list_devices() {
 	tdInit();
 	int intNum = tdGetNumberOfDevices();
@@ -135,98 +243,46 @@ int list_devices() {
 		i++;
 	}
 
-	char protocol[DATA_LENGTH], model[DATA_LENGTH];
-	int sensorId = 0, dataTypes = 0;
+	bool first = true;
+	for_each_sensor(print_sensor, &first);
+	printf("\n");
+	return TELLSTICK_SUCCESS;
+}
 
-	int sensorStatus = tdSensor(protocol, DATA_LENGTH, model, DATA_LENGTH, &sensorId, &dataTypes);
-	if(sensorStatus == 0){
-		printf("\n\nSENSORS:\n\n%-20s\t%-20s\t%-5s\t%-5s\t%-8s\t%-20s\n", "PROTOCOL", "MODEL", "ID", "TEMP", "HUMIDITY", "LAST UPDATED");
-	}
-	while(sensorStatus == 0){
-		char tempvalue[DATA_LENGTH];
-		tempvalue[0] = 0;
-		char humidityvalue[DATA_LENGTH];
-		humidityvalue[0] = 0;
-		char timeBuf[80];
-		timeBuf[0] = 0;
-		time_t timestamp = 0;
+void print_kv_sensor(const SensorValues *sensor, void *context) {
+	time_t now = *static_cast<time_t *>(context);
 
-		if (dataTypes & TELLSTICK_TEMPERATURE) {
-			tdSensorValue(protocol, model, sensorId, TELLSTICK_TEMPERATURE, tempvalue, DATA_LENGTH, (int *)&timestamp);
-			strcat(tempvalue, DEGREE);
-			strftime(timeBuf, sizeof(timeBuf), "%Y-%m-%d %H:%M:%S", localtime(&timestamp));
-		}
+	printf("type=sensor\tprotocol=%s\tmodel=%s\tid=%d",
+		sensor->protocol, sensor->model, sensor->id);
 
-		if (dataTypes & TELLSTICK_HUMIDITY) {
-			tdSensorValue(protocol, model, sensorId, TELLSTICK_HUMIDITY, humidityvalue, DATA_LENGTH, (int *)&timestamp);
-			strcat(humidityvalue, "%");
-			strftime(timeBuf, sizeof(timeBuf), "%Y-%m-%d %H:%M:%S", localtime(&timestamp));
-		}
-		printf("%-20s\t%-20s\t%-5i\t%-5s\t%-8s\t%-20s\n", protocol, model, sensorId, tempvalue, humidityvalue, timeBuf);
+	if (sensor->dataTypes & TELLSTICK_TEMPERATURE) {
+		printf("\ttemperature=%s", sensor->temperature);
+	}
 
-		sensorStatus = tdSensor(protocol, DATA_LENGTH, model, DATA_LENGTH, &sensorId, &dataTypes);
+	if (sensor->dataTypes & TELLSTICK_HUMIDITY) {
+		printf("\thumidity=%s", sensor->humidity);
 	}
-	printf("\n");
-	if(sensorStatus != TELLSTICK_ERROR_DEVICE_NOT_FOUND){
-		char *errorString = tdGetErrorString(sensorStatus);
-		fprintf(stderr, "Error fetching sensors: %s\n", errorString);
-		tdReleaseString(errorString);
-		return sensorStatus;
+
+	if (sensor->dataTypes & (TELLSTICK_TEMPERATURE | TELLSTICK_HUMIDITY)) {
+		/* timestamp has been set, print time & age */
+		/* (age is more useful on e.g. embedded systems
+		 * which may not have real-time clock chips =>
+		 * time is useful only as a relative value) */
+		char timeBuf[80];
+		strftime(timeBuf, sizeof(timeBuf), "%Y-%m-%d %H:%M:%S", localtime(&sensor->timestamp));
+		printf("\ttime=%s\tage=%d", timeBuf, (int)(now - sensor->timestamp));
 	}
-	return TELLSTICK_SUCCESS;
+	printf("\n");
 }
 
 /* list sensors using key=value format, one sensor/line, no header lines
  * and no degree or percent signs attached to the numbers - just
  * plain values. */
 int list_kv_sensors() {
-	char protocol[DATA_LENGTH], model[DATA_LENGTH];
-
 	tdInit();
-	int sensorId = 0, dataTypes = 0;
 	time_t now = 0;
-	int sensorStatus;
-
 	time(&now);
-	while(1) {
-		sensorStatus = tdSensor(protocol, DATA_LENGTH, model, DATA_LENGTH, &sensorId, &dataTypes);
-		if (sensorStatus != 0) break;
-
-		printf("type=sensor\tprotocol=%s\tmodel=%s\tid=%d",
-			protocol, model, sensorId);
-
-		time_t timestamp = 0;
-
-		if (dataTypes & TELLSTICK_TEMPERATURE) {
-			char tempvalue[DATA_LENGTH];
-			tdSensorValue(protocol, model, sensorId, TELLSTICK_TEMPERATURE, tempvalue, DATA_LENGTH, (int *)&timestamp);
-			printf("\ttemperature=%s", tempvalue);
-		}
-
-		if (dataTypes & TELLSTICK_HUMIDITY) {
-			char humidityvalue[DATA_LENGTH];
-			tdSensorValue(protocol, model, sensorId, TELLSTICK_HUMIDITY, humidityvalue, DATA_LENGTH, (int *)&timestamp);
-			printf("\thumidity=%s", humidityvalue);
-		}
-
-		if (dataTypes & (TELLSTICK_TEMPERATURE | TELLSTICK_HUMIDITY)) {
-			/* timestamp has been set, print time & age */
-			/* (age is more useful on e.g. embedded systems
-			 * which may not have real-time clock chips =>
-			 * time is useful only as a relative value) */
-			char timeBuf[80];
-			strftime(timeBuf, sizeof(timeBuf), "%Y-%m-%d %H:%M:%S", localtime(&timestamp));
-			printf("\ttime=%s\tage=%d", timeBuf, (int)(now - timestamp));
-		}
-		printf("\n");
-
-	}
-	if(sensorStatus != TELLSTICK_ERROR_DEVICE_NOT_FOUND){
-		char *errorString = tdGetErrorString(sensorStatus);
-		fprintf(stderr, "Error fetching sensors: %s\n", errorString);
-		tdReleaseString(errorString);
-		return sensorStatus;
-	}
+	for_each_sensor(print_kv_sensor, &now);
 	return TELLSTICK_SUCCESS;
 }
 
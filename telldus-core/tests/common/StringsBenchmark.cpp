@@ -0,0 +1,169 @@
+//
+// Measures the string conversions done for every message to and from the
+// service. Compares the functions in Strings.cpp with the previous versions,
+// which opened a new iconv conversion and used a string stream every call.
+//
+#include "Strings.h"
+#include <iconv.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <time.h>
+
+#ifdef _MACOSX
+#define WCHAR_T_ENCODING "UCS-4-INTERNAL"
+#else
+#define WCHAR_T_ENCODING "WCHAR_T"
+#endif
+
+namespace {
+	const int ITERATIONS = 200000;
+
+	std::wstring legacyCharToWstring(const char *value) {
+		size_t utf8Length = strlen(value);
+		size_t outbytesLeft = utf8Length*sizeof(wchar_t);
+		char *inString = new char[utf8Length+1];
+		strcpy(inString, value);
+		char *outString = (char*)new wchar_t[utf8Length+1];
+		memset(outString, 0, sizeof(wchar_t)*(utf8Length+1));
+		char *inPointer = inString;
+		char *outPointer = outString;
+		iconv_t convDesc = iconv_open(WCHAR_T_ENCODING, "UTF-8");
+		iconv(convDesc, &inPointer, &utf8Length, &outPointer, &outbytesLeft);
+		iconv_close(convDesc);
+		std::wstring retval( (wchar_t *)outString );
+		delete[] inString;
+		delete[] outString;
+		return retval;
+	}
+
+	std::string legacyWideToString(const std::wstring &input) {
+		size_t wideSize = sizeof(wchar_t)*input.length();
+		size_t outbytesLeft = wideSize+sizeof(char);
+		char *inString = (char*)new wchar_t[input.length()+1];
+		memcpy(inString, input.c_str(), wideSize+sizeof(wchar_t));
+		char *outString = new char[outbytesLeft];
+		memset(outString, 0, sizeof(char)*(outbytesLeft));
+		char *inPointer = inString;
+		char *outPointer = outString;
+		iconv_t convDesc = iconv_open("UTF-8", WCHAR_T_ENCODING);
+		iconv(convDesc, &inPointer, &wideSize, &outPointer, &outbytesLeft);
+		iconv_close(convDesc);
+		std::string retval(outString);
+		delete[] inString;
+		delete[] outString;
+		return retval;
+	}
+
+	std::wstring legacyIntToWstring(int value) {
+		std::wstringstream st;
+		st << value;
+		return st.str();
+	}
+
+	int legacyWideToInteger(const std::wstring &input) {
+		std::wstringstream inputstream;
+		inputstream << input;
+		int retval;
+		inputstream >> retval;
+		return retval;
+	}
+
+	bool legacyComparei(std::wstring stringA, std::wstring stringB) {
+		transform(stringA.begin(), stringA.end(), stringA.begin(), toupper);
+		transform(stringB.begin(), stringB.end(), stringB.begin(), toupper);
+		return stringA == stringB;
+	}
+
+	void report(const char *name, clock_t legacy, clock_t current) {
+		double legacySeconds = static_cast<double>(legacy) / CLOCKS_PER_SEC;
+		double currentSeconds = static_cast<double>(current) / CLOCKS_PER_SEC;
+		if (currentSeconds <= 0) {
+			currentSeconds = 1.0 / CLOCKS_PER_SEC;
+		}
+		printf("%-14s %10.0f calls/s %10.0f calls/s %6.1fx\n", name, ITERATIONS / legacySeconds, ITERATIONS / currentSeconds, legacySeconds / currentSeconds);
+	}
+}
+
+int main() {
+	//A typical client message, and a device name that is not plain ASCII
+	const char *ascii = "17:tdSensorHistory8:mandolyn12:temperaturehumidityi11si1si1388534400s";
+	const char *utf8 = "K\xc3\xb6ksf\xc3\xb6nster";
+	std::wstring wideAscii = TelldusCore::charToWstring(ascii);
+	std::wstring wideUtf8 = TelldusCore::charToWstring(utf8);
+	size_t sink = 0;
+	clock_t start, legacy;
+
+	printf("%-14s %19s %19s\n", "", "previous", "current");
+
+	start = clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		sink += legacyCharToWstring(ascii).length();
+	}
+	legacy = clock() - start;
+	start = clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		sink += TelldusCore::charToWstring(ascii).length();
+	}
+	report("toWide ascii", legacy, clock() - start);
+
+	start = clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		sink += legacyCharToWstring(utf8).length();
+	}
+	legacy = clock() - start;
+	start = clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		sink += TelldusCore::charToWstring(utf8).length();
+	}
+	report("toWide utf8", legacy, clock() - start);
+
+	start = clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		sink += legacyWideToString(wideAscii).length();
+	}
+	legacy = clock() - start;
+	start = clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		sink += TelldusCore::wideToString(wideAscii).length();
+	}
+	report("toUtf8 ascii", legacy, clock() - start);
+
+	start = clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		sink += legacyWideToString(wideUtf8).length();
+	}
+	legacy = clock() - start;
+	start = clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		sink += TelldusCore::wideToString(wideUtf8).length();
+	}
+	report("toUtf8 utf8", legacy, clock() - start);
+
+	start = clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		sink += legacyWideToInteger(legacyIntToWstring(i - ITERATIONS/2));
+	}
+	legacy = clock() - start;
+	start = clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		sink += TelldusCore::wideToInteger(TelldusCore::intToWstring(i - ITERATIONS/2));
+	}
+	report("integers", legacy, clock() - start);
+
+	start = clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		sink += legacyComparei(L"selflearning-switch", L"SelfLearning-Switch");
+	}
+	legacy = clock() - start;
+	start = clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		sink += TelldusCore::comparei("selflearning-switch", "SelfLearning-Switch");
+	}
+	report("comparei", legacy, clock() - start);
+
+	//Keeps the loops from being optimized away
+	return (sink == 0 ? 1 : 0);
+}
@@ -16,3 +16,52 @@ void StringsTest :: formatfTest (void) {
 	CPPUNIT_ASSERT_EQUAL(std::string("2A"), TelldusCore::formatf("%X", 42));
 	CPPUNIT_ASSERT_EQUAL(std::string("42"), TelldusCore::formatf("%s", "42"));
 }
+
+void StringsTest :: conversionTest (void) {
+	//Plain ASCII takes the fast path
+	CPPUNIT_ASSERT(std::wstring(L"arctech") == TelldusCore::charToWstring("arctech"));
+	CPPUNIT_ASSERT_EQUAL(std::string("arctech"), TelldusCore::wideToString(L"arctech"));
+	CPPUNIT_ASSERT(std::wstring(L"") == TelldusCore::charToWstring(""));
+	CPPUNIT_ASSERT_EQUAL(std::string(""), TelldusCore::wideToString(L""));
+
+	//Mixed with UTF-8, both ways
+	const char *utf8 = "Vardagsrum \xc3\xa5\xc3\xa4\xc3\xb6 \xe2\x82\xac";
+	std::wstring wide = TelldusCore::charToWstring(utf8);
+	CPPUNIT_ASSERT_EQUAL((size_t)16, wide.length());
+	CPPUNIT_ASSERT(wide[11] == 0xE5);
+	CPPUNIT_ASSERT(wide[15] == 0x20AC);
+	CPPUNIT_ASSERT_EQUAL(std::string(utf8), TelldusCore::wideToString(wide));
+
+	//Conversion stops at an invalid sequence
+	CPPUNIT_ASSERT(std::wstring(L"ab") == TelldusCore::charToWstring("ab\xff" "cd"));
+
+	//Again, on the cached conversion
+	CPPUNIT_ASSERT_EQUAL(std::string(utf8), TelldusCore::wideToString(TelldusCore::charToWstring(utf8)));
+}
+
+void StringsTest :: integerTest (void) {
+	CPPUNIT_ASSERT_EQUAL(std::string("0"), TelldusCore::intToString(0));
+	CPPUNIT_ASSERT_EQUAL(std::string("-42"), TelldusCore::intToString(-42));
+	CPPUNIT_ASSERT_EQUAL(std::string("2147483647"), TelldusCore::intToString(2147483647));
+	CPPUNIT_ASSERT_EQUAL(std::string("-2147483648"), TelldusCore::intToString(-2147483647 - 1));
+	CPPUNIT_ASSERT(std::wstring(L"1234") == TelldusCore::intToWstring(1234));
+	CPPUNIT_ASSERT(std::wstring(L"255") == TelldusCore::charUnsignedToWstring(255));
+
+	CPPUNIT_ASSERT_EQUAL(42, TelldusCore::charToInteger("42"));
+	CPPUNIT_ASSERT_EQUAL(-42, TelldusCore::charToInteger(" \t-42"));
+	CPPUNIT_ASSERT_EQUAL(42, TelldusCore::charToInteger("+42;"));
+	CPPUNIT_ASSERT_EQUAL(0, TelldusCore::charToInteger("abc"));
+	CPPUNIT_ASSERT_EQUAL(0, TelldusCore::charToInteger(""));
+	CPPUNIT_ASSERT_EQUAL(-2147483647 - 1, TelldusCore::charToInteger("-2147483648"));
+	CPPUNIT_ASSERT_EQUAL(2147483647, TelldusCore::charToInteger("99999999999"));
+	CPPUNIT_ASSERT_EQUAL(12, TelldusCore::wideToInteger(L"12s"));
+	CPPUNIT_ASSERT_EQUAL(-7, TelldusCore::wideToInteger(L"-7"));
+}
+
+void StringsTest :: compareiTest (void) {
+	CPPUNIT_ASSERT(TelldusCore::comparei("arctech", "ArcTech"));
+	CPPUNIT_ASSERT(TelldusCore::comparei("", ""));
+	CPPUNIT_ASSERT(!TelldusCore::comparei("arctech", "arctec"));
+	CPPUNIT_ASSERT(!TelldusCore::comparei("sartano", "arctech"));
+	CPPUNIT_ASSERT(!TelldusCore::comparei("a[", "A{"));
+}
@@ -8,6 +8,9 @@ class StringsTest : public CPPUNIT_NS :: TestFixture
 {
 	CPPUNIT_TEST_SUITE (StringsTest);
 	CPPUNIT_TEST (formatfTest);
+	CPPUNIT_TEST (conversionTest);
+	CPPUNIT_TEST (integerTest);
+	CPPUNIT_TEST (compareiTest);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -16,6 +19,9 @@ public:
 
 protected:
 	void formatfTest(void);
+	void conversionTest(void);
+	void integerTest(void);
+	void compareiTest(void);
 };
 
 #endif //STRINGSTEST_H
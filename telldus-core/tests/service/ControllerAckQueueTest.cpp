@@ -0,0 +1,67 @@
+#include "ControllerAckQueueTest.h"
+#include "ControllerAckQueue.h"
+#include "../client/telldus-core.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (ControllerAckQueueTest);
+
+void ControllerAckQueueTest :: setUp (void)
+{
+}
+
+void ControllerAckQueueTest :: tearDown (void)
+{
+}
+
+void ControllerAckQueueTest :: inOrderTest (void) {
+	ControllerAckQueue acks;
+	int first = acks.queue(4);
+	int second = acks.queue(4);
+	int third = acks.queue(4);
+	CPPUNIT_ASSERT_MESSAGE("Tickets must be unique", first != second && second != third);
+	CPPUNIT_ASSERT(acks.isWaiting());
+
+	acks.signal(TELLSTICK_SUCCESS);
+	acks.signal(TELLSTICK_SUCCESS);
+	CPPUNIT_ASSERT_EQUAL(TELLSTICK_SUCCESS, acks.wait(second, 0));
+	CPPUNIT_ASSERT_EQUAL(TELLSTICK_SUCCESS, acks.wait(first, 0));
+	CPPUNIT_ASSERT(acks.isWaiting());
+
+	acks.signal(TELLSTICK_SUCCESS);
+	CPPUNIT_ASSERT_EQUAL(TELLSTICK_SUCCESS, acks.wait(third, 0));
+	CPPUNIT_ASSERT(!acks.isWaiting());
+}
+
+void ControllerAckQueueTest :: errorTest (void) {
+	ControllerAckQueue acks;
+	int first = acks.queue(4);
+	int second = acks.queue(4);
+	acks.signal(TELLSTICK_ERROR_BROKEN_PIPE);
+	CPPUNIT_ASSERT(!acks.isWaiting());
+	CPPUNIT_ASSERT_EQUAL(TELLSTICK_ERROR_BROKEN_PIPE, acks.wait(first, 0));
+	CPPUNIT_ASSERT_EQUAL(TELLSTICK_ERROR_BROKEN_PIPE, acks.wait(second, 0));
+}
+
+void ControllerAckQueueTest :: timeoutTest (void) {
+	ControllerAckQueue acks;
+	int first = acks.queue(4);
+	int second = acks.queue(4);
+	CPPUNIT_ASSERT_EQUAL(TELLSTICK_ERROR_COMMUNICATION, acks.wait(first, 10));
+
+	//A late ack can't be told apart from the ack of the second command
+	acks.signal(TELLSTICK_SUCCESS);
+	CPPUNIT_ASSERT_EQUAL(TELLSTICK_ERROR_COMMUNICATION, acks.wait(second, 0));
+	CPPUNIT_ASSERT_EQUAL(TELLSTICK_ERROR_UNKNOWN, acks.wait(second, 0));
+}
+
+void ControllerAckQueueTest :: roomTest (void) {
+	ControllerAckQueue acks;
+	CPPUNIT_ASSERT(acks.waitForRoom(10, 0, 0));
+	int ticket = acks.queue(10);
+	CPPUNIT_ASSERT_MESSAGE("Stop-and-wait must wait for the ack", !acks.waitForRoom(1, 0, 10));
+	CPPUNIT_ASSERT(acks.waitForRoom(10, 20, 10));
+	CPPUNIT_ASSERT(!acks.waitForRoom(11, 20, 10));
+
+	acks.cancel(ticket);
+	CPPUNIT_ASSERT(!acks.isWaiting());
+	CPPUNIT_ASSERT(acks.waitForRoom(1, 0, 0));
+}
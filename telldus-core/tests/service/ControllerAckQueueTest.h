@@ -0,0 +1,27 @@
+#ifndef CONTROLLERACKQUEUETEST_H
+#define CONTROLLERACKQUEUETEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class ControllerAckQueueTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (ControllerAckQueueTest);
+	CPPUNIT_TEST (inOrderTest);
+	CPPUNIT_TEST (errorTest);
+	CPPUNIT_TEST (timeoutTest);
+	CPPUNIT_TEST (roomTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void inOrderTest(void);
+	void errorTest(void);
+	void timeoutTest(void);
+	void roomTest(void);
+};
+
+#endif //CONTROLLERACKQUEUETEST_H
@@ -0,0 +1,104 @@
+//
+// Measures how fast controller input can be split into lines.
+// Compares ControllerLineFramer with the previous character by character parser.
+//
+#include "ControllerLineFramer.h"
+#include <stdio.h>
+#include <string>
+#include <time.h>
+
+namespace {
+	const int ITERATIONS = 20000;
+	const size_t CHUNK_SIZE = 62; //The payload of one FTDI USB packet
+
+	std::string sampleData() {
+		std::string data;
+		for(int i = 0; i < 10; ++i) {
+			data.append("+Wclass:command;protocol:arctech;model:selflearning;data:0x4C9AF29A;\r\n");
+			data.append("+Wclass:sensor;protocol:fineoffset;data:48801AFF05;\r\n");
+			data.append("+W\r\n");
+			data.append("+Rclass:command;protocol:arctech;model:codeswitch;house:A;unit:1;method:turnon;\r\n");
+			data.append("+S\r\n");
+		}
+		return data;
+	}
+
+	int legacyParse(const std::string &data, std::string *message) {
+		int lines = 0;
+		for (unsigned int i = 0; i < data.length(); ++i) {
+			if (data[i] == 13) { // Skip \r
+				continue;
+			} else if (data[i] == 10) { // \n found
+				if (message->substr(0,2).compare("+V") == 0) {
+					++lines;
+				} else if (message->substr(0,2).compare("+R") == 0) {
+					std::string payload = message->substr(2);
+					++lines;
+				} else if(message->substr(0,2).compare("+W") == 0) {
+					std::string payload = message->substr(2);
+					++lines;
+				} else {
+					++lines;
+				}
+				message->clear();
+			} else { // Append the character
+				message->append( 1, data[i] );
+			}
+		}
+		return lines;
+	}
+
+	int framerParse(ControllerLineFramer *framer, const char *data, size_t length) {
+		int lines = 0;
+		const char *line;
+		size_t lineLength;
+		while (length > 0) {
+			size_t consumed = framer->append(data, length);
+			data += consumed;
+			length -= consumed;
+			while (framer->nextLine(&line, &lineLength)) {
+				if (lineLength >= 2 && line[0] == '+' && (line[1] == 'R' || line[1] == 'W')) {
+					std::string payload(line+2, lineLength-2);
+				}
+				++lines;
+			}
+		}
+		return lines;
+	}
+
+	void report(const char *name, clock_t ticks, size_t bytes, int lines) {
+		double seconds = static_cast<double>(ticks) / CLOCKS_PER_SEC;
+		if (seconds <= 0) {
+			seconds = 1.0 / CLOCKS_PER_SEC;
+		}
+		printf("%-10s %8.2f MB/s %12.0f lines/s\n", name, bytes / seconds / (1024*1024), lines / seconds);
+	}
+}
+
+int main() {
+	std::string data = sampleData();
+	size_t bytes = static_cast<size_t>(ITERATIONS) * data.length();
+
+	std::string message;
+	int lines = 0;
+	clock_t start = clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		for (size_t pos = 0; pos < data.length(); pos += CHUNK_SIZE) {
+			lines += legacyParse(data.substr(pos, CHUNK_SIZE), &message);
+		}
+	}
+	report("legacy", clock() - start, bytes, lines);
+
+	ControllerLineFramer framer;
+	lines = 0;
+	start = clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		for (size_t pos = 0; pos < data.length(); pos += CHUNK_SIZE) {
+			size_t length = (data.length() - pos < CHUNK_SIZE ? data.length() - pos : CHUNK_SIZE);
+			lines += framerParse(&framer, data.c_str() + pos, length);
+		}
+	}
+	report("framer", clock() - start, bytes, lines);
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+#include "ControllerLineFramerTest.h"
+#include "ControllerLineFramer.h"
+#include <string>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (ControllerLineFramerTest);
+
+namespace {
+	std::string nextLine(ControllerLineFramer *framer) {
+		const char *line;
+		size_t length;
+		if (!framer->nextLine(&line, &length)) {
+			return "<none>";
+		}
+		return std::string(line, length);
+	}
+
+	size_t append(ControllerLineFramer *framer, const std::string &data) {
+		return framer->append(data.c_str(), data.length());
+	}
+}
+
+void ControllerLineFramerTest :: setUp (void)
+{
+}
+
+void ControllerLineFramerTest :: tearDown (void)
+{
+}
+
+void ControllerLineFramerTest :: splitLinesTest (void) {
+	ControllerLineFramer framer;
+	CPPUNIT_ASSERT_EQUAL((size_t)18, append(&framer, "+V2\r\n+S\r\n+Wdata;\r\n"));
+	CPPUNIT_ASSERT_EQUAL(std::string("+V2"), nextLine(&framer));
+	CPPUNIT_ASSERT_EQUAL(std::string("+S"), nextLine(&framer));
+	CPPUNIT_ASSERT_EQUAL(std::string("+Wdata;"), nextLine(&framer));
+	CPPUNIT_ASSERT_EQUAL(std::string("<none>"), nextLine(&framer));
+}
+
+void ControllerLineFramerTest :: partialLineTest (void) {
+	ControllerLineFramer framer;
+	append(&framer, "+Wclass:command;");
+	CPPUNIT_ASSERT_EQUAL(std::string("<none>"), nextLine(&framer));
+	append(&framer, "protocol:arctech;\r");
+	CPPUNIT_ASSERT_EQUAL(std::string("<none>"), nextLine(&framer));
+	append(&framer, "\n+S");
+	CPPUNIT_ASSERT_EQUAL(std::string("+Wclass:command;protocol:arctech;"), nextLine(&framer));
+	CPPUNIT_ASSERT_EQUAL(std::string("<none>"), nextLine(&framer));
+	append(&framer, "\r\n");
+	CPPUNIT_ASSERT_EQUAL(std::string("+S"), nextLine(&framer));
+}
+
+void ControllerLineFramerTest :: embeddedNulTest (void) {
+	ControllerLineFramer framer;
+	append(&framer, std::string("+R\0x\r\n+V3\r\n", 11));
+	CPPUNIT_ASSERT_EQUAL(std::string("+R\0x", 4), nextLine(&framer));
+	CPPUNIT_ASSERT_EQUAL(std::string("+V3"), nextLine(&framer));
+}
+
+void ControllerLineFramerTest :: overflowTest (void) {
+	ControllerLineFramer framer(8);
+	append(&framer, "+S\r\n");
+	//The buffer is full with a complete line still waiting
+	CPPUNIT_ASSERT_EQUAL((size_t)4, append(&framer, "+W0123456789"));
+	CPPUNIT_ASSERT_EQUAL((size_t)0, append(&framer, "456789"));
+	CPPUNIT_ASSERT_EQUAL(std::string("+S"), nextLine(&framer));
+	CPPUNIT_ASSERT_EQUAL((size_t)4, append(&framer, "4567"));
+	CPPUNIT_ASSERT_EQUAL(std::string("<none>"), nextLine(&framer));
+	//The line is longer than the buffer and must be dropped
+	CPPUNIT_ASSERT_EQUAL((size_t)8, append(&framer, "89\r\n+V2\r\n"));
+	CPPUNIT_ASSERT_EQUAL(std::string("<none>"), nextLine(&framer));
+	CPPUNIT_ASSERT_EQUAL(1, framer.droppedLines());
+	append(&framer, "\n");
+	CPPUNIT_ASSERT_EQUAL(std::string("+V2"), nextLine(&framer));
+}
+
+void ControllerLineFramerTest :: overflowCountedOnceTest (void) {
+	ControllerLineFramer framer(8);
+	//One line filling the buffer three times over
+	for (int i = 0; i < 3; ++i) {
+		CPPUNIT_ASSERT_EQUAL((size_t)8, append(&framer, "01234567"));
+		CPPUNIT_ASSERT_EQUAL(std::string("<none>"), nextLine(&framer));
+	}
+	CPPUNIT_ASSERT_EQUAL(0, framer.droppedLines());
+	append(&framer, "89\r\n+S\r\n");
+	CPPUNIT_ASSERT_EQUAL(std::string("+S"), nextLine(&framer));
+	CPPUNIT_ASSERT_EQUAL(1, framer.droppedLines());
+}
@@ -0,0 +1,29 @@
+#ifndef CONTROLLERLINEFRAMERTEST_H
+#define CONTROLLERLINEFRAMERTEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class ControllerLineFramerTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (ControllerLineFramerTest);
+	CPPUNIT_TEST (splitLinesTest);
+	CPPUNIT_TEST (partialLineTest);
+	CPPUNIT_TEST (embeddedNulTest);
+	CPPUNIT_TEST (overflowTest);
+	CPPUNIT_TEST (overflowCountedOnceTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void splitLinesTest(void);
+	void partialLineTest(void);
+	void embeddedNulTest(void);
+	void overflowTest(void);
+	void overflowCountedOnceTest(void);
+};
+
+#endif //CONTROLLERLINEFRAMERTEST_H
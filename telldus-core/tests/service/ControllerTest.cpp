@@ -0,0 +1,76 @@
+#include "ControllerTest.h"
+#include "Controller.h"
+#include "../client/telldus-core.h"
+
+#include <string>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (ControllerTest);
+
+namespace {
+	//Logs what it's asked to do, acks with the result set for the command
+	class FakeController : public Controller {
+	public:
+		FakeController()
+			:Controller(1, TelldusCore::EventRef(), TelldusCore::EventRef()), nextTicket(1) {
+		}
+		virtual int reset() {
+			return TELLSTICK_SUCCESS;
+		}
+		std::string log;
+		int nextTicket;
+	protected:
+		virtual int doStartSend( const std::string &message, int *ticket ) {
+			log += "start " + message + ";";
+			if (message == "bad") {
+				return TELLSTICK_ERROR_BROKEN_PIPE;
+			}
+			*ticket = nextTicket++;
+			return TELLSTICK_SUCCESS;
+		}
+		virtual int doFinishSend( int ticket ) {
+			log += "finish " + std::string(1, '0'+ticket) + ";";
+			return (ticket == 2 ? TELLSTICK_ERROR_COMMUNICATION : TELLSTICK_SUCCESS);
+		}
+	};
+}
+
+void ControllerTest :: setUp (void)
+{
+}
+
+void ControllerTest :: tearDown (void)
+{
+}
+
+void ControllerTest :: sendTest (void) {
+	FakeController controller;
+	CPPUNIT_ASSERT_EQUAL(TELLSTICK_SUCCESS, controller.send("a"));
+	CPPUNIT_ASSERT_EQUAL(std::string("start a;finish 1;"), controller.log);
+	CPPUNIT_ASSERT_EQUAL(0, controller.queueDepth());
+}
+
+void ControllerTest :: pipelineTest (void) {
+	FakeController controller;
+	Controller::PendingSend first, second, third;
+	controller.startSend("a", &first);
+	controller.startSend("b", &second);
+	controller.startSend("c", &third);
+	CPPUNIT_ASSERT_EQUAL_MESSAGE("Nothing is waited for while starting", std::string("start a;start b;start c;"), controller.log);
+	CPPUNIT_ASSERT_EQUAL(3, controller.queueDepth());
+
+	CPPUNIT_ASSERT_EQUAL(TELLSTICK_SUCCESS, controller.finishSend(&first));
+	CPPUNIT_ASSERT_EQUAL(TELLSTICK_ERROR_COMMUNICATION, controller.finishSend(&second));
+	CPPUNIT_ASSERT_EQUAL(TELLSTICK_SUCCESS, controller.finishSend(&third));
+	CPPUNIT_ASSERT_EQUAL(std::string("start a;start b;start c;finish 1;finish 2;finish 3;"), controller.log);
+	CPPUNIT_ASSERT_EQUAL(0, controller.queueDepth());
+	CPPUNIT_ASSERT(controller.errorRate() > 0);
+}
+
+void ControllerTest :: failedStartTest (void) {
+	FakeController controller;
+	Controller::PendingSend pending;
+	controller.startSend("bad", &pending);
+	CPPUNIT_ASSERT_EQUAL(TELLSTICK_ERROR_BROKEN_PIPE, controller.finishSend(&pending));
+	CPPUNIT_ASSERT_EQUAL_MESSAGE("There is no ack to wait for", std::string("start bad;"), controller.log);
+	CPPUNIT_ASSERT_EQUAL(0, controller.queueDepth());
+}
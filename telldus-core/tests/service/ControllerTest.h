@@ -0,0 +1,25 @@
+#ifndef CONTROLLERTEST_H
+#define CONTROLLERTEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class ControllerTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (ControllerTest);
+	CPPUNIT_TEST (sendTest);
+	CPPUNIT_TEST (pipelineTest);
+	CPPUNIT_TEST (failedStartTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void sendTest(void);
+	void pipelineTest(void);
+	void failedStartTest(void);
+};
+
+#endif //CONTROLLERTEST_H
@@ -0,0 +1,139 @@
+#include "LogBufferTest.h"
+#include "LogBuffer.h"
+#include "Thread.h"
+#include "common.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (LogBufferTest);
+
+namespace {
+	bool push(LogBuffer *buffer, int level, const char *format, ...) {
+		va_list ap;
+		va_start(ap, format);
+		bool retval = buffer->push(level, format, ap);
+		va_end(ap);
+		return retval;
+	}
+
+	const int PRODUCERS = 4;
+	const int MESSAGES = 5000;
+
+	class Producer : public TelldusCore::Thread {
+	public:
+		Producer(LogBuffer *b, int i) : buffer(b), id(i) {}
+		~Producer() {
+			wait();
+		}
+
+	protected:
+		void run() {
+			for (int i = 0; i < MESSAGES; ++i) {
+				while (!push(buffer, id, "%d", i)) {
+					//Full, let the consumer catch up
+					msleep(1);
+				}
+			}
+		}
+
+	private:
+		LogBuffer *buffer;
+		int id;
+	};
+}
+
+void LogBufferTest :: setUp (void)
+{
+}
+
+void LogBufferTest :: tearDown (void)
+{
+}
+
+void LogBufferTest :: orderTest (void) {
+	LogBuffer buffer(5);
+	CPPUNIT_ASSERT_EQUAL((size_t)8, buffer.capacity());
+
+	LogBuffer::Entry entry;
+	CPPUNIT_ASSERT(!buffer.pop(&entry));
+	//Several rounds, so the positions wrap around the slots
+	for (int round = 0; round < 3; ++round) {
+		for (int i = 0; i < 6; ++i) {
+			CPPUNIT_ASSERT(push(&buffer, i % 4, "message %d", i));
+		}
+		for (int i = 0; i < 6; ++i) {
+			CPPUNIT_ASSERT(buffer.pop(&entry));
+			CPPUNIT_ASSERT_EQUAL(i % 4, entry.level);
+			char expected[16];
+			sprintf(expected, "message %d", i);
+			CPPUNIT_ASSERT_EQUAL(std::string(expected), std::string(entry.message));
+		}
+		CPPUNIT_ASSERT(!buffer.pop(&entry));
+	}
+	CPPUNIT_ASSERT_EQUAL(0L, buffer.takeDropped());
+}
+
+void LogBufferTest :: fullTest (void) {
+	LogBuffer buffer(4);
+	for (int i = 0; i < 4; ++i) {
+		CPPUNIT_ASSERT(push(&buffer, 0, "%d", i));
+	}
+	CPPUNIT_ASSERT(!push(&buffer, 0, "%d", 4));
+	CPPUNIT_ASSERT(!push(&buffer, 0, "%d", 5));
+	CPPUNIT_ASSERT_EQUAL(2L, buffer.takeDropped());
+	CPPUNIT_ASSERT_EQUAL(0L, buffer.takeDropped());
+
+	//Room again once one is popped
+	LogBuffer::Entry entry;
+	CPPUNIT_ASSERT(buffer.pop(&entry));
+	CPPUNIT_ASSERT_EQUAL(std::string("0"), std::string(entry.message));
+	CPPUNIT_ASSERT(push(&buffer, 0, "%d", 6));
+	for (int i = 1; i < 4; ++i) {
+		CPPUNIT_ASSERT(buffer.pop(&entry));
+	}
+	CPPUNIT_ASSERT(buffer.pop(&entry));
+	CPPUNIT_ASSERT_EQUAL(std::string("6"), std::string(entry.message));
+}
+
+void LogBufferTest :: truncateTest (void) {
+	LogBuffer buffer(2);
+	std::string longMessage(LogBuffer::MESSAGE_SIZE * 2, 'x');
+	CPPUNIT_ASSERT(push(&buffer, 0, "%s", longMessage.c_str()));
+
+	LogBuffer::Entry entry;
+	CPPUNIT_ASSERT(buffer.pop(&entry));
+	CPPUNIT_ASSERT_EQUAL((size_t)LogBuffer::MESSAGE_SIZE - 1, strlen(entry.message));
+}
+
+void LogBufferTest :: concurrentPushTest (void) {
+	LogBuffer buffer(64);
+	std::vector<Producer *> producers;
+	for (int i = 0; i < PRODUCERS; ++i) {
+		producers.push_back(new Producer(&buffer, i));
+		producers.back()->start();
+	}
+
+	//Every message arrives once, in the order of its producer
+	std::vector<int> next(PRODUCERS, 0);
+	int received = 0;
+	LogBuffer::Entry entry;
+	while (received < PRODUCERS*MESSAGES) {
+		if (!buffer.pop(&entry)) {
+			msleep(1);
+			continue;
+		}
+		CPPUNIT_ASSERT(entry.level >= 0 && entry.level < PRODUCERS);
+		char expected[16];
+		sprintf(expected, "%d", next[entry.level]);
+		CPPUNIT_ASSERT_EQUAL(std::string(expected), std::string(entry.message));
+		++next[entry.level];
+		++received;
+	}
+	CPPUNIT_ASSERT(!buffer.pop(&entry));
+
+	for (int i = 0; i < PRODUCERS; ++i) {
+		delete producers[i];
+	}
+}
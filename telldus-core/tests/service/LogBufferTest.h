@@ -0,0 +1,27 @@
+#ifndef LOGBUFFERTEST_H
+#define LOGBUFFERTEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class LogBufferTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (LogBufferTest);
+	CPPUNIT_TEST (orderTest);
+	CPPUNIT_TEST (fullTest);
+	CPPUNIT_TEST (truncateTest);
+	CPPUNIT_TEST (concurrentPushTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void orderTest(void);
+	void fullTest(void);
+	void truncateTest(void);
+	void concurrentPushTest(void);
+};
+
+#endif //LOGBUFFERTEST_H
@@ -0,0 +1,97 @@
+#include "LogRateLimiterTest.h"
+#include "LogRateLimiter.h"
+#include <stdio.h>
+#include <string>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (LogRateLimiterTest);
+
+namespace {
+	const time_t START = 1350000000;
+	const char *SITE_A = "Weird send length %i";
+	const char *SITE_B = "Broken pipe";
+}
+
+void LogRateLimiterTest :: setUp (void)
+{
+}
+
+void LogRateLimiterTest :: tearDown (void)
+{
+}
+
+void LogRateLimiterTest :: burstTest (void) {
+	LogRateLimiter limiter(3, 10);
+	for (int i = 0; i < 3; ++i) {
+		CPPUNIT_ASSERT(limiter.allow(SITE_A, 2, START));
+	}
+	CPPUNIT_ASSERT(!limiter.allow(SITE_A, 2, START));
+	CPPUNIT_ASSERT(!limiter.allow(SITE_A, 2, START + 1));
+
+	std::vector<LogRateLimiter::Suppressed> suppressed;
+	limiter.takeSuppressed(&suppressed);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, suppressed.size());
+	CPPUNIT_ASSERT_EQUAL(std::string(SITE_A), std::string(suppressed[0].format));
+	CPPUNIT_ASSERT_EQUAL(2, suppressed[0].level);
+	CPPUNIT_ASSERT_EQUAL(2L, suppressed[0].count);
+
+	//Taken, nothing more to report
+	suppressed.clear();
+	limiter.takeSuppressed(&suppressed);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, suppressed.size());
+}
+
+void LogRateLimiterTest :: windowTest (void) {
+	//Windows are aligned to the interval
+	time_t start = START - START % 10;
+	LogRateLimiter limiter(2, 10);
+	CPPUNIT_ASSERT(limiter.allow(SITE_A, 0, start));
+	CPPUNIT_ASSERT(limiter.allow(SITE_A, 0, start + 5));
+	CPPUNIT_ASSERT(!limiter.allow(SITE_A, 0, start + 9));
+
+	CPPUNIT_ASSERT(limiter.allow(SITE_A, 0, start + 10));
+	CPPUNIT_ASSERT(limiter.allow(SITE_A, 0, start + 19));
+	CPPUNIT_ASSERT(!limiter.allow(SITE_A, 0, start + 19));
+
+	//A jump back in time starts over as well
+	CPPUNIT_ASSERT(limiter.allow(SITE_A, 0, start));
+
+	std::vector<LogRateLimiter::Suppressed> suppressed;
+	limiter.takeSuppressed(&suppressed);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, suppressed.size());
+	CPPUNIT_ASSERT_EQUAL(2L, suppressed[0].count);
+}
+
+void LogRateLimiterTest :: sitesTest (void) {
+	LogRateLimiter limiter(1, 10);
+	CPPUNIT_ASSERT(limiter.allow(SITE_A, 3, START));
+	CPPUNIT_ASSERT(limiter.allow(SITE_B, 1, START));
+	CPPUNIT_ASSERT(!limiter.allow(SITE_A, 3, START));
+	CPPUNIT_ASSERT(!limiter.allow(SITE_B, 1, START));
+	CPPUNIT_ASSERT(!limiter.allow(SITE_B, 1, START));
+
+	std::vector<LogRateLimiter::Suppressed> suppressed;
+	limiter.takeSuppressed(&suppressed);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, suppressed.size());
+	long total = 0;
+	for (size_t i = 0; i < suppressed.size(); ++i) {
+		if (suppressed[i].format == SITE_B) {
+			CPPUNIT_ASSERT_EQUAL(1, suppressed[i].level);
+			CPPUNIT_ASSERT_EQUAL(2L, suppressed[i].count);
+		}
+		total += suppressed[i].count;
+	}
+	CPPUNIT_ASSERT_EQUAL(3L, total);
+
+	//More sites than there is room for are let through
+	char formats[200][8];
+	for (int i = 0; i < 200; ++i) {
+		sprintf(formats[i], "%d", i);
+		CPPUNIT_ASSERT(limiter.allow(formats[i], 0, START));
+	}
+	for (int i = 0; i < 200; ++i) {
+		limiter.allow(formats[i], 0, START);
+	}
+	suppressed.clear();
+	limiter.takeSuppressed(&suppressed);
+	CPPUNIT_ASSERT(suppressed.size() < 200);
+}
@@ -0,0 +1,25 @@
+#ifndef LOGRATELIMITERTEST_H
+#define LOGRATELIMITERTEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class LogRateLimiterTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (LogRateLimiterTest);
+	CPPUNIT_TEST (burstTest);
+	CPPUNIT_TEST (windowTest);
+	CPPUNIT_TEST (sitesTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void burstTest(void);
+	void windowTest(void);
+	void sitesTest(void);
+};
+
+#endif //LOGRATELIMITERTEST_H
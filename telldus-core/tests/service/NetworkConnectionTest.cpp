@@ -0,0 +1,182 @@
+#include "NetworkConnectionTest.h"
+#include "NetworkConnection.h"
+#include "Thread.h"
+
+#include <string>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (NetworkConnectionTest);
+
+namespace {
+	//A serial to TCP bridge stub, listening on a free port on the loopback interface
+	int listenOnLoopback(int *port) {
+		int s = socket(AF_INET, SOCK_STREAM, 0);
+		struct sockaddr_in address;
+		memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = 0;
+		bind(s, reinterpret_cast<struct sockaddr *>(&address), sizeof(address));
+		listen(s, 1);
+		socklen_t length = sizeof(address);
+		getsockname(s, reinterpret_cast<struct sockaddr *>(&address), &length);
+		*port = ntohs(address.sin_port);
+		return s;
+	}
+
+	std::string readAll(int s, size_t length) {
+		std::string retval;
+		char buf[64];
+		while (retval.length() < length) {
+			int ret = recv(s, buf, sizeof(buf), 0);
+			if (ret <= 0) {
+				break;
+			}
+			retval.append(buf, ret);
+		}
+		return retval;
+	}
+
+	//Writes to a bridge that never reads, until the write fails
+	class StalledWriter : public TelldusCore::Thread {
+	public:
+		StalledWriter(NetworkConnection *connection, int timeout)
+			:connection(connection), timeout(timeout), writes(0) {
+		}
+		NetworkConnection *connection;
+		int timeout, writes;
+	protected:
+		void run() {
+			std::string chunk(65536, 'S');
+			while (writes < 1000 && connection->write(chunk.c_str(), chunk.length(), timeout)) {
+				++writes;
+			}
+		}
+	};
+}
+
+void NetworkConnectionTest :: setUp (void)
+{
+	listener = listenOnLoopback(&port);
+}
+
+void NetworkConnectionTest :: tearDown (void)
+{
+	if (listener >= 0) {
+		close(listener);
+	}
+}
+
+void NetworkConnectionTest :: parseAddressTest (void) {
+	std::string host;
+	int port = 0;
+	CPPUNIT_ASSERT(NetworkConnection::parseAddress("192.168.0.10:4001", &host, &port));
+	CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.10"), host);
+	CPPUNIT_ASSERT_EQUAL(4001, port);
+	CPPUNIT_ASSERT(NetworkConnection::parseAddress("bridge.local:23", &host, &port));
+	CPPUNIT_ASSERT_EQUAL(std::string("bridge.local"), host);
+	CPPUNIT_ASSERT(!NetworkConnection::parseAddress("bridge.local", &host, &port));
+	CPPUNIT_ASSERT(!NetworkConnection::parseAddress(":4001", &host, &port));
+	CPPUNIT_ASSERT(!NetworkConnection::parseAddress("bridge.local:", &host, &port));
+	CPPUNIT_ASSERT(!NetworkConnection::parseAddress("bridge.local:70000", &host, &port));
+}
+
+void NetworkConnectionTest :: exchangeTest (void) {
+	NetworkConnection connection;
+	CPPUNIT_ASSERT(connection.connect("127.0.0.1", port, 1000));
+	CPPUNIT_ASSERT(connection.isConnected());
+	int stub = accept(listener, NULL, NULL);
+	CPPUNIT_ASSERT(stub >= 0);
+
+	//A command goes out and the stub acks it like a TellStick would
+	std::string command = "S$k$k$kk$$kk$$k+";
+	CPPUNIT_ASSERT(connection.write(command.c_str(), command.length(), 1000));
+	CPPUNIT_ASSERT_EQUAL(command, readAll(stub, command.length()));
+	send(stub, "+S\r\n", 4, 0);
+
+	char buf[16];
+	int ret = connection.read(buf, sizeof(buf), 1000);
+	CPPUNIT_ASSERT_EQUAL(std::string("+S\r\n"), std::string(buf, ret > 0 ? ret : 0));
+
+	close(stub);
+}
+
+void NetworkConnectionTest :: readTimeoutTest (void) {
+	NetworkConnection connection;
+	CPPUNIT_ASSERT(connection.connect("127.0.0.1", port, 1000));
+	int stub = accept(listener, NULL, NULL);
+
+	char buf[16];
+	CPPUNIT_ASSERT_EQUAL(0, connection.read(buf, sizeof(buf), 50));
+	CPPUNIT_ASSERT(connection.isConnected());
+
+	close(stub);
+}
+
+void NetworkConnectionTest :: remoteCloseTest (void) {
+	NetworkConnection connection;
+	CPPUNIT_ASSERT(connection.connect("127.0.0.1", port, 1000));
+	int stub = accept(listener, NULL, NULL);
+	close(stub);
+
+	char buf[16];
+	CPPUNIT_ASSERT_EQUAL(-1, connection.read(buf, sizeof(buf), 1000));
+	connection.close();
+	CPPUNIT_ASSERT(!connection.isConnected());
+	CPPUNIT_ASSERT(!connection.write("N+", 2, 1000));
+
+	//The bridge is back, so should we be
+	CPPUNIT_ASSERT(connection.connect("127.0.0.1", port, 1000));
+	stub = accept(listener, NULL, NULL);
+	CPPUNIT_ASSERT(connection.write("N+", 2, 1000));
+	CPPUNIT_ASSERT_EQUAL(std::string("N+"), readAll(stub, 2));
+	close(stub);
+}
+
+void NetworkConnectionTest :: connectRefusedTest (void) {
+	close(listener);
+	listener = -1;
+
+	NetworkConnection connection;
+	CPPUNIT_ASSERT(!connection.connect("127.0.0.1", port, 1000));
+	CPPUNIT_ASSERT(!connection.isConnected());
+}
+
+void NetworkConnectionTest :: writeTimeoutTest (void) {
+	NetworkConnection connection;
+	CPPUNIT_ASSERT(connection.connect("127.0.0.1", port, 1000));
+	int stub = accept(listener, NULL, NULL);
+
+	//Once the socket buffers are full the write must give up instead of blocking
+	StalledWriter writer(&connection, 50);
+	writer.start();
+	writer.wait();
+	CPPUNIT_ASSERT(writer.writes < 1000);
+	CPPUNIT_ASSERT(connection.isConnected());
+
+	close(stub);
+}
+
+void NetworkConnectionTest :: closeWhileWritingTest (void) {
+	NetworkConnection connection;
+	CPPUNIT_ASSERT(connection.connect("127.0.0.1", port, 1000));
+	int stub = accept(listener, NULL, NULL);
+
+	StalledWriter writer(&connection, 10000);
+	time_t start = time(NULL);
+	writer.start();
+	usleep(200000);
+	//Neither close() nor the stalled write may wait for the write timeout
+	connection.close();
+	CPPUNIT_ASSERT(!connection.isConnected());
+	writer.wait();
+	CPPUNIT_ASSERT(time(NULL) - start < 5);
+	CPPUNIT_ASSERT(writer.writes < 1000);
+
+	close(stub);
+}
@@ -0,0 +1,36 @@
+#ifndef NETWORKCONNECTIONTEST_H
+#define NETWORKCONNECTIONTEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class NetworkConnectionTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (NetworkConnectionTest);
+	CPPUNIT_TEST (parseAddressTest);
+	CPPUNIT_TEST (exchangeTest);
+	CPPUNIT_TEST (readTimeoutTest);
+	CPPUNIT_TEST (remoteCloseTest);
+	CPPUNIT_TEST (connectRefusedTest);
+	CPPUNIT_TEST (writeTimeoutTest);
+	CPPUNIT_TEST (closeWhileWritingTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void parseAddressTest(void);
+	void exchangeTest(void);
+	void readTimeoutTest(void);
+	void remoteCloseTest(void);
+	void connectRefusedTest(void);
+	void writeTimeoutTest(void);
+	void closeWhileWritingTest(void);
+
+private:
+	int listener, port;
+};
+
+#endif //NETWORKCONNECTIONTEST_H
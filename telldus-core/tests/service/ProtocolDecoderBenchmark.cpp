@@ -0,0 +1,72 @@
+//
+// Measures how fast received frames are decoded, for each protocol.
+// Replays a corpus of "+W" lines, one per line, given as the first argument.
+//
+#include "ControllerMessage.h"
+#include "Protocol.h"
+#include "SensorRecord.h"
+#include <fstream>
+#include <map>
+#include <stdio.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+#ifndef DECODER_CORPUS
+#define DECODER_CORPUS "DecoderCorpus.txt"
+#endif
+
+namespace {
+	const int ITERATIONS = 20000;
+
+	typedef std::map<std::string, std::vector<std::string> > FrameMap;
+
+	int decode(const std::string &frame) {
+		ControllerMessage msg(frame);
+		SensorRecord record;
+		if (Protocol::decodeSensorData(msg, &record)) {
+			return 1;
+		}
+		return (Protocol::decodeData(msg).size() > 0 ? 1 : 0);
+	}
+
+	void report(const std::string &name, clock_t ticks, size_t frames, int decoded) {
+		double seconds = static_cast<double>(ticks) / CLOCKS_PER_SEC;
+		if (seconds <= 0) {
+			seconds = 1.0 / CLOCKS_PER_SEC;
+		}
+		printf("%-14s %12.0f frames/s %6.1f%% decoded\n", name.c_str(), frames / seconds, 100.0 * decoded / frames);
+	}
+}
+
+int main(int argc, char **argv) {
+	std::ifstream corpus(argc > 1 ? argv[1] : DECODER_CORPUS);
+	if (!corpus) {
+		fprintf(stderr, "Could not open the corpus %s\n", (argc > 1 ? argv[1] : DECODER_CORPUS));
+		return 1;
+	}
+
+	FrameMap frames;
+	std::string line;
+	while (std::getline(corpus, line)) {
+		if (line.length() < 2 || line.compare(0, 2, "+W") != 0) {
+			continue;
+		}
+		std::string frame = line.substr(2);
+		std::string protocol = ControllerMessage(frame).protocol();
+		frames[protocol.length() ? protocol : "(none)"].push_back(frame);
+	}
+
+	for (FrameMap::const_iterator it = frames.begin(); it != frames.end(); ++it) {
+		int decoded = 0;
+		clock_t start = clock();
+		for (int i = 0; i < ITERATIONS; ++i) {
+			for (size_t j = 0; j < it->second.size(); ++j) {
+				decoded += decode(it->second[j]);
+			}
+		}
+		report(it->first, clock() - start, static_cast<size_t>(ITERATIONS) * it->second.size(), decoded);
+	}
+
+	return 0;
+}
@@ -0,0 +1,25 @@
+//
+// libFuzzer entry point for the protocol decoders.
+// Every input is handled as a "+W" line from a controller, the "+W" itself
+// is optional. Seed it with the lines in DecoderCorpus.txt, one file per line.
+//
+#include "ControllerMessage.h"
+#include "Protocol.h"
+#include "SensorRecord.h"
+#include <stdint.h>
+#include <string>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+	std::string frame(reinterpret_cast<const char *>(data), size);
+	if (frame.compare(0, 2, "+W") == 0) {
+		frame = frame.substr(2);
+	}
+	ControllerMessage msg(frame);
+	SensorRecord record;
+	if (Protocol::decodeSensorData(msg, &record)) {
+		record.toString();
+		return 0;
+	}
+	Protocol::decodeData(msg);
+	return 0;
+}
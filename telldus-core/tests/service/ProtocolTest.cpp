@@ -0,0 +1,317 @@
+#include "ProtocolTest.h"
+#include "Protocol.h"
+#include "ControllerMessage.h"
+#include "SensorRecord.h"
+#include "PulseTrain.h"
+
+#include <stdio.h>
+#include <string.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (ProtocolTest);
+
+namespace {
+	//Packets produced by each protocol and model, in hex. Any change to these
+	//changes what is sent on air.
+	const struct {
+		const char *protocol, *model, *parameters;
+		int method;
+		unsigned char level;
+		const char *packet;
+	} goldenPackets[] = {
+		{"arctech", "codeswitch", "house:A;unit:1", TELLSTICK_TURNON, 0,
+			"53246B246B246B246B246B246B246B246B246B246B246B246B246B246B246B246B246B246B246B6B24246B6B24246B6B24246B2B"},
+		{"arctech", "codeswitch", "house:A;unit:1", TELLSTICK_TURNOFF, 0,
+			"53246B246B246B246B246B246B246B246B246B246B246B246B246B246B246B246B246B246B246B6B24246B6B24246B246B246B2B"},
+		{"arctech", "codeswitch", "house:P;unit:16", TELLSTICK_TURNON, 0,
+			"53246B6B24246B6B24246B6B24246B6B24246B6B24246B6B24246B6B24246B6B24246B246B246B6B24246B6B24246B6B24246B2B"},
+		{"arctech", "codeswitch", "house:P;unit:16", TELLSTICK_TURNOFF, 0,
+			"53246B6B24246B6B24246B6B24246B6B24246B6B24246B6B24246B6B24246B6B24246B246B246B6B24246B6B24246B246B246B2B"},
+		{"arctech", "codeswitch", "house:F;unit:9", TELLSTICK_DIM, 128,
+			""},
+		{"arctech", "bell", "house:C", TELLSTICK_BELL, 0,
+			"53246B246B246B6B24246B246B246B246B246B6B24246B6B24246B6B24246B246B246B6B24246B6B24246B6B24246B6B24246B2B"},
+		{"arctech", "selflearning-switch", "house:1;unit:1", TELLSTICK_TURNON, 0,
+			"547FFF1801849A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A88AA88AA8A8A8A8A2B"},
+		{"arctech", "selflearning-switch", "house:1;unit:1", TELLSTICK_TURNOFF, 0,
+			"547FFF1801849A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A88AA8A8A8A8A8A8A2B"},
+		{"arctech", "selflearning-switch", "house:67108863;unit:16", TELLSTICK_TURNON, 0,
+			"547FFF18018498A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8AA88A8A8A8A8AA2B"},
+		{"arctech", "selflearning-switch", "house:12345678;unit:7", TELLSTICK_LEARN, 0,
+			"547FFF1801849A8A88AA88A8A8A8AA8A8A88A8AA8A8A8A88AA88AA8A88A8A8AA8A88AA88A8AA8A2B"},
+		{"arctech", "selflearning-dimmer", "house:2345;unit:3", TELLSTICK_TURNON, 0,
+			"547FFF1801939A8A8A8A8A8A8A8A8A8A8A8A8A8A88AA8A88AA8A88AA88AA8A88AA8AAA8A88AA88A8A8A8AA2B"},
+		{"arctech", "selflearning-dimmer", "house:2345;unit:3", TELLSTICK_TURNOFF, 0,
+			"547FFF1801849A8A8A8A8A8A8A8A8A8A8A8A8A8A88AA8A88AA8A88AA88AA8A88AA8A8A8A88AA8A2B"},
+		{"arctech", "selflearning-dimmer", "house:2345;unit:3", TELLSTICK_DIM, 128,
+			"547FFF1801939A8A8A8A8A8A8A8A8A8A8A8A8A8A88AA8A88AA8A88AA88AA8A88AA8AAA8A88AA88AA8A8A8A2B"},
+		{"arctech", "selflearning-dimmer", "house:2345;unit:3", TELLSTICK_DIM, 15,
+			"547FFF1801939A8A8A8A8A8A8A8A8A8A8A8A8A8A88AA8A88AA8A88AA88AA8A88AA8AAA8A88AA8A8A8A8A8A2B"},
+		{"arctech", "selflearning-dimmer:nexa", "house:2345;unit:3", TELLSTICK_DIM, 255,
+			"547FFF1801939A8A8A8A8A8A8A8A8A8A8A8A8A8A88AA8A88AA8A88AA88AA8A88AA8AAA8A88AA88A8A8A8AA2B"},
+		{"brateck", "", "house:01-01-01", TELLSTICK_UP, 0,
+			"53562156212156215621565621562156212156215621565621562156212156215656215621215621562156215621562156212B"},
+		{"brateck", "", "house:01-01-01", TELLSTICK_DOWN, 0,
+			"53562156212156215621565621562156212156215621565621562156212156215621562156215621562156215656215621212B"},
+		{"brateck", "", "house:11110000", TELLSTICK_STOP, 0,
+			"53215621562156215621562156215621565621562156215621562156215621562121562156562156212156215621562156212B"},
+		{"brateck", "", "house:11110000", TELLSTICK_TURNON, 0,
+			""},
+		{"comen", "", "house:12345;unit:3", TELLSTICK_TURNON, 0,
+			"547FFF1801849A8A8A8A8A8A8A8A8A8A8A88A8AA8A8A8A8A8A88A8A8AA8A88AA8A88AA8A88AA8A2B"},
+		{"comen", "", "house:33554431;unit:16", TELLSTICK_TURNOFF, 0,
+			"547FFF18018498A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8A8AA8A8A88A8A8A8AA2B"},
+		{"everflourish", "", "house:0;unit:1", TELLSTICK_TURNON, 0,
+			"520554723C0101695555545454545454545454545454545454545445544545454545552B"},
+		{"everflourish", "", "house:0;unit:1", TELLSTICK_TURNOFF, 0,
+			"520554723C0101695555545454545454545454545454545454545445544554545454552B"},
+		{"everflourish", "", "house:16383;unit:4", TELLSTICK_LEARN, 0,
+			"520554723C0101695555454545454545454545454545454545454545544545544554552B"},
+		{"everflourish", "", "house:4242;unit:3", TELLSTICK_TURNON, 0,
+			"520554723C0101695555544554545454455454455454455445545445455445454545552B"},
+		{"everflourish", "", "house:4242;unit:3", TELLSTICK_DIM, 0,
+			""},
+		{"fuhaote", "", "code:0101010101", TELLSTICK_TURNON, 0,
+			"53133A3A133A133A13133A3A133A133A13133A3A13133A133A133A3A13133A133A133A3A13133A133A133A3A13133A133A132B"},
+		{"fuhaote", "", "code:0101010101", TELLSTICK_TURNOFF, 0,
+			"53133A3A133A133A13133A3A133A133A13133A3A13133A133A133A3A13133A133A133A3A13133A133A133A133A133A3A13132B"},
+		{"fuhaote", "", "code:1111100000", TELLSTICK_TURNON, 0,
+			"533A133A133A133A133A133A133A133A133A133A13133A3A13133A3A13133A3A13133A3A13133A3A13133A3A13133A133A132B"},
+		{"hasta", "", "house:1;unit:1", TELLSTICK_UP, 0,
+			"BE01BE01BEBE21111121112111211121112111211121112111211121112111211121112111212111112111211121112111211121112111211121112111211121112111211121112111211121112111211121112111"},
+		{"hasta", "", "house:1;unit:1", TELLSTICK_DOWN, 0,
+			"BE01BE01BEBE21111121112111211121112111211121112111211121112111211121112111212111112111211121211111211121112111211121112111211121112111211121112111211121112111211121112111"},
+		{"hasta", "", "house:65536;unit:15", TELLSTICK_STOP, 0,
+			"BE01BE01BEBE11211121112111211121112111211121112111211121112111211121112111212111211121112111211111212111112111211121112111211121112111211121112111211121112111211121112111"},
+		{"hasta", "", "house:4660;unit:7", TELLSTICK_LEARN, 0,
+			"BE01BE01BEBE11211121211111212111211111211121112121111121112121111121112111212111211121111121112111212111112111211121112111211121112111211121112111211121112111211121112111"},
+		{"hasta", "", "house:4660;unit:7", TELLSTICK_TURNON, 0,
+			""},
+		{"ikea", "", "system:1;units:1,2,10", TELLSTICK_TURNON, 0,
+			"53545454545454AAAAAAAAAA545454545454AAAAAAAAAAAAAA5454AAAAAAAAAA54545454AAAA2B"},
+		{"ikea", "", "system:1;units:1,2,10", TELLSTICK_TURNOFF, 0,
+			"53545454545454AAAAAAAAAA545454545454AAAAAAAAAAAAAA5454AAAA5454AA545454545454AAAA2B"},
+		{"ikea", "", "system:16;units:5;fade:false", TELLSTICK_DIM, 50,
+			"53545454545454AA5454545454545454AAAAAAAAAA5454AAAAAAAA5454AAAA5454AAAA5454AAAAAA2B"},
+		{"ikea", "", "system:7;units:3,4;fade:true", TELLSTICK_DIM, 200,
+			"53545454545454AAAA54545454AAAAAAAA54545454AAAAAAAAAA54545454AAAAAA545454545454AA54542B"},
+		{"ikea", "", "system:7;units:3,4", TELLSTICK_DIM, 10,
+			"53545454545454AAAA54545454AAAAAAAA54545454AAAAAAAAAA54545454AA5454AA545454545454AAAA2B"},
+		{"risingsun", "codeswitch", "house:1;unit:1", TELLSTICK_TURNON, 0,
+			"532E652E652E65652E2E65652E2E65652E2E652E652E65652E2E65652E2E65652E2E65652E2E65652E2E65652E2E65652E2E652B"},
+		{"risingsun", "codeswitch", "house:4;unit:3", TELLSTICK_TURNOFF, 0,
+			"532E65652E2E65652E2E65652E2E652E652E65652E2E65652E2E652E652E65652E2E65652E2E65652E2E65652E2E652E652E652B"},
+		{"risingsun", "selflearning", "house:1234;code:5", TELLSTICK_TURNON, 0,
+			"5005537833337878337833783333783378783378333378337833787833337878337833337833787833337833783378337833783378337833783378337833783378337833782B"},
+		{"risingsun", "selflearning", "house:1234;code:5", TELLSTICK_TURNOFF, 0,
+			"5005537833337878337833337878333378783378333378337833787833337878337833337833787833337833783378337833783378337833783378337833783378337833782B"},
+		{"risingsun", "selflearning", "house:33554432;code:16", TELLSTICK_LEARN, 0,
+			"50055232537833337833787833783378333378337878337833783378337833783378337833783378337833783378337833783378337833783378337833783378337833783378332B"},
+		{"sartano", "", "code:0101010101", TELLSTICK_TURNON, 0,
+			"53246B6B24246B246B246B6B24246B246B246B6B24246B246B246B6B24246B246B246B6B24246B246B246B246B246B6B24246B2B"},
+		{"sartano", "", "code:1100110011", TELLSTICK_TURNOFF, 0,
+			"53246B246B246B246B246B6B24246B6B24246B246B246B246B246B6B24246B6B24246B246B246B246B246B6B24246B246B246B2B"},
+		{"silvanchip", "kp100", "house:12345", TELLSTICK_UP, 0,
+			"64FF01FF01FF01FF01FF01FF01FF01FF01FF01FF01FF01FF01642EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012EFF012E2EFF012E2E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012EFF012E2EFF012E2EFF012E2E2EFF012E2EFF012EFF012E2E2EFF012E2EFF012EFF012E2E2EFF012E2EFF012E"},
+		{"silvanchip", "kp100", "house:12345", TELLSTICK_DOWN, 0,
+			"64FF01FF01FF01FF01FF01FF01FF01FF01FF01FF01FF01FF01642EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012EFF012E2EFF012E2E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012EFF012E2EFF012E2EFF012E2E2EFF012E2EFF012EFF012E2EFF012E2E2EFF012E2EFF012E2EFF012E2EFF012E"},
+		{"silvanchip", "kp100", "house:1048575", TELLSTICK_STOP, 0,
+			"64FF01FF01FF01FF01FF01FF01FF01FF01FF01FF01FF01FF0164FF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2E2EFF012EFF012E2E2EFF012E2EFF012E2EFF012E"},
+		{"silvanchip", "kp100", "house:1", TELLSTICK_LEARN, 0,
+			"64FF01FF01FF01FF01FF01FF01FF01FF01FF01FF01FF01FF01642EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012E2EFF012EFF012E2E2EFF012E2EFF012E2EFF012EFF012E2E2EFF012E"},
+		{"silvanchip", "displaymatic", "house:54321", TELLSTICK_UP, 0,
+			"25FF01FF01FF01FF01252569256925692569691569152569691525696915256925692569256969156915256925692569691525692569256969152569"},
+		{"silvanchip", "displaymatic", "house:54321", TELLSTICK_DOWN, 0,
+			"25FF01FF01FF01FF01252569256925692569691569152569691525696915256925692569256969156915256925692569691525696915256925692569"},
+		{"silvanchip", "displaymatic", "house:54321", TELLSTICK_STOP, 0,
+			"25FF01FF01FF01FF01252569256925692569691569152569691525696915256925692569256969156915256925692569691525692569691525692569"},
+		{"silvanchip", "ecosavers", "house:777;unit:1", TELLSTICK_TURNON, 0,
+			"25FF01FF01FF01FF01252569256925692569256925692569256925692569691569152569256925692569691525692569691569156915691569152569"},
+		{"silvanchip", "ecosavers", "house:777;unit:2", TELLSTICK_TURNOFF, 0,
+			"25FF01FF01FF01FF01252569256925692569256925692569256925692569691569152569256925692569691525692569691525692569691569152569"},
+		{"silvanchip", "ecosavers", "house:777;unit:3", TELLSTICK_LEARN, 0,
+			"25FF01FF01FF01FF01252569256925692569256925692569256925692569691569152569256925692569691525692569691569156915256969152569"},
+		{"silvanchip", "ecosavers", "house:777;unit:4", TELLSTICK_TURNOFF, 0,
+			"25FF01FF01FF01FF01252569256925692569256925692569256925692569691569152569256925692569691525692569691525696915691525692569"},
+		{"upm", "", "house:0;unit:1", TELLSTICK_TURNON, 0,
+			"533B3B7E3B7E3B7E3B7E3B7E3B7E3B7E3B7E3B7E3B7E3B7E3B7E3B7E3B7E3B7E7E3B3B7E3B7E3B7E7E3B2B"},
+		{"upm", "", "house:4095;unit:4", TELLSTICK_TURNOFF, 0,
+			"533B7E3B7E3B7E3B7E3B7E3B7E3B7E3B7E3B7E3B7E3B7E3B7E3B7E3B7E3B3B7E3B7E3B7E3B7E7E3B7E3B2B"},
+		{"upm", "", "house:1234;unit:2", TELLSTICK_LEARN, 0,
+			"533B3B7E7E3B3B7E3B7E7E3B7E3B3B7E7E3B3B7E3B7E7E3B3B7E7E3B3B7E3B7E7E3B3B7E3B7E7E3B7E3B2B"},
+		{"waveman", "", "house:B;unit:5", TELLSTICK_TURNON, 0,
+			"53246B6B24246B246B246B246B246B246B246B246B246B246B246B6B24246B246B246B246B246B6B24246B6B24246B6B24246B2B"},
+		{"waveman", "", "house:B;unit:5", TELLSTICK_TURNOFF, 0,
+			"53246B6B24246B246B246B246B246B246B246B246B246B246B246B6B24246B246B246B246B246B246B246B246B246B246B246B2B"},
+		{"x10", "", "house:A;unit:1", TELLSTICK_TURNON, 0,
+			"53FF01FF01FF0164FF01B43B3B3BA93BA93B3B3B3B3B3B3B3B3B3B3BA93B3B3B3B3BA93BA93BA93BA93BA93B3B3B3B3B3B3B3B3B3B3B3B3B3B3B3B3BA93BA93BA93BA93BA93BA93BA93BA93B2B"},
+		{"x10", "", "house:A;unit:1", TELLSTICK_TURNOFF, 0,
+			"53FF01FF01FF0164FF01B43B3B3BA93BA93B3B3B3B3B3B3B3B3B3B3BA93B3B3B3B3BA93BA93BA93BA93BA93B3B3B3B3BA93B3B3B3B3B3B3B3B3B3B3BA93BA93B3B3BA93BA93BA93BA93BA93B2B"},
+		{"x10", "", "house:P;unit:16", TELLSTICK_TURNON, 0,
+			"53FF01FF01FF0164FF01B43B3B3B3B3BA93BA93B3B3BA93B3B3B3B3BA93BA93B3B3B3B3BA93B3B3BA93BA93B3B3BA93B3B3BA93BA93B3B3B3B3B3B3BA93B3B3BA93B3B3B3B3BA93BA93BA93B2B"},
+		{"x10", "", "house:G;unit:8", TELLSTICK_TURNOFF, 0,
+			"53FF01FF01FF0164FF01B43BA93B3B3BA93B3B3B3B3B3B3B3B3B3B3B3B3BA93B3B3BA93BA93BA93BA93BA93B3B3BA93BA93BA93BA93B3B3B3B3B3B3BA93B3B3B3B3B3B3B3B3BA93BA93BA93B2B"},
+		{"x10", "", "house:K;unit:11", TELLSTICK_TURNON, 0,
+			"53FF01FF01FF0164FF01B43BA93BA93B3B3B3B3B3B3BA93B3B3B3B3B3B3B3B3BA93BA93BA93B3B3BA93BA93B3B3B3B3B3B3B3B3BA93B3B3B3B3B3B3BA93BA93BA93BA93B3B3BA93BA93BA93B2B"},
+		{"yidong", "", "unit:1", TELLSTICK_TURNON, 0,
+			"53246B246B246B246B246B246B246B6B24246B6B24246B246B246B6B24246B246B246B246B246B6B24246B246B246B6B24246B2B"},
+		{"yidong", "", "unit:2", TELLSTICK_TURNOFF, 0,
+			"53246B246B246B246B246B246B246B6B24246B6B24246B6B24246B246B246B246B246B246B246B6B24246B6B24246B246B246B2B"},
+		{"yidong", "", "unit:3", TELLSTICK_TURNON, 0,
+			"53246B246B246B246B246B246B246B6B24246B246B246B6B24246B6B24246B246B246B246B246B6B24246B246B246B6B24246B2B"},
+		{"yidong", "", "unit:4", TELLSTICK_TURNOFF, 0,
+			"53246B246B246B246B246B246B246B246B246B6B24246B6B24246B6B24246B246B246B246B246B6B24246B6B24246B246B246B2B"},
+		{"group", "", "devices:1,2", TELLSTICK_TURNON, 0,
+			""},
+		{"scene", "", "devices:1:turnon:0", TELLSTICK_EXECUTE, 0,
+			""}
+	};
+
+	//Received frames and what they decode to, a sensor reading or a list of
+	//commands. Malformed frames must decode to nothing.
+	const struct {
+		const char *frame, *decoded;
+	} decodedFrames[] = {
+		{"class:command;protocol:arctech;model:selflearning;data:0x4B5A1D2;",
+			"class:command;protocol:arctech;model:selflearning;house:1234567;unit:3;group:0;method:turnon;"},
+		{"class:command;protocol:arctech;model:selflearning;data:0xFFFFFFFF;",
+			"class:command;protocol:arctech;model:selflearning;house:67108863;unit:16;group:1;method:turnon;"},
+		{"class:command;protocol:arctech;model:selflearning;data:0x124F82B;",
+			"class:command;protocol:arctech;model:selflearning;house:300000;unit:12;group:1;method:turnoff;"},
+		{"class:command;protocol:arctech;model:codeswitch;data:0xE49;",
+			"class:command;protocol:arctech;model:codeswitch;house:J;unit:5;method:turnon;"
+			"class:command;protocol:waveman;model:codeswitch;house:J;unit:5;method:turnon;"},
+		{"class:command;protocol:everflourish;data:0x424A0A;",
+			"class:command;protocol:everflourish;model:selflearning;house:4242;unit:3;method:learn;"},
+		{"class:sensor;protocol:fineoffset;data:48834644D;",
+			"class:sensor;protocol:fineoffset;model:temperaturehumidity;id:72;humidity:100;temp:-5.2;"},
+		{"class:sensor;protocol:fineoffset;data:A3000FFCA;",
+			"class:sensor;protocol:fineoffset;model:temperature;id:163;temp:0.0;"},
+		{"class:sensor;protocol:mandolyn;data:0xFC9E2D00;",
+			"class:sensor;protocol:mandolyn;model:temperaturehumidity;id:154;temp:-5.0;humidity:30;"},
+		{"class:sensor;protocol:oregon;model:0xEA4C;data:30E230043B04;",
+			"class:sensor;protocol:oregon;model:EA4C;id:226;temp:-4.3;"},
+		{"class:sensor;protocol:oregon;model:0x1A2D;data:201B7619402540E1;",
+			"class:sensor;protocol:oregon;model:1A2D;id:27;temp:19.7;"},
+		{"class:command;protocol:arctech;model:selflearning;data:;", ""},
+		{"class:command;protocol:arctech;model:selflearning;", ""},
+		{"class:command;protocol:arctech;model:codeswitch;data:0xZZ;", ""},
+		{"class:command;protocol:x10;data:0x;", ""},
+		{"class:command;protocol:x10;data:0x123456789ABCDEF012;", ""},
+		{"class:command;protocol:everflourish;data:-1;", ""},
+		{"class:sensor;protocol:fineoffset;data:1234;", ""},
+		{"class:sensor;protocol:fineoffset;data:48801AGG05;", ""},
+		{"class:sensor;protocol:mandolyn;data:;", ""},
+		{"class:sensor;protocol:oregon;model:0xEA4C;data:0x0;", ""},
+		{"class:command;protocol:unknown;data:0x1234;", ""},
+		{"", ""}
+	};
+
+	std::string decode(const std::string &frame) {
+		ControllerMessage msg(frame);
+		SensorRecord record;
+		if (Protocol::decodeSensorData(msg, &record)) {
+			return record.toString();
+		}
+		std::string retval;
+		std::list<std::string> commands = Protocol::decodeData(msg);
+		for (std::list<std::string>::const_iterator it = commands.begin(); it != commands.end(); ++it) {
+			retval.append(*it);
+		}
+		return retval;
+	}
+
+	std::string toHex(const std::string &data) {
+		std::string retval;
+		char buf[3];
+		for (size_t i = 0; i < data.length(); ++i) {
+			sprintf(buf, "%02X", (unsigned char)data[i]);
+			retval.append(buf);
+		}
+		return retval;
+	}
+
+	//Parameters in the form "key:value;key:value"
+	ParameterMap parseParameters(const std::string &parameters) {
+		ParameterMap retval;
+		size_t start = 0;
+		while (start < parameters.length()) {
+			size_t end = parameters.find(';', start);
+			if (end == std::string::npos) {
+				end = parameters.length();
+			}
+			size_t separator = parameters.find(':', start);
+			retval[parameters.substr(start, separator-start)] = parameters.substr(separator+1, end-separator-1);
+			start = end+1;
+		}
+		return retval;
+	}
+}
+
+void ProtocolTest :: setUp (void)
+{
+}
+
+void ProtocolTest :: tearDown (void)
+{
+}
+
+void ProtocolTest :: goldenPacketTest (void) {
+	for (size_t i = 0; i < sizeof(goldenPackets)/sizeof(goldenPackets[0]); ++i) {
+		Protocol *protocol = Protocol::getProtocolInstance(goldenPackets[i].protocol);
+		CPPUNIT_ASSERT(protocol);
+		protocol->setModel(goldenPackets[i].model);
+		ParameterMap parameters = parseParameters(goldenPackets[i].parameters);
+		protocol->setParameters(parameters);
+
+		std::string packet = protocol->getStringForMethod(goldenPackets[i].method, goldenPackets[i].level, 0);
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(std::string(goldenPackets[i].protocol) + " " + goldenPackets[i].model + " " + goldenPackets[i].parameters,
+			std::string(goldenPackets[i].packet), toHex(packet));
+		delete protocol;
+	}
+}
+
+void ProtocolTest :: pulseTrainTest (void) {
+	const BitCoding coding = {"01", "10"};
+	PulseTrain<16> train;
+	train.repeat(2).append('S').appendBits(coding, 0x5, 3).appendBitsReversed(coding, 0x1, 2).append('+');
+	CPPUNIT_ASSERT_EQUAL(std::string("R\x02S100110" "1001+"), train.str());
+
+	//Too long for the buffer
+	train.append("0123456789");
+	CPPUNIT_ASSERT_EQUAL(std::string(""), train.str());
+
+	PulseTrain<> tTrain;
+	tTrain.append("0123" "3");
+	CPPUNIT_ASSERT_EQUAL(std::string("T\x01\x02\x03\x04\x05\x1B\xC0+"), tTrain.tPacket(1, 2, 3, 4));
+	CPPUNIT_ASSERT_EQUAL(std::string("T\x01\x02\x03\x04\x04\x1B\xC0+"), tTrain.tPacket(1, 2, 3, 4, 4));
+}
+
+void ProtocolTest :: decodeTest (void) {
+	for (size_t i = 0; i < sizeof(decodedFrames)/sizeof(decodedFrames[0]); ++i) {
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(decodedFrames[i].frame, std::string(decodedFrames[i].decoded), decode(decodedFrames[i].frame));
+	}
+}
+
+void ProtocolTest :: strayTurnOnTest (void) {
+	const std::string turnOff("class:command;protocol:arctech;model:codeswitch;data:0x600;");
+	const std::string turnOn("class:command;protocol:arctech;model:codeswitch;data:0xE00;");
+	const std::string selfLearning("class:command;protocol:arctech;model:selflearning;data:0xE00;");
+
+	//A turnoff decodes the same whatever came before it, and starts the state over
+	CPPUNIT_ASSERT_EQUAL(std::string(
+		"class:command;protocol:arctech;model:codeswitch;house:A;unit:1;method:turnoff;"
+		"class:command;protocol:sartano;model:codeswitch;code:1111111110;method:turnoff;"),
+		decode(turnOff));
+
+	//A selflearning frame in between doesn't count as the stray turnon
+	decode(selfLearning);
+
+	//The stray turnon following the turnoff is dropped
+	CPPUNIT_ASSERT_EQUAL(std::string(""), decode(turnOn));
+
+	//The next one is a real turnon
+	CPPUNIT_ASSERT_EQUAL(std::string(
+		"class:command;protocol:arctech;model:codeswitch;house:A;unit:1;method:turnon;"
+		"class:command;protocol:waveman;model:codeswitch;house:A;unit:1;method:turnon;"),
+		decode(turnOn));
+}
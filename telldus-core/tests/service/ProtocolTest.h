@@ -0,0 +1,27 @@
+#ifndef PROTOCOLTEST_H
+#define PROTOCOLTEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class ProtocolTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (ProtocolTest);
+	CPPUNIT_TEST (goldenPacketTest);
+	CPPUNIT_TEST (pulseTrainTest);
+	CPPUNIT_TEST (decodeTest);
+	CPPUNIT_TEST (strayTurnOnTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void goldenPacketTest(void);
+	void pulseTrainTest(void);
+	void decodeTest(void);
+	void strayTurnOnTest(void);
+};
+
+#endif //PROTOCOLTEST_H
@@ -0,0 +1,111 @@
+#include "SchedulerJobTest.h"
+#include "SchedulerJob.h"
+#include "SunCalculator.h"
+#include "../client/telldus-core.h"
+#include <stdlib.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (SchedulerJobTest);
+
+namespace {
+	const double STOCKHOLM_LATITUDE = 59.33, STOCKHOLM_LONGITUDE = 18.07;
+
+	time_t utc(int year, int month, int day, int hour, int minute) {
+		//Days since 1970-01-01, valid from March 1970
+		int y = year - (month <= 2);
+		int m = (month + 9) % 12;
+		long days = 365L*y + y/4 - y/100 + y/400 + (m*306 + 5)/10 + day - 1 - 719468L;
+		return (time_t)(days*86400 + hour*3600 + minute*60);
+	}
+
+	SchedulerJob timeJob(int hour, int minute, int weekdays) {
+		SchedulerJob job;
+		job.type = TELLSTICK_SCHEDULE_TIME;
+		job.hour = hour;
+		job.minute = minute;
+		job.weekdays = weekdays;
+		return job;
+	}
+}
+
+void SchedulerJobTest :: setUp (void)
+{
+	const char *tz = getenv("TZ");
+	hadTimezone = (tz != 0);
+	timezone = (tz ? tz : "");
+	setenv("TZ", "Europe/Stockholm", 1);
+	tzset();
+}
+
+void SchedulerJobTest :: tearDown (void)
+{
+	if (hadTimezone) {
+		setenv("TZ", timezone.c_str(), 1);
+	} else {
+		unsetenv("TZ");
+	}
+	tzset();
+}
+
+void SchedulerJobTest :: sunTest (void) {
+	time_t sunrise, sunset;
+	//Midsummer in Stockholm, 03:31 and 22:08 local time
+	CPPUNIT_ASSERT(SunCalculator::calculate(2012, 6, 21, STOCKHOLM_LATITUDE, STOCKHOLM_LONGITUDE, &sunrise, &sunset));
+	CPPUNIT_ASSERT(labs((long)(sunrise - utc(2012, 6, 21, 1, 31))) < 5*60);
+	CPPUNIT_ASSERT(labs((long)(sunset - utc(2012, 6, 21, 20, 8))) < 5*60);
+
+	//New York, west of Greenwich
+	CPPUNIT_ASSERT(SunCalculator::calculate(2012, 3, 20, 40.71, -74.0, &sunrise, &sunset));
+	CPPUNIT_ASSERT(labs((long)(sunrise - utc(2012, 3, 20, 11, 2))) < 5*60);
+	CPPUNIT_ASSERT(labs((long)(sunset - utc(2012, 3, 20, 23, 12))) < 5*60);
+
+	//Polar night in Tromsø
+	CPPUNIT_ASSERT(!SunCalculator::calculate(2012, 12, 21, 69.65, 18.96, &sunrise, &sunset));
+}
+
+void SchedulerJobTest :: timeOfDayTest (void) {
+	SchedulerJob job = timeJob(7, 30, 0);
+	CPPUNIT_ASSERT(job.isValid());
+	CPPUNIT_ASSERT(job.runsOnce());
+	//2012-10-15 05:00 UTC is 07:00 local time
+	CPPUNIT_ASSERT_EQUAL(utc(2012, 10, 15, 5, 30), job.nextRunTime(utc(2012, 10, 15, 5, 0), 0, 0));
+	//Passed, the next day
+	CPPUNIT_ASSERT_EQUAL(utc(2012, 10, 16, 5, 30), job.nextRunTime(utc(2012, 10, 15, 5, 30), 0, 0));
+
+	job.offset = -45;
+	CPPUNIT_ASSERT_EQUAL(utc(2012, 10, 15, 4, 45), job.nextRunTime(utc(2012, 10, 15, 4, 0), 0, 0));
+
+	job.hour = 24;
+	CPPUNIT_ASSERT(!job.isValid());
+}
+
+void SchedulerJobTest :: weekdaysTest (void) {
+	//Saturdays and Sundays
+	SchedulerJob job = timeJob(9, 0, (1 << 5) | (1 << 6));
+	CPPUNIT_ASSERT(!job.runsOnce());
+	//Monday 2012-10-15, the next is Saturday 2012-10-20
+	CPPUNIT_ASSERT_EQUAL(utc(2012, 10, 20, 7, 0), job.nextRunTime(utc(2012, 10, 15, 12, 0), 0, 0));
+	CPPUNIT_ASSERT_EQUAL(utc(2012, 10, 21, 7, 0), job.nextRunTime(utc(2012, 10, 20, 7, 0), 0, 0));
+}
+
+void SchedulerJobTest :: daylightSavingTest (void) {
+	SchedulerJob job = timeJob(7, 0, 0x7F);
+	//Summer time ends 2012-10-28, 07:00 local time moves from 05:00 to 06:00 UTC
+	CPPUNIT_ASSERT_EQUAL(utc(2012, 10, 27, 5, 0), job.nextRunTime(utc(2012, 10, 27, 0, 0), 0, 0));
+	CPPUNIT_ASSERT_EQUAL(utc(2012, 10, 28, 6, 0), job.nextRunTime(utc(2012, 10, 27, 5, 0), 0, 0));
+}
+
+void SchedulerJobTest :: sunriseJobTest (void) {
+	SchedulerJob job;
+	job.type = TELLSTICK_SCHEDULE_SUNRISE;
+	job.offset = 30;
+	job.weekdays = 0x7F;
+	time_t sunrise, sunset;
+	SunCalculator::calculate(2012, 6, 22, STOCKHOLM_LATITUDE, STOCKHOLM_LONGITUDE, &sunrise, &sunset);
+	//After today's sunrise, the next is tomorrow
+	CPPUNIT_ASSERT_EQUAL(sunrise + 30*60, job.nextRunTime(utc(2012, 6, 21, 12, 0), STOCKHOLM_LATITUDE, STOCKHOLM_LONGITUDE));
+
+	//No sunrise during the polar night, the first one is in January
+	time_t next = job.nextRunTime(utc(2012, 12, 1, 12, 0), 69.65, 18.96);
+	CPPUNIT_ASSERT(next > utc(2013, 1, 5, 0, 0));
+	CPPUNIT_ASSERT(next < utc(2013, 1, 20, 0, 0));
+}
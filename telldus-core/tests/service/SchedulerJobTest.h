@@ -0,0 +1,34 @@
+#ifndef SCHEDULERJOBTEST_H
+#define SCHEDULERJOBTEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+class SchedulerJobTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (SchedulerJobTest);
+	CPPUNIT_TEST (sunTest);
+	CPPUNIT_TEST (timeOfDayTest);
+	CPPUNIT_TEST (weekdaysTest);
+	CPPUNIT_TEST (daylightSavingTest);
+	CPPUNIT_TEST (sunriseJobTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void sunTest(void);
+	void timeOfDayTest(void);
+	void weekdaysTest(void);
+	void daylightSavingTest(void);
+	void sunriseJobTest(void);
+
+private:
+	std::string timezone;
+	bool hadTimezone;
+};
+
+#endif //SCHEDULERJOBTEST_H
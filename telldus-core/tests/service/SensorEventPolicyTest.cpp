@@ -0,0 +1,83 @@
+#include "SensorEventPolicyTest.h"
+#include "SensorEventPolicy.h"
+#include "../client/telldus-core.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (SensorEventPolicyTest);
+
+namespace {
+	Sensor::Reading reading(int value, int decimals, time_t timestamp) {
+		Sensor::Reading r;
+		r.value = value;
+		r.decimals = decimals;
+		r.timestamp = timestamp;
+		return r;
+	}
+
+	SensorRecord::Value value(int dataType, int v, int decimals) {
+		SensorRecord::Value r;
+		r.dataType = dataType;
+		r.value = v;
+		r.decimals = decimals;
+		return r;
+	}
+}
+
+void SensorEventPolicyTest :: setUp (void)
+{
+}
+
+void SensorEventPolicyTest :: tearDown (void)
+{
+}
+
+void SensorEventPolicyTest :: defaultTest (void) {
+	SensorEventPolicy policy;
+	Sensor::Reading last = reading(215, 1, 1000);
+	CPPUNIT_ASSERT(policy.shouldSignal(0, value(TELLSTICK_TEMPERATURE, 215, 1), 1000));
+	CPPUNIT_ASSERT(policy.shouldSignal(&last, value(TELLSTICK_TEMPERATURE, 215, 1), 1030));
+}
+
+void SensorEventPolicyTest :: deadbandTest (void) {
+	SensorEventPolicy policy;
+	policy.setDeadband(TELLSTICK_TEMPERATURE, 2, 1);
+	Sensor::Reading last = reading(215, 1, 1000);
+
+	//The first value is always signalled
+	CPPUNIT_ASSERT(policy.shouldSignal(0, value(TELLSTICK_TEMPERATURE, 215, 1), 1000));
+	CPPUNIT_ASSERT(!policy.shouldSignal(&last, value(TELLSTICK_TEMPERATURE, 215, 1), 1030));
+	CPPUNIT_ASSERT(!policy.shouldSignal(&last, value(TELLSTICK_TEMPERATURE, 217, 1), 1030));
+	CPPUNIT_ASSERT(!policy.shouldSignal(&last, value(TELLSTICK_TEMPERATURE, 213, 1), 1030));
+	CPPUNIT_ASSERT(policy.shouldSignal(&last, value(TELLSTICK_TEMPERATURE, 218, 1), 1030));
+	CPPUNIT_ASSERT(policy.shouldSignal(&last, value(TELLSTICK_TEMPERATURE, 212, 1), 1030));
+
+	//No deadband for humidity
+	Sensor::Reading humidity = reading(45, 0, 1000);
+	CPPUNIT_ASSERT(policy.shouldSignal(&humidity, value(TELLSTICK_HUMIDITY, 45, 0), 1030));
+
+	//A deadband of zero signals changes only
+	policy.setDeadband(TELLSTICK_HUMIDITY, 0, 0);
+	CPPUNIT_ASSERT(!policy.shouldSignal(&humidity, value(TELLSTICK_HUMIDITY, 45, 0), 1030));
+	CPPUNIT_ASSERT(policy.shouldSignal(&humidity, value(TELLSTICK_HUMIDITY, 46, 0), 1030));
+}
+
+void SensorEventPolicyTest :: heartbeatTest (void) {
+	SensorEventPolicy policy;
+	policy.setDeadband(TELLSTICK_TEMPERATURE, 5, 1);
+	Sensor::Reading last = reading(215, 1, 1000);
+	CPPUNIT_ASSERT(!policy.shouldSignal(&last, value(TELLSTICK_TEMPERATURE, 215, 1), 100000));
+
+	policy.setHeartbeat(600);
+	CPPUNIT_ASSERT(!policy.shouldSignal(&last, value(TELLSTICK_TEMPERATURE, 215, 1), 1599));
+	CPPUNIT_ASSERT(policy.shouldSignal(&last, value(TELLSTICK_TEMPERATURE, 215, 1), 1600));
+}
+
+void SensorEventPolicyTest :: decimalsTest (void) {
+	SensorEventPolicy policy;
+	policy.setDeadband(TELLSTICK_TEMPERATURE, 5, 1);
+	Sensor::Reading last = reading(215, 1, 1000);
+	//21.5 and 21.95 differ by less than 0.5
+	CPPUNIT_ASSERT(!policy.shouldSignal(&last, value(TELLSTICK_TEMPERATURE, 2195, 2), 1030));
+	CPPUNIT_ASSERT(policy.shouldSignal(&last, value(TELLSTICK_TEMPERATURE, 2201, 2), 1030));
+	//22 and 21.5 differ by exactly the deadband
+	CPPUNIT_ASSERT(!policy.shouldSignal(&last, value(TELLSTICK_TEMPERATURE, 22, 0), 1030));
+}
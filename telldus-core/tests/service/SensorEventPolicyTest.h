@@ -0,0 +1,27 @@
+#ifndef SENSOREVENTPOLICYTEST_H
+#define SENSOREVENTPOLICYTEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class SensorEventPolicyTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (SensorEventPolicyTest);
+	CPPUNIT_TEST (defaultTest);
+	CPPUNIT_TEST (deadbandTest);
+	CPPUNIT_TEST (heartbeatTest);
+	CPPUNIT_TEST (decimalsTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void defaultTest(void);
+	void deadbandTest(void);
+	void heartbeatTest(void);
+	void decimalsTest(void);
+};
+
+#endif //SENSOREVENTPOLICYTEST_H
@@ -0,0 +1,60 @@
+#include "SensorHistoryTest.h"
+#include "SensorHistory.h"
+#include "../client/telldus-core.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (SensorHistoryTest);
+
+void SensorHistoryTest :: setUp (void)
+{
+}
+
+void SensorHistoryTest :: tearDown (void)
+{
+}
+
+void SensorHistoryTest :: rangeTest (void) {
+	SensorHistory history(16);
+	for (int i = 0; i < 5; ++i) {
+		history.append(TELLSTICK_TEMPERATURE, 200+i, 1, 1000+i*60);
+		history.append(TELLSTICK_HUMIDITY, 40+i, 0, 1000+i*60);
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t)10, history.size());
+
+	std::vector<SensorHistory::Sample> samples;
+	history.range(TELLSTICK_TEMPERATURE, 1060, 1180, &samples);
+	CPPUNIT_ASSERT_EQUAL((size_t)3, samples.size());
+	CPPUNIT_ASSERT_EQUAL(201, samples[0].value);
+	CPPUNIT_ASSERT_EQUAL((time_t)1060, samples[0].timestamp);
+	CPPUNIT_ASSERT_EQUAL(203, samples[2].value);
+	CPPUNIT_ASSERT_EQUAL(1, samples[2].decimals);
+
+	samples.clear();
+	history.range(TELLSTICK_HUMIDITY, 0, 999, &samples);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, samples.size());
+}
+
+void SensorHistoryTest :: wrapAroundTest (void) {
+	SensorHistory history(4);
+	for (int i = 0; i < 10; ++i) {
+		history.append(TELLSTICK_TEMPERATURE, i, 0, i);
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t)4, history.size());
+
+	//Only the latest are kept, still oldest first
+	std::vector<SensorHistory::Sample> samples;
+	history.range(TELLSTICK_TEMPERATURE, 0, 100, &samples);
+	CPPUNIT_ASSERT_EQUAL((size_t)4, samples.size());
+	for (int i = 0; i < 4; ++i) {
+		CPPUNIT_ASSERT_EQUAL(6+i, samples[i].value);
+	}
+}
+
+void SensorHistoryTest :: disabledTest (void) {
+	SensorHistory history(0);
+	history.append(TELLSTICK_TEMPERATURE, 1, 0, 1);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, history.size());
+
+	std::vector<SensorHistory::Sample> samples;
+	history.range(TELLSTICK_TEMPERATURE, 0, 100, &samples);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, samples.size());
+}
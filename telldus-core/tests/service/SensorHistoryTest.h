@@ -0,0 +1,25 @@
+#ifndef SENSORHISTORYTEST_H
+#define SENSORHISTORYTEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class SensorHistoryTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (SensorHistoryTest);
+	CPPUNIT_TEST (rangeTest);
+	CPPUNIT_TEST (wrapAroundTest);
+	CPPUNIT_TEST (disabledTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void rangeTest(void);
+	void wrapAroundTest(void);
+	void disabledTest(void);
+};
+
+#endif //SENSORHISTORYTEST_H
@@ -0,0 +1,95 @@
+#include "SensorRollupTest.h"
+#include "SensorRollup.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (SensorRollupTest);
+
+namespace {
+	const size_t DEPTHS[SensorRollup::NUMBER_OF_RESOLUTIONS] = {60, 48, 7};
+	const time_t MIDNIGHT = 1350000000 - (1350000000 % 86400);
+}
+
+void SensorRollupTest :: setUp (void)
+{
+}
+
+void SensorRollupTest :: tearDown (void)
+{
+}
+
+void SensorRollupTest :: aggregateTest (void) {
+	SensorRollup rollup(DEPTHS);
+	rollup.add(215, 1, MIDNIGHT+10);
+	rollup.add(-52, 1, MIDNIGHT+20);
+	rollup.add(100, 1, MIDNIGHT+30);
+
+	std::vector<SensorRollup::Bucket> buckets;
+	rollup.range(SensorRollup::MINUTE, MIDNIGHT, MIDNIGHT, &buckets);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, buckets.size());
+	CPPUNIT_ASSERT_EQUAL(MIDNIGHT, buckets[0].start);
+	CPPUNIT_ASSERT_EQUAL(-52, buckets[0].min);
+	CPPUNIT_ASSERT_EQUAL(215, buckets[0].max);
+	CPPUNIT_ASSERT_EQUAL(88, buckets[0].average());
+	CPPUNIT_ASSERT_EQUAL(3, buckets[0].count);
+	CPPUNIT_ASSERT_EQUAL(1, buckets[0].decimals);
+}
+
+void SensorRollupTest :: bucketAlignmentTest (void) {
+	SensorRollup rollup(DEPTHS);
+	//Every ten minutes for two hours
+	for (int i = 0; i < 12; ++i) {
+		rollup.add(i, 0, MIDNIGHT + i*600 + 5);
+	}
+
+	std::vector<SensorRollup::Bucket> buckets;
+	rollup.range(SensorRollup::MINUTE, 0, MIDNIGHT*2, &buckets);
+	CPPUNIT_ASSERT_EQUAL((size_t)12, buckets.size());
+
+	buckets.clear();
+	rollup.range(SensorRollup::HOUR, 0, MIDNIGHT*2, &buckets);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, buckets.size());
+	CPPUNIT_ASSERT_EQUAL(MIDNIGHT, buckets[0].start);
+	CPPUNIT_ASSERT_EQUAL(MIDNIGHT+3600, buckets[1].start);
+	CPPUNIT_ASSERT_EQUAL(6, buckets[1].min);
+	CPPUNIT_ASSERT_EQUAL(11, buckets[1].max);
+	CPPUNIT_ASSERT_EQUAL(6, buckets[1].count);
+
+	buckets.clear();
+	rollup.range(SensorRollup::DAY, 0, MIDNIGHT*2, &buckets);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, buckets.size());
+	CPPUNIT_ASSERT_EQUAL(12, buckets[0].count);
+
+	//Values from before the current bucket are dropped
+	rollup.add(100, 0, MIDNIGHT);
+	buckets.clear();
+	rollup.range(SensorRollup::HOUR, 0, MIDNIGHT*2, &buckets);
+	CPPUNIT_ASSERT_EQUAL(11, buckets[1].max);
+	CPPUNIT_ASSERT_EQUAL(6, buckets[0].count);
+}
+
+void SensorRollupTest :: wrapAroundTest (void) {
+	SensorRollup rollup(DEPTHS);
+	for (int i = 0; i < 10; ++i) {
+		rollup.add(i, 0, MIDNIGHT + i*86400);
+	}
+
+	//Only the latest days are kept, still oldest first
+	std::vector<SensorRollup::Bucket> buckets;
+	rollup.range(SensorRollup::DAY, 0, MIDNIGHT*2, &buckets);
+	CPPUNIT_ASSERT_EQUAL((size_t)7, buckets.size());
+	for (int i = 0; i < 7; ++i) {
+		CPPUNIT_ASSERT_EQUAL(MIDNIGHT + (3+i)*86400, buckets[i].start);
+		CPPUNIT_ASSERT_EQUAL(3+i, buckets[i].min);
+	}
+}
+
+void SensorRollupTest :: decimalsTest (void) {
+	SensorRollup rollup(DEPTHS);
+	rollup.add(20, 0, MIDNIGHT);
+	rollup.add(215, 1, MIDNIGHT+1);
+
+	//Later values are scaled to the decimals of the first
+	std::vector<SensorRollup::Bucket> buckets;
+	rollup.range(SensorRollup::MINUTE, MIDNIGHT, MIDNIGHT, &buckets);
+	CPPUNIT_ASSERT_EQUAL(0, buckets[0].decimals);
+	CPPUNIT_ASSERT_EQUAL(21, buckets[0].max);
+}
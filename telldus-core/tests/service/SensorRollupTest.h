@@ -0,0 +1,27 @@
+#ifndef SENSORROLLUPTEST_H
+#define SENSORROLLUPTEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class SensorRollupTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (SensorRollupTest);
+	CPPUNIT_TEST (aggregateTest);
+	CPPUNIT_TEST (bucketAlignmentTest);
+	CPPUNIT_TEST (wrapAroundTest);
+	CPPUNIT_TEST (decimalsTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void aggregateTest(void);
+	void bucketAlignmentTest(void);
+	void wrapAroundTest(void);
+	void decimalsTest(void);
+};
+
+#endif //SENSORROLLUPTEST_H
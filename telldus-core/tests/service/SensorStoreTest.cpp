@@ -0,0 +1,160 @@
+#include "SensorStoreTest.h"
+#include "SensorStore.h"
+#include "../client/telldus-core.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (SensorStoreTest);
+
+namespace {
+	const char *STORE_FILE = "SensorStoreTest.dat";
+
+	SensorStore::Entry makeEntry(int id, int value, time_t timestamp) {
+		SensorStore::Entry entry;
+		strncpy(entry.protocol, "fineoffset", sizeof(entry.protocol));
+		strncpy(entry.model, "temperaturehumidity", sizeof(entry.model));
+		entry.id = id;
+		entry.value.dataType = TELLSTICK_TEMPERATURE;
+		entry.value.value = value;
+		entry.value.decimals = 1;
+		entry.timestamp = timestamp;
+		return entry;
+	}
+
+	int valueAt(const SensorStore &store, size_t index) {
+		SensorStore::Entry entry;
+		if (!store.entry(index, &entry)) {
+			return -1;
+		}
+		return entry.value.value;
+	}
+}
+
+void SensorStoreTest :: setUp (void)
+{
+	remove(STORE_FILE);
+}
+
+void SensorStoreTest :: tearDown (void)
+{
+	remove(STORE_FILE);
+}
+
+void SensorStoreTest :: reopenTest (void) {
+	{
+		SensorStore store;
+		CPPUNIT_ASSERT(store.open(STORE_FILE, 16, 0));
+		store.append(makeEntry(135, 215, 1350000000));
+		store.append(makeEntry(136, -52, 1350000060));
+	}
+
+	SensorStore store;
+	CPPUNIT_ASSERT(store.open(STORE_FILE, 16, 0));
+	CPPUNIT_ASSERT_EQUAL((size_t)2, store.size());
+	SensorStore::Entry entry;
+	CPPUNIT_ASSERT(store.entry(1, &entry));
+	CPPUNIT_ASSERT_EQUAL(std::string("fineoffset"), std::string(entry.protocol));
+	CPPUNIT_ASSERT_EQUAL(std::string("temperaturehumidity"), std::string(entry.model));
+	CPPUNIT_ASSERT_EQUAL(136, entry.id);
+	CPPUNIT_ASSERT_EQUAL(TELLSTICK_TEMPERATURE, entry.value.dataType);
+	CPPUNIT_ASSERT_EQUAL(-52, entry.value.value);
+	CPPUNIT_ASSERT_EQUAL(1, entry.value.decimals);
+	CPPUNIT_ASSERT_EQUAL((time_t)1350000060, entry.timestamp);
+	CPPUNIT_ASSERT(!store.entry(2, &entry));
+}
+
+void SensorStoreTest :: batchedWriteTest (void) {
+	SensorStore store;
+	CPPUNIT_ASSERT(store.open(STORE_FILE, 16, 3600));
+	store.append(makeEntry(1, 1, 1));
+	store.append(makeEntry(1, 2, 2));
+	//Held back until the flusher runs
+	CPPUNIT_ASSERT_EQUAL((size_t)0, store.size());
+
+	store.flush();
+	CPPUNIT_ASSERT_EQUAL((size_t)2, store.size());
+	CPPUNIT_ASSERT_EQUAL(1, valueAt(store, 0));
+	CPPUNIT_ASSERT_EQUAL(2, valueAt(store, 1));
+}
+
+void SensorStoreTest :: wrapAroundTest (void) {
+	SensorStore store;
+	CPPUNIT_ASSERT(store.open(STORE_FILE, 4, 3600));
+	for (int i = 0; i < 3; ++i) {
+		store.append(makeEntry(1, i, i));
+	}
+	store.flush();
+	//More than fits between two flushes, only the newest are kept
+	for (int i = 3; i < 10; ++i) {
+		store.append(makeEntry(1, i, i));
+	}
+	store.flush();
+	CPPUNIT_ASSERT_EQUAL((size_t)4, store.size());
+	for (int i = 0; i < 4; ++i) {
+		CPPUNIT_ASSERT_EQUAL(6+i, valueAt(store, i));
+	}
+}
+
+void SensorStoreTest :: resizeTest (void) {
+	{
+		SensorStore store;
+		CPPUNIT_ASSERT(store.open(STORE_FILE, 4, 0));
+		for (int i = 0; i < 6; ++i) {
+			store.append(makeEntry(1, i, i));
+		}
+	}
+	{
+		//Smaller, the newest are kept
+		SensorStore store;
+		CPPUNIT_ASSERT(store.open(STORE_FILE, 2, 0));
+		CPPUNIT_ASSERT_EQUAL((size_t)2, store.size());
+		CPPUNIT_ASSERT_EQUAL(4, valueAt(store, 0));
+		CPPUNIT_ASSERT_EQUAL(5, valueAt(store, 1));
+	}
+
+	SensorStore store;
+	CPPUNIT_ASSERT(store.open(STORE_FILE, 8, 0));
+	CPPUNIT_ASSERT_EQUAL((size_t)2, store.size());
+	store.append(makeEntry(1, 6, 6));
+	store.flush();
+	CPPUNIT_ASSERT_EQUAL((size_t)3, store.size());
+	CPPUNIT_ASSERT_EQUAL(4, valueAt(store, 0));
+	CPPUNIT_ASSERT_EQUAL(6, valueAt(store, 2));
+}
+
+void SensorStoreTest :: corruptFileTest (void) {
+	FILE *fp = fopen(STORE_FILE, "w");
+	for (int i = 0; i < 100; ++i) {
+		fputs("not a sensor store ", fp);
+	}
+	fclose(fp);
+
+	SensorStore store;
+	CPPUNIT_ASSERT(store.open(STORE_FILE, 4, 0));
+	CPPUNIT_ASSERT_EQUAL((size_t)0, store.size());
+	store.append(makeEntry(1, 1, 1));
+	store.flush();
+	CPPUNIT_ASSERT_EQUAL((size_t)1, store.size());
+}
+
+void SensorStoreTest :: notRegularFileTest (void) {
+	//A fifo opens read-write without blocking, but must not be truncated
+	CPPUNIT_ASSERT_EQUAL(0, mkfifo(STORE_FILE, 0644));
+	SensorStore store;
+	CPPUNIT_ASSERT(!store.open(STORE_FILE, 4, 0));
+	CPPUNIT_ASSERT(!store.isOpen());
+}
+
+void SensorStoreTest :: backgroundFlushTest (void) {
+	SensorStore store;
+	CPPUNIT_ASSERT(store.open(STORE_FILE, 16, 1));
+	store.append(makeEntry(1, 1, 1));
+	//Written within the interval without another append or flush
+	for (int i = 0; i < 30 && store.size() == 0; ++i) {
+		usleep(100000);
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t)1, store.size());
+	CPPUNIT_ASSERT_EQUAL(1, valueAt(store, 0));
+}
@@ -0,0 +1,33 @@
+#ifndef SENSORSTORETEST_H
+#define SENSORSTORETEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class SensorStoreTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (SensorStoreTest);
+	CPPUNIT_TEST (reopenTest);
+	CPPUNIT_TEST (batchedWriteTest);
+	CPPUNIT_TEST (wrapAroundTest);
+	CPPUNIT_TEST (resizeTest);
+	CPPUNIT_TEST (corruptFileTest);
+	CPPUNIT_TEST (notRegularFileTest);
+	CPPUNIT_TEST (backgroundFlushTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void reopenTest(void);
+	void batchedWriteTest(void);
+	void wrapAroundTest(void);
+	void resizeTest(void);
+	void corruptFileTest(void);
+	void notRegularFileTest(void);
+	void backgroundFlushTest(void);
+};
+
+#endif //SENSORSTORETEST_H
@@ -0,0 +1,106 @@
+#include "TellStickTest.h"
+#include "TellStick.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TellStickTest);
+
+namespace {
+	//Decodes a packet the way the firmware does, into what it will send on air
+	std::string emittedPulses(const std::string &packet) {
+		std::string retval;
+		size_t i = 0;
+		while (i+1 < packet.length() && (packet[i] == 'R' || packet[i] == 'P')) {
+			retval.append(1, packet[i]).append(1, packet[i+1]);
+			i += 2;
+		}
+		if (i < packet.length() && packet[i] == 'S') {
+			size_t end = packet.find('+', i);
+			CPPUNIT_ASSERT(end == packet.length()-1);
+			return retval + "|" + packet.substr(i+1, end-i-1);
+		}
+		CPPUNIT_ASSERT(i+6 <= packet.length() && packet[i] == 'T');
+		size_t length = (unsigned char)packet[i+5];
+		CPPUNIT_ASSERT_EQUAL(i+6+(length+3)/4+1, packet.length());
+		CPPUNIT_ASSERT_EQUAL('+', packet[packet.length()-1]);
+		retval.append("|");
+		for (size_t j = 0; j < length; ++j) {
+			unsigned char dataByte = packet[i+6+j/4];
+			retval.append(1, packet[i+1+((dataByte >> (6-(j%4)*2)) & 3)]);
+		}
+		return retval;
+	}
+
+	std::string pulseTrain(const char *times, size_t numberOfTimes, size_t length) {
+		std::string retval;
+		unsigned int seed = 17;
+		for (size_t i = 0; i < length; ++i) {
+			seed = seed*1103515245 + 12345;
+			retval.append(1, times[(seed >> 16) % numberOfTimes]);
+		}
+		return retval;
+	}
+}
+
+void TellStickTest :: setUp (void)
+{
+}
+
+void TellStickTest :: tearDown (void)
+{
+}
+
+void TellStickTest :: packetAirtimeTest (void) {
+	//Three pulses of 1ms, repeated 10 times with 11ms pause
+	std::string pulses(3, 100);
+	CPPUNIT_ASSERT_EQUAL(129, TellStick::packetAirtime("S" + pulses + "+"));
+	CPPUNIT_ASSERT_EQUAL(129, TellStick::packetAirtime(TellStick::createTPacket(pulses)));
+	CPPUNIT_ASSERT_EQUAL(17, TellStick::packetAirtime("R\x02S" + pulses + "+"));
+	CPPUNIT_ASSERT_EQUAL(19, TellStick::packetAirtime("P\x05R\x03S" + pulses + "+"));
+	//Not sent on air
+	CPPUNIT_ASSERT_EQUAL(0, TellStick::packetAirtime("N+"));
+	CPPUNIT_ASSERT_EQUAL(0, TellStick::packetAirtime("V+"));
+}
+
+void TellStickTest :: encodePacketEquivalenceTest (void) {
+	const char times[] = {'$', 'k', 1, (char)255, '+'};
+	for (size_t numberOfTimes = 1; numberOfTimes <= 5; ++numberOfTimes) {
+		for (size_t length = 1; length <= 300; ++length) {
+			std::string pulses = pulseTrain(times, numberOfTimes, length);
+			for (int pid = 0x0C30; pid <= 0x0C31; ++pid) {
+				std::string packet = TellStick::encodePacket(pulses, pid);
+				if (!packet.length()) {
+					//Must be impossible to send as an S- or T-packet
+					CPPUNIT_ASSERT(numberOfTimes > 4 || length > 255);
+					CPPUNIT_ASSERT(length > (pid == 0x0C31 ? 512u : 80u) || numberOfTimes == 5);
+					continue;
+				}
+				CPPUNIT_ASSERT_EQUAL("|" + pulses, emittedPulses(packet));
+
+				//Prefixes from the protocol must be kept
+				std::string prefixed = "P\x05R\x32S" + pulses + "+";
+				if (pulses.find('+') == std::string::npos && length <= 80) {
+					CPPUNIT_ASSERT_EQUAL("P\x05R\x32|" + pulses, emittedPulses(TellStick::encodePacket(prefixed, pid)));
+				}
+			}
+		}
+	}
+}
+
+void TellStickTest :: encodePacketSizeTest (void) {
+	//A typical codeswitch packet, 4 pulse lengths
+	std::string pulses = pulseTrain("$k\x01\x7f", 4, 50);
+	std::string packet = TellStick::encodePacket(pulses, 0x0C30);
+	CPPUNIT_ASSERT_EQUAL('T', packet[0]);
+	CPPUNIT_ASSERT_EQUAL((size_t)6+13+1, packet.length());
+
+	//Too short to gain anything from a T-packet
+	CPPUNIT_ASSERT_EQUAL(std::string("S$k$k+"), TellStick::encodePacket("$k$k", 0x0C30));
+
+	//Too many pulse lengths for a T-packet
+	pulses = pulseTrain("$k\x01\x7f\x02", 5, 100);
+	CPPUNIT_ASSERT_EQUAL(std::string(""), TellStick::encodePacket(pulses, 0x0C30));
+	CPPUNIT_ASSERT_EQUAL("S" + pulses + "+", TellStick::encodePacket(pulses, 0x0C31));
+
+	//T-packets are already compact and left as they are
+	std::string tPacket = TellStick::createTPacket(pulseTrain("$k", 2, 132));
+	CPPUNIT_ASSERT_EQUAL("R\x05" + tPacket, TellStick::encodePacket("R\x05" + tPacket, 0x0C30));
+}
@@ -0,0 +1,25 @@
+#ifndef TELLSTICKTEST_H
+#define TELLSTICKTEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class TellStickTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (TellStickTest);
+	CPPUNIT_TEST (packetAirtimeTest);
+	CPPUNIT_TEST (encodePacketEquivalenceTest);
+	CPPUNIT_TEST (encodePacketSizeTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void packetAirtimeTest(void);
+	void encodePacketEquivalenceTest(void);
+	void encodePacketSizeTest(void);
+};
+
+#endif //TELLSTICKTEST_H
@@ -0,0 +1,101 @@
+#include "TimerWheelTest.h"
+#include "TimerWheel.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TimerWheelTest);
+
+namespace {
+	const time_t START = 1350000000;
+}
+
+void TimerWheelTest :: setUp (void)
+{
+}
+
+void TimerWheelTest :: tearDown (void)
+{
+}
+
+void TimerWheelTest :: expiryTest (void) {
+	TimerWheel wheel(START);
+	std::vector<int> expired;
+	wheel.schedule(1, START + 10);
+	wheel.schedule(2, START + 5);
+	//Already passed, runs at the next advance
+	wheel.schedule(3, START - 100);
+	CPPUNIT_ASSERT_EQUAL((size_t)3, wheel.size());
+
+	wheel.advance(START + 1, &expired);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, expired.size());
+	CPPUNIT_ASSERT_EQUAL(3, expired[0]);
+
+	wheel.advance(START + 9, &expired);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, expired.size());
+	CPPUNIT_ASSERT_EQUAL(2, expired[1]);
+
+	wheel.advance(START + 10, &expired);
+	CPPUNIT_ASSERT_EQUAL((size_t)3, expired.size());
+	CPPUNIT_ASSERT_EQUAL(1, expired[2]);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, wheel.size());
+}
+
+void TimerWheelTest :: cascadeTest (void) {
+	TimerWheel wheel(START);
+	//One timer on each wheel and one beyond them all
+	const time_t delays[] = { 100, 1000, 50000, 5000000, 70000000 };
+	const int count = sizeof(delays)/sizeof(delays[0]);
+	for (int i = 0; i < count; ++i) {
+		wheel.schedule(i, START + delays[i]);
+	}
+
+	std::vector<int> expired;
+	time_t now = START;
+	for (int i = 0; i < count; ++i) {
+		//Advanced in steps short enough to go through the wheels, the timer must not expire early
+		time_t due = START + delays[i];
+		while (now < due - 1) {
+			now = (due - 1 - now > 10000 ? now + 10000 : due - 1);
+			wheel.advance(now, &expired);
+		}
+		CPPUNIT_ASSERT_EQUAL((size_t)i, expired.size());
+		wheel.advance(++now, &expired);
+		CPPUNIT_ASSERT_EQUAL((size_t)i+1, expired.size());
+		CPPUNIT_ASSERT_EQUAL(i, expired[i]);
+	}
+}
+
+void TimerWheelTest :: cancelTest (void) {
+	TimerWheel wheel(START);
+	std::vector<int> expired;
+	wheel.schedule(1, START + 10);
+	wheel.schedule(2, START + 20000);
+	wheel.cancel(1);
+	CPPUNIT_ASSERT(!wheel.isScheduled(1));
+	CPPUNIT_ASSERT(wheel.isScheduled(2));
+
+	//Rescheduling replaces the timer
+	wheel.schedule(2, START + 30);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, wheel.size());
+	wheel.advance(START + 20000, &expired);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, expired.size());
+	CPPUNIT_ASSERT_EQUAL(2, expired[0]);
+}
+
+void TimerWheelTest :: clockJumpTest (void) {
+	TimerWheel wheel(START);
+	std::vector<int> expired;
+	wheel.schedule(1, START + 3600);
+	wheel.schedule(2, START + 2*24*3600);
+	wheel.schedule(3, START + 60);
+
+	//The clock is set back a day, nothing has expired
+	wheel.advance(START - 24*3600, &expired);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, expired.size());
+	CPPUNIT_ASSERT_EQUAL((size_t)3, wheel.size());
+
+	//And then forward a week, both expire in order
+	wheel.advance(START + 7*24*3600, &expired);
+	CPPUNIT_ASSERT_EQUAL((size_t)3, expired.size());
+	CPPUNIT_ASSERT_EQUAL(3, expired[0]);
+	CPPUNIT_ASSERT_EQUAL(1, expired[1]);
+	CPPUNIT_ASSERT_EQUAL(2, expired[2]);
+}
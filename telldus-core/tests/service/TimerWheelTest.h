@@ -0,0 +1,27 @@
+#ifndef TIMERWHEELTEST_H
+#define TIMERWHEELTEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class TimerWheelTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (TimerWheelTest);
+	CPPUNIT_TEST (expiryTest);
+	CPPUNIT_TEST (cascadeTest);
+	CPPUNIT_TEST (cancelTest);
+	CPPUNIT_TEST (clockJumpTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void expiryTest(void);
+	void cascadeTest(void);
+	void cancelTest(void);
+	void clockJumpTest(void);
+};
+
+#endif //TIMERWHEELTEST_H
@@ -8,26 +8,18 @@ __postInit__ = function() {
 com.telldus.sensors = function() {
 	var sensorList;
 	function init() {
-		var sensorData = 0;
 		sensorList = loadSensorModel();
 		sensorList.rowsRemoved.connect(function(){saveSensorModel();});
 		sensorList.rowsInserted.connect(function(){saveSensorModel();});
 
-		while(sensorData = com.telldus.core.sensor()) {
-			var p = sensorData["protocol"];
-			var m = sensorData["model"];
-			var id = sensorData["sensorId"];
-			var types = sensorData["dataTypes"];
-
-			var tryFetchValue = function(p, m, id, types, type) {
-				if (types & type) {
-					sensorValue = com.telldus.core.sensorValue(p, m, id, type);
-					sensorEvent(p, m, id, type, sensorValue["value"], sensorValue["timestamp"], true);
-				}
+		//All values of all sensors, in one call. Only temperature and humidity are shown
+		var snapshot = com.telldus.core.sensorSnapshot();
+		for (var i = 0; i < snapshot.length; ++i) {
+			var v = snapshot[i];
+			if (v["dataType"] != com.telldus.core.TELLSTICK_TEMPERATURE && v["dataType"] != com.telldus.core.TELLSTICK_HUMIDITY) {
+				continue;
 			}
-			tryFetchValue(p, m, id, types, com.telldus.core.TELLSTICK_TEMPERATURE);
-			tryFetchValue(p, m, id, types, com.telldus.core.TELLSTICK_HUMIDITY);
-
+			sensorEvent(v["protocol"], v["model"], v["sensorId"], v["dataType"], v["value"], v["timestamp"], true);
 		}
 
 		com.telldus.core.sensorEvent.connect(sensorEvent);
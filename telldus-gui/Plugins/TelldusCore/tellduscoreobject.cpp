@@ -1,5 +1,6 @@
 #include "tellduscoreobject.h"
 #include <QDateTime>
+#include <QStringList>
 #include <QDebug>
 
 TelldusCoreObject::TelldusCoreObject( QObject * parent )
@@ -136,6 +137,31 @@ QVariant TelldusCoreObject::sensorValue(const QString &protocol, const QString &
 	return retval;
 }
 
+QVariantList TelldusCoreObject::sensorSnapshot() const {
+	char *snapshot = tdSensorSnapshot();
+	QStringList lines = QString::fromUtf8(snapshot).split('\n', QString::SkipEmptyParts);
+	tdReleaseString(snapshot);
+
+	QVariantList retval;
+	foreach(QString line, lines) {
+		//"protocol model id dataType value timestamp", see tdSensorSnapshot()
+		QStringList fields = line.split(' ');
+		if (fields.size() != 6) {
+			qWarning() << "Skipping sensor value that could not be parsed:" << line;
+			continue;
+		}
+		QVariantMap value;
+		value["protocol"] = fields[0];
+		value["model"] = fields[1];
+		value["sensorId"] = fields[2].toInt();
+		value["dataType"] = fields[3].toInt();
+		value["value"] = fields[4];
+		value["timestamp"] = QDateTime::fromTime_t(fields[5].toUInt());
+		retval << value;
+	}
+	return retval;
+}
+
 QVariant TelldusCoreObject::controller() const {
 	const int DATA_LENGTH = 255;
 	char name[DATA_LENGTH];
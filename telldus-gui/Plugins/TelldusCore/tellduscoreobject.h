@@ -31,6 +31,7 @@ public slots:
 
 	QVariant sensor() const;
 	QVariant sensorValue(const QString &protocol, const QString &model, int id, int dataType) const;
+	QVariantList sensorSnapshot() const;
 
 	QVariant controller() const;
 